@@ -0,0 +1,209 @@
+// Benchmarks του heap file: παραγωγή εγγραφών, insert, πλήρες scan, scan με
+// φίλτρο στο id και φόρτωση CSV, με ops/s, εκατοστημόρια καθυστέρησης και σελίδες I/O ανά πράξη
+// σε CSV. Τα id βγαίνουν από το workload.h.
+//
+// Χρήση: hp_bench [-n records] [-S scans] [-d uniform|zipfian|hotspot|sequential|latest] [-b frames] [-s seed]
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bf.h"
+#include "hp_file_funcs.h"
+#include "bench.h"
+#include "workload.h"
+
+#define BENCH_FILE "bench.db"
+#define BENCH_CSV_FILE "bench_load.db"
+#define BENCH_CSV "bench.csv"
+
+typedef struct {
+  long records;
+  long scans;
+  WorkloadConfig workload;
+  int frames;
+  uint64_t seed;
+} Options;
+
+static const char *distribution(const Options *options)
+{
+  return workload_distribution_name(options->workload.distribution);
+}
+
+static int parse_options(const int argc, char **argv, Options *options)
+{
+  options->records = 100000;
+  options->scans = 3;
+  workload_config_default(&options->workload);
+  options->frames = BF_BUFFER_SIZE;
+  options->seed = 42;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:S:d:b:s:")) != -1) {
+    switch (opt) {
+      case 'n': options->records = atol(optarg); break;
+      case 'S': options->scans = atol(optarg); break;
+      case 'd':
+        if (workload_parse_distribution(optarg, &options->workload.distribution) == -1) {
+          return 0;
+        }
+        break;
+      case 'b': options->frames = atoi(optarg); break;
+      case 's': options->seed = strtoull(optarg, NULL, 10); break;
+      default: return 0;
+    }
+  }
+  // sequential και latest κρατάνε id = index, ώστε τα νεότερα id να είναι και τα μεγαλύτερα
+  options->workload.scramble = options->workload.distribution != WORKLOAD_SEQUENTIAL &&
+                               options->workload.distribution != WORKLOAD_LATEST;
+  return options->records > 0 && options->records <= INT_MAX && options->scans > 0 && options->frames > 0;
+}
+
+// Πόσο γρήγορα βγαίνουν εγγραφές (id από την κατανομή + πεδία) χωρίς καθόλου I/O
+static int bench_generate(const Options *options)
+{
+  Workload workload;
+  BenchRun run;
+  const long total = options->records * 100;
+  long checksum = 0;
+
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  if (bench_begin(&run, "workload_generate", 1) == -1) {
+    return 0;
+  }
+  const double start = bench_now();
+  for (long i = 0; i < total; i++) {
+    const Record record = makeRecord(workload_key(&workload, workload_next_index(&workload)),
+                                     workload_random(&workload));
+    checksum += record.name[0];
+  }
+  bench_record_batch(&run, start, total);
+  bench_end(&run, distribution(options), options->records);
+  return checksum > 0;
+}
+
+static int bench_insert(const Options *options)
+{
+  int file_handle;
+  HeapFileHeader *header;
+  BenchRun run;
+  Workload workload;
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_FILE);
+  if (!HeapFile_Create(BENCH_FILE) || !HeapFile_Open(BENCH_FILE, &file_handle, &header) ||
+      bench_begin(&run, "heap_insert", options->records) == -1) {
+    return 0;
+  }
+  for (long i = 0; i < options->records; i++) {
+    const Record record = makeRecord(workload_key(&workload, workload_insert_index(&workload)),
+                                     workload_random(&workload));
+    const double start = bench_now();
+    HeapFile_InsertRecord(file_handle, header, record);
+    bench_record(&run, start);
+  }
+  // το κλείσιμο γράφει πίσω ό,τι έμεινε στη μνήμη, μετράει στο insert
+  HeapFile_Close(file_handle, header);
+  bench_end(&run, distribution(options), options->records);
+  return 1;
+}
+
+// Ένα πλήρες πέρασμα του αρχείου με id = -1 (όλες) ή με φίλτρο στο id
+static int bench_scan(const Options *options, const char *name, const int filtered)
+{
+  int file_handle;
+  HeapFileHeader *header;
+  BenchRun run;
+  Workload workload;
+
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  if (!HeapFile_Open(BENCH_FILE, &file_handle, &header) || bench_begin(&run, name, options->scans) == -1) {
+    return 0;
+  }
+  long expected = filtered ? options->scans : options->scans * options->records;
+  long seen = 0;
+  for (long i = 0; i < options->scans; i++) {
+    const int id = filtered ? workload_key(&workload, workload_next_index(&workload)) : -1;
+    const double start = bench_now();
+    HeapFileIterator iterator = HeapFile_CreateIterator(file_handle, header, id);
+    Record *record;
+    while (HeapFile_GetNextRecord(&iterator, &record)) {
+      seen++;
+      free(record);
+    }
+    bench_record(&run, start);
+  }
+  bench_end(&run, distribution(options), options->records);
+  HeapFile_Close(file_handle, header);
+
+  if (seen != expected) {
+    fprintf(stderr, "Error: %s returned %ld records instead of %ld\n", name, seen, expected);
+    return 0;
+  }
+  return 1;
+}
+
+// Φόρτωση ενός CSV με options->records γραμμές σε νέο αρχείο (το γράψιμο του CSV δεν μετράει)
+static int bench_csv_load(const Options *options)
+{
+  int file_handle;
+  HeapFileHeader *header;
+  BenchRun run;
+  Workload workload;
+  long loaded = 0;
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  FILE *csv = fopen(BENCH_CSV, "w");
+  if (csv == NULL) {
+    return 0;
+  }
+  fprintf(csv, "id,name,surname,city\n");
+  for (long i = 0; i < options->records; i++) {
+    const Record record = makeRecord(workload_key(&workload, workload_insert_index(&workload)),
+                                     workload_random(&workload));
+    fprintf(csv, "%d,%s,%s,%s\n", record.id, record.name, record.surname, record.city);
+  }
+  fclose(csv);
+
+  remove(BENCH_CSV_FILE);
+  if (!HeapFile_Create(BENCH_CSV_FILE) || !HeapFile_Open(BENCH_CSV_FILE, &file_handle, &header) ||
+      bench_begin(&run, "heap_csv_load", options->records) == -1) {
+    return 0;
+  }
+  const double start = bench_now();
+  const int ok = HeapFile_LoadCsv(file_handle, header, BENCH_CSV, 1, 0, &loaded);
+  HeapFile_Close(file_handle, header);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+  remove(BENCH_CSV_FILE);
+  remove(BENCH_CSV);
+
+  if (!ok || loaded != options->records) {
+    fprintf(stderr, "Error: heap_csv_load loaded %ld records instead of %ld\n", loaded, options->records);
+    return 0;
+  }
+  return 1;
+}
+
+int main(const int argc, char **argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, &options)) {
+    fprintf(stderr, "usage: %s [-n records] [-S scans] [-d uniform|zipfian|hotspot|sequential|latest] [-b frames] [-s seed]\n",
+            argv[0]);
+    return 1;
+  }
+  if (bench_io_init(options.frames) == -1) {
+    return 1;
+  }
+
+  BF_Init(LRU);
+  bench_print_header();
+  const int ok = bench_generate(&options) && bench_insert(&options) && bench_scan(&options, "heap_scan", 0) &&
+                 bench_scan(&options, "heap_filtered_scan", 1) && bench_csv_load(&options);
+  BF_Close();
+  remove(BENCH_FILE);
+  return ok ? 0 : 1;
+}
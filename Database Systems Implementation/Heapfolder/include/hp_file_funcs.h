@@ -0,0 +1,92 @@
+#ifndef HP_FILE_FUNCS_H
+#define HP_FILE_FUNCS_H
+
+#include "record.h"
+#include "hp_file_structs.h"
+
+/**
+ * @file hp_file_funcs.h
+ * @brief Heap file operations (src/hp_file.c). All return 1 on success, 0 on failure.
+ */
+
+/**
+ * @brief Creates an empty heap file.
+ * @param fileName Name of the file to create.
+ */
+int HeapFile_Create(const char *fileName);
+
+/**
+ * @brief Opens a heap file, recovering it from its log if it was not closed cleanly.
+ * @param fileName Name of the file.
+ * @param file_handle Receives the BF file descriptor.
+ * @param header_info Receives the in-memory header, freed by HeapFile_Close.
+ */
+int HeapFile_Open(const char *fileName, int *file_handle, HeapFileHeader **header_info);
+
+/**
+ * @brief Writes back the header and closes a heap file.
+ * @param file_handle BF file descriptor.
+ * @param hp_info Header returned by HeapFile_Open.
+ */
+int HeapFile_Close(int file_handle, HeapFileHeader *hp_info);
+
+/**
+ * @brief Appends a record to the last data block, allocating a new one when it is full.
+ * @param file_handle BF file descriptor.
+ * @param hp_info Header returned by HeapFile_Open.
+ * @param record Record to insert.
+ */
+int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record record);
+
+/**
+ * @brief Appends many records, filling each data block with one copy and one log operation.
+ * @param file_handle BF file descriptor.
+ * @param hp_info Header returned by HeapFile_Open.
+ * @param records Records to insert, in order.
+ * @param count Number of records.
+ */
+int HeapFile_InsertRecords(int file_handle, HeapFileHeader *hp_info, const Record *records, int count);
+
+/**
+ * @brief Loads a CSV file of id,name,surname,city lines (src/hp_csv.c).
+ *
+ * The file is memory-mapped and split into chunks at line boundaries,
+ * which worker threads parse in parallel while the calling thread appends
+ * them in file order with HeapFile_InsertRecords. Fields may be quoted
+ * ("" for a quote); strings longer than their field are cut. A malformed
+ * line stops the load and is reported with its line number.
+ * @param file_handle BF file descriptor.
+ * @param hp_info Header returned by HeapFile_Open.
+ * @param csv_path Path of the CSV file.
+ * @param has_header 1 if the first line holds column names and is skipped.
+ * @param threads Parsing threads, 0 for one per online CPU.
+ * @param loaded Receives the number of records loaded (may be NULL).
+ */
+int HeapFile_LoadCsv(int file_handle, HeapFileHeader *hp_info, const char *csv_path, int has_header, int threads,
+                     long *loaded);
+
+/**
+ * @brief Waits until every insert made so far is durable on disk.
+ *
+ * Recovery from the log covers crashes of the process, not power loss (see wal.h).
+ * @param file_handle BF file descriptor.
+ */
+int HeapFile_Sync(int file_handle);
+
+/**
+ * @brief Creates an iterator over the records with a given id.
+ * @param file_handle BF file descriptor.
+ * @param header_info Header returned by HeapFile_Open.
+ * @param id Id to match, or -1 for every record.
+ */
+HeapFileIterator HeapFile_CreateIterator(int file_handle, HeapFileHeader *header_info, int id);
+
+/**
+ * @brief Returns the next matching record of an iterator.
+ * @param heap_iterator Iterator from HeapFile_CreateIterator.
+ * @param record Receives a malloc'd copy of the record (to be freed by the caller), or NULL at the end.
+ * @return 1 if a record was returned, 0 at the end or on failure.
+ */
+int HeapFile_GetNextRecord(HeapFileIterator *heap_iterator, Record **record);
+
+#endif /* HP_FILE_FUNCS_H */
@@ -14,6 +14,9 @@
 
 /**
  * @brief Heap file header containing metadata about the file organization
+ *
+ * The B+ tree project reads heap files through its own copy of this layout
+ * (bplus_tree/include/bplus_heap.h); a change here must be made there too.
  */
 typedef struct HeapFileHeader {
     int is_heap_file; // 1 = true, 0 = false
@@ -20,6 +20,9 @@ typedef struct Record {
 
 Record randomRecord();
 
+// εγγραφή με δοσμένο id, τα πεδία της διαλέγονται από τα bits ενός τυχαίου αριθμού
+Record makeRecord(int id, unsigned long long bits);
+
 void printRecord(Record record);
 
 #endif
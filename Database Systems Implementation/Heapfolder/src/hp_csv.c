@@ -0,0 +1,282 @@
+// Φόρτωση CSV σε heap file: το αρχείο γίνεται mmap και κόβεται σε κομμάτια στα
+// όρια γραμμών, νήματα τα μετατρέπουν παράλληλα σε Record και το νήμα που
+// κάλεσε τα γράφει με τη σειρά του αρχείου με το HeapFile_InsertRecords.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hp_file_funcs.h"
+#include "record.h"
+
+#define CHUNK_SIZE (8 << 20)   // bytes ανά κομμάτι
+#define NO_ERROR SIZE_MAX
+#define ID_LENGTH 16           // το μεγαλύτερο πεδίο id που δεχόμαστε
+
+typedef struct {
+  Record *records;   // οι εγγραφές του κομματιού
+  int capacity;
+  int count;
+  int ready;         // 1 όταν τελειώσει το parsing
+  size_t error;      // offset της πρώτης κακής γραμμής, NO_ERROR αν δεν υπάρχει
+} CsvSlot;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  size_t body;       // αρχή της πρώτης γραμμής δεδομένων (μετά το header)
+  long chunk_count;
+
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  long next_chunk;   // το επόμενο κομμάτι που θα πάρει ένα νήμα
+  long consumed;     // κομμάτια που έχουν γραφτεί στο αρχείο
+  int window;        // κομμάτια που μπορεί να είναι ταυτόχρονα στη μνήμη
+  int stop;
+  CsvSlot *slots;    // το κομμάτι c ζει στο slots[c % window]
+} CsvLoad;
+
+// η αρχή της πρώτης γραμμής που ξεκινά στο offset ή μετά
+static size_t line_start(const CsvLoad *load, size_t offset)
+{
+  if (offset <= load->body) return load->body;
+  if (offset >= load->size) return load->size;
+  const char *newline = memchr(load->data + offset - 1, '\n', load->size - offset + 1);
+  return newline != NULL ? (size_t)(newline - load->data) + 1 : load->size;
+}
+
+// Διαβάζει ένα πεδίο ως το κόμμα ή το τέλος της γραμμής, με ή χωρίς εισαγωγικά.
+// Κρατάει ως max bytes στο out και επιστρέφει το μήκος του ή -1 για λάθος.
+static int read_field(const char **pos, const char *end, char *out, int max)
+{
+  const char *p = *pos;
+  int length = 0;
+  int quoted = p < end && *p == '"';
+  if (quoted) p++;
+
+  while (p < end) {
+    if (quoted && *p == '"') {
+      if (p + 1 < end && p[1] == '"') {
+        p++;
+      } else {
+        quoted = 0;
+        p++;
+        break;
+      }
+    } else if (!quoted && *p == ',') {
+      break;
+    }
+    if (length < max) out[length] = *p;
+    length++;
+    p++;
+  }
+  if (quoted || (p < end && *p != ',')) return -1;
+
+  *pos = p;
+  return length;
+}
+
+// πεδίο κειμένου: κόβεται ώστε να χωράει και το '\0'
+static int read_string(const char **pos, const char *end, char *out, int size)
+{
+  memset(out, 0, size);
+  return read_field(pos, end, out, size - 1) == -1 ? -1 : 0;
+}
+
+static int parse_line(const char *line, const char *end, Record *record)
+{
+  char id[ID_LENGTH];
+  const char *pos = line;
+  int length = read_field(&pos, end, id, ID_LENGTH);
+  if (length <= 0 || length >= ID_LENGTH) return -1;
+
+  int sign = id[0] == '-' || id[0] == '+';
+  if (sign == length || length - sign > 10) return -1;
+  long long value = 0;
+  for (int i = sign; i < length; i++) {
+    if (id[i] < '0' || id[i] > '9') return -1;
+    value = value * 10 + (id[i] - '0');
+  }
+  if (id[0] == '-') value = -value;
+  if (value < INT32_MIN || value > INT32_MAX) return -1;
+  record->id = (int)value;
+
+  char *fields[] = {record->name, record->surname, record->city};
+  int sizes[] = {sizeof(record->name), sizeof(record->surname), sizeof(record->city)};
+  for (int f = 0; f < 3; f++) {
+    if (pos == end) return -1;   // λείπουν πεδία
+    pos++;                       // το κόμμα
+    if (read_string(&pos, end, fields[f], sizes[f]) == -1) return -1;
+  }
+  return pos == end ? 0 : -1;    // περισσότερα πεδία
+}
+
+static void parse_chunk(const CsvLoad *load, long chunk, CsvSlot *slot)
+{
+  const char *pos = load->data + line_start(load, (size_t)chunk * CHUNK_SIZE);
+  const char *stop = load->data + line_start(load, (size_t)(chunk + 1) * CHUNK_SIZE);
+  slot->count = 0;
+  slot->error = NO_ERROR;
+
+  while (pos < stop) {
+    const char *newline = memchr(pos, '\n', stop - pos);
+    const char *next = newline != NULL ? newline + 1 : stop;
+    const char *end = newline != NULL ? newline : stop;
+    if (end > pos && end[-1] == '\r') end--;
+
+    // οι κενές γραμμές αγνοούνται
+    if (end > pos) {
+      if (slot->count == slot->capacity) {
+        int capacity = slot->capacity == 0 ? 4096 : 2 * slot->capacity;
+        Record *records = realloc(slot->records, (size_t)capacity * sizeof(Record));
+        if (records == NULL) {
+          slot->error = (size_t)(pos - load->data);
+          return;
+        }
+        slot->records = records;
+        slot->capacity = capacity;
+      }
+      if (parse_line(pos, end, &slot->records[slot->count]) == -1) {
+        slot->error = (size_t)(pos - load->data);
+        return;
+      }
+      slot->count++;
+    }
+    pos = next;
+  }
+}
+
+static void *parse_worker(void *arg)
+{
+  CsvLoad *load = arg;
+  pthread_mutex_lock(&load->lock);
+  while (!load->stop && load->next_chunk < load->chunk_count) {
+    // το slot ελευθερώνεται όταν γραφτεί το κομμάτι που είναι window θέσεις πιο πίσω
+    if (load->next_chunk >= load->consumed + load->window) {
+      pthread_cond_wait(&load->changed, &load->lock);
+      continue;
+    }
+    long chunk = load->next_chunk++;
+    CsvSlot *slot = &load->slots[chunk % load->window];
+    pthread_mutex_unlock(&load->lock);
+
+    parse_chunk(load, chunk, slot);
+
+    pthread_mutex_lock(&load->lock);
+    slot->ready = 1;
+    pthread_cond_broadcast(&load->changed);
+  }
+  pthread_mutex_unlock(&load->lock);
+  return NULL;
+}
+
+static long line_number(const char *data, size_t offset)
+{
+  long line = 1;
+  for (const char *p = data; (p = memchr(p, '\n', offset - (p - data))) != NULL; p++) line++;
+  return line;
+}
+
+// γράφει τα κομμάτια στο αρχείο με τη σειρά, μόλις ετοιμαστεί το καθένα
+static int write_chunks(CsvLoad *load, int file_handle, HeapFileHeader *hp_info, const char *csv_path, long *loaded)
+{
+  for (long chunk = 0; chunk < load->chunk_count; chunk++) {
+    CsvSlot *slot = &load->slots[chunk % load->window];
+    pthread_mutex_lock(&load->lock);
+    while (!slot->ready) pthread_cond_wait(&load->changed, &load->lock);
+    pthread_mutex_unlock(&load->lock);
+
+    if (slot->error != NO_ERROR) {
+      fprintf(stderr, "Error: %s:%ld: malformed CSV line\n", csv_path, line_number(load->data, slot->error));
+      return 0;
+    }
+    if (!HeapFile_InsertRecords(file_handle, hp_info, slot->records, slot->count)) return 0;
+    *loaded += slot->count;
+
+    pthread_mutex_lock(&load->lock);
+    slot->ready = 0;
+    load->consumed++;
+    pthread_cond_broadcast(&load->changed);
+    pthread_mutex_unlock(&load->lock);
+  }
+  return 1;
+}
+
+int HeapFile_LoadCsv(int file_handle, HeapFileHeader *hp_info, const char *csv_path, int has_header, int threads,
+                     long *loaded)
+{
+  long count = 0;
+  if (loaded != NULL) *loaded = 0;
+  if (!hp_info) return 0;
+
+  int fd = open(csv_path, O_RDONLY);
+  struct stat st;
+  if (fd == -1 || fstat(fd, &st) == -1) {
+    perror(csv_path);
+    if (fd != -1) close(fd);
+    return 0;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    return 1;
+  }
+  char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(csv_path);
+    return 0;
+  }
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  CsvLoad load;
+  memset(&load, 0, sizeof(load));
+  load.data = data;
+  load.size = st.st_size;
+  if (has_header) {
+    const char *newline = memchr(data, '\n', load.size);
+    load.body = newline != NULL ? (size_t)(newline - data) + 1 : load.size;
+  }
+  load.chunk_count = (long)((load.size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0) threads = 1;
+  if (threads > load.chunk_count) threads = (int)load.chunk_count;
+  load.window = 2 * threads;
+  load.slots = calloc(load.window, sizeof(CsvSlot));
+  pthread_t *workers = malloc(threads * sizeof(pthread_t));
+  if (load.slots == NULL || workers == NULL) {
+    free(load.slots);
+    free(workers);
+    munmap(data, st.st_size);
+    return 0;
+  }
+  pthread_mutex_init(&load.lock, NULL);
+  pthread_cond_init(&load.changed, NULL);
+
+  int started = 0;
+  while (started < threads && pthread_create(&workers[started], NULL, parse_worker, &load) == 0) started++;
+  int ok = started > 0 && write_chunks(&load, file_handle, hp_info, csv_path, &count);
+
+  // σταματάμε τα νήματα, και όσα περιμένουν ελεύθερο slot
+  pthread_mutex_lock(&load.lock);
+  load.stop = 1;
+  pthread_cond_broadcast(&load.changed);
+  pthread_mutex_unlock(&load.lock);
+  for (int t = 0; t < started; t++) pthread_join(workers[t], NULL);
+
+  for (int s = 0; s < load.window; s++) free(load.slots[s].records);
+  pthread_cond_destroy(&load.changed);
+  pthread_mutex_destroy(&load.lock);
+  free(load.slots);
+  free(workers);
+  munmap(data, st.st_size);
+
+  if (loaded != NULL) *loaded = count;
+  return ok;
+}
@@ -5,6 +5,7 @@
 #include "bf.h"
 #include "hp_file_structs.h"
 #include "record.h"
+#include "wal.h"
 
 #define CALL_BF(call)         \
   {                           \
@@ -16,6 +17,35 @@
     }                         \
   }
 
+// κρατάμε την εικόνα του block πριν το αλλάξει η τρέχουσα πράξη (για το undo)
+static int track_block(int file_handle, int block_id, BF_Block *blk)
+{
+  WalOp *op = wal_current(wal_of(file_handle));
+  return op == NULL || wal_track(op, block_id, BF_Block_GetData(blk)) == 0;
+}
+
+// SetDirty + εγγραφή των αλλαγών στο log, πριν το unpin
+static int dirty_block(int file_handle, int block_id, BF_Block *blk)
+{
+  BF_Block_SetDirty(blk);
+  Wal *wal = wal_of(file_handle);
+  WalOp *op = wal_current(wal);
+  return op == NULL || wal_log_page(wal, op, block_id, BF_Block_GetData(blk)) == 0;
+}
+
+// Νέο data block μετά το τελευταίο, που μένει pinned. Αν το αρχείο έχει ήδη block
+// εκεί, το άφησε μια πράξη που αναιρέθηκε στο recovery· είναι γεμάτο μηδενικά όπως
+// το έδωσε το BF και το ξαναπαίρνουμε αντί να μείνει κενό ανάμεσα στα δεδομένα.
+static int new_data_block(int file_handle, const HeapFileHeader *hp_info, BF_Block *blk, int *block_id)
+{
+  int total = 0;
+  if (BF_GetBlockCounter(file_handle, &total) != BF_OK) return 0;
+
+  *block_id = hp_info->last_data_block + 1;
+  if (*block_id < total) return BF_GetBlock(file_handle, *block_id, blk) == BF_OK;
+  return BF_AllocateBlock(file_handle, blk) == BF_OK;
+}
+
 int HeapFile_Create(const char* fileName)
 {
   int fd;
@@ -61,6 +91,12 @@ int HeapFile_Open(const char *fileName, int *file_handle, HeapFileHeader **heade
     return 0;
   }
 
+  // αν το αρχείο δεν έκλεισε σωστά, το log το φέρνει στο τελευταίο commit
+  if (wal_recover(fileName, file_handle) != 0) {
+    BF_CloseFile(*file_handle);
+    return 0;
+  }
+
   // παίρνουμε το πρώτο block (header)
   BF_Block *blk = NULL;
   BF_Block_Init(&blk);
@@ -93,6 +129,13 @@ int HeapFile_Open(const char *fileName, int *file_handle, HeapFileHeader **heade
     return 0;
   }
 
+  // κάθε αλλαγή από εδώ και πέρα γράφεται πρώτα στο log
+  if (wal_open(fileName, *file_handle, temp, sizeof(HeapFileHeader)) == NULL) {
+    free(temp);
+    BF_CloseFile(*file_handle);
+    return 0;
+  }
+
   *header_info = temp;
   return 1;
 }
@@ -121,17 +164,19 @@ int HeapFile_Close(int file_handle, HeapFileHeader *hp_info)
   free(hp_info);
 
   // τελικό κλείσιμο αρχείου
+  Wal *wal = wal_of(file_handle);
   if (BF_CloseFile(file_handle) != BF_OK) return 0;
 
+  // τα blocks γράφτηκαν, το log δεν χρειάζεται άλλο
+  if (wal != NULL && wal_close(wal) != 0) return 0;
+
   return 1;
 }
 
 
 
-int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record record)
+static int insert_record(int file_handle, HeapFileHeader *hp_info, const Record record)
 {
-  if (!hp_info || hp_info->records_per_block <= 0) return 0;
-
   BF_Block *blk = NULL;
   BF_Block_Init(&blk);
 
@@ -139,22 +184,19 @@ int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record
 
   // αν δεν υπάρχει κανένα data block, φτιάξε πρώτο
   if (target == 0) {
-    if (BF_AllocateBlock(file_handle, blk) != BF_OK) {
+    if (!new_data_block(file_handle, hp_info, blk, &target)) {
       BF_Block_Destroy(&blk);
       return 0;
     }
 
-    int total = 0;
-    if (BF_GetBlockCounter(file_handle, &total) != BF_OK) {
+    if (!track_block(file_handle, target, blk)) {
       BF_UnpinBlock(blk);
       BF_Block_Destroy(&blk);
       return 0;
     }
-    target = total - 1;
-
     char *raw0 = BF_Block_GetData(blk);
     *(int *)raw0 = 0;     // count = 0 στο νέο block
-    BF_Block_SetDirty(blk);
+    dirty_block(file_handle, target, blk);
     BF_UnpinBlock(blk);
 
     hp_info->last_data_block = target;
@@ -165,6 +207,11 @@ int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record
     BF_Block_Destroy(&blk);
     return 0;
   }
+  if (!track_block(file_handle, target, blk)) {
+    BF_UnpinBlock(blk);
+    BF_Block_Destroy(&blk);
+    return 0;
+  }
 
   char *base = BF_Block_GetData(blk);
   int  *cnt  = (int *)base;
@@ -174,24 +221,28 @@ int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record
   if (*cnt < cap) {
     arr[*cnt] = record;   // γράψε & αύξησε
     (*cnt)++;
-    BF_Block_SetDirty(blk);
+    int logged = dirty_block(file_handle, target, blk);
     BF_UnpinBlock(blk);
+    if (!logged) {
+      BF_Block_Destroy(&blk);
+      return 0;
+    }
   } else {
     // γέμισε → νέο block
     BF_UnpinBlock(blk);
 
-    if (BF_AllocateBlock(file_handle, blk) != BF_OK) {
+    int fresh = 0;
+    if (!new_data_block(file_handle, hp_info, blk, &fresh)) {
       BF_Block_Destroy(&blk);
       return 0;
     }
 
-    int total = 0;
-    if (BF_GetBlockCounter(file_handle, &total) != BF_OK) {
+    // το νέο block έρχεται γεμάτο μηδενικά, αυτή είναι και η εικόνα του για το undo
+    if (!track_block(file_handle, fresh, blk)) {
       BF_UnpinBlock(blk);
       BF_Block_Destroy(&blk);
       return 0;
     }
-    int fresh = total - 1;
 
     char *base2 = BF_Block_GetData(blk);
     int  *cnt2  = (int *)base2;
@@ -200,17 +251,107 @@ int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record
     *cnt2 = 1;
     arr2[0] = record;
 
-    BF_Block_SetDirty(blk);
+    int logged = dirty_block(file_handle, fresh, blk);
     BF_UnpinBlock(blk);
+    if (!logged) {
+      BF_Block_Destroy(&blk);
+      return 0;
+    }
 
     hp_info->last_data_block = fresh;
   }
 
   BF_Block_Destroy(&blk);
-  hp_info->total_records += 1;   // θα γραφτεί μόνιμα στο Close
+  hp_info->total_records += 1;   // θα γραφτεί μόνιμα στο Close, ως τότε ζει στο log
   return 1;
 }
 
+int HeapFile_InsertRecord(int file_handle, HeapFileHeader *hp_info, const Record record)
+{
+  if (!hp_info || hp_info->records_per_block <= 0) return 0;
+
+  // οι αλλαγές στα blocks και στον header γίνονται commit μαζί
+  Wal *wal = wal_of(file_handle);
+  if (wal != NULL) wal_begin(wal, NULL);
+
+  int ok = insert_record(file_handle, hp_info, record);
+
+  if (wal != NULL && wal_commit(wal, NULL) != 0) return 0;
+  return ok;
+}
+
+// Γεμίζει το τελευταίο block (ή ένα νέο, αν είναι γεμάτο) με όσες από τις count
+// εγγραφές χωράνε, με ένα αντίγραφο. Στο *added πόσες μπήκαν.
+static int fill_block(int file_handle, HeapFileHeader *hp_info, BF_Block *blk, const Record *records, int count,
+                      int *added)
+{
+  int target = hp_info->last_data_block;
+  int fresh = 0;
+  *added = 0;
+
+  if (target != 0) {
+    CALL_BF(BF_GetBlock(file_handle, target, blk));
+    if (*(int *)BF_Block_GetData(blk) >= hp_info->records_per_block) {
+      BF_UnpinBlock(blk);
+      target = 0;
+    }
+  }
+  if (target == 0) {
+    if (!new_data_block(file_handle, hp_info, blk, &target)) return 0;
+    fresh = 1;
+  }
+
+  if (!track_block(file_handle, target, blk)) {
+    BF_UnpinBlock(blk);
+    return 0;
+  }
+  char *base = BF_Block_GetData(blk);
+  int *cnt = (int *)base;
+  if (fresh) *cnt = 0;
+  int n = hp_info->records_per_block - *cnt;
+  if (n > count) n = count;
+  memcpy(base + sizeof(int) + (size_t)*cnt * sizeof(Record), records, (size_t)n * sizeof(Record));
+  *cnt += n;
+
+  int logged = dirty_block(file_handle, target, blk);
+  BF_UnpinBlock(blk);
+  if (!logged) return 0;
+
+  hp_info->last_data_block = target;
+  hp_info->total_records += n;
+  *added = n;
+  return 1;
+}
+
+int HeapFile_InsertRecords(int file_handle, HeapFileHeader *hp_info, const Record *records, int count)
+{
+  if (!hp_info || hp_info->records_per_block <= 0 || count < 0) return 0;
+
+  BF_Block *blk = NULL;
+  BF_Block_Init(&blk);
+  Wal *wal = wal_of(file_handle);
+  int ok = 1;
+
+  // μία πράξη του log ανά block, όχι ανά εγγραφή
+  for (int done = 0; ok && done < count;) {
+    int added = 0;
+    if (wal != NULL) wal_begin(wal, NULL);
+    ok = fill_block(file_handle, hp_info, blk, records + done, count - done, &added);
+    if (wal != NULL && wal_commit(wal, NULL) != 0) ok = 0;
+    done += added;
+  }
+
+  BF_Block_Destroy(&blk);
+  return ok;
+}
+
+// Περιμένει ώσπου όλες οι εισαγωγές που έχουν γίνει να είναι μόνιμες στον δίσκο
+int HeapFile_Sync(int file_handle)
+{
+  Wal *wal = wal_of(file_handle);
+  return wal != NULL && wal_sync(wal) == 0;
+}
+
 
 
 
@@ -59,6 +59,19 @@ Record randomRecord(){
     return record;
 }
 
+Record makeRecord(int id, unsigned long long bits){
+    Record record;
+    record.id = id;
+    // κάθε πεδίο παίρνει τα δικά του 16 bits του αριθμού
+    const char *name = names[(bits & 0xffff) % (sizeof(names) / sizeof(names[0]))];
+    memcpy(record.name, name, strlen(name) + 1);
+    const char *surname = surnames[((bits >> 16) & 0xffff) % (sizeof(surnames) / sizeof(surnames[0]))];
+    memcpy(record.surname, surname, strlen(surname) + 1);
+    const char *city = cities[((bits >> 32) & 0xffff) % (sizeof(cities) / sizeof(cities[0]))];
+    memcpy(record.city, city, strlen(city) + 1);
+    return record;
+}
+
 void printRecord(Record record){
     printf("(%d,%s,%s,%s)\n",record.id,record.name,record.surname,record.city);
 
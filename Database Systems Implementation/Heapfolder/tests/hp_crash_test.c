@@ -0,0 +1,199 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bf.h"
+#include "hp_file_structs.h"
+#include "hp_file_funcs.h"
+#include "wal.h"
+
+#define RECORDS_NUM 60000  // Committed inserts; the log passes WAL_CHECKPOINT_BYTES on the way
+#define UNCOMMITTED_NUM 20 // Inserts of the operation that never commits
+#define SYNC_EVERY 1000    // Inserts between the progress reports of the killed child
+#define KILL_AFTER 20      // Progress reports before the child is killed
+#define FILE_NAME "test_crash.db"
+
+// Prints a failed check and counts it
+#define CHECK(condition, ...)                                           \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      fprintf(stderr, "%s:%d: check failed: ", __FILE__, __LINE__);     \
+      fprintf(stderr, __VA_ARGS__);                                     \
+      fprintf(stderr, "\n");                                            \
+      failures++;                                                       \
+    }                                                                   \
+  } while (0)
+
+static int failures = 0;
+
+/**
+ * Creates the file, opens it and inserts the records 0..count-1, one operation each.
+ */
+static int insert_records(int count, int report_fd, HeapFileHeader **header_info)
+{
+  BF_Init(LRU);
+  HeapFile_Create(FILE_NAME);
+  int file_handle;
+  if (!HeapFile_Open(FILE_NAME, &file_handle, header_info)) {
+    _exit(2);
+  }
+
+  for (int id = 0; id < count; id++) {
+    if (!HeapFile_InsertRecord(file_handle, *header_info, makeRecord(id, (unsigned long long)id * 2654435761u))) {
+      _exit(3);
+    }
+    // Everything up to a report is durable when the parent reads it
+    if (report_fd != -1 && (id + 1) % SYNC_EVERY == 0) {
+      HeapFile_Sync(file_handle);
+      const int done = id + 1;
+      if (write(report_fd, &done, sizeof(done)) != sizeof(done)) {
+        _exit(4);
+      }
+    }
+  }
+  return file_handle;
+}
+
+/**
+ * Child that commits every insert, then crashes in the middle of one
+ * operation whose new blocks have been written back.
+ */
+static void crash_in_operation(void)
+{
+  HeapFileHeader *header_info;
+  const int file_handle = insert_records(RECORDS_NUM, -1, &header_info);
+  HeapFile_Sync(file_handle);
+
+  wal_begin(wal_of(file_handle), NULL);
+  for (int i = 0; i < UNCOMMITTED_NUM; i++) {
+    HeapFile_InsertRecord(file_handle, header_info, makeRecord(-1, 0));
+  }
+  // Scanning the whole file evicts the changed blocks, which BF writes to the file
+  HeapFileIterator iterator = HeapFile_CreateIterator(file_handle, header_info, -2);
+  Record *record;
+  while (HeapFile_GetNextRecord(&iterator, &record)) {
+    free(record);
+  }
+  _exit(0);
+}
+
+/**
+ * Checks that the data blocks hold exactly the records 0..total_records-1 in
+ * order, every block but the last full, and no block past the last one.
+ */
+static void check_blocks(const char *scenario, int file_handle, const HeapFileHeader *header)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int next_id = 0, wrong = 0;
+  for (int block_id = 1; block_id <= header->last_data_block; block_id++) {
+    if (BF_GetBlock(file_handle, block_id, block) != BF_OK) {
+      wrong++;
+      break;
+    }
+    const char *data = BF_Block_GetData(block);
+    const int count = *(const int *)data;
+    const Record *records = (const Record *)(data + sizeof(int));
+    if (count > header->records_per_block ||
+        (block_id < header->last_data_block && count != header->records_per_block)) {
+      wrong++;
+    }
+    for (int i = 0; i < count && i < header->records_per_block; i++) {
+      if (records[i].id != next_id++) {
+        wrong++;
+      }
+    }
+    BF_UnpinBlock(block);
+  }
+  BF_Block_Destroy(&block);
+
+  int blocks = 0;
+  BF_GetBlockCounter(file_handle, &blocks);
+  CHECK(wrong == 0, "%s: %d blocks or records out of place", scenario, wrong);
+  CHECK(next_id == header->total_records, "%s: %d records in the blocks, %d in the header", scenario, next_id,
+        header->total_records);
+  CHECK(blocks == header->last_data_block + 1, "%s: %d blocks past the last data block", scenario,
+        blocks - header->last_data_block - 1);
+}
+
+/**
+ * Opens the crashed file and checks that it holds exactly the records
+ * 0..expected-1. With expected < 0 it may hold any prefix of at least
+ * -expected records. New inserts then reuse the blocks of the rolled back
+ * operation.
+ */
+static void check_recovered(const char *scenario, int expected)
+{
+  BF_Init(LRU);
+  int file_handle;
+  HeapFileHeader *header;
+  if (!HeapFile_Open(FILE_NAME, &file_handle, &header)) {
+    CHECK(0, "%s: recovery failed", scenario);
+    BF_Close();
+    return;
+  }
+
+  const int present = header->total_records;
+  if (expected >= 0) {
+    CHECK(present == expected, "%s: %d records, expected %d", scenario, present, expected);
+  } else {
+    CHECK(present >= -expected, "%s: %d records, at least %d were durable", scenario, present, -expected);
+  }
+  int blocks = 0;
+  BF_GetBlockCounter(file_handle, &blocks);
+  for (int id = present; id < present + UNCOMMITTED_NUM; id++) {
+    CHECK(HeapFile_InsertRecord(file_handle, header, makeRecord(id, 0)), "%s: insert after recovery", scenario);
+  }
+  check_blocks(scenario, file_handle, header);
+  printf("%-10s recovered %d records in %d blocks\n", scenario, present, blocks);
+
+  HeapFile_Close(file_handle, header);
+  BF_Close();
+  CHECK(access(FILE_NAME ".wal", F_OK) == -1, "%s: log left after a clean close", scenario);
+}
+
+int main() {
+  // ===== _exit in the middle of an operation =====
+  remove(FILE_NAME);
+  remove(FILE_NAME ".wal");
+  pid_t child = fork();
+  if (child == 0) {
+    crash_in_operation();
+  }
+  int status;
+  waitpid(child, &status, 0);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0, "child failed before the crash");
+  CHECK(access(FILE_NAME ".wal", F_OK) == 0, "no log after the crash");
+  check_recovered("_exit", RECORDS_NUM);
+
+  // ===== SIGKILL during inserts =====
+  remove(FILE_NAME);
+  remove(FILE_NAME ".wal");
+  int reports[2];
+  if (pipe(reports) == -1) {
+    return 1;
+  }
+  child = fork();
+  if (child == 0) {
+    close(reports[0]);
+    HeapFileHeader *header_info;
+    insert_records(RECORDS_NUM, reports[1], &header_info);
+    pause();
+    _exit(0);
+  }
+  close(reports[1]);
+  int durable = 0;
+  for (int i = 0; i < KILL_AFTER && read(reports[0], &durable, sizeof(durable)) == sizeof(durable); i++) {
+  }
+  kill(child, SIGKILL);
+  waitpid(child, &status, 0);
+  close(reports[0]);
+  CHECK(durable == KILL_AFTER * SYNC_EVERY, "child reported %d durable inserts", durable);
+  check_recovered("SIGKILL", -durable);
+
+  remove(FILE_NAME);
+  printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+  return failures == 0 ? 0 : 1;
+}
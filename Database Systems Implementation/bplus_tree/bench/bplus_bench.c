@@ -0,0 +1,831 @@
+// Benchmarks του B+ δέντρου: παραγωγή φορτίου, insert, point lookup (και με page
+// pool, και σε snapshot με και χωρίς συμπίεση), range scan, ερώτημα με scan
+// (εγγραφή-εγγραφή και vectorized), joins, μικτό φορτίο, bulk load, φόρτωση CSV
+// και χτίσιμο ευρετηρίου από heap file, με ops/s, εκατοστημόρια καθυστέρησης και
+// σελίδες I/O ανά πράξη σε CSV.
+// Τα κλειδιά και οι πράξεις βγαίνουν από το workload.h.
+//
+// Χρήση: bp_bench [-n records] [-o ops] [-d uniform|zipfian|hotspot|sequential|latest]
+//                 [-m read/insert/scan] [-b frames] [-p pool MiB] [-r range] [-t threads] [-s seed]
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bf.h"
+#include "bplus_bulk_load.h"
+#include "bplus_csv.h"
+#include "bplus_exec.h"
+#include "bplus_file_funcs.h"
+#include "bplus_heap.h"
+#include "bplus_index_build.h"
+#include "bplus_join.h"
+#include "bplus_page_pool.h"
+#include "bplus_secondary.h"
+#include "bplus_snapshot.h"
+#include "record_generator.h"
+#include "bench.h"
+#include "workload.h"
+
+#define BENCH_FILE "bench.db"
+#define BENCH_BULK_FILE "bench_bulk.db"
+#define BENCH_JOIN_FILE "bench_join.db"
+#define BENCH_SNAPSHOT_FILE "bench_snapshot.db"
+#define BENCH_CSV_FILE "bench_load.db"
+#define BENCH_CSV "bench.csv"
+#define BENCH_HEAP_FILE "bench_heap.db"
+#define BENCH_INDEX_FILE "bench_index.db"
+#define BENCH_INDEX_ATTR "city"
+#define BULK_BUFFER_RECORDS 4096
+#define BENCH_QUERY_NAME "Maria"
+#define BENCH_POOL_MIB 64
+
+typedef struct {
+  long records;
+  long ops;
+  WorkloadConfig workload;
+  int frames;
+  int pool;        // MiB του page pool για ολα τα benchmarks, 0 χωρις
+  int range;
+  int threads;
+  uint64_t seed;
+} Options;
+
+static const char *distribution(const Options *options)
+{
+  return workload_distribution_name(options->workload.distribution);
+}
+
+static int parse_options(const int argc, char **argv, Options *options)
+{
+  options->records = 100000;
+  options->ops = -1;
+  workload_config_default(&options->workload);
+  options->workload.read_percent = 90;
+  options->workload.insert_percent = 5;
+  options->frames = BF_BUFFER_SIZE;
+  options->pool = 0;
+  options->range = 100;
+  options->threads = 1;
+  options->seed = 42;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:o:d:m:b:p:r:t:s:")) != -1) {
+    switch (opt) {
+      case 'n': options->records = atol(optarg); break;
+      case 'o': options->ops = atol(optarg); break;
+      case 'd':
+        if (workload_parse_distribution(optarg, &options->workload.distribution) == -1) {
+          return -1;
+        }
+        break;
+      case 'm':
+        if (workload_parse_mix(optarg, &options->workload) == -1) {
+          return -1;
+        }
+        break;
+      case 'b': options->frames = atoi(optarg); break;
+      case 'p': options->pool = atoi(optarg); break;
+      case 'r': options->range = atoi(optarg); break;
+      case 't': options->threads = atoi(optarg); break;
+      case 's': options->seed = strtoull(optarg, NULL, 10); break;
+      default: return -1;
+    }
+  }
+  if (options->ops < 0) {
+    options->ops = options->records;
+  }
+  // sequential και latest κρατανε key = index, ωστε τα νεοτερα κλειδια να ειναι και τα μεγαλυτερα
+  options->workload.scramble = options->workload.distribution != WORKLOAD_SEQUENTIAL &&
+                               options->workload.distribution != WORKLOAD_LATEST;
+  if (options->records <= 0 || options->records > INT_MAX / 2 || options->frames <= 0 || options->pool < 0 || options->range <= 0 ||
+      options->threads <= 0) {
+    return -1;
+  }
+  return 0;
+}
+
+typedef struct {
+  const Options *options;
+  const TableSchema *schema;
+  int thread;
+  long count;
+  long checksum;
+} GenerateTask;
+
+static void *generate(void *arg)
+{
+  GenerateTask *task = arg;
+  Workload workload;
+  Record record;
+  workload_init(&workload, &task->options->workload, task->options->records, task->options->seed, task->thread,
+                task->options->threads);
+  for (long i = 0; i < task->count; i++) {
+    const int key = workload_key(&workload, workload_next_index(&workload));
+    employee_record(task->schema, &record, key, workload_random(&workload));
+    task->checksum += record.values[1].string_value[0];
+  }
+  return NULL;
+}
+
+// Ποσο γρηγορα βγαινουν εγγραφες (κλειδι απο την κατανομη + πεδια) χωρις καθολου I/O, με options->threads νηματα
+static int bench_generate(const Options *options, const TableSchema *schema)
+{
+  GenerateTask tasks[options->threads];
+  pthread_t threads[options->threads];
+  BenchRun run;
+  const long total = options->records * 100;
+
+  if (bench_begin(&run, "workload_generate", 1) == -1) {
+    return -1;
+  }
+  const double start = bench_now();
+  for (int t = 0; t < options->threads; t++) {
+    tasks[t] = (GenerateTask){options, schema, t, total / options->threads, 0};
+    pthread_create(&threads[t], NULL, generate, &tasks[t]);
+  }
+  long generated = 0;
+  long checksum = 0;
+  for (int t = 0; t < options->threads; t++) {
+    pthread_join(threads[t], NULL);
+    generated += tasks[t].count;
+    checksum += tasks[t].checksum;
+  }
+  bench_record_batch(&run, start, generated);
+  bench_end(&run, distribution(options), options->records);
+  return checksum > 0 ? 0 : -1;
+}
+
+static int bench_insert(const Options *options, const TableSchema *schema)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Record record;
+  Workload workload;
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_FILE);
+  if (bplus_create_file(schema, BENCH_FILE) == -1 || bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_insert", options->records) == -1) {
+    return -1;
+  }
+  for (long i = 0; i < options->records; i++) {
+    const int key = workload_key(&workload, workload_insert_index(&workload));
+    employee_record(schema, &record, key, workload_random(&workload));
+    const double start = bench_now();
+    bplus_record_insert(file_desc, metadata, &record);
+    bench_record(&run, start);
+  }
+  // το κλεισιμο γραφει πισω οτι εμεινε στη μνημη, μετραει στο insert
+  bplus_close_file(file_desc, metadata);
+  bench_end(&run, distribution(options), options->records);
+  return 0;
+}
+
+// options->ops lookups, μετρημενα στο run αν δεν ειναι NULL. Επιστρεφει ποσα δεν βρεθηκαν
+static long lookups(const Options *options, const int file_desc, const BPlusMeta *metadata, BenchRun *run)
+{
+  Workload workload;
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  long misses = 0;
+  for (long i = 0; i < options->ops; i++) {
+    const int key = workload_key(&workload, workload_next_index(&workload));
+    Record *record;
+    const double start = bench_now();
+    misses += bplus_record_find(file_desc, metadata, key, &record) != 0;
+    if (run != NULL) {
+      bench_record(run, start);
+    }
+    free(record);
+  }
+  if (misses > 0) {
+    fprintf(stderr, "Error: %ld lookups did not find their key\n", misses);
+  }
+  return misses;
+}
+
+static int bench_lookup(const Options *options)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_lookup", options->ops) == -1) {
+    return -1;
+  }
+  const long misses = lookups(options, file_desc, metadata, &run);
+  bench_end(&run, distribution(options), options->records);
+  bplus_close_file(file_desc, metadata);
+  return misses > 0 ? -1 : 0;
+}
+
+// Τα ιδια lookups με page pool του -p (BENCH_POOL_MIB αν δεν δοθηκε): ενα περασμα
+// γεμιζει το pool και μετραει το δευτερο, οποτε οι σελιδες I/O ειναι οσες δεν χωρεσαν
+static int bench_lookup_pool(const Options *options)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  const int pool = options->pool > 0 ? options->pool : BENCH_POOL_MIB;
+
+  if (bplus_pool_resize((size_t)pool << 20) == -1 || bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1) {
+    return -1;
+  }
+  long misses = lookups(options, file_desc, metadata, NULL);
+  if (bench_begin(&run, "bplus_lookup_pool", options->ops) == -1) {
+    return -1;
+  }
+  misses += lookups(options, file_desc, metadata, &run);
+  bench_end(&run, distribution(options), options->records);
+  bplus_close_file(file_desc, metadata);
+  bplus_pool_resize((size_t)options->pool << 20);
+  return misses > 0 ? -1 : 0;
+}
+
+// Lookups σε snapshot του αρχειου, μια φορα με τις εγγραφες οπως ειναι και μια με
+// συμπιεσμενες ομαδες· το ονομα της δευτερης γραμμης εχει ποσο μικραιναν οι εγγραφες
+static int bench_snapshot_lookup(const Options *options, const int compress)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Workload workload;
+  Record record;
+  char name[64];
+
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1) {
+    return -1;
+  }
+  const int exported = compress ? bplus_export_snapshot_compressed(file_desc, metadata, BENCH_SNAPSHOT_FILE)
+                                : bplus_export_snapshot(file_desc, metadata, BENCH_SNAPSHOT_FILE);
+  bplus_close_file(file_desc, metadata);
+  BPlusSnapshot *snapshot = exported == -1 ? NULL : bplus_snapshot_open(BENCH_SNAPSHOT_FILE);
+  if (snapshot == NULL) {
+    return -1;
+  }
+  const BPlusSnapshotHeader *header = snapshot->header;
+  snprintf(name, sizeof(name), compress ? "snapshot_lookup_lz_%.1fx" : "snapshot_lookup",
+           (double)header->record_count * header->record_size / (header->records_bytes > 0 ? header->records_bytes : 1));
+
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  long misses = 0;
+  if (bench_begin(&run, name, options->ops) == -1) {
+    bplus_snapshot_close(snapshot);
+    return -1;
+  }
+  for (long i = 0; i < options->ops; i++) {
+    const int key = workload_key(&workload, workload_next_index(&workload));
+    const double start = bench_now();
+    misses += bplus_snapshot_find(snapshot, key, &record) != 0;
+    bench_record(&run, start);
+  }
+  bench_end(&run, distribution(options), options->records);
+  bplus_snapshot_close(snapshot);
+  remove(BENCH_SNAPSHOT_FILE);
+
+  if (misses > 0) {
+    fprintf(stderr, "Error: %ld snapshot lookups did not find their key\n", misses);
+    return -1;
+  }
+  return 0;
+}
+
+typedef struct {
+  int limit;
+  int seen;
+} ScanState;
+
+static int count_up_to(const Record *record, void *ctx)
+{
+  (void)record;
+  ScanState *state = ctx;
+  return ++state->seen >= state->limit;
+}
+
+static int bench_range_scan(const Options *options)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Workload workload;
+  const long scans = options->ops / options->range > 0 ? options->ops / options->range : 1;
+
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_range_scan", scans) == -1) {
+    return -1;
+  }
+  // καθε scan ξεκινα απο ενα υπαρκτο κλειδι και σταματα μετα απο range εγγραφες
+  for (long i = 0; i < scans; i++) {
+    const int lo = workload_key(&workload, workload_next_index(&workload));
+    ScanState state = {options->range, 0};
+    const double start = bench_now();
+    bplus_range_scan(file_desc, metadata, lo, INT_MAX, count_up_to, &state);
+    bench_record(&run, start);
+  }
+  bench_end(&run, distribution(options), options->records);
+  bplus_close_file(file_desc, metadata);
+  return 0;
+}
+
+typedef struct {
+  long count;
+  long long sum;
+} QueryState;
+
+static int match_name(const Record *record, void *ctx)
+{
+  QueryState *state = ctx;
+  if (strcmp(employee_name(record), BENCH_QUERY_NAME) == 0) {
+    state->count++;
+    state->sum += employee_id(record);
+  }
+  return 0;
+}
+
+// SELECT COUNT(*), SUM(id) WHERE name = BENCH_QUERY_NAME, μια φορα εγγραφη-εγγραφη
+// με το bplus_range_scan και μια με τους τελεστες του bplus_exec.h
+static int bench_query(const Options *options)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  QueryState state = {0, 0};
+  ExecBatch *batch;
+  FieldValue name;
+  const ExecAggregateSpec specs[] = {{EXEC_COUNT, 0}, {EXEC_SUM, 0}};
+  strcpy(name.string_value, BENCH_QUERY_NAME);
+
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_query_tuple", options->records) == -1) {
+    return -1;
+  }
+  double start = bench_now();
+  bplus_range_scan(file_desc, metadata, INT_MIN, INT_MAX, match_name, &state);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+
+  if (bench_begin(&run, "bplus_query_vectorized", options->records) == -1) {
+    return -1;
+  }
+  start = bench_now();
+  ExecOperator *query = exec_aggregate(exec_filter(exec_bplus_scan(file_desc, metadata), 1, EXEC_EQ, &name), specs, 2);
+  const int rows = query == NULL ? -1 : exec_next(query, &batch);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+
+  const int same = rows == 1 && (long)exec_aggregate_value(query, 0) == state.count &&
+                   (long long)exec_aggregate_value(query, 1) == state.sum;
+  exec_close(query);
+  bplus_close_file(file_desc, metadata);
+  if (!same) {
+    fprintf(stderr, "Error: the vectorized query disagrees with the tuple scan\n");
+  }
+  return same ? 0 : -1;
+}
+
+typedef struct {
+  long matches;
+  long long checksum;
+} JoinState;
+
+static int join_pair(const Record *left, const Record *right, void *ctx)
+{
+  JoinState *state = ctx;
+  state->matches++;
+  state->checksum += employee_id(left) + employee_id(right);
+  return 0;
+}
+
+// Hash join για συγκριση: ολο το αρχειο του join σε hash table και probe με scan του BENCH_FILE
+typedef struct {
+  Record *records;
+  int *slots;  // θεση στο records + 1, 0 για αδειο
+  unsigned mask;
+  long count;
+  JoinState state;
+} HashJoin;
+
+static unsigned hash_slot(const HashJoin *join, const int key)
+{
+  return ((unsigned)key * 2654435761u) & join->mask;
+}
+
+static int hash_build(const Record *record, void *ctx)
+{
+  HashJoin *join = ctx;
+  unsigned slot = hash_slot(join, employee_id(record));
+  while (join->slots[slot] != 0) {
+    slot = (slot + 1) & join->mask;
+  }
+  join->records[join->count] = *record;
+  join->slots[slot] = (int)++join->count;
+  return 0;
+}
+
+static int hash_probe(const Record *record, void *ctx)
+{
+  HashJoin *join = ctx;
+  for (unsigned slot = hash_slot(join, employee_id(record)); join->slots[slot] != 0; slot = (slot + 1) & join->mask) {
+    const Record *built = &join->records[join->slots[slot] - 1];
+    if (employee_id(built) == employee_id(record)) {
+      join_pair(built, record, &join->state);
+      break;
+    }
+  }
+  return 0;
+}
+
+static int hash_join(const int join_desc, const BPlusMeta *join_meta, const int file_desc, const BPlusMeta *metadata,
+                     const long rows, JoinState *state)
+{
+  HashJoin join = {NULL, NULL, 1, 0, {0, 0}};
+  while (join.mask < 2 * (unsigned)rows) {
+    join.mask <<= 1;
+  }
+  join.records = malloc(rows * sizeof(Record));
+  join.slots = calloc(join.mask, sizeof(int));
+  join.mask--;
+  int result = -1;
+  if (join.records != NULL && join.slots != NULL &&
+      bplus_range_scan(join_desc, join_meta, INT_MIN, INT_MAX, hash_build, &join) != -1 &&
+      bplus_range_scan(file_desc, metadata, INT_MIN, INT_MAX, hash_probe, &join) != -1) {
+    *state = join.state;
+    result = 0;
+  }
+  free(join.slots);
+  free(join.records);
+  return result;
+}
+
+// Join του BENCH_FILE με ενα αρχειο που εχει καθε δευτερο κλειδι του: hash join,
+// merge join των δυο φυλλων και index nested loop join με εξωτερικο το μικρο αρχειο
+static int bench_join(const Options *options, const TableSchema *schema)
+{
+  int file_desc, join_desc;
+  BPlusMeta *metadata, *join_meta;
+  BenchRun run;
+  Workload workload;
+  Record record;
+  ExecBatch *batch;
+  int n;
+  long rows = 0;
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_JOIN_FILE);
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 || bplus_create_file(schema, BENCH_JOIN_FILE) == -1 ||
+      bplus_open_file(BENCH_JOIN_FILE, &join_desc, &join_meta) == -1 ||
+      bplus_insert_buffer_enable(join_desc, join_meta, BULK_BUFFER_RECORDS) == -1) {
+    return -1;
+  }
+  ExecOperator *scan = exec_bplus_scan(file_desc, metadata);
+  long position = 0;
+  while (scan != NULL && (n = exec_next(scan, &batch)) > 0) {
+    for (int r = 0; r < n; r++, position++) {
+      if (position % 2 == 0) {
+        employee_record(schema, &record, ((const int *)batch->columns[0])[r], workload_random(&workload));
+        bplus_record_insert(join_desc, join_meta, &record);
+        rows++;
+      }
+    }
+  }
+  exec_close(scan);
+  bplus_insert_buffer_enable(join_desc, join_meta, 0);
+
+  JoinState hashed = {0, 0}, merged = {0, 0}, probed = {0, 0};
+  if (bench_begin(&run, "bplus_join_hash", options->records) == -1) {
+    return -1;
+  }
+  double start = bench_now();
+  int failed = hash_join(join_desc, join_meta, file_desc, metadata, rows, &hashed) == -1;
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+
+  if (bench_begin(&run, "bplus_join_merge", options->records) == -1) {
+    return -1;
+  }
+  start = bench_now();
+  failed |= bplus_merge_join(join_desc, join_meta, file_desc, metadata, join_pair, &merged) == -1;
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+
+  if (bench_begin(&run, "bplus_join_index", rows) == -1) {
+    return -1;
+  }
+  start = bench_now();
+  failed |= bplus_index_join(exec_bplus_scan(join_desc, join_meta), 0, file_desc, metadata, join_pair, &probed) == -1;
+  bench_record_batch(&run, start, rows);
+  bench_end(&run, distribution(options), options->records);
+
+  bplus_close_file(join_desc, join_meta);
+  bplus_close_file(file_desc, metadata);
+  remove(BENCH_JOIN_FILE);
+  const int same = !failed && hashed.matches == rows && merged.matches == rows && probed.matches == rows &&
+                   merged.checksum == hashed.checksum && probed.checksum == hashed.checksum;
+  if (!same) {
+    fprintf(stderr, "Error: the joins disagree (hash %ld, merge %ld, index %ld of %ld rows)\n", hashed.matches,
+            merged.matches, probed.matches, rows);
+  }
+  return same ? 0 : -1;
+}
+
+// Μικτο φορτιο πανω στο αρχειο του insert: reads, inserts νεων κλειδιων και
+// scans με τα ποσοστα του -m. Τρεχει τελευταιο γιατι μεγαλωνει το αρχειο
+static int bench_mixed(const Options *options, const TableSchema *schema)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Workload workload;
+  Record record;
+  char name[64];
+
+  snprintf(name, sizeof(name), "bplus_mixed_%d/%d/%d", options->workload.read_percent,
+           options->workload.insert_percent, 100 - options->workload.read_percent - options->workload.insert_percent);
+  workload_init(&workload, &options->workload, options->records, options->seed + 1, 0, 1);
+  if (bplus_open_file(BENCH_FILE, &file_desc, &metadata) == -1 || bench_begin(&run, name, options->ops) == -1) {
+    return -1;
+  }
+  long misses = 0;
+  for (long i = 0; i < options->ops; i++) {
+    const WorkloadOp op = workload_next_op(&workload);
+    if (op == WORKLOAD_INSERT) {
+      const int key = workload_key(&workload, workload_insert_index(&workload));
+      employee_record(schema, &record, key, workload_random(&workload));
+      const double start = bench_now();
+      bplus_record_insert(file_desc, metadata, &record);
+      bench_record(&run, start);
+    } else if (op == WORKLOAD_READ) {
+      const int key = workload_key(&workload, workload_next_index(&workload));
+      Record *found;
+      const double start = bench_now();
+      misses += bplus_record_find(file_desc, metadata, key, &found) != 0;
+      bench_record(&run, start);
+      free(found);
+    } else {
+      ScanState state = {options->range, 0};
+      const int lo = workload_key(&workload, workload_next_index(&workload));
+      const double start = bench_now();
+      bplus_range_scan(file_desc, metadata, lo, INT_MAX, count_up_to, &state);
+      bench_record(&run, start);
+    }
+  }
+  bplus_close_file(file_desc, metadata);
+  bench_end(&run, distribution(options), workload.records);
+  if (misses > 0) {
+    fprintf(stderr, "Error: %ld mixed reads did not find their key\n", misses);
+  }
+  return misses > 0 ? -1 : 0;
+}
+
+// Αυξουσα σειρα κλειδιων σε αδειο αρχειο: με bulk load (bplus_bulk_load.h), ή με
+// εισαγωγες μεσα απο το insert buffer, που γεμιζει τα φυλλα με τη σειρα. Το
+// bulk load μετραει και το finish, που χτιζει τα επιπεδα ευρετηριου
+static int bench_sorted_load(const Options *options, const TableSchema *schema, const int bulk)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Record record;
+  Workload workload;
+  BPlusBulkLoader *loader = NULL;
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_BULK_FILE);
+  if (bplus_create_file(schema, BENCH_BULK_FILE) == -1 ||
+      bplus_open_file(BENCH_BULK_FILE, &file_desc, &metadata) == -1) {
+    return -1;
+  }
+  if (bulk) {
+    loader = bplus_bulk_load_create(file_desc, metadata);
+  }
+  if ((bulk ? loader == NULL : bplus_insert_buffer_enable(file_desc, metadata, BULK_BUFFER_RECORDS) == -1) ||
+      bench_begin(&run, bulk ? "bplus_bulk_load" : "bplus_buffered_insert", options->records) == -1) {
+    return -1;
+  }
+  int result = 0;
+  for (long i = 0; i < options->records && result == 0; i++) {
+    employee_record(schema, &record, (int)i, workload_random(&workload));
+    const double start = bench_now();
+    if (bulk) {
+      result = bplus_bulk_load_add(loader, &record) == 0 ? 0 : -1;
+    } else {
+      bplus_record_insert(file_desc, metadata, &record);
+    }
+    bench_record(&run, start);
+  }
+  if (bulk && result == 0) {
+    result = bplus_bulk_load_finish(loader) == options->records ? 0 : -1;
+  } else if (bulk) {
+    bplus_bulk_load_abort(loader);
+  }
+  bplus_close_file(file_desc, metadata);
+  bench_end(&run, "sorted", options->records);
+  remove(BENCH_BULK_FILE);
+  return result;
+}
+
+static int count_records(const char *records, const int count, void *ctx)
+{
+  (void)records;
+  *(long *)ctx += count;
+  return 0;
+}
+
+// Φορτωση ενος CSV με options->records γραμμες: μονο το parsing (sink που δεν κανει
+// τιποτα) και μετα ολη η φορτωση σε νεο αρχειο. Το γραψιμο του CSV δεν μετραει
+static int bench_csv(const Options *options, const TableSchema *schema)
+{
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Workload workload;
+  Record record;
+  BPlusCsvOptions csv_options;
+
+  workload_init(&workload, &options->workload, options->records, options->seed, 0, 1);
+  FILE *csv = fopen(BENCH_CSV, "w");
+  if (csv == NULL) {
+    return -1;
+  }
+  fprintf(csv, "id,name,surname,city\n");
+  for (long i = 0; i < options->records; i++) {
+    employee_record(schema, &record, workload_key(&workload, workload_insert_index(&workload)),
+                    workload_random(&workload));
+    fprintf(csv, "%d,%.20s,%.20s,%.20s\n", employee_id(&record), employee_name(&record), employee_surname(&record),
+            employee_city(&record));
+  }
+  fclose(csv);
+  bplus_csv_options_default(&csv_options);
+  csv_options.header = 1;
+  csv_options.threads = options->threads;
+
+  long parsed = 0;
+  if (bench_begin(&run, "bplus_csv_parse", options->records) == -1) {
+    return -1;
+  }
+  double start = bench_now();
+  const long read = bplus_csv_read(BENCH_CSV, schema, &csv_options, count_records, &parsed);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+
+  remove(BENCH_CSV_FILE);
+  if (bplus_create_file(schema, BENCH_CSV_FILE) == -1 ||
+      bplus_open_file(BENCH_CSV_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_csv_load", options->records) == -1) {
+    return -1;
+  }
+  start = bench_now();
+  const long loaded = bplus_csv_load(BENCH_CSV, file_desc, metadata, &csv_options);
+  bplus_close_file(file_desc, metadata);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, distribution(options), options->records);
+  remove(BENCH_CSV_FILE);
+  remove(BENCH_CSV);
+
+  if (read != options->records || parsed != options->records || loaded != options->records) {
+    fprintf(stderr, "Error: the CSV load read %ld/%ld records instead of %ld\n", read, loaded, options->records);
+    return -1;
+  }
+  return 0;
+}
+
+// Heap file με options->records εγγραφες, στη μορφη του heap του Heapfolder (bplus_heap.h),
+// με τις εγγραφες πακεταρισμενες στα blocks δεδομενων
+static int write_heap(const Options *options, const TableSchema *schema, const int records_per_block)
+{
+  int file_desc;
+  BF_Block *block;
+  Record record;
+  Workload workload;
+  const RecordSerializer serialize = record_serializer(schema);
+
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_HEAP_FILE);
+  if (BF_CreateFile(BENCH_HEAP_FILE) != BF_OK || BF_OpenFile(BENCH_HEAP_FILE, &file_desc) != BF_OK) {
+    return -1;
+  }
+  BF_Block_Init(&block);
+  int result = BF_AllocateBlock(file_desc, block) == BF_OK && BF_UnpinBlock(block) == BF_OK ? 0 : -1;
+  int last_block = 0;
+  for (long i = 0; i < options->records && result == 0; i += records_per_block) {
+    if (BF_AllocateBlock(file_desc, block) != BF_OK) {
+      result = -1;
+      break;
+    }
+    char *data = BF_Block_GetData(block);
+    int *count = (int *)data;
+    for (*count = 0; *count < records_per_block && i + *count < options->records; (*count)++) {
+      employee_record(schema, &record, (int)(i + *count), workload_random(&workload));
+      serialize(schema, &record, data + sizeof(int) + (size_t)*count * schema->record_size);
+    }
+    BF_Block_SetDirty(block);
+    result = BF_UnpinBlock(block) == BF_OK ? 0 : -1;
+    last_block++;
+  }
+
+  if (result == 0 && BF_GetBlock(file_desc, 0, block) == BF_OK) {
+    const BPlusHeapHeader header = {1, last_block, (int)options->records, records_per_block};
+    memcpy(BF_Block_GetData(block), &header, sizeof(header));
+    BF_Block_SetDirty(block);
+    BF_UnpinBlock(block);
+  }
+  BF_Block_Destroy(&block);
+  return BF_CloseFile(file_desc) == BF_OK ? result : -1;
+}
+
+// Ευρετηριο στην πολη ενος heap file: μια-μια θεση με το bplus_secondary_insert, και
+// ολο μαζι με το bplus_build_index (scan, εξωτερικη ταξινομηση, φορτωση με τη σειρα)
+static int bench_index_build(const Options *options, const TableSchema *schema)
+{
+  const int records_per_block = (int)((BF_BLOCK_SIZE - sizeof(int)) / schema->record_size);
+  int attr = 0;
+  while (strcmp(schema->attributes[attr].name, BENCH_INDEX_ATTR) != 0) {
+    attr++;
+  }
+  int file_desc;
+  BPlusMeta *metadata;
+  BenchRun run;
+  Record record;
+  Workload workload;
+
+  if (write_heap(options, schema, records_per_block) == -1) {
+    return -1;
+  }
+  workload_init(&workload, &options->workload, 0, options->seed, 0, 1);
+  remove(BENCH_INDEX_FILE);
+  if (bplus_secondary_create(schema, BENCH_INDEX_ATTR, BENCH_INDEX_FILE) == -1 ||
+      bplus_open_file(BENCH_INDEX_FILE, &file_desc, &metadata) == -1 ||
+      bench_begin(&run, "bplus_index_insert", options->records) == -1) {
+    return -1;
+  }
+  // οι ιδιες εγγραφες με το write_heap, στις θεσεις τους στο heap file
+  for (long i = 0; i < options->records; i++) {
+    employee_record(schema, &record, (int)i, workload_random(&workload));
+    const int location = (int)(i / records_per_block + 1) * records_per_block + (int)(i % records_per_block);
+    const double start = bench_now();
+    bplus_secondary_insert(file_desc, metadata, &record.values[attr], location);
+    bench_record(&run, start);
+  }
+  bplus_close_file(file_desc, metadata);
+  bench_end(&run, "sorted", options->records);
+  remove(BENCH_INDEX_FILE);
+
+  int heap_desc;
+  if (BF_OpenFile(BENCH_HEAP_FILE, &heap_desc) != BF_OK || bench_begin(&run, "bplus_index_build", options->records) == -1) {
+    return -1;
+  }
+  const double start = bench_now();
+  const long indexed = bplus_build_index(heap_desc, schema, schema->record_size, BENCH_INDEX_ATTR, BENCH_INDEX_FILE,
+                                         NULL);
+  bench_record_batch(&run, start, options->records);
+  bench_end(&run, "sorted", options->records);
+  BF_CloseFile(heap_desc);
+  remove(BENCH_INDEX_FILE);
+  remove(BENCH_HEAP_FILE);
+
+  if (indexed != options->records) {
+    fprintf(stderr, "Error: the index build indexed %ld records instead of %ld\n", indexed, options->records);
+    return -1;
+  }
+  return 0;
+}
+
+int main(const int argc, char **argv)
+{
+  Options options;
+  if (parse_options(argc, argv, &options) == -1) {
+    fprintf(stderr,
+            "usage: %s [-n records] [-o ops] [-d uniform|zipfian|hotspot|sequential|latest] [-m read/insert/scan]\n"
+            "          [-b frames] [-p pool MiB] [-r range] [-t threads] [-s seed]\n",
+            argv[0]);
+    return 1;
+  }
+  if (bench_io_init(options.frames) == -1) {
+    return 1;
+  }
+
+  const TableSchema schema = employee_get_schema();
+  BF_Init(LRU);
+  if (bplus_pool_init((size_t)options.pool << 20) == -1) {
+    return 1;
+  }
+  bench_print_header();
+  const int failed = bench_generate(&options, &schema) == -1 || bench_insert(&options, &schema) == -1 ||
+                     bench_lookup(&options) == -1 || bench_lookup_pool(&options) == -1 ||
+                     bench_snapshot_lookup(&options, 0) == -1 || bench_snapshot_lookup(&options, 1) == -1 ||
+                     bench_range_scan(&options) == -1 || bench_query(&options) == -1 ||
+                     bench_join(&options, &schema) == -1 || bench_mixed(&options, &schema) == -1 ||
+                     bench_sorted_load(&options, &schema, 1) == -1 ||
+                     bench_sorted_load(&options, &schema, 0) == -1 || bench_csv(&options, &schema) == -1 ||
+                     bench_index_build(&options, &schema) == -1;
+  bplus_pool_close();
+  BF_Close();
+  remove(BENCH_FILE);
+  return failed ? 1 : 0;
+}
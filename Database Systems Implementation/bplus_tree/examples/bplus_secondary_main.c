@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "bplus_secondary.h"
+#include "record_generator.h"
+
+#define RECORDS_NUM 1000 // Number of random students to insert
+
+// Macro to handle BF library errors
+#define CALL_OR_DIE(call)     \
+{                             \
+  BF_ErrorCode code = call;   \
+  if (code != BF_OK) {        \
+    BF_PrintError(code);      \
+    exit(code);               \
+  }                           \
+}
+
+int main() {
+  const TableSchema schema = student_get_schema();
+  const int university = 3; // index of "university" in the student schema
+
+  CALL_OR_DIE(BF_Init(LRU));
+
+  // Primary B+ tree on id and secondary index on university
+  bplus_create_file(&schema, "students.db");
+  bplus_secondary_create(&schema, "university", "students_university.db");
+
+  int file_desc, index_desc;
+  BPlusMeta *info, *index_info;
+  bplus_open_file("students.db", &file_desc, &info);
+  bplus_open_file("students_university.db", &index_desc, &index_info);
+
+  // Every student goes to both files, the index points at the primary key
+  Record record;
+  srand(42);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    student_random_record(&schema, &record);
+    if (bplus_record_insert(file_desc, info, &record) != -1) {
+      bplus_secondary_insert(index_desc, index_info, &record.values[university],
+                             record_get_key(&schema, &record));
+    }
+  }
+
+  // All students at EKPA, without scanning the primary file
+  FieldValue value;
+  memset(&value, 0, sizeof(value));
+  strcpy(value.string_value, "EKPA");
+
+  int *ids;
+  const int count = bplus_secondary_find(index_desc, index_info, &value, &ids);
+  printf("Students at EKPA: %d\n", count);
+  const RecordPrinter print = record_printer(&schema);
+  for (int i = 0; i < count; i++) {
+    Record *student;
+    if (bplus_record_find(file_desc, info, ids[i], &student) == 0) {
+      print(&schema, student);
+      free(student);
+    }
+  }
+  free(ids);
+
+  bplus_close_file(index_desc, index_info);
+  bplus_close_file(file_desc, info);
+  CALL_OR_DIE(BF_Close());
+  return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef BP_BLOCK_H
+#define BP_BLOCK_H
+
+#include "bf.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Logging of page changes
+ *
+ * Functions that change the tree run as one operation of the file's
+ * write-ahead log (wal.h) between bplus_begin_op and bplus_commit_op.
+ * A page is fetched with bplus_get_block (or tracked with
+ * bplus_track_block) before it is changed, and bplus_set_dirty is called
+ * after the last change and before the page is unpinned. Outside an
+ * operation, or for a file without a log, they behave like the plain BF calls.
+ */
+
+/**
+ * @brief Starts (or nests into) a logged operation on the file.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void bplus_begin_op(int file_desc);
+
+/**
+ * @brief Ends a logged operation; the outermost call commits it together with the metadata changes.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_commit_op(int file_desc);
+
+/**
+ * @brief Remembers the current contents of a pinned page that is about to change.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param block_id Block number of the page.
+ * @param block Pinned block.
+ * @return BF_OK on success, BF_ERROR if the operation changes too many pages.
+ */
+BF_ErrorCode bplus_track_block(int file_desc, int block_id, BF_Block *block);
+
+/**
+ * @brief BF_GetBlock for a page that is about to change (also tracks it).
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param block_id Block number of the page.
+ * @param block Block handle that receives the pinned block.
+ * @return BF_OK on success, an error code otherwise.
+ */
+BF_ErrorCode bplus_get_block(int file_desc, int block_id, BF_Block *block);
+
+/**
+ * @brief BF_Block_SetDirty that also logs the changes of the page.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param block_id Block number of the page.
+ * @param block Pinned block.
+ * @return BF_OK on success, BF_ERROR if the log could not be written.
+ */
+BF_ErrorCode bplus_set_dirty(int file_desc, int block_id, BF_Block *block);
+
+/**
+ * @brief Allocates a block for a new node, reusing freed blocks first.
+ *
+ * The block is returned pinned and tracked by the current operation, its
+ * contents are undefined, the caller initializes it and unpins it.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param block Block handle that receives the pinned block.
+ * @return Block number of the allocated block, -1 on failure.
+ */
+int bplus_allocate_block(int file_desc, BPlusMeta *metadata, BF_Block *block);
+
+/**
+ * @brief Returns a block that is no longer part of the tree to the free list.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param block_id Block number to release.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_free_block(int file_desc, BPlusMeta *metadata, int block_id);
+
+#endif
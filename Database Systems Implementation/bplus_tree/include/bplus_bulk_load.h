@@ -0,0 +1,57 @@
+#ifndef BP_BULK_LOAD_H
+#define BP_BULK_LOAD_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Bottom-up bulk loading
+ *
+ * Builds the tree of an empty B+ tree file from records that arrive in
+ * ascending key order, without a single descent or split. Every leaf is
+ * filled to leaf_capacity and written once, except that the last one takes
+ * records from the one before it if it would stay under half full. When
+ * the last record is in, the index levels are built from the first key,
+ * block number and record count of the nodes below them. The nodes of
+ * each level are given equal shares of children, so every node is at
+ * least half full, and the subtree counts are exact.
+ *
+ * Every block is written in an operation of the file's log. The tree
+ * becomes visible (metadata->root_block_num) only at
+ * bplus_bulk_load_finish. If the load fails or the process crashes before
+ * that, the file stays empty and the blocks written so far are left unused.
+ * A Bloom filter of the file (bplus_filter_enable) is rebuilt at the end.
+ */
+typedef struct BPlusBulkLoader BPlusBulkLoader;
+
+/**
+ * @brief Starts a bulk load into an empty B+ tree file.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the file.
+ * @return The loader, or NULL if the file is not empty or out of memory.
+ */
+BPlusBulkLoader *bplus_bulk_load_create(int file_desc, BPlusMeta *metadata);
+
+/**
+ * @brief Appends the next record.
+ * @param loader Loader from bplus_bulk_load_create.
+ * @param record Record whose key is above the key of the previous one.
+ * @return 0 on success, 1 if the key is not above the previous one (the
+ *         record is not added), -1 on failure.
+ */
+int bplus_bulk_load_add(BPlusBulkLoader *loader, const Record *record);
+
+/**
+ * @brief Writes the last leaves, builds the index levels and frees the loader.
+ * @param loader Loader from bplus_bulk_load_create.
+ * @return Number of records loaded, -1 on failure.
+ */
+long bplus_bulk_load_finish(BPlusBulkLoader *loader);
+
+/**
+ * @brief Frees a loader without finishing the load (the file stays empty).
+ * @param loader Loader from bplus_bulk_load_create.
+ */
+void bplus_bulk_load_abort(BPlusBulkLoader *loader);
+
+#endif
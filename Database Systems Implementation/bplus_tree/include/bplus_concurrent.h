@@ -0,0 +1,78 @@
+#ifndef BP_CONCURRENT_H
+#define BP_CONCURRENT_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * @brief Handle for serving lookups and inserts on one B+ file from many threads.
+ *
+ * Uses optimistic lock coupling: every node has a version counter in an
+ * in-memory table, readers descend without taking any lock and restart if
+ * a version they depend on changed, and writers lock exclusively only the
+ * leaf they modify, or the nodes taking part in a split. Full index nodes
+ * are split eagerly on the way down, so a split never climbs more than one
+ * level. Calls into the BF layer, which is not thread safe, are serialized
+ * by a single short mutex; page contents are read and written outside it
+ * while the block is pinned.
+ *
+ * Only bplus_shared_* functions may touch the file while the handle is open.
+ *
+ * A thread that finds every frame of the BF buffer pinned by other threads
+ * waits for one to be released. Failures (a block that cannot be read, a
+ * buffer that stays full, a log write that fails) are reported as
+ * BPLUS_SHARED_ERROR, so they are never mistaken for a missing or a
+ * duplicate key.
+ */
+typedef struct BPlusSharedTree BPlusSharedTree;
+
+#define BPLUS_SHARED_ERROR -2 /* Result of a bplus_shared_* call that failed */
+
+/**
+ * @brief Wraps an open B+ tree file for concurrent use.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata returned by bplus_open_file (still owned by the caller).
+ * @return New handle, or NULL on failure.
+ */
+BPlusSharedTree *bplus_shared_open(int file_desc, BPlusMeta *metadata);
+
+/**
+ * @brief Releases the handle. The file stays open and must be closed with bplus_close_file.
+ * @param tree Handle to release.
+ */
+void bplus_shared_close(BPlusSharedTree *tree);
+
+/**
+ * @brief Thread-safe version of bplus_record_insert.
+ * @param tree Shared tree handle.
+ * @param record Record to insert.
+ * @return Block ID of inserted record on success, -1 if the key already exists,
+ *         BPLUS_SHARED_ERROR on failure.
+ */
+int bplus_shared_insert(BPlusSharedTree *tree, const Record *record);
+
+/**
+ * @brief Thread-safe version of bplus_record_find.
+ * @param tree Shared tree handle.
+ * @param key Key value to search for.
+ * @param out_record Caller-provided record that receives the match.
+ * @return 0 if found, -1 if not found, BPLUS_SHARED_ERROR on failure.
+ */
+int bplus_shared_find(BPlusSharedTree *tree, int key, Record *out_record);
+
+/**
+ * @brief Thread-safe version of bplus_record_find_by_key.
+ * @param tree Shared tree handle.
+ * @param key_record Record whose key attributes hold the key to search for.
+ * @param out_record Caller-provided record that receives the match.
+ * @return 0 if found, -1 if not found, BPLUS_SHARED_ERROR on failure.
+ */
+int bplus_shared_find_by_key(BPlusSharedTree *tree, const Record *key_record, Record *out_record);
+
+/**
+ * @brief Number of optimistic restarts so far (for tuning and benchmarks).
+ * @param tree Shared tree handle.
+ */
+long bplus_shared_restarts(const BPlusSharedTree *tree);
+
+#endif
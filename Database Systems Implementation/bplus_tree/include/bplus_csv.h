@@ -0,0 +1,83 @@
+#ifndef BP_CSV_H
+#define BP_CSV_H
+
+#include <stddef.h>
+
+#include "bplus_file_structs.h"
+#include "record.h"
+
+/**
+ * Parallel CSV loading
+ *
+ * The file is memory-mapped and split into chunks of chunk_size bytes,
+ * moved forward to line boundaries. Worker threads parse whole chunks into
+ * records in the packed layout of a TableSchema (schema_init offsets) while
+ * the calling thread hands finished chunks to a sink in file order. At most
+ * two chunks per thread are parsed ahead of the sink, so memory stays
+ * bounded and a sink that writes to disk sets the pace.
+ *
+ * Every line holds one field per attribute, in schema order, separated by
+ * the delimiter. Lines may end in "\n" or "\r\n" and empty lines are
+ * skipped. Fields may be enclosed in double quotes, with "" for a quote
+ * inside them, but may not hold line breaks. INT and FLOAT fields must be
+ * whole numbers of their type. CHAR fields longer than the attribute are
+ * cut, as in record_create. A malformed line stops the load and is
+ * reported with its line number.
+ */
+
+#define BPLUS_CSV_CHUNK_SIZE (8 << 20)  /* Default bytes per chunk */
+#define BPLUS_CSV_BUFFER_RECORDS 16384  /* Insert buffer of bplus_csv_load */
+
+/**
+ * @brief Options of a CSV load.
+ */
+typedef struct {
+    char delimiter;     /**< Field separator, ',' by default */
+    int header;         /**< 1 if the first line holds column names and is skipped */
+    int threads;        /**< Parsing threads, 0 for one per online CPU */
+    size_t chunk_size;  /**< Bytes per chunk */
+} BPlusCsvOptions;
+
+/**
+ * @brief Receives the records of one chunk, in file order.
+ * @return 0 to go on, -1 to stop the load with an error.
+ */
+typedef int (*BPlusCsvSink)(const char *records, int count, void *ctx);
+
+/**
+ * @brief Fills options with the defaults (comma, no header, all CPUs, BPLUS_CSV_CHUNK_SIZE).
+ * @param options Options to fill.
+ */
+void bplus_csv_options_default(BPlusCsvOptions *options);
+
+/**
+ * @brief Parses a CSV file in parallel and passes its records to a sink.
+ * @param path Path of the CSV file.
+ * @param schema Schema of the records.
+ * @param options Options, or NULL for the defaults.
+ * @param sink Called from the calling thread with every chunk, in file order.
+ * @param ctx Passed to sink.
+ * @return Number of records passed to the sink, -1 on failure.
+ */
+long bplus_csv_read(const char *path, const TableSchema *schema, const BPlusCsvOptions *options, BPlusCsvSink sink,
+                    void *ctx);
+
+/**
+ * @brief Loads a CSV file into a B+ tree file.
+ *
+ * Into an empty file, rows in ascending key order are bulk loaded
+ * (bplus_bulk_load.h) into full leaves. From the first row out of order, or
+ * from the start if the file is not empty, records go through an insert
+ * buffer of BPLUS_CSV_BUFFER_RECORDS, which writes them to the leaves in
+ * key order, and the buffer is flushed and removed at the end. Rows whose
+ * key is already in the file, or in an earlier row, are skipped; any other
+ * failed insert stops the load.
+ * @param path Path of the CSV file, with the columns of the file schema.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the file.
+ * @param options Options, or NULL for the defaults.
+ * @return Number of rows read, -1 on failure.
+ */
+long bplus_csv_load(const char *path, int file_desc, BPlusMeta *metadata, const BPlusCsvOptions *options);
+
+#endif
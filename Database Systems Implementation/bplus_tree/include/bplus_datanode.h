@@ -1,6 +1,136 @@
-#ifndef BP_DATANODE_H
-#define BP_DATANODE_H
-/* Στο αντίστοιχο αρχείο .h μπορείτε να δηλώσετε τις συναρτήσεις
- * και τις δομές δεδομένων που σχετίζονται με τους Κόμβους Δεδομένων.*/
-
-#endif
+#ifndef BP_DATANODE_H
+#define BP_DATANODE_H
+/* Στο αντίστοιχο αρχείο .h μπορείτε να δηλώσετε τις συναρτήσεις
+ * και τις δομές δεδομένων που σχετίζονται με τους Κόμβους Δεδομένων.*/
+
+#include "record.h"
+
+/**
+ * @brief Header of a leaf (data) node, stored at the start of its block.
+ *
+ * The rest of the block is split in two dense arrays: first the heads of
+ * the sorted keys (`capacity` ints, see bplus_key.h), then the records in
+ * the same order, packed at schema->record_size bytes each (see
+ * record_serialize). Searches only touch the head array, which stays within
+ * a few cache lines, and read a record only to break a tie between heads.
+ */
+typedef struct {
+    int is_leaf;    /**< Always 1 for data nodes */
+    int key_count;  /**< Number of records currently stored */
+    int next_block; /**< Block number of the next leaf, or -1 */
+} BPlusDataNode;
+
+/**
+ * @brief Number of records that fit in one data node block.
+ * @param schema Pointer to the table schema.
+ * @return Leaf capacity in records.
+ */
+int datanode_capacity(const TableSchema *schema);
+
+/**
+ * @brief Initializes an empty data node in the given block data.
+ * @param data Block data of the node.
+ */
+void datanode_init(char *data);
+
+/**
+ * @brief Returns the sorted array of key heads of a data node.
+ * @param data Block data of the node.
+ */
+int *datanode_heads(char *data);
+
+/**
+ * @brief Returns the packed record stored at a position of a data node.
+ * @param data Block data of the node.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param pos Position of the record.
+ * @return Pointer to the packed record inside the block.
+ */
+char *datanode_record(char *data, const TableSchema *schema, int capacity, int pos);
+
+/**
+ * @brief Builds the normalized key of the record at a position.
+ * @param data Block data of the node.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param pos Position of the record.
+ * @param key Output buffer of schema->key_size bytes.
+ */
+void datanode_key(char *data, const TableSchema *schema, int capacity, int pos, unsigned char *key);
+
+/**
+ * @brief Finds the position of the first record whose key is >= key.
+ * @param data Block data of the node.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param key Normalized key to search for.
+ * @param found Set to 1 if the record at the returned position has this key, else 0.
+ * @return Position in the node (key_count if every key is smaller).
+ */
+int datanode_search(char *data, const TableSchema *schema, int capacity, const unsigned char *key, int *found);
+
+/**
+ * @brief Inserts a record at a given position, shifting the following entries.
+ * @param data Block data of the node (must not be full).
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param pos Position of the new entry.
+ * @param record Record to insert.
+ */
+void datanode_insert_at(char *data, const TableSchema *schema, int capacity, int pos, const Record *record);
+
+/**
+ * @brief Splits a full data node while inserting a new record.
+ *
+ * The upper half of the entries moves to new_data, which must already be
+ * initialized. The caller is responsible for linking next_block.
+ * @param data Block data of the full node.
+ * @param new_data Block data of the new (right) node.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param pos Position of the new entry in the full node.
+ * @param record Record to insert.
+ * @param in_new Set to 1 if the record ended up in the new node, else 0.
+ * @param separator Receives the separator (normalized key of the first record of the new node).
+ */
+void datanode_split(char *data, char *new_data, const TableSchema *schema, int capacity,
+                    int pos, const Record *record, int *in_new, unsigned char *separator);
+
+/**
+ * @brief Removes the entry at a given position, shifting the following entries.
+ * @param data Block data of the node.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ * @param pos Position of the entry to remove.
+ */
+void datanode_remove_at(char *data, const TableSchema *schema, int capacity, int pos);
+
+/**
+ * @brief Moves the last entry of the left sibling to the front of a node.
+ * @param data Block data of the node that borrows.
+ * @param left_data Block data of its left sibling.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ */
+void datanode_borrow_left(char *data, char *left_data, const TableSchema *schema, int capacity);
+
+/**
+ * @brief Moves the first entry of the right sibling to the end of a node.
+ * @param data Block data of the node that borrows.
+ * @param right_data Block data of its right sibling.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ */
+void datanode_borrow_right(char *data, char *right_data, const TableSchema *schema, int capacity);
+
+/**
+ * @brief Appends all entries of a node to its left sibling and unlinks it.
+ * @param left_data Block data of the node that is kept.
+ * @param right_data Block data of the node that is emptied.
+ * @param schema Pointer to the table schema.
+ * @param capacity Leaf capacity of the file.
+ */
+void datanode_merge(char *left_data, char *right_data, const TableSchema *schema, int capacity);
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef BP_EXEC_H
+#define BP_EXEC_H
+
+#include "bplus_file_structs.h"
+#include "record.h"
+
+/**
+ * Vectorized execution
+ *
+ * Operators are pulled with exec_next and hand back column batches of up to
+ * EXEC_BATCH_SIZE rows, so the per-record cost is a few array accesses
+ * instead of a function call and a Record copy.
+ *
+ * Every column of a batch is a dense array, typed by the attribute of the
+ * batch schema:
+ * - TYPE_INT columns are int[].
+ * - TYPE_FLOAT columns are float[].
+ * - TYPE_CHAR(n) columns hold n bytes per row, as stored on the page. The
+ *   value ends at the first NUL or after n bytes, and bytes after the NUL
+ *   may be garbage in heap files.
+ * Filters do not move values. They leave a selection vector with the
+ * positions of the rows that passed, and the rest of the plan only reads
+ * those rows.
+ *
+ * A batch belongs to the operator that returned it and stays valid until
+ * that operator's next exec_next or exec_close.
+ *
+ * Scans read the pages directly and copy each column in one loop per page:
+ * - exec_bplus_scan walks the leaf list of a B+ tree file.
+ * - exec_heap_scan walks the data blocks of a heap file of the heap file
+ *   project (../Heapfolder), laid out as in bplus_heap.h.
+ */
+
+#define EXEC_BATCH_SIZE 1024
+
+/**
+ * @brief A batch of rows, stored by column.
+ */
+typedef struct {
+    const TableSchema *schema;        /**< Types of the columns */
+    int count;                        /**< Rows stored in the columns */
+    int selected;                     /**< Live rows */
+    const unsigned short *selection;  /**< Positions of the live rows, or NULL if rows 0..count-1 are all live */
+    char *columns[MAX_ATTRIBUTES];    /**< One array per attribute of the schema */
+} ExecBatch;
+
+/**
+ * @brief Comparisons of exec_filter.
+ */
+typedef enum {
+    EXEC_EQ,
+    EXEC_NE,
+    EXEC_LT,
+    EXEC_LE,
+    EXEC_GT,
+    EXEC_GE
+} ExecCompare;
+
+/**
+ * @brief Aggregate functions of exec_aggregate.
+ */
+typedef enum {
+    EXEC_COUNT,  /**< Live rows (the column is ignored) */
+    EXEC_SUM,
+    EXEC_MIN,
+    EXEC_MAX,
+    EXEC_AVG
+} ExecFunction;
+
+/**
+ * @brief One aggregate of exec_aggregate.
+ */
+typedef struct {
+    ExecFunction function;  /**< Function */
+    int column;             /**< Input column, INT or FLOAT */
+} ExecAggregateSpec;
+
+typedef struct ExecOperator ExecOperator;
+
+/**
+ * @brief Common part of every operator.
+ */
+struct ExecOperator {
+    int (*next)(ExecOperator *self, ExecBatch **batch);  /**< See exec_next */
+    void (*close)(ExecOperator *self);                  /**< Frees the operator and its input */
+    TableSchema schema;                                 /**< Schema of the batches it returns */
+};
+
+/**
+ * @brief Scans every record of a B+ tree file in key order.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the file.
+ * @return The operator, or NULL on failure.
+ */
+ExecOperator *exec_bplus_scan(int file_desc, const BPlusMeta *metadata);
+
+/**
+ * @brief Scans every record of a heap file.
+ * @param file_desc BF file descriptor of the heap file (closed by its owner, so its header is written).
+ * @param schema Schema of the records (packed offsets, see schema_init).
+ * @param record_stride Bytes from one record of a block to the next (sizeof the heap Record).
+ * @return The operator, or NULL on failure.
+ */
+ExecOperator *exec_heap_scan(int file_desc, const TableSchema *schema, int record_stride);
+
+/**
+ * @brief Keeps the rows whose column compares true against a constant.
+ * @param child Input operator (owned from now on).
+ * @param column Column of the input to compare.
+ * @param compare Comparison.
+ * @param value Constant: int_value, float_value or string_value by the column type.
+ * @return The operator, or NULL on failure (the input is closed).
+ */
+ExecOperator *exec_filter(ExecOperator *child, int column, ExecCompare compare, const FieldValue *value);
+
+/**
+ * @brief Keeps some of the columns, in a given order. No values are copied.
+ * @param child Input operator (owned from now on).
+ * @param columns Input columns of the output.
+ * @param count Number of output columns.
+ * @return The operator, or NULL on failure (the input is closed).
+ */
+ExecOperator *exec_project(ExecOperator *child, const int *columns, int count);
+
+/**
+ * @brief Stops after a number of rows.
+ * @param child Input operator (owned from now on).
+ * @param limit Rows to return.
+ * @return The operator, or NULL on failure (the input is closed).
+ */
+ExecOperator *exec_limit(ExecOperator *child, long limit);
+
+/**
+ * @brief Aggregates all input rows into one row.
+ *
+ * The output has one column per aggregate. COUNT is INT. SUM and AVG are
+ * FLOAT. MIN and MAX keep the type of their input. Every result is also
+ * kept exactly as a double (see exec_aggregate_value). Over no rows, MIN,
+ * MAX and AVG are 0.
+ * @param child Input operator (owned from now on).
+ * @param specs Aggregates.
+ * @param count Number of aggregates (at most MAX_ATTRIBUTES).
+ * @return The operator, or NULL on failure (the input is closed).
+ */
+ExecOperator *exec_aggregate(ExecOperator *child, const ExecAggregateSpec *specs, int count);
+
+/**
+ * @brief Returns an aggregate result at full precision, after the output row has been pulled.
+ * @param aggregate Operator made by exec_aggregate.
+ * @param index Aggregate index.
+ */
+double exec_aggregate_value(const ExecOperator *aggregate, int index);
+
+/**
+ * @brief Pulls the next batch.
+ * @param op Operator.
+ * @param batch Receives the batch (at least one live row).
+ * @return Live rows of the batch, 0 at the end, -1 on error.
+ */
+int exec_next(ExecOperator *op, ExecBatch **batch);
+
+/**
+ * @brief Frees an operator together with all its inputs.
+ * @param op Operator, or NULL.
+ */
+void exec_close(ExecOperator *op);
+
+#endif
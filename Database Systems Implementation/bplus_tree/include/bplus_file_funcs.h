@@ -1,57 +1,268 @@
-#ifndef BP_FILE_H
-#define BP_FILE_H
-
-#include "record.h"
-#include "bplus_file_structs.h"
-#include "record_generator.h"
-#include "bplus_index_node.h"
-#include "bplus_datanode.h"
-#include "bf.h"
-
-/**
- * @brief Creates a new empty B+ tree file with the given schema.
- * @param schema Pointer to the TableSchema describing the table.
- * @param fileName Name of the file to create.
- * @return 0 on success, -1 on failure.
- */
-int bplus_create_file(const TableSchema *schema, const char *fileName);
-
-/**
- * @brief Opens a B+ tree file and loads its metadata.
- * @param fileName Name of the file to open.
- * @param file_desc Pointer to store the file descriptor.
- * @param metadata Pointer to store the metadata structure (allocated by the function).
- * @return 0 on success, -1 on failure.
- */
-int bplus_open_file(const char *fileName, int *file_desc, BPlusMeta **metadata);
-
-
-/**
- * @brief Closes a B+ tree file and frees its metadata.
- * @param file_desc File descriptor of the B+ tree file.
- * @param metadata Pointer to the BPlusMeta structure to free.
- * @return 0 on success, -1 on failure.
- */
-int bplus_close_file(int file_desc, BPlusMeta* metadata);
-
-
-/**
- * @brief Inserts a record into the B+ tree.
- * @param file_desc File descriptor of the B+ tree file.
- * @param metadata Pointer to the BPlusMeta structure of the tree.
- * @param record Record to insert.
- * @return Block ID of inserted record on success, -1 on failure.
- */
-int bplus_record_insert(int file_desc, BPlusMeta* metadata, const Record *record);
-
-/**
- * @brief Finds a record in the B+ tree by key.
- * @param file_desc File descriptor of the B+ tree file.
- * @param metadata Pointer to the BPlusMeta structure of the tree.
- * @param key Key value to search for.
- * @param out_record Pointer to store the found record (or NULL if not found).
- * @return 0 if found, -1 if not found.
- */
-int bplus_record_find(int file_desc, const BPlusMeta *metadata, int key, Record** out_record);
-
-#endif 
+#ifndef BP_FILE_H
+#define BP_FILE_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+#include "record_generator.h"
+#include "bplus_index_node.h"
+#include "bplus_datanode.h"
+#include "bf.h"
+#include "bplus_filter.h"
+
+/**
+ * @brief Creates a new empty B+ tree file with the given schema.
+ * @param schema Pointer to the TableSchema describing the table.
+ * @param fileName Name of the file to create.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_create_file(const TableSchema *schema, const char *fileName);
+
+/**
+ * @brief Opens a B+ tree file and loads its metadata.
+ * @param fileName Name of the file to open.
+ * @param file_desc Pointer to store the file descriptor.
+ * @param metadata Pointer to store the metadata structure (allocated by the function).
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_open_file(const char *fileName, int *file_desc, BPlusMeta **metadata);
+
+
+/**
+ * @brief Closes a B+ tree file and frees its metadata.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure to free.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_close_file(int file_desc, BPlusMeta* metadata);
+
+/**
+ * @brief Gives the file an in-memory insert buffer, or removes it.
+ *
+ * Inserts then go to the buffer, which is flushed to the leaves in key
+ * order whenever it fills up, on bplus_sync and on bplus_close_file. Finds,
+ * updates and deletes see buffered records. Whether a buffered key already
+ * exists in the tree is decided lazily, so such an insert returns 0 and the
+ * record is dropped later and counted in BPlusInsertBuffer::duplicates.
+ * The buffer is for single threaded use; bplus_shared_open flushes it.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param max_records Most records to buffer; 0 flushes and removes the buffer.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_insert_buffer_enable(int file_desc, BPlusMeta *metadata, int max_records);
+
+/**
+ * @brief Moves every buffered record into the tree.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @return Number of buffered records dropped as duplicates, -1 on failure.
+ */
+int bplus_insert_buffer_flush(int file_desc);
+
+/**
+ * @brief Gives the file an in-memory Bloom filter over its keys, or removes it.
+ *
+ * The filter is built by one pass over the leaves and kept up to date by
+ * every insert, so a find for a key that is not in the tree usually returns
+ * -1 without reading any block. Deleted keys stay in the filter until it is
+ * rebuilt, which happens on its own once they (or new keys beyond the size
+ * it was built for) make up too large a part of it. Enable it before
+ * bplus_shared_open; shared handles use it but never rebuild it.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param bits_per_key Filter bits per key (BPLUS_FILTER_BITS_PER_KEY gives
+ *        about 1% false positives); 0 removes the filter.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_filter_enable(int file_desc, const BPlusMeta *metadata, int bits_per_key);
+
+/**
+ * @brief Waits until every operation committed so far is durable.
+ *
+ * Every insert, update and delete is logged to "<fileName>.wal" before its
+ * pages can reach the file, and a file that was not closed cleanly is
+ * recovered by bplus_open_file. Commits become durable in groups, at most
+ * WAL_GROUP_COMMIT_USEC after they return, unless synchronous commits are on.
+ * Recovery covers crashes of the process, not power loss (see wal.h).
+ * Records waiting in the insert buffer are flushed first.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_sync(int file_desc);
+
+/**
+ * @brief Chooses whether each operation waits until its commit is durable.
+ *
+ * Operations of different threads (bplus_shared_*) that wait together
+ * share one fsync of the log.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param synchronous 1 to wait, 0 (the default) to return right after the commit is logged.
+ */
+void bplus_set_synchronous_commit(int file_desc, int synchronous);
+
+
+/**
+ * @brief Inserts a record into the B+ tree.
+ *
+ * If the file has an insert buffer the record is only buffered; a key that
+ * is already in the tree is then dropped when the buffer is flushed
+ * (see bplus_insert_buffer_enable).
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param record Record to insert.
+ * @return Block ID of inserted record on success, 0 if it was buffered, -1 on failure.
+ */
+int bplus_record_insert(int file_desc, BPlusMeta* metadata, const Record *record);
+
+/**
+ * @brief Finds a record in the B+ tree by an INT key.
+ *
+ * Only for tables whose key is a single INT attribute; other keys are
+ * looked up with bplus_record_find_by_key.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param key Key value to search for.
+ * @param out_record Pointer to store the found record (or NULL if not found).
+ * @return 0 if found, -1 if not found.
+ */
+int bplus_record_find(int file_desc, const BPlusMeta *metadata, int key, Record** out_record);
+
+/**
+ * @brief Finds a record in the B+ tree by a key of any type.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param key_record Record whose key attributes hold the key to search for.
+ * @param out_record Pointer to store the found record (or NULL if not found).
+ * @return 0 if found, -1 if not found.
+ */
+int bplus_record_find_by_key(int file_desc, const BPlusMeta *metadata, const Record *key_record,
+                             Record **out_record);
+
+/**
+ * @brief Finds many records by INT key with one pass over the tree.
+ *
+ * The keys are visited in sorted order and each one restarts the descent
+ * from the deepest node of the previous path that still covers it, so keys
+ * in the same leaf cost one read of that leaf and neighbouring leaves only
+ * revisit their common parent. The keys may be in any order and repeat.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param keys Key values to search for.
+ * @param n Number of keys.
+ * @param out Array of n records; out[i] receives the record of keys[i] if found.
+ * @param found Array of n flags; found[i] is set to 1 if keys[i] was found, else 0.
+ * @return Number of keys found, -1 on failure.
+ */
+int bplus_record_find_many(int file_desc, const BPlusMeta *metadata, const int *keys, int n,
+                           Record *out, int *found);
+
+/**
+ * @brief Like bplus_record_find_many, for keys of any type.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param key_records Array of n records whose key attributes hold the keys.
+ * @param n Number of keys.
+ * @param out Array of n records; out[i] receives the record of key_records[i] if found.
+ * @param found Array of n flags; found[i] is set to 1 if the key was found, else 0.
+ * @return Number of keys found, -1 on failure.
+ */
+int bplus_record_find_many_by_key(int file_desc, const BPlusMeta *metadata, const Record *key_records, int n,
+                                  Record *out, int *found);
+
+/**
+ * @brief Counts the records with lo <= key <= hi, for a single INT key.
+ *
+ * Index nodes keep the record count of every child subtree, so the answer
+ * comes from two root-to-leaf descents, whatever the size of the range.
+ * Buffered inserts are flushed first, and the counts are rebuilt once after
+ * a bplus_shared_open session, whose writers do not maintain them.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param lo Smallest key of the range.
+ * @param hi Largest key of the range.
+ * @return Number of records in the range (0 if lo > hi), -1 on failure.
+ */
+int bplus_count_range(int file_desc, BPlusMeta *metadata, int lo, int hi);
+
+/**
+ * @brief Like bplus_count_range, for keys of any type.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param lo_record Record whose key attributes hold the smallest key of the range.
+ * @param hi_record Record whose key attributes hold the largest key of the range.
+ * @return Number of records in the range (0 if lo > hi), -1 on failure.
+ */
+int bplus_count_range_by_key(int file_desc, BPlusMeta *metadata, const Record *lo_record,
+                             const Record *hi_record);
+
+/**
+ * @brief Visits the records with lo <= key <= hi in key order, for a single INT key.
+ *
+ * One descent finds the first leaf, then the scan follows the leaf chain.
+ * Buffered inserts are flushed first. The leaf being read stays pinned
+ * while visit runs, so visit must not call functions on the same file.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param lo Smallest key of the range.
+ * @param hi Largest key of the range.
+ * @param visit Called with each record and ctx; a non-zero return stops the scan.
+ * @param ctx Passed to visit.
+ * @return Number of records visited, -1 on failure.
+ */
+int bplus_range_scan(int file_desc, const BPlusMeta *metadata, int lo, int hi,
+                     int (*visit)(const Record *record, void *ctx), void *ctx);
+
+/**
+ * @brief Like bplus_range_scan, for keys of any type.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param lo_record Record whose key attributes hold the smallest key of the range.
+ * @param hi_record Record whose key attributes hold the largest key of the range.
+ * @param visit Called with each record and ctx; a non-zero return stops the scan.
+ * @param ctx Passed to visit.
+ * @return Number of records visited, -1 on failure.
+ */
+int bplus_range_scan_by_key(int file_desc, const BPlusMeta *metadata, const Record *lo_record,
+                            const Record *hi_record, int (*visit)(const Record *record, void *ctx), void *ctx);
+
+/**
+ * @brief Finds the record with the k-th smallest key with one descent.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param k Rank of the record, 1 for the smallest key.
+ * @param out_record Receives the record.
+ * @return 0 on success, -1 if the tree has fewer than k records or on failure.
+ */
+int bplus_select_kth(int file_desc, BPlusMeta *metadata, int k, Record *out_record);
+
+/**
+ * @brief Overwrites the stored record that has the same key as record.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param record New contents of the record (its key selects the record).
+ * @return Block ID of the updated record on success, -1 if the key was not found or on failure.
+ */
+int bplus_record_update(int file_desc, const BPlusMeta *metadata, const Record *record);
+
+/**
+ * @brief Deletes the record with the given key from the B+ tree.
+ *
+ * Underfull nodes borrow from a sibling or are merged with it, separators
+ * in the index nodes are updated accordingly and the root collapses when
+ * it is left with a single child. Freed blocks are reused by later inserts.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param key Key of the record to delete (the key must be a single INT attribute).
+ * @return 0 on success, -1 if the key was not found or on failure.
+ */
+int bplus_record_delete(int file_desc, BPlusMeta *metadata, int key);
+
+/**
+ * @brief Deletes the record with the key of key_record, for keys of any type.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param key_record Record whose key attributes hold the key to delete.
+ * @return 0 on success, -1 if the key was not found or on failure.
+ */
+int bplus_record_delete_by_key(int file_desc, BPlusMeta *metadata, const Record *key_record);
+
+#endif 
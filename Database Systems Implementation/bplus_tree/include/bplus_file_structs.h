@@ -1,17 +1,47 @@
-//
-// Created by theofilos on 11/4/25.
-//
-
-#ifndef BPLUS_BPLUS_FILE_STRUCTS_H
-#define BPLUS_BPLUS_FILE_STRUCTS_H
-#include "bf.h"
-#include "bplus_datanode.h"
-#include "bplus_index_node.h"
-#include "record.h"
-#include "bplus_file_structs.h"
-
-typedef struct {
-} BPlusMeta;
-
-#endif //BPLUS_BPLUS_FILE_STRUCTS_H
-
+//
+// Created by theofilos on 11/4/25.
+//
+
+#ifndef BPLUS_BPLUS_FILE_STRUCTS_H
+#define BPLUS_BPLUS_FILE_STRUCTS_H
+#include "bf.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "record.h"
+#include "bplus_file_structs.h"
+
+#define BPLUS_MAX_DEPTH 32 // αρκετό για οποιοδήποτε αρχείο χωράει στο BF
+
+#define BPLUS_FREE_BLOCK -1 // τιμή του is_leaf σε block που έχει ελευθερωθεί
+
+// Block που ελευθερώθηκε από διαγραφή και περιμένει στη λίστα free_block_head
+typedef struct {
+    int is_leaf;    // πάντα BPLUS_FREE_BLOCK
+    int next_free;  // επόμενο ελεύθερο block ή -1
+} BPlusFreeBlock;
+
+#define BPLUS_POSTING_BLOCK -2 // τιμή του is_leaf σε σελίδα posting list (bplus_secondary.h)
+
+// Σελίδα υπερχείλισης posting list: ακολουθούν bytes_used bytes με τις θέσεις
+// εγγραφών σε αύξουσα σειρά, η πρώτη ολόκληρη και οι επόμενες ως διαφορές (varint)
+typedef struct {
+    int is_leaf;     // πάντα BPLUS_POSTING_BLOCK
+    int next_block;  // επόμενη σελίδα της ίδιας λίστας ή -1
+    int count;       // πόσες θέσεις έχει η σελίδα
+    int bytes_used;  // πόσα bytes πιάνουν κωδικοποιημένες
+    int last_value;  // η μεγαλύτερη θέση της σελίδας, για να προσπερνάμε σελίδες χωρίς αποκωδικοποίηση
+} BPlusPostingPage;
+
+typedef struct {
+    int root_block_num;       // block της ρίζας (-1 για άδειο δέντρο)
+    int depth;                // επίπεδα του δέντρου (1 = μόνο ένα φύλλο)
+    int data_block_count;     // πόσα φύλλα έχουμε
+    int index_block_count;    // πόσοι κόμβοι ευρετηρίου
+    int leaf_capacity;        // εγγραφές ανά φύλλο
+    int index_capacity;       // κλειδιά ανά κόμβο ευρετηρίου
+    int free_block_head;      // πρώτο ελεύθερο block για επαναχρησιμοποίηση (-1 αν δεν υπάρχει)
+    int counts_stale;         // 1 αν τα πλήθη των κόμβων ευρετηρίου πρέπει να ξαναμετρηθούν
+    TableSchema table_schema;
+} BPlusMeta;
+
+#endif //BPLUS_BPLUS_FILE_STRUCTS_H
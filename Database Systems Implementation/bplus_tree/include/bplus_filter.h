@@ -0,0 +1,67 @@
+#ifndef BP_FILTER_H
+#define BP_FILTER_H
+
+#include <stdint.h>
+
+/**
+ * Key filter
+ *
+ * An in-memory blocked Bloom filter over the keys of one B+ tree file. Each
+ * key sets BPLUS_FILTER_PROBES bits inside a single 64-byte block, so a
+ * lookup costs one cache line, and a key the filter rejects is certainly not
+ * in the tree: the search returns without reading any page. Deleted keys
+ * keep their bits until the filter is rebuilt, which only costs false
+ * positives. Enable it with bplus_filter_enable (bplus_file_funcs.h).
+ */
+
+#define BPLUS_FILTER_BITS_PER_KEY 10 /* Default size, about 1% false positives */
+#define BPLUS_FILTER_PROBES 8        /* Bits set per key, one in each word of its block */
+
+typedef struct {
+    uint64_t *words;   /**< block_count blocks of 8 words */
+    uint32_t block_mask; /**< block_count - 1 (a power of two) */
+    int key_size;      /**< Bytes of the normalized keys */
+    int bits_per_key;  /**< Size the filter was asked for */
+    int capacity;      /**< Keys the filter was sized for */
+    long keys;         /**< Keys added since the last build */
+    long stale;        /**< Keys deleted since the last build */
+} BPlusFilter;
+
+/**
+ * @brief Creates an empty filter and registers it for a file.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param key_size Bytes of the normalized keys.
+ * @param capacity Keys to size the filter for.
+ * @param bits_per_key Bits per key (BPLUS_FILTER_BITS_PER_KEY unless tuning).
+ * @return New filter, or NULL on failure or if the file already has one.
+ */
+BPlusFilter *filter_create(int file_desc, int key_size, int capacity, int bits_per_key);
+
+/**
+ * @brief Returns the filter of a file, or NULL if it has none.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+BPlusFilter *filter_of(int file_desc);
+
+/**
+ * @brief Unregisters and frees the filter of a file.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void filter_destroy(int file_desc);
+
+/**
+ * @brief Adds a key. Safe to call from many threads at once.
+ * @param filter Key filter.
+ * @param key Normalized key.
+ */
+void filter_add(BPlusFilter *filter, const unsigned char *key);
+
+/**
+ * @brief Checks whether a key may be in the tree.
+ * @param filter Key filter.
+ * @param key Normalized key.
+ * @return 0 if the key is certainly absent, 1 if it may be present.
+ */
+int filter_may_contain(const BPlusFilter *filter, const unsigned char *key);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef BP_HEAP_H
+#define BP_HEAP_H
+
+/**
+ * Heap files
+ *
+ * The layout of the heap files of the heap file project (../Heapfolder,
+ * hp_file_structs.h), as read by exec_heap_scan and bplus_build_index.
+ * Block 0 starts with a BPlusHeapHeader, the same four ints as
+ * HeapFileHeader, and every data block 1..last_data_block is an int record
+ * count followed by the records at a fixed stride (sizeof the heap
+ * Record). The header is written when the heap file is closed.
+ */
+
+/**
+ * @brief Header of a heap file, in block 0.
+ */
+typedef struct {
+    int is_heap_file;       /**< 1 for a heap file */
+    int last_data_block;    /**< Last block that holds records, 0 if none */
+    int total_records;      /**< Records in the file */
+    int records_per_block;  /**< Records a data block holds */
+} BPlusHeapHeader;
+
+/**
+ * @brief Reads the header of a heap file.
+ * @param file_desc BF file descriptor of the heap file.
+ * @param header Receives the header.
+ * @return 0 on success, -1 on failure or if the file is not a heap file.
+ */
+int bplus_heap_header(int file_desc, BPlusHeapHeader *header);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BP_INDEX_BUILD_H
+#define BP_INDEX_BUILD_H
+
+#include <stddef.h>
+
+#include "record.h"
+
+/**
+ * Index builds from heap files
+ *
+ * bplus_build_index creates a secondary index (bplus_secondary.h) on one
+ * attribute of an existing heap file, with the locations
+ * block * records_per_block + slot. It never inserts one record at a time:
+ *
+ * 1. The calling thread scans the data blocks and turns every record into
+ *    a (normalized key, location) pair in one of two sort buffers. When a
+ *    buffer is full it goes to a sort thread, which sorts it and writes it
+ *    to a temporary run file while the scan fills the other buffer.
+ * 2. The runs and the last buffer (sorted but kept in memory) are merged
+ *    k ways. If there are more runs than the memory allows to read at
+ *    once, groups of them are first merged into longer runs.
+ * 3. The merged pairs arrive in (value, location) order and go to a
+ *    BPlusSecondaryLoader, which writes every posting page once and bulk
+ *    loads the directory entries (bplus_bulk_load.h).
+ *
+ * Only the calling thread uses BF, so the usual single threaded rules of
+ * the buffer manager hold. The memory budget covers the sort buffers and
+ * the read buffers of the merge; the BF frames are not counted.
+ */
+
+#define BPLUS_BUILD_MEMORY (64 << 20)      /* Default memory budget in bytes */
+#define BPLUS_BUILD_PROGRESS_PAIRS (1 << 20) /* Pairs between progress reports */
+
+/**
+ * @brief Phase of an index build.
+ */
+typedef enum {
+    BPLUS_BUILD_SCAN,   /**< Scanning the heap and writing sorted runs */
+    BPLUS_BUILD_MERGE,  /**< Merging runs into longer runs */
+    BPLUS_BUILD_LOAD    /**< Merging the last runs into the index */
+} BPlusBuildPhase;
+
+/**
+ * @brief Progress of an index build, as passed to the progress callback.
+ */
+typedef struct {
+    BPlusBuildPhase phase;
+    long done;   /**< Records scanned (SCAN) or pairs merged (MERGE, LOAD) */
+    long total;  /**< Records in the heap file */
+    int runs;    /**< Sorted runs on disk */
+} BPlusBuildProgress;
+
+/**
+ * @brief Called from the calling thread at every phase change and every BPLUS_BUILD_PROGRESS_PAIRS pairs.
+ */
+typedef void (*BPlusBuildProgressFn)(const BPlusBuildProgress *progress, void *ctx);
+
+/**
+ * @brief Options of an index build.
+ */
+typedef struct {
+    size_t memory;                 /**< Memory budget in bytes */
+    const char *temp_dir;          /**< Directory of the run files, NULL for tmpfile() */
+    BPlusBuildProgressFn progress; /**< Progress callback, or NULL */
+    void *progress_ctx;            /**< Passed to progress */
+} BPlusBuildOptions;
+
+/**
+ * @brief Fills options with the defaults (BPLUS_BUILD_MEMORY, tmpfile(), no progress).
+ * @param options Options to fill.
+ */
+void bplus_build_options_default(BPlusBuildOptions *options);
+
+/**
+ * @brief Builds a secondary index on one attribute of a heap file.
+ * @param heap_desc BF file descriptor of the heap file (bplus_heap.h; its header must be on disk).
+ * @param heap_schema Schema of the heap records, as for exec_heap_scan.
+ * @param record_stride Bytes from one record of a block to the next (sizeof the heap Record).
+ * @param attr_name Name of the indexed attribute.
+ * @param index_file Name of the index file, which must not exist yet.
+ * @param options Options, or NULL for the defaults.
+ * @return Number of records indexed, -1 on failure (the index file is then removed).
+ */
+long bplus_build_index(int heap_desc, const TableSchema *heap_schema, int record_stride, const char *attr_name,
+                       const char *index_file, const BPlusBuildOptions *options);
+
+#endif
@@ -1,6 +1,196 @@
-#ifndef BP_INDEX_NODE_H
-#define BP_INDEX_NODE_H
-/* Στο αντίστοιχο αρχείο .h μπορείτε να δηλώσετε τις συναρτήσεις
- * και τις δομές δεδομένων που σχετίζονται με τους Κόμβους Δεδομένων.*/
-
-#endif
\ No newline at end of file
+#ifndef BP_INDEX_NODE_H
+#define BP_INDEX_NODE_H
+/* Στο αντίστοιχο αρχείο .h μπορείτε να δηλώσετε τις συναρτήσεις
+ * και τις δομές δεδομένων που σχετίζονται με τους Κόμβους Δεδομένων.*/
+
+/**
+ * @brief Header of an index node, stored at the start of its block.
+ *
+ * It is followed by the heads of the sorted separator keys (`capacity`
+ * ints, see bplus_key.h), then by the `capacity + 1` child block numbers,
+ * the `capacity + 1` record counts of the child subtrees and finally by the
+ * remaining `key_size - 4` bytes of every separator, which INT keys do not
+ * have. Child i holds the keys k with keys[i-1] <= k < keys[i]. The counts
+ * make the tree an order statistic tree (bplus_count_range,
+ * bplus_select_kth); every function below moves them together with their
+ * children, the callers keep them up to date for records that come and go.
+ */
+typedef struct {
+    int is_leaf;   /**< Always 0 for index nodes */
+    int key_count; /**< Number of separator keys */
+} BPlusIndexNode;
+
+/**
+ * @brief Number of separator keys that fit in one index node block.
+ * @param key_size Size of the normalized key (schema->key_size).
+ */
+int indexnode_capacity(int key_size);
+
+/**
+ * @brief Initializes an index node with a single child and no keys.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param first_child Block number of the leftmost child.
+ */
+void indexnode_init(char *data, int capacity, int first_child);
+
+/**
+ * @brief Returns the sorted array of separator heads of an index node.
+ * @param data Block data of the node.
+ */
+int *indexnode_heads(char *data);
+
+/**
+ * @brief Returns the child array of an index node.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ */
+int *indexnode_children(char *data, int capacity);
+
+/**
+ * @brief Returns the array with the record count of each child subtree.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ */
+int *indexnode_counts(char *data, int capacity);
+
+/**
+ * @brief Returns the number of records under an index node (sum of its counts).
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ */
+long indexnode_total(char *data, int capacity);
+
+/**
+ * @brief Copies the full normalized separator at a position.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param pos Position of the separator.
+ * @param key Output buffer of key_size bytes.
+ */
+void indexnode_key(char *data, int capacity, int key_size, int pos, unsigned char *key);
+
+/**
+ * @brief Overwrites the separator at a position.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param pos Position of the separator.
+ * @param key New normalized separator.
+ */
+void indexnode_set_key(char *data, int capacity, int key_size, int pos, const unsigned char *key);
+
+/**
+ * @brief Finds the slot of the child that may contain the given key.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param key Normalized key to route.
+ * @return Index in the child array (also the number of separators <= key).
+ */
+int indexnode_child_slot(char *data, int capacity, int key_size, const unsigned char *key);
+
+/**
+ * @brief Finds the child that may contain the given key.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param key Normalized key to route.
+ * @return Block number of the child.
+ */
+int indexnode_child(char *data, int capacity, int key_size, const unsigned char *key);
+
+/**
+ * @brief Inserts a separator and its right child at the given position.
+ * @param data Block data of the node (must not be full).
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param pos Position of the new key.
+ * @param key Normalized separator.
+ * @param right_child Child placed right after the new key.
+ * @param right_count Records in the subtree of right_child.
+ */
+void indexnode_insert_at(char *data, int capacity, int key_size, int pos, const unsigned char *key,
+                         int right_child, int right_count);
+
+/**
+ * @brief Splits a full index node while inserting a new separator.
+ * @param data Block data of the full node.
+ * @param new_data Block data of the new (right) node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param pos Position of the new key in the full node.
+ * @param key Normalized separator.
+ * @param right_child Child placed right after the new key.
+ * @param right_count Records in the subtree of right_child.
+ * @param up_key Receives the middle key, which moves up to the parent.
+ */
+void indexnode_split(char *data, char *new_data, int capacity, int key_size, int pos,
+                     const unsigned char *key, int right_child, int right_count, unsigned char *up_key);
+
+/**
+ * @brief Splits a full index node in two halves without inserting anything.
+ *
+ * Used when full nodes are split eagerly on the way down, so that the
+ * parent of any node that later splits is known to have room.
+ * @param data Block data of the full node.
+ * @param new_data Block data of the new (right) node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param up_key Receives the middle key, which moves up to the parent.
+ */
+void indexnode_split_half(char *data, char *new_data, int capacity, int key_size, unsigned char *up_key);
+
+/**
+ * @brief Removes the separator at pos together with the child right after it.
+ * @param data Block data of the node.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param pos Position of the key to remove.
+ */
+void indexnode_remove_at(char *data, int capacity, int key_size, int pos);
+
+/**
+ * @brief Rotates the last child of the left sibling into the front of a node.
+ *
+ * The parent separator moves down and the last key of the sibling replaces it;
+ * the counts of the two nodes in the parent follow the moved child.
+ * @param data Block data of the node that borrows.
+ * @param left_data Block data of its left sibling.
+ * @param parent_data Block data of the common parent.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param sep_pos Position of the parent separator between the two nodes.
+ */
+void indexnode_borrow_left(char *data, char *left_data, char *parent_data, int capacity, int key_size,
+                           int sep_pos);
+
+/**
+ * @brief Rotates the first child of the right sibling into the end of a node.
+ * @param data Block data of the node that borrows.
+ * @param right_data Block data of its right sibling.
+ * @param parent_data Block data of the common parent.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param sep_pos Position of the parent separator between the two nodes.
+ */
+void indexnode_borrow_right(char *data, char *right_data, char *parent_data, int capacity, int key_size,
+                            int sep_pos);
+
+/**
+ * @brief Merges a node into its left sibling, pulling down the parent separator.
+ *
+ * The separator and the pointer to the right node are removed from the parent,
+ * whose count for the left node takes over the records of the right one.
+ * @param left_data Block data of the node that is kept.
+ * @param right_data Block data of the node that is emptied.
+ * @param parent_data Block data of the common parent.
+ * @param capacity Index node capacity.
+ * @param key_size Size of the normalized key.
+ * @param sep_pos Position of the parent separator between the two nodes.
+ */
+void indexnode_merge(char *left_data, char *right_data, char *parent_data, int capacity, int key_size,
+                     int sep_pos);
+
+#endif
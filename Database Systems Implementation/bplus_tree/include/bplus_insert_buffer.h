@@ -0,0 +1,112 @@
+#ifndef BP_INSERT_BUFFER_H
+#define BP_INSERT_BUFFER_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Insert buffer
+ *
+ * With random keys almost every insert dirties a different leaf, and with
+ * only BF_BUFFER_SIZE frames most of them are evicted (and written) before
+ * the next insert reaches them again. An insert buffer keeps new records in
+ * memory, in a hash table on their normalized key, and moves them into the
+ * tree in key order when it fills up: each leaf is then fetched, changed
+ * and logged once for all the buffered records that belong to it.
+ *
+ * Whether a buffered key already exists in the tree is found out lazily:
+ * when the buffer is flushed, or when a lookup, update or delete of the
+ * same key meets both copies. The buffered record is then dropped as a
+ * duplicate, exactly as the insert would have been refused. Use
+ * bplus_insert_buffer_enable / bplus_insert_buffer_flush
+ * (bplus_file_funcs.h) to work with it; the functions below are the
+ * in-memory part.
+ */
+typedef struct {
+    BPlusMeta *metadata;    /**< Tree the buffer belongs to */
+    int capacity;           /**< Most records held before a flush */
+    int count;              /**< Records currently held */
+    int entry_size;         /**< Normalized key followed by the packed record */
+    char *entries;          /**< count entries, in insertion order */
+    int *table;             /**< Open addressing table of entry numbers (-1 = empty) */
+    int table_mask;         /**< Table size - 1 (a power of two) */
+    long flushes;           /**< Flushes so far */
+    long duplicates;        /**< Buffered records dropped because the key was already in the tree */
+} BPlusInsertBuffer;
+
+/**
+ * @brief Creates an empty buffer for a tree and registers it for the file.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the tree.
+ * @param capacity Most records to hold (memory is about capacity * (key_size + record_size + 8) bytes).
+ * @return New buffer, or NULL on failure or if the file already has one.
+ */
+BPlusInsertBuffer *insert_buffer_create(int file_desc, BPlusMeta *metadata, int capacity);
+
+/**
+ * @brief Returns the buffer of a file, or NULL if it has none.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+BPlusInsertBuffer *insert_buffer_of(int file_desc);
+
+/**
+ * @brief Unregisters and frees a buffer (its records are lost, flush it first).
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void insert_buffer_destroy(int file_desc);
+
+/**
+ * @brief Returns the packed record buffered under a key, or NULL.
+ * @param buffer Insert buffer.
+ * @param key Normalized key.
+ */
+char *insert_buffer_get(BPlusInsertBuffer *buffer, const unsigned char *key);
+
+/**
+ * @brief Buffers a record.
+ * @param buffer Insert buffer (must not be full).
+ * @param key Normalized key of the record.
+ * @param record Record to buffer.
+ * @return 0 on success, -1 if the key is already buffered.
+ */
+int insert_buffer_add(BPlusInsertBuffer *buffer, const unsigned char *key, const Record *record);
+
+/**
+ * @brief Removes the record buffered under a key.
+ * @param buffer Insert buffer.
+ * @param key Normalized key.
+ * @return 0 on success, -1 if the key is not buffered.
+ */
+int insert_buffer_remove(BPlusInsertBuffer *buffer, const unsigned char *key);
+
+/**
+ * @brief Returns the entry numbers of the buffer sorted by key.
+ * @param buffer Insert buffer.
+ * @return Array of buffer->count entry numbers (free it), NULL on failure.
+ */
+int *insert_buffer_sorted(const BPlusInsertBuffer *buffer);
+
+/**
+ * @brief Returns the normalized key of an entry.
+ * @param buffer Insert buffer.
+ * @param entry Entry number.
+ */
+unsigned char *insert_buffer_key(const BPlusInsertBuffer *buffer, int entry);
+
+/**
+ * @brief Returns the packed record of an entry.
+ * @param buffer Insert buffer.
+ * @param entry Entry number.
+ */
+char *insert_buffer_record(const BPlusInsertBuffer *buffer, int entry);
+
+/**
+ * @brief Keeps only some entries (the rest have been flushed) and rebuilds the table.
+ * @param buffer Insert buffer.
+ * @param keep Entry numbers to keep.
+ * @param keep_count Number of entries to keep (0 empties the buffer).
+ * @return 0 on success, -1 on failure.
+ */
+int insert_buffer_retain(BPlusInsertBuffer *buffer, const int *keep, int keep_count);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef BP_JOIN_H
+#define BP_JOIN_H
+
+#include "bplus_exec.h"
+#include "bplus_file_structs.h"
+#include "record.h"
+
+/**
+ * Joins without a hash table
+ *
+ * Both joins stream their output: every matching pair is handed to a visit
+ * callback as soon as it is found, and nothing is built in memory.
+ *
+ * bplus_merge_join joins two B+ tree files on their keys. Both leaf chains
+ * are already in key order, so two cursors move forward together and each
+ * leaf is read once. When one side is ahead, the other binary searches its
+ * current leaf for that key, so long runs with no match cost a search per
+ * leaf instead of a comparison per record.
+ *
+ * bplus_index_join joins any scan of bplus_exec.h (for example a heap file
+ * through exec_heap_scan) with a B+ tree file whose key is a single
+ * attribute. The live rows of every outer batch probe the B+ tree together
+ * with bplus_record_find_many_by_key, which visits the probes in key order
+ * and reads each leaf once per batch.
+ *
+ * Keys are unique in a B+ tree file, so every outer row matches at most
+ * one record.
+ */
+
+/**
+ * @brief Called with every matching pair; a non-zero return stops the join.
+ */
+typedef int (*BPlusJoinVisit)(const Record *left, const Record *right, void *ctx);
+
+/**
+ * @brief Joins two B+ tree files on equal keys, in key order.
+ *
+ * The keys of the two files must have the same attribute types (and CHAR
+ * lengths) in the same order. A leaf of each file stays pinned while visit
+ * runs, so visit must not call functions on either file.
+ * @param left_desc File descriptor of the left file.
+ * @param left Metadata of the left file.
+ * @param right_desc File descriptor of the right file.
+ * @param right Metadata of the right file.
+ * @param visit Called with the left and the right record of each match.
+ * @param ctx Passed to visit.
+ * @return Number of matches visited, -1 on failure or incompatible keys.
+ */
+int bplus_merge_join(int left_desc, const BPlusMeta *left, int right_desc, const BPlusMeta *right,
+                     BPlusJoinVisit visit, void *ctx);
+
+/**
+ * @brief Joins the rows of a scan with the records of a B+ tree file whose key equals one of their columns.
+ *
+ * The outer column must have the type of the single key attribute of the
+ * inner file. Matches come in outer order.
+ * @param outer Outer scan (closed by this call).
+ * @param outer_column Column of the outer scan to join on.
+ * @param inner_desc File descriptor of the inner B+ tree file.
+ * @param inner Metadata of the inner file.
+ * @param visit Called with the outer row (as a record of the outer schema) and the inner record.
+ * @param ctx Passed to visit.
+ * @return Number of matches visited, -1 on failure or incompatible keys.
+ */
+int bplus_index_join(ExecOperator *outer, int outer_column, int inner_desc, const BPlusMeta *inner,
+                     BPlusJoinVisit visit, void *ctx);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef BP_KEY_H
+#define BP_KEY_H
+
+#include "record.h"
+
+/**
+ * @brief Largest normalized key, in bytes (every attribute a full string).
+ */
+#define BPLUS_MAX_KEY_SIZE (MAX_ATTRIBUTES * MAX_STRING_LENGTH)
+
+/**
+ * Normalized keys
+ *
+ * The key attributes of a record (schema->key_indexes, in key order) are
+ * encoded into schema->key_size bytes whose memcmp order equals the key
+ * order: INT and FLOAT become 4 big-endian bytes with the sign handled so
+ * that negative values sort first, CHAR(n) keeps its n zero-padded bytes.
+ *
+ * Nodes keep only the first 4 bytes of each key in their dense key array,
+ * as a signed int "head" (for a single INT key the head is the value itself),
+ * so the int search of bplus_search.h works for every key type. Only keys
+ * with equal heads need the remaining bytes to be compared.
+ */
+
+/**
+ * @brief Builds the normalized key of a record.
+ * @param schema Pointer to the table schema.
+ * @param record Record holding (at least) the key attributes.
+ * @param key Output buffer of schema->key_size bytes.
+ */
+void bplus_key_from_record(const TableSchema *schema, const Record *record, unsigned char *key);
+
+/**
+ * @brief Builds the normalized key of a packed (on-page) record.
+ * @param schema Pointer to the table schema.
+ * @param packed Packed record bytes.
+ * @param key Output buffer of schema->key_size bytes.
+ */
+void bplus_key_from_packed(const TableSchema *schema, const char *packed, unsigned char *key);
+
+/**
+ * @brief Builds the normalized key for an INT key value.
+ * @param schema Pointer to the table schema (key must be a single INT).
+ * @param value Key value.
+ * @param key Output buffer of schema->key_size bytes.
+ * @return 0 on success, -1 if the key of the schema is not a single INT.
+ */
+int bplus_key_from_int(const TableSchema *schema, int value, unsigned char *key);
+
+/**
+ * @brief Decodes a normalized key back into the key attributes of a record.
+ * @param schema Pointer to the table schema.
+ * @param key Normalized key of schema->key_size bytes.
+ * @param record Record whose key attributes are set (the others are left alone).
+ */
+void bplus_key_to_record(const TableSchema *schema, const unsigned char *key, Record *record);
+
+/**
+ * @brief Returns the head (first 4 bytes as an order-preserving int) of a key.
+ * @param key Normalized key.
+ */
+int bplus_key_head(const unsigned char *key);
+
+/**
+ * @brief Writes a head back as the first 4 bytes of a normalized key.
+ * @param head Head value.
+ * @param key Output buffer (at least 4 bytes).
+ */
+void bplus_key_set_head(int head, unsigned char *key);
+
+/**
+ * @brief Compares a normalized key with the key of a packed record.
+ * @param schema Pointer to the table schema.
+ * @param key Normalized key.
+ * @param packed Packed record bytes.
+ * @return <0, 0 or >0 like memcmp.
+ */
+int bplus_key_compare_packed(const TableSchema *schema, const unsigned char *key, const char *packed);
+
+#endif
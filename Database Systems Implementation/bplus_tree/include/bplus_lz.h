@@ -0,0 +1,59 @@
+#ifndef BP_LZ_H
+#define BP_LZ_H
+
+/**
+ * Page compression
+ *
+ * A small LZ77 codec in the LZ4 block format, for pages and groups of
+ * records a few kilobytes long. The input is a sequence of
+ *
+ *   [token][literal length...][literals][offset][match length...]
+ *
+ * where the high four bits of the token count the literals and the low
+ * four the match length minus BPLUS_LZ_MIN_MATCH, a value of 15 being
+ * continued by bytes of 255 and a last smaller byte. The offset is two
+ * bytes little endian, so matches reach back 64 KiB. The last sequence has
+ * literals only, and like LZ4 the compressor keeps the last five bytes
+ * literal and starts no match in the last twelve, so its output can also be
+ * read by any LZ4 block decoder.
+ *
+ * The decoder checks every length and offset against both buffers, and
+ * refuses a stream that ends inside a sequence or after a match. A stream
+ * cut right after the literals of a sequence whose match has the minimum
+ * length is still a valid, shorter stream, so callers that know the
+ * original size compare it with the result.
+ *
+ * Matches are found with one probe of a hash table of four-byte sequences;
+ * there is no entropy coding. Both directions touch each byte a few times,
+ * which makes decompression far cheaper than reading the page from disk.
+ */
+
+#define BPLUS_LZ_MIN_MATCH 4
+
+/**
+ * @brief Upper bound of the compressed size of n bytes.
+ */
+#define BPLUS_LZ_BOUND(n) ((n) + (n) / 255 + 16)
+
+/**
+ * @brief Compresses a buffer.
+ * @param in Bytes to compress.
+ * @param n Number of bytes.
+ * @param out Receives the compressed bytes.
+ * @param capacity Size of out; BPLUS_LZ_BOUND(n) is always enough.
+ * @return Compressed size, or -1 if it does not fit in capacity.
+ */
+int bplus_lz_compress(const char *in, int n, char *out, int capacity);
+
+/**
+ * @brief Decompresses a buffer of bplus_lz_compress.
+ * @param in Compressed bytes.
+ * @param n Number of compressed bytes.
+ * @param out Receives the original bytes.
+ * @param capacity Size of out.
+ * @return Original size, or -1 if the input is malformed, truncated (it must
+ *         end with a sequence of literals only) or does not fit in capacity.
+ */
+int bplus_lz_decompress(const char *in, int n, char *out, int capacity);
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef BP_MEMTREE_H
+#define BP_MEMTREE_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * In-memory B+ tree
+ *
+ * A memory resident copy of a B+ tree file for hot data sets, laid out as a
+ * CSB+ tree: the children of an index node are stored one after the other
+ * in a single 64-byte aligned group, so an index node keeps one pointer
+ * instead of one per child and almost all of its BPLUS_MEMTREE_NODE_BYTES
+ * hold keys. A descent reads two cache lines per level and finds each child
+ * by arithmetic. Leaves use the data node layout (bplus_datanode.h) with
+ * BPLUS_MEMTREE_LEAF_RECORDS records, and the same Record and TableSchema.
+ *
+ * The B+ tree file stays the durable copy. bplus_memtree_load reads it at
+ * startup and builds the tree bottom up, with nearly full leaves and the
+ * fewest levels that hold the records; every change is then logged in memory and replayed into the file
+ * by bplus_memtree_checkpoint, called explicitly, every checkpoint_every
+ * changes, and on close. Changes after the last checkpoint are lost in a
+ * crash. Deletes do not rebalance: leaves may shrink or empty, which costs
+ * memory but not correctness. A tree is not thread safe, and the file must
+ * not be changed through other functions while it is loaded.
+ */
+
+#define BPLUS_MEMTREE_NODE_BYTES 128   /* Index node size, two cache lines */
+#define BPLUS_MEMTREE_LEAF_RECORDS 16  /* Records per leaf */
+
+/**
+ * @brief Header of an in-memory index node, followed by its heads and key suffixes.
+ */
+typedef struct {
+    int key_count;   /**< Number of keys; the node has key_count + 1 children */
+    char *children;  /**< Group of the children, index_capacity + 1 nodes long */
+} BPlusMemIndexNode;
+
+typedef struct {
+    TableSchema schema;    /**< Schema of the records */
+    char *root;            /**< Root node (a leaf when depth is 1) */
+    int depth;             /**< Levels, leaves included */
+    int index_capacity;    /**< Keys per index node */
+    int index_size;        /**< Bytes per index node (a multiple of 64) */
+    int leaf_size;         /**< Bytes per leaf (a multiple of 64) */
+    long record_count;     /**< Records in the tree */
+    char *log;             /**< Changes since the last checkpoint */
+    int log_count;         /**< Entries in the log */
+    int log_allocated;     /**< Entries the log has room for */
+    int file_desc;         /**< File the tree checkpoints to */
+    BPlusMeta *metadata;   /**< Metadata of that file */
+    int checkpoint_every;  /**< Changes between automatic checkpoints, 0 for none */
+} BPlusMemTree;
+
+/**
+ * @brief Loads a B+ tree file into a new in-memory tree.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the file.
+ * @param checkpoint_every Changes between automatic checkpoints, 0 to checkpoint only explicitly.
+ * @return New tree, or NULL on failure.
+ */
+BPlusMemTree *bplus_memtree_load(int file_desc, BPlusMeta *metadata, int checkpoint_every);
+
+/**
+ * @brief Writes the changes since the last checkpoint to the B+ tree file.
+ * @param tree In-memory tree.
+ * @return Number of changes written, or -1 on failure (the unwritten ones are kept).
+ */
+int bplus_memtree_checkpoint(BPlusMemTree *tree);
+
+/**
+ * @brief Checkpoints and frees an in-memory tree. The file stays open.
+ * @param tree In-memory tree.
+ * @return 0 on success, -1 if the last checkpoint failed (the tree is freed anyway).
+ */
+int bplus_memtree_close(BPlusMemTree *tree);
+
+/**
+ * @brief Inserts a record.
+ *
+ * A failed automatic checkpoint is reported on stderr and retried at the next one.
+ * @param tree In-memory tree.
+ * @param record Record to insert.
+ * @return 0 on success, -1 if the key already exists or on allocation failure.
+ */
+int bplus_memtree_insert(BPlusMemTree *tree, const Record *record);
+
+/**
+ * @brief Finds a record by INT key.
+ * @param tree In-memory tree.
+ * @param key Key value to search for.
+ * @param out_record Receives the record if found.
+ * @return 0 if found, -1 if not found or the key is not a single INT attribute.
+ */
+int bplus_memtree_find(const BPlusMemTree *tree, int key, Record *out_record);
+
+/**
+ * @brief Finds a record by a key of any type.
+ * @param tree In-memory tree.
+ * @param key_record Record whose key attributes hold the key to search for.
+ * @param out_record Receives the record if found.
+ * @return 0 if found, -1 if not found.
+ */
+int bplus_memtree_find_by_key(const BPlusMemTree *tree, const Record *key_record, Record *out_record);
+
+/**
+ * @brief Deletes a record by INT key.
+ * @param tree In-memory tree.
+ * @param key Key of the record to delete.
+ * @return 0 on success, -1 if not found or the key is not a single INT attribute.
+ */
+int bplus_memtree_delete(BPlusMemTree *tree, int key);
+
+/**
+ * @brief Deletes a record by a key of any type.
+ * @param tree In-memory tree.
+ * @param key_record Record whose key attributes hold the key of the record to delete.
+ * @return 0 on success, -1 if not found.
+ */
+int bplus_memtree_delete_by_key(BPlusMemTree *tree, const Record *key_record);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef BP_NODE_CACHE_H
+#define BP_NODE_CACHE_H
+
+#include "bf.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Upper level node cache
+ *
+ * Every descent reads the root and the upper index levels, and with only
+ * BF_BUFFER_SIZE frames the leaves keep evicting them. The node cache keeps
+ * private copies of the top index levels of a tree (as many whole levels as
+ * fit in BPLUS_NODE_CACHE_MAX_NODES nodes), each with pointers straight to
+ * the cached copies of its children, so a descent only goes to the buffer
+ * pool below the cached levels.
+ *
+ * The copies are kept exact by bplus_commit_op, which hands the final image
+ * of every page an operation changed to node_cache_update. Index nodes made
+ * by splits are not cached until the next rebuild, which happens when the
+ * root or the depth changes, or once descents have missed the cache often
+ * enough to have paid for one. The cache belongs to the single threaded
+ * functions; bplus_shared_open and bplus_shared_close drop it.
+ */
+
+#define BPLUS_NODE_CACHE_MAX_NODES 4096 /* About 4MB with 512 byte blocks */
+
+typedef struct BPlusCachedNode BPlusCachedNode;
+
+struct BPlusCachedNode {
+    int block_id;                /**< Block of the node, -1 once it is no longer an index node */
+    char data[BF_BLOCK_SIZE];    /**< Copy of the block */
+    BPlusCachedNode *children[]; /**< Cached copy of each child, or NULL (index_capacity + 1) */
+};
+
+typedef struct {
+    int root_block_num;        /**< Root the cache was built for */
+    int depth;                 /**< Depth the cache was built for */
+    int index_capacity;        /**< Keys per index node of the tree */
+    int levels;                /**< Index levels that were cached whole */
+    int node_count;            /**< Cached nodes */
+    BPlusCachedNode **nodes;   /**< node_count nodes, root first */
+    BPlusCachedNode **table;   /**< Open addressing table on block_id */
+    int table_mask;            /**< Table size - 1 (a power of two) */
+    long misses;               /**< Descents that found an uncached node inside the cached levels */
+    long rebuilds;             /**< Builds so far */
+} BPlusNodeCache;
+
+/**
+ * @brief Returns the cached root of a tree, building the cache when needed.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the tree.
+ * @return Cached root, or NULL if the tree has no index nodes or the cache cannot be built.
+ */
+BPlusCachedNode *node_cache_root(int file_desc, const BPlusMeta *metadata);
+
+/**
+ * @brief Returns the cache of a file, or NULL if it has none.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+BPlusNodeCache *node_cache_of(int file_desc);
+
+/**
+ * @brief Applies the final images of the pages of a committed operation.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param block_ids Blocks the operation changed.
+ * @param images Final contents of each block.
+ * @param count Number of blocks.
+ */
+void node_cache_update(int file_desc, const int *block_ids, const char (*images)[BF_BLOCK_SIZE], int count);
+
+/**
+ * @brief Frees the cache of a file (it is built again on the next descent).
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void node_cache_destroy(int file_desc);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef BP_PAGE_POOL_H
+#define BP_PAGE_POOL_H
+
+#include <stddef.h>
+
+#include "bf.h"
+
+/**
+ * Page pool
+ *
+ * The BF layer is a prebuilt library with BF_BUFFER_SIZE frames fixed at
+ * compile time. The page pool is a second, much larger cache above it:
+ * read-only copies of B+ tree pages in frames of BF_BLOCK_SIZE bytes, which
+ * serve the descents of find_leaf, point lookups and range scans without
+ * going to BF at all. Its size is chosen when it is created, after BF_Init,
+ * and can be changed at any time while files are open.
+ *
+ * Frames come in extents of BPLUS_POOL_EXTENT bytes, each mapped from a
+ * 2 MiB huge page when the system has some reserved (MAP_HUGETLB) and
+ * otherwise aligned to 2 MiB and offered to transparent huge pages, so a
+ * large pool costs few TLB entries. Growing maps new extents; shrinking
+ * drops the frames of the last extents and unmaps them. Frames are
+ * replaced with the clock algorithm.
+ *
+ * Copies are kept exact like those of the node cache: bplus_commit_op hands
+ * the final image of every page an operation changed to page_pool_update,
+ * and reads inside an operation go to BF, since pages may have changed but
+ * not been committed yet. Files are cached from bplus_open_file to
+ * bplus_close_file; bplus_shared_open stops caching a file until
+ * bplus_shared_close, since the pool is not thread safe.
+ */
+
+#define BPLUS_POOL_EXTENT (2 << 20)  /* Bytes per extent, one huge page */
+
+/**
+ * @brief Counters of the page pool.
+ */
+typedef struct {
+    size_t bytes;       /**< Current size */
+    int frames;         /**< Frames of BF_BLOCK_SIZE bytes */
+    int huge_extents;   /**< Extents mapped from reserved huge pages (the rest use transparent ones) */
+    long hits;          /**< Reads served from the pool */
+    long misses;        /**< Reads that went to BF and filled a frame */
+} BPlusPoolStats;
+
+/**
+ * @brief Creates the page pool (call after BF_Init).
+ * @param bytes Size of the pool, rounded up to whole extents; 0 leaves it empty.
+ * @return 0 on success, -1 if memory could not be mapped.
+ */
+int bplus_pool_init(size_t bytes);
+
+/**
+ * @brief Grows or shrinks the page pool while files are open.
+ *
+ * Shrinking drops the pages cached in the extents that are unmapped.
+ * @param bytes New size, rounded up to whole extents; 0 empties the pool.
+ * @return 0 on success, -1 if memory could not be mapped (the pool keeps the extents it got).
+ */
+int bplus_pool_resize(size_t bytes);
+
+/**
+ * @brief Unmaps the page pool (call before BF_Close).
+ */
+void bplus_pool_close(void);
+
+/**
+ * @brief Returns the size and counters of the page pool.
+ * @param stats Receives the counters.
+ */
+void bplus_pool_stats(BPlusPoolStats *stats);
+
+/**
+ * @brief Returns the cached copy of a page, reading it through BF on a miss.
+ *
+ * The copy stays valid until the next call into the pool and must not be
+ * written to.
+ * @param file_desc File descriptor of a B+ tree file.
+ * @param block_id Block to read.
+ * @return The copy, or NULL if the pool cannot serve the read (empty pool,
+ *         file not cached, an operation in progress or a BF error).
+ */
+const char *page_pool_read(int file_desc, int block_id);
+
+/**
+ * @brief Applies the final images of the pages of a committed operation.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param block_ids Blocks the operation changed.
+ * @param images Final contents of each block.
+ * @param count Number of blocks.
+ */
+void page_pool_update(int file_desc, const int *block_ids, const char (*images)[BF_BLOCK_SIZE], int count);
+
+/**
+ * @brief Starts caching the pages of a file.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void page_pool_attach(int file_desc);
+
+/**
+ * @brief Stops caching the pages of a file and drops those cached.
+ * @param file_desc File descriptor of the B+ tree file.
+ */
+void page_pool_detach(int file_desc);
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef BP_PLANNER_H
+#define BP_PLANNER_H
+
+#include "bplus_exec.h"
+#include "bplus_file_structs.h"
+#include "bplus_stats.h"
+#include "record.h"
+
+/**
+ * Access path planner
+ *
+ * For a predicate "column compare value" on a B+ tree file, bplus_plan
+ * uses the statistics of bplus_analyze to estimate how many rows match.
+ * It then prices three ways to read them and keeps the cheapest:
+ *
+ * - Full scan: read every leaf in order. The pages are read sequentially
+ *   and every row is checked.
+ * - Index scan: on the primary key (a single INT key, any comparison
+ *   except NE), one descent and then a scan of the matching leaves. On a
+ *   secondary index (EQ only), one lookup in the primary file per matching
+ *   location, in posting list order, each a random page read.
+ * - Bitmap scan: the locations of a secondary index are sorted and fetched
+ *   with bplus_record_find_many, so every page is read at most once and
+ *   nearby pages are read close together.
+ *
+ * Costs are in page reads: a sequential read costs BPLUS_COST_SEQ_PAGE and
+ * a random read BPLUS_COST_RANDOM_PAGE, plus a small CPU cost per row. The
+ * pages a bitmap scan touches are estimated from the number of matches with
+ * the Cardenas formula.
+ *
+ * Locations of the secondary indexes must be the INT keys of the primary
+ * file (see bplus_secondary.h).
+ */
+
+#define BPLUS_COST_SEQ_PAGE 1.0     /* Reading the next page of a scan */
+#define BPLUS_COST_RANDOM_PAGE 4.0  /* Reading a page at a random position */
+#define BPLUS_COST_CPU_ROW 0.01     /* Checking one row against the predicate */
+#define BPLUS_COST_CPU_BITMAP 0.1   /* Sorting and probing one location of a bitmap scan */
+
+/**
+ * @brief The ways to read the rows of a predicate.
+ */
+typedef enum {
+    BPLUS_PLAN_FULL_SCAN,
+    BPLUS_PLAN_INDEX_SCAN,
+    BPLUS_PLAN_BITMAP_SCAN
+} BPlusPlanKind;
+
+/**
+ * @brief A secondary index of the table (made by bplus_secondary_create).
+ */
+typedef struct {
+    int file_desc;             /**< File descriptor of the index file */
+    const BPlusMeta *metadata; /**< Metadata of the index file */
+} BPlusSecondaryPath;
+
+/**
+ * @brief Everything the planner may use to read a table.
+ */
+typedef struct {
+    int file_desc;                          /**< File descriptor of the primary B+ tree file */
+    const BPlusMeta *metadata;              /**< Metadata of the primary file */
+    const BPlusTableStats *stats;           /**< Statistics of the primary file (bplus_analyze) */
+    const BPlusSecondaryPath *secondaries;  /**< Secondary indexes, or NULL */
+    int secondary_count;                    /**< Number of secondary indexes */
+} BPlusAccessPaths;
+
+/**
+ * @brief A predicate "column compare value".
+ */
+typedef struct {
+    int column;          /**< Attribute index in the table schema */
+    ExecCompare compare; /**< Comparison */
+    FieldValue value;    /**< Constant, by the column type */
+} BPlusPredicate;
+
+/**
+ * @brief The chosen plan and the estimates behind it.
+ */
+typedef struct {
+    BPlusPlanKind kind;     /**< Chosen access path */
+    int secondary;          /**< Secondary index used, or -1 for the primary key / full scan */
+    double estimated_rows;  /**< Rows expected to match */
+    double cost;            /**< Cost of the chosen path */
+    double full_scan_cost;  /**< Cost of a full scan */
+    double index_cost;      /**< Cost of the best index scan, or -1 if none applies */
+    double bitmap_cost;     /**< Cost of the best bitmap scan, or -1 if none applies */
+} BPlusPlan;
+
+/**
+ * @brief Chooses the cheapest access path for a predicate.
+ * @param paths Files, indexes and statistics of the table.
+ * @param predicate Predicate to evaluate.
+ * @param plan Receives the plan.
+ * @return 0 on success, -1 on an invalid column.
+ */
+int bplus_plan(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, BPlusPlan *plan);
+
+/**
+ * @brief Runs a plan and visits every row that satisfies the predicate.
+ *
+ * Rows come in key order for full scans, primary key scans and bitmap scans,
+ * and in posting list order (also key order) for secondary index scans.
+ * visit must not call functions on the primary file, whose leaf may still
+ * be pinned.
+ * @param paths Files and indexes of the table (the ones given to bplus_plan).
+ * @param predicate Predicate of the plan.
+ * @param plan Plan made by bplus_plan.
+ * @param visit Called with each matching row and ctx; a non-zero return stops.
+ * @param ctx Passed to visit.
+ * @return Number of rows visited, -1 on failure.
+ */
+int bplus_plan_execute(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, const BPlusPlan *plan,
+                       int (*visit)(const Record *record, void *ctx), void *ctx);
+
+/**
+ * @brief Prints a plan with the costs of all access paths.
+ * @param plan Plan to print.
+ */
+void bplus_plan_print(const BPlusPlan *plan);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef BP_SEARCH_H
+#define BP_SEARCH_H
+
+/**
+ * @brief Counts the keys of a sorted array that are smaller than key.
+ *
+ * Uses a branch-free binary search down to a small window, which is then
+ * counted with AVX2 compares when available (plain counting otherwise).
+ * @param keys Sorted key array.
+ * @param n Number of keys.
+ * @param key Key to search for.
+ * @return Position of the first key >= key (n if none).
+ */
+int bplus_rank_lower(const int *keys, int n, int key);
+
+/**
+ * @brief Counts the keys of a sorted array that are smaller or equal to key.
+ * @param keys Sorted key array.
+ * @param n Number of keys.
+ * @param key Key to search for.
+ * @return Position of the first key > key (n if none).
+ */
+int bplus_rank_upper(const int *keys, int n, int key);
+
+#endif
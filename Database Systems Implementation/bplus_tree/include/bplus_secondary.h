@@ -0,0 +1,111 @@
+#ifndef BP_SECONDARY_H
+#define BP_SECONDARY_H
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Secondary indexes
+ *
+ * A secondary index maps every value of one (non-key) attribute of a table
+ * to the sorted list of locations of the records that have it. A location
+ * is any non-negative int chosen by the caller that identifies a record in
+ * the primary file: its INT key for a primary B+ tree, or
+ * block * records_per_block + slot for a heap file.
+ *
+ * The index is an ordinary B+ tree file (open and close it with
+ * bplus_open_file / bplus_close_file) whose records are directory entries
+ * {value, count, postings, first, second}. Up to BPLUS_POSTING_INLINE
+ * locations are kept inside the entry itself; longer lists move to a chain
+ * of overflow pages (BPlusPostingPage) in the same file, where they are
+ * delta and varint encoded, so hot values cost about one byte per record.
+ */
+
+/**
+ * @brief Number of locations stored inside the directory entry of a value.
+ */
+#define BPLUS_POSTING_INLINE 2
+
+/**
+ * @brief Creates an empty secondary index on one attribute of a table.
+ * @param table_schema Schema of the indexed table.
+ * @param attr_name Name of the indexed attribute.
+ * @param fileName Name of the index file to create.
+ * @return 0 on success, -1 on failure or unknown attribute.
+ */
+int bplus_secondary_create(const TableSchema *table_schema, const char *attr_name, const char *fileName);
+
+/**
+ * @brief Adds the location of a record to the posting list of its value.
+ * @param file_desc File descriptor of the index file.
+ * @param metadata Pointer to the BPlusMeta structure of the index.
+ * @param value Value of the indexed attribute (e.g. &record.values[i]).
+ * @param location Location of the record in the primary file (>= 0).
+ * @return 0 on success, -1 on failure or if the location is already listed.
+ */
+int bplus_secondary_insert(int file_desc, BPlusMeta *metadata, const FieldValue *value, int location);
+
+/**
+ * @brief Removes the location of a record from the posting list of its value.
+ *
+ * A value whose list becomes empty is removed from the index, and overflow
+ * pages that are no longer needed are returned to the free list.
+ * @param file_desc File descriptor of the index file.
+ * @param metadata Pointer to the BPlusMeta structure of the index.
+ * @param value Value of the indexed attribute.
+ * @param location Location to remove.
+ * @return 0 on success, -1 on failure or if the location was not listed.
+ */
+int bplus_secondary_delete(int file_desc, BPlusMeta *metadata, const FieldValue *value, int location);
+
+/**
+ * @brief Returns all locations of the records that have the given value.
+ * @param file_desc File descriptor of the index file.
+ * @param metadata Pointer to the BPlusMeta structure of the index.
+ * @param value Value of the indexed attribute.
+ * @param out_locations Receives a malloc'd array of locations in ascending
+ *        order (NULL if there are none), to be freed by the caller.
+ * @return Number of locations (0 if the value is not indexed), -1 on failure.
+ */
+int bplus_secondary_find(int file_desc, const BPlusMeta *metadata, const FieldValue *value, int **out_locations);
+
+/**
+ * Loading in order
+ *
+ * A loader fills an index from (value, location) pairs that arrive sorted
+ * by value and then by location, as from an external sort. The locations
+ * of a value are packed into full overflow pages as they come, so each page
+ * is written once and only the current page of the current value is held
+ * in memory, however long its list grows. Every page and directory entry
+ * is its own WAL operation. The index must not hold any of the loaded
+ * values yet (for example, it was just created). If it is empty, the
+ * directory is built bottom up (bplus_bulk_load.h) and appears at
+ * bplus_secondary_loader_finish; otherwise every entry is inserted.
+ */
+typedef struct BPlusSecondaryLoader BPlusSecondaryLoader;
+
+/**
+ * @brief Starts loading an index in order.
+ * @param file_desc File descriptor of the index file.
+ * @param metadata Pointer to the BPlusMeta structure of the index.
+ * @return The loader, or NULL if out of memory.
+ */
+BPlusSecondaryLoader *bplus_secondary_loader_create(int file_desc, BPlusMeta *metadata);
+
+/**
+ * @brief Adds the next (value, location) pair.
+ * @param loader Loader from bplus_secondary_loader_create.
+ * @param value Value of the indexed attribute, not below the previous one.
+ * @param location Location (>= 0), above the previous one if the value is the same.
+ * @return 0 on success, -1 on failure or a pair out of order.
+ */
+int bplus_secondary_loader_add(BPlusSecondaryLoader *loader, const FieldValue *value, int location);
+
+/**
+ * @brief Writes the last value and frees the loader.
+ * @param loader Loader from bplus_secondary_loader_create.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_secondary_loader_finish(BPlusSecondaryLoader *loader);
+
+#endif
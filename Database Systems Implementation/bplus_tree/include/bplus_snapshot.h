@@ -0,0 +1,210 @@
+#ifndef BP_SNAPSHOT_H
+#define BP_SNAPSHOT_H
+
+#include <stddef.h>
+
+#include "record.h"
+#include "bplus_file_structs.h"
+
+/**
+ * Read-only snapshots
+ *
+ * bplus_export_snapshot writes the records of a B+ tree file into a static
+ * file that is searched straight from a memory map, without the BF layer:
+ *
+ *   [header][index nodes][sorted keys][records]
+ *
+ * The records are packed in key order and split into groups of
+ * BPLUS_SNAPSHOT_FANOUT. Above them sits a complete tree of index nodes
+ * with BPLUS_SNAPSHOT_FANOUT children each. Every node is one cache line
+ * for INT keys: the offset of its first child, then its 15 separators in
+ * Eytzinger (breadth-first) order, so the search inside a node is four
+ * branch-free steps down an implicit binary tree. The nodes are stored in
+ * van Emde Boas order: the tree is cut at half its height, the top half is
+ * laid out recursively and then each bottom subtree after it, so a descent
+ * stays within a few cache lines and pages at every level of the memory
+ * hierarchy whatever their size. The children of a node are consecutive
+ * equal-sized subtrees, hence one offset per node and one stride per level.
+ *
+ *   [header][index nodes][sorted keys][records][models]
+ *
+ * For a single INT key the export also fits a two-stage learned model of
+ * the key positions. The first stage interpolates between the smallest and
+ * the largest key to pick one of model_count second-stage models, each one
+ * interpolating between the first and last key it covers. Each model keeps
+ * the largest errors of its predictions, so a lookup only binary searches
+ * the few keys of its error window. When the keys are close to uniform the
+ * window is a handful of keys and the lookup reads one model and one or two
+ * cache lines of keys; bplus_snapshot_report measures when it pays off.
+ *
+ *   [header][index nodes][sorted keys][slots][records][models]
+ *
+ * bplus_export_snapshot_compressed stores each group of records compressed
+ * with the codec of bplus_lz.h, in slots of variable size one after the
+ * other. The slot table holds group_count + 1 offsets from the start of the
+ * records, so the slot of group g lies between offsets g and g + 1; a group
+ * that would not shrink is stored as is, with the length of its records.
+ * The keys and the index stay uncompressed, so a lookup searches exactly as
+ * before and decompresses only the group of the record it found.
+ */
+
+#define BPLUS_SNAPSHOT_FANOUT 16     /* Children per index node and records per group */
+#define BPLUS_SNAPSHOT_MAX_HEIGHT 8  /* Enough for 16^8 groups */
+#define BPLUS_SNAPSHOT_MODEL_KEYS 16 /* Keys per second-stage model, on average */
+
+/**
+ * @brief How bplus_snapshot_find locates a key.
+ */
+typedef enum {
+    BPLUS_SNAPSHOT_SEARCH_TREE,  /**< Descend the van Emde Boas index */
+    BPLUS_SNAPSHOT_SEARCH_MODEL  /**< Predict the position with the learned model */
+} BPlusSnapshotSearch;
+
+/**
+ * @brief Second-stage model: predicts first + (key - first_key) * (count - 1) / key_span.
+ */
+typedef struct {
+    int first;              /**< Position of the first key covered */
+    int count;              /**< Keys covered (may be 0) */
+    int first_key;          /**< Smallest key covered */
+    unsigned int key_span;  /**< Largest minus smallest key covered */
+    int error_low;          /**< Smallest (actual - predicted) position */
+    int error_high;         /**< Largest (actual - predicted) position */
+} BPlusSnapshotModel;
+
+typedef struct {
+    char magic[8];                              /**< "BPSNAP3" */
+    int key_size;                               /**< Bytes of a normalized key */
+    int record_size;                            /**< Bytes of a packed record */
+    int record_count;                           /**< Records in the snapshot */
+    int group_count;                            /**< Groups of BPLUS_SNAPSHOT_FANOUT records */
+    int height;                                 /**< Levels of index nodes (0 for a single group) */
+    int node_size;                              /**< Bytes of an index node (a multiple of 64) */
+    long node_count;                            /**< Index nodes, padding nodes included */
+    long nodes_offset;                          /**< File offset of the index nodes */
+    long keys_offset;                           /**< File offset of the sorted keys */
+    long records_offset;                        /**< File offset of the packed records, or of their slots */
+    long models_offset;                         /**< File offset of the second-stage models */
+    int compressed;                             /**< 1 if the groups of records are compressed */
+    long slots_offset;                          /**< File offset of the slot table (compressed only) */
+    long records_bytes;                         /**< Bytes of the records as stored */
+    int model_count;                            /**< Second-stage models (0 if the key is not an INT) */
+    int min_key;                                /**< Smallest key, for the first stage */
+    long key_range;                             /**< Largest minus smallest key plus one */
+    long strides[BPLUS_SNAPSHOT_MAX_HEIGHT];    /**< Distance in nodes between siblings, per level */
+    TableSchema schema;                         /**< Schema of the records */
+} BPlusSnapshotHeader;
+
+typedef struct {
+    const BPlusSnapshotHeader *header; /**< Start of the mapping */
+    const char *nodes;                 /**< Index nodes in van Emde Boas order */
+    const unsigned char *keys;         /**< record_count normalized keys in order */
+    const char *records;               /**< record_count packed records in order, or their slots */
+    const long *slots;                 /**< group_count + 1 slot offsets, NULL if not compressed */
+    const BPlusSnapshotModel *models;  /**< model_count second-stage models */
+    BPlusSnapshotSearch search;        /**< Search used by the find functions */
+    size_t size;                       /**< Length of the mapping */
+} BPlusSnapshot;
+
+/**
+ * @brief Writes a read-only snapshot of a B+ tree file.
+ *
+ * Buffered inserts are flushed first. The snapshot does not change when the
+ * tree does; export it again to pick up later changes.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param snapshot_name Name of the snapshot file to create (replaced if it exists).
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_export_snapshot(int file_desc, BPlusMeta *metadata, const char *snapshot_name);
+
+/**
+ * @brief Writes a read-only snapshot of a B+ tree file with its records compressed.
+ *
+ * Like bplus_export_snapshot, with every group of BPLUS_SNAPSHOT_FANOUT
+ * records in a compressed slot. Lookups decompress the group of the record
+ * they return.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Pointer to the BPlusMeta structure of the tree.
+ * @param snapshot_name Name of the snapshot file to create (replaced if it exists).
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_export_snapshot_compressed(int file_desc, BPlusMeta *metadata, const char *snapshot_name);
+
+/**
+ * @brief Maps a snapshot file for lookups.
+ *
+ * The handle searches with the learned model when the snapshot has one,
+ * with the index tree otherwise (see bplus_snapshot_set_search).
+ * @param snapshot_name Name of the snapshot file.
+ * @return New snapshot handle, or NULL on failure.
+ */
+BPlusSnapshot *bplus_snapshot_open(const char *snapshot_name);
+
+/**
+ * @brief Unmaps a snapshot and frees its handle.
+ * @param snapshot Snapshot handle.
+ */
+void bplus_snapshot_close(BPlusSnapshot *snapshot);
+
+/**
+ * @brief Finds a record by INT key. Safe to call from many threads at once.
+ * @param snapshot Snapshot handle.
+ * @param key Key value to search for.
+ * @param out_record Receives the record if found.
+ * @return 0 if found, -1 if not found or the key is not a single INT attribute.
+ */
+int bplus_snapshot_find(const BPlusSnapshot *snapshot, int key, Record *out_record);
+
+/**
+ * @brief Finds a record by a key of any type. Safe to call from many threads at once.
+ * @param snapshot Snapshot handle.
+ * @param key_record Record whose key attributes hold the key to search for.
+ * @param out_record Receives the record if found.
+ * @return 0 if found, -1 if not found.
+ */
+int bplus_snapshot_find_by_key(const BPlusSnapshot *snapshot, const Record *key_record, Record *out_record);
+
+/**
+ * @brief Chooses how the find functions locate keys.
+ * @param snapshot Snapshot handle.
+ * @param search Search to use.
+ * @return 0 on success, -1 if the model was requested but the snapshot has none.
+ */
+int bplus_snapshot_set_search(BPlusSnapshot *snapshot, BPlusSnapshotSearch search);
+
+/**
+ * @brief Accuracy and cost of the learned model against the classic searches.
+ */
+typedef struct {
+    int model_count;            /**< Second-stage models */
+    double mean_error;          /**< Mean distance between predicted and actual position of the keys */
+    int max_error;              /**< Largest such distance */
+    double mean_window;         /**< Mean keys searched after the prediction, per lookup */
+    double model_comparisons;   /**< Key comparisons per lookup, learned model */
+    double tree_comparisons;    /**< Key comparisons per lookup, van Emde Boas index */
+    double binary_comparisons;  /**< Key comparisons per lookup, binary search of all keys */
+    double model_ns;            /**< Nanoseconds per lookup, learned model */
+    double tree_ns;             /**< Nanoseconds per lookup, van Emde Boas index */
+    double binary_ns;           /**< Nanoseconds per lookup, binary search of all keys */
+} BPlusSnapshotReport;
+
+/**
+ * @brief Measures the learned model against the index tree and plain binary search.
+ *
+ * Half of the lookups are keys of the snapshot, half random values between
+ * the smallest and the largest key, the same for all three searches.
+ * @param snapshot Snapshot handle.
+ * @param lookups Number of lookups per search.
+ * @param report Receives the measurements.
+ * @return 0 on success, -1 if the snapshot has no model or on allocation failure.
+ */
+int bplus_snapshot_report(const BPlusSnapshot *snapshot, int lookups, BPlusSnapshotReport *report);
+
+/**
+ * @brief Prints a report of bplus_snapshot_report.
+ * @param report Report to print.
+ */
+void bplus_snapshot_report_print(const BPlusSnapshotReport *report);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef BP_STATS_H
+#define BP_STATS_H
+
+#include "bplus_exec.h"
+#include "bplus_file_structs.h"
+#include "record.h"
+
+/**
+ * Table statistics (ANALYZE)
+ *
+ * bplus_analyze reads a whole table once through the vectorized scan of
+ * bplus_exec.h. For every column it records the row count, the exact number
+ * of distinct values, the minimum, the maximum and an equi-depth histogram:
+ * bucket b holds the same share of the rows, covers
+ * [bounds[b], bounds[b + 1]] and knows how many distinct values it holds.
+ * A value that fills whole buckets is frequent and is estimated from them;
+ * any other value gets an equal share of its bucket.
+ *
+ * Values are kept as doubles on one order-preserving scale. INT and FLOAT
+ * are stored as is. CHAR uses its first BPLUS_STATS_CHAR_PREFIX bytes read
+ * as a big-endian number, which is enough for range estimates. Distinct
+ * CHAR values are counted on a hash of the whole string.
+ *
+ * Statistics describe the table when they were taken. Run ANALYZE again
+ * after large changes.
+ */
+
+#define BPLUS_STATS_BUCKETS 32     /* Histogram buckets per column */
+#define BPLUS_STATS_CHAR_PREFIX 6  /* Bytes of a CHAR value that make its position on the scale */
+
+/**
+ * @brief Statistics of one column.
+ */
+typedef struct {
+    long distinct_count;                       /**< Distinct values */
+    double min;                                /**< Smallest value */
+    double max;                                /**< Largest value */
+    int bucket_count;                          /**< Buckets used (fewer for small tables) */
+    double bounds[BPLUS_STATS_BUCKETS + 1];    /**< Bucket b covers [bounds[b], bounds[b + 1]] */
+    long bucket_distinct[BPLUS_STATS_BUCKETS]; /**< Distinct values of each bucket */
+} BPlusColumnStats;
+
+/**
+ * @brief Statistics of a table.
+ */
+typedef struct {
+    TableSchema schema;                         /**< Schema of the table */
+    long row_count;                             /**< Rows */
+    int page_count;                             /**< Pages that hold the rows (leaves or heap data blocks) */
+    BPlusColumnStats columns[MAX_ATTRIBUTES];   /**< One per attribute */
+} BPlusTableStats;
+
+/**
+ * @brief Collects the statistics of a B+ tree file.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the file.
+ * @param stats Receives the statistics.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_analyze(int file_desc, const BPlusMeta *metadata, BPlusTableStats *stats);
+
+/**
+ * @brief Collects statistics from any scan, e.g. exec_heap_scan of a heap file.
+ * @param scan Scan of the table (closed by this call).
+ * @param page_count Pages the table occupies, for the planner.
+ * @param stats Receives the statistics.
+ * @return 0 on success, -1 on failure.
+ */
+int bplus_analyze_scan(ExecOperator *scan, int page_count, BPlusTableStats *stats);
+
+/**
+ * @brief Maps a value of a column onto the scale of its statistics.
+ * @param attr Attribute of the column.
+ * @param value Value (int_value, float_value or string_value by type).
+ */
+double bplus_stats_position(const AttributeSchema *attr, const FieldValue *value);
+
+/**
+ * @brief Estimates the fraction of rows for which "column compare value" holds.
+ * @param stats Statistics of the table.
+ * @param column Column of the predicate.
+ * @param compare Comparison.
+ * @param value Constant of the predicate.
+ * @return Estimated selectivity in [0, 1].
+ */
+double bplus_stats_selectivity(const BPlusTableStats *stats, int column, ExecCompare compare, const FieldValue *value);
+
+/**
+ * @brief Prints the statistics, one line per column.
+ * @param stats Statistics to print.
+ */
+void bplus_stats_print(const BPlusTableStats *stats);
+
+#endif
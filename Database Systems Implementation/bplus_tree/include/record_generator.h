@@ -1,16 +1,52 @@
-//
-// Created by theofilos on 10/30/25.
-//
-
-
-#ifndef BPLUS_EMPLOYEE_H
-#define BPLUS_EMPLOYEE_H
-#include <record.h>
-
-TableSchema employee_get_schema();
-TableSchema student_get_schema();
-
-void employee_random_record(const TableSchema* schema, Record *record);
-void student_random_record(const TableSchema *schema, Record *record);
-
+//
+// Created by theofilos on 10/30/25.
+//
+
+
+#ifndef BPLUS_EMPLOYEE_H
+#define BPLUS_EMPLOYEE_H
+#include <record.h>
+#include "record_layout.h"
+
+// The two fixed schemas, as compile-time layouts (record_layout.h):
+// employee_<field>(), employee_serialize(), employee_make(), ... and the same for student.
+#define EMPLOYEE_FIELDS(X, P) \
+    X(P, id, INT, 0)          \
+    X(P, name, CHAR, 20)      \
+    X(P, surname, CHAR, 20)   \
+    X(P, city, CHAR, 20)
+
+#define STUDENT_FIELDS(X, P)   \
+    X(P, id, INT, 0)           \
+    X(P, name, CHAR, 20)       \
+    X(P, surname, CHAR, 20)    \
+    X(P, university, CHAR, 20) \
+    X(P, department, CHAR, 20)
+
+RECORD_LAYOUT(employee, EMPLOYEE_FIELDS, id)
+RECORD_LAYOUT(student, STUDENT_FIELDS, id)
+
+TableSchema employee_get_schema();
+TableSchema student_get_schema();
+
+void employee_random_record(const TableSchema* schema, Record *record);
+void student_random_record(const TableSchema *schema, Record *record);
+
+// Records with a given id whose text fields are picked by the bits of a
+// caller's random number, for generators that do not go through rand().
+void employee_record(const TableSchema *schema, Record *record, int id, unsigned long long bits);
+void student_record(const TableSchema *schema, Record *record, int id, unsigned long long bits);
+
+// record_serialize, record_deserialize and record_print, or the compiled
+// employee_/student_ versions when the schema has exactly that layout
+// (*_schema_matches). A loop picks the function once per schema and then calls
+// it without checking the schema again.
+typedef void (*RecordSerializer)(const TableSchema *schema, const Record *record, char *out);
+typedef void (*RecordDeserializer)(const TableSchema *schema, const char *packed, Record *record);
+typedef void (*RecordPrinter)(const TableSchema *schema, const Record *record);
+
+RecordSerializer record_serializer(const TableSchema *schema);
+RecordDeserializer record_deserializer(const TableSchema *schema);
+RecordPrinter record_printer(const TableSchema *schema);
+
 #endif //BPLUS_EMPLOYEE_H
\ No newline at end of file
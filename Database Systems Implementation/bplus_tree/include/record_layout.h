@@ -0,0 +1,180 @@
+#ifndef BPLUS_RECORD_LAYOUT_H
+#define BPLUS_RECORD_LAYOUT_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "record.h"
+
+/**
+ * Compile-time record layouts
+ *
+ * A schema that is known when the program is compiled is written once as a
+ * field list macro:
+ *
+ *     #define EMPLOYEE_FIELDS(X, P) \
+ *         X(P, id, INT, 0)          \
+ *         X(P, name, CHAR, 20)      \
+ *         ...
+ *
+ * RECORD_LAYOUT(employee, EMPLOYEE_FIELDS, id) then defines, with id as the key:
+ *
+ *     enum employee_field           employee_field_<f>, employee_field_count
+ *     struct employee_packed        the on-page layout (same offsets as schema_init)
+ *     employee_<f>(record)          read a field of a Record
+ *     employee_set_<f>(record, v)   write a field of a Record
+ *     employee_packed_<f>(packed)   read a field of a packed record in place
+ *     employee_make(record, ...)    fill a Record from one value per field
+ *     employee_serialize / employee_deserialize / employee_print
+ *     employee_schema()             the TableSchema of the layout
+ *     employee_schema_matches(s)    1 if a runtime schema has exactly this layout
+ *
+ * Everything is static inline with the field indexes, offsets and types
+ * fixed at compile time, so there is no name lookup and no switch on
+ * DataType per field. Code that gets its schema at run time (the B+ tree
+ * reads it from the file) can test the schema with *_schema_matches and
+ * use the TableSchema functions of record.h otherwise; record_serializer,
+ * record_deserializer and record_printer (record_generator.h) do that once
+ * per loop. There are no field comparators: the B+ tree compares normalized
+ * keys (bplus_key.h), whatever the layout.
+ * Field types are INT, FLOAT and CHAR (at most MAX_STRING_LENGTH bytes).
+ */
+
+#define RL_INDEX(P, f, T, n) P##_field_##f,
+
+#define RL_MEMBER_INT(f, n) int f;
+#define RL_MEMBER_FLOAT(f, n) float f;
+#define RL_MEMBER_CHAR(f, n) char f[n];
+#define RL_MEMBER(P, f, T, n) RL_MEMBER_##T(f, n)
+
+#define RL_ATTR(P, f, T, n) {#f, TYPE_##T, n},
+
+#define RL_OFFSET(P, f) offsetof(struct P##_packed, f)
+
+#define RL_ACCESS_INT(P, f, n)                                                        \
+  static inline int P##_##f(const Record *record)                                     \
+  {                                                                                   \
+    return record->values[P##_field_##f].int_value;                                   \
+  }                                                                                   \
+  static inline void P##_set_##f(Record *record, const int value)                     \
+  {                                                                                   \
+    record->values[P##_field_##f].int_value = value;                                  \
+  }                                                                                   \
+  static inline int P##_packed_##f(const char *packed)                                \
+  {                                                                                   \
+    int value;                                                                        \
+    memcpy(&value, packed + RL_OFFSET(P, f), sizeof(int));                            \
+    return value;                                                                     \
+  }
+
+#define RL_ACCESS_FLOAT(P, f, n)                                                      \
+  static inline float P##_##f(const Record *record)                                   \
+  {                                                                                   \
+    return record->values[P##_field_##f].float_value;                                 \
+  }                                                                                   \
+  static inline void P##_set_##f(Record *record, const float value)                   \
+  {                                                                                   \
+    record->values[P##_field_##f].float_value = value;                                \
+  }                                                                                   \
+  static inline float P##_packed_##f(const char *packed)                              \
+  {                                                                                   \
+    float value;                                                                      \
+    memcpy(&value, packed + RL_OFFSET(P, f), sizeof(float));                          \
+    return value;                                                                     \
+  }
+
+#define RL_ACCESS_CHAR(P, f, n)                                                       \
+  static inline const char *P##_##f(const Record *record)                             \
+  {                                                                                   \
+    return record->values[P##_field_##f].string_value;                                \
+  }                                                                                   \
+  static inline void P##_set_##f(Record *record, const char *value)                   \
+  {                                                                                   \
+    const size_t length = strnlen(value, n);                                          \
+    memcpy(record->values[P##_field_##f].string_value, value, length);                \
+    memset(record->values[P##_field_##f].string_value + length, 0,                    \
+           MAX_STRING_LENGTH - length);                                               \
+  }                                                                                   \
+  /* n bytes, zero padded and not necessarily NUL-terminated */                       \
+  static inline const char *P##_packed_##f(const char *packed)                        \
+  {                                                                                   \
+    return packed + RL_OFFSET(P, f);                                                  \
+  }
+
+#define RL_ACCESS(P, f, T, n) RL_ACCESS_##T(P, f, n)
+
+#define RL_PARAM_INT(f) , const int f
+#define RL_PARAM_FLOAT(f) , const float f
+#define RL_PARAM_CHAR(f) , const char *f
+#define RL_PARAM(P, f, T, n) RL_PARAM_##T(f)
+
+#define RL_SET(P, f, T, n) P##_set_##f(record, f);
+
+#define RL_SERIALIZE_INT(P, f, n) memcpy(out + RL_OFFSET(P, f), &record->values[P##_field_##f].int_value, sizeof(int));
+#define RL_SERIALIZE_FLOAT(P, f, n) \
+  memcpy(out + RL_OFFSET(P, f), &record->values[P##_field_##f].float_value, sizeof(float));
+#define RL_SERIALIZE_CHAR(P, f, n) strncpy(out + RL_OFFSET(P, f), record->values[P##_field_##f].string_value, n);
+#define RL_SERIALIZE(P, f, T, n) RL_SERIALIZE_##T(P, f, n)
+
+#define RL_DESERIALIZE_INT(P, f, n) P##_set_##f(record, P##_packed_##f(packed));
+#define RL_DESERIALIZE_FLOAT(P, f, n) P##_set_##f(record, P##_packed_##f(packed));
+#define RL_DESERIALIZE_CHAR(P, f, n)                                             \
+  memcpy(record->values[P##_field_##f].string_value, P##_packed_##f(packed), n); \
+  memset(record->values[P##_field_##f].string_value + n, 0, MAX_STRING_LENGTH - n);
+#define RL_DESERIALIZE(P, f, T, n) RL_DESERIALIZE_##T(P, f, n)
+
+#define RL_PRINT_INT(P, f, n) printf("%d", P##_##f(record));
+#define RL_PRINT_FLOAT(P, f, n) printf("%.2f", P##_##f(record));
+/* a string of n bytes has no NUL */
+#define RL_PRINT_CHAR(P, f, n) printf("%.*s", n, P##_##f(record));
+#define RL_PRINT(P, f, T, n)        \
+  if (P##_field_##f > 0) {          \
+    printf(", ");                   \
+  }                                 \
+  RL_PRINT_##T(P, f, n)
+
+#define RL_MATCH(P, f, T, n)                                                            \
+  matches = matches && schema->attributes[P##_field_##f].type == TYPE_##T &&            \
+            (TYPE_##T != TYPE_CHAR || schema->attributes[P##_field_##f].length == n) && \
+            schema->offsets[P##_field_##f] == (int)RL_OFFSET(P, f);
+
+#define RECORD_LAYOUT(P, FIELDS, KEY)                                                   \
+  enum P##_field { FIELDS(RL_INDEX, P) P##_field_count };                               \
+  struct __attribute__((packed)) P##_packed { FIELDS(RL_MEMBER, P) };                   \
+  FIELDS(RL_ACCESS, P)                                                                  \
+  static inline void P##_make(Record *record FIELDS(RL_PARAM, P))                       \
+  {                                                                                     \
+    FIELDS(RL_SET, P)                                                                   \
+  }                                                                                     \
+  static inline void P##_serialize(const Record *record, char *out)                     \
+  {                                                                                     \
+    FIELDS(RL_SERIALIZE, P)                                                             \
+  }                                                                                     \
+  static inline void P##_deserialize(const char *packed, Record *record)                \
+  {                                                                                     \
+    FIELDS(RL_DESERIALIZE, P)                                                           \
+  }                                                                                     \
+  static inline void P##_print(const Record *record)                                    \
+  {                                                                                     \
+    printf("(");                                                                        \
+    FIELDS(RL_PRINT, P)                                                                 \
+    printf(")\n");                                                                      \
+  }                                                                                     \
+  static inline TableSchema P##_schema(void)                                            \
+  {                                                                                     \
+    const AttributeSchema attrs[] = {FIELDS(RL_ATTR, P)};                               \
+    TableSchema schema;                                                                 \
+    schema_init(&schema, attrs, P##_field_count, #KEY);                                 \
+    return schema;                                                                      \
+  }                                                                                     \
+  static inline int P##_schema_matches(const TableSchema *schema)                       \
+  {                                                                                     \
+    int matches = schema->count == P##_field_count &&                                   \
+                  schema->record_size == (int)sizeof(struct P##_packed) &&              \
+                  schema->key_attr_count == 1 && schema->key_index == P##_field_##KEY;  \
+    FIELDS(RL_MATCH, P)                                                                 \
+    return matches;                                                                     \
+  }
+
+#endif
@@ -0,0 +1,124 @@
+#include "bplus_block.h"
+#include "bf.h"
+#include "wal.h"
+#include "bplus_node_cache.h"
+#include "bplus_page_pool.h"
+#include <stdio.h>
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+
+void bplus_begin_op(const int file_desc)
+{
+  Wal *wal = wal_of(file_desc);
+  if (wal != NULL) {
+    wal_begin(wal, NULL);
+  }
+}
+
+int bplus_commit_op(const int file_desc)
+{
+  Wal *wal = wal_of(file_desc);
+  if (wal == NULL) {
+    return 0;
+  }
+
+  // η τελευταια εικονα καθε σελιδας της πραξης ενημερωνει και τα αντιγραφα των
+  // κομβων και του page pool, και στα εσωτερικα commit ωστε μια επομενη καταβαση
+  // να τα βρει σωστα
+  const WalOp *op = wal_current(wal);
+  if (op != NULL) {
+    node_cache_update(file_desc, op->block_ids, (const char (*)[BF_BLOCK_SIZE])op->images, op->page_count);
+    page_pool_update(file_desc, op->block_ids, (const char (*)[BF_BLOCK_SIZE])op->images, op->page_count);
+  }
+  return wal_commit(wal, NULL);
+}
+
+BF_ErrorCode bplus_track_block(const int file_desc, const int block_id, BF_Block *block)
+{
+  WalOp *op = wal_current(wal_of(file_desc));
+  if (op != NULL && wal_track(op, block_id, BF_Block_GetData(block)) == -1) {
+    return BF_ERROR;
+  }
+  return BF_OK;
+}
+
+BF_ErrorCode bplus_get_block(const int file_desc, const int block_id, BF_Block *block)
+{
+  BF_ErrorCode code = BF_GetBlock(file_desc, block_id, block);
+  if (code == BF_OK && (code = bplus_track_block(file_desc, block_id, block)) != BF_OK) {
+    BF_UnpinBlock(block);
+  }
+  return code;
+}
+
+// οι αλλαγες γραφονται στο log πριν το unpin, μετα το BF μπορει να γραψει τη σελιδα
+BF_ErrorCode bplus_set_dirty(const int file_desc, const int block_id, BF_Block *block)
+{
+  BF_Block_SetDirty(block);
+  Wal *wal = wal_of(file_desc);
+  WalOp *op = wal_current(wal);
+  if (op != NULL && wal_log_page(wal, op, block_id, BF_Block_GetData(block)) == -1) {
+    return BF_ERROR;
+  }
+  return BF_OK;
+}
+
+// Δέσμευση block (μένει pinned), επιστρέφει το id του ή -1. Προτιμάμε
+// blocks από τη λίστα ελεύθερων, αλλιώς νέο στο τέλος του αρχείου.
+int bplus_allocate_block(const int file_desc, BPlusMeta *metadata, BF_Block *block)
+{
+  if (metadata->free_block_head != -1) {
+    const int block_id = metadata->free_block_head;
+    CALL_BF(bplus_get_block(file_desc, block_id, block));
+    metadata->free_block_head = ((BPlusFreeBlock *)BF_Block_GetData(block))->next_free;
+    return block_id;
+  }
+
+  CALL_BF(BF_AllocateBlock(file_desc, block));
+
+  int block_count;
+  BF_ErrorCode code = BF_GetBlockCounter(file_desc, &block_count);
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    BF_UnpinBlock(block);
+    return -1;
+  }
+
+  // το BF δινει το νεο block γεματο μηδενικα, αυτη ειναι και η εικονα του για το undo
+  code = bplus_track_block(file_desc, block_count - 1, block);
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    BF_UnpinBlock(block);
+    return -1;
+  }
+
+  return block_count - 1;
+}
+
+// Βάζει ένα block που δεν χρησιμοποιείται πια στην αρχή της λίστας ελεύθερων
+int bplus_free_block(const int file_desc, BPlusMeta *metadata, const int block_id)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  CALL_BF(bplus_get_block(file_desc, block_id, block));
+
+  BPlusFreeBlock *free_node = (BPlusFreeBlock *)BF_Block_GetData(block);
+  free_node->is_leaf = BPLUS_FREE_BLOCK;
+  free_node->next_free = metadata->free_block_head;
+  metadata->free_block_head = block_id;
+
+  CALL_BF(bplus_set_dirty(file_desc, block_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return 0;
+}
@@ -0,0 +1,298 @@
+// Φόρτωση ταξινομημένων εγγραφών από κάτω προς τα πάνω: γεμάτα φύλλα με τη
+// σειρά, και μετά τα επίπεδα ευρετηρίου από τα πρώτα κλειδιά των κόμβων.
+
+#include "bplus_bulk_load.h"
+#include "bplus_block.h"
+#include "bplus_datanode.h"
+#include "bplus_file_funcs.h"
+#include "bplus_filter.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+// οι κομβοι ενος επιπεδου που εχουν γραφτει, με τη σειρα των κλειδιων τους
+typedef struct {
+  unsigned char *keys;  // το πρωτο κλειδι καθε κομβου
+  int *ids;
+  int *counts;          // εγγραφες στο υποδεντρο του
+  int count;
+  int allocated;
+} NodeList;
+
+struct BPlusBulkLoader {
+  int file_desc;
+  BPlusMeta *metadata;
+  long records;
+  int index_nodes;
+  unsigned char last_key[BPLUS_MAX_KEY_SIZE];
+  // το προτελευταιο φυλλο μενει στη μνημη ωστε το τελευταιο να μπορει να παρει
+  // εγγραφες του· τα blocks τους εχουν ηδη δεσμευτει
+  char pending[BF_BLOCK_SIZE];
+  int pending_id;                     // -1 αν δεν υπαρχει
+  char current[BF_BLOCK_SIZE];
+  int current_id;                     // -1 πριν την πρωτη εγγραφη
+  NodeList leaves;
+};
+
+static int list_append(NodeList *list, const int key_size, const unsigned char *key, const int id, const int count)
+{
+  if (list->count == list->allocated) {
+    const int allocated = list->allocated == 0 ? 256 : 2 * list->allocated;
+    unsigned char *keys = realloc(list->keys, (size_t)allocated * key_size);
+    if (keys != NULL) {
+      list->keys = keys;
+    }
+    int *ids = realloc(list->ids, allocated * sizeof(int));
+    if (ids != NULL) {
+      list->ids = ids;
+    }
+    int *counts = realloc(list->counts, allocated * sizeof(int));
+    if (counts != NULL) {
+      list->counts = counts;
+    }
+    if (keys == NULL || ids == NULL || counts == NULL) {
+      return -1;
+    }
+    list->allocated = allocated;
+  }
+  memcpy(list->keys + (size_t)list->count * key_size, key, key_size);
+  list->ids[list->count] = id;
+  list->counts[list->count] = count;
+  list->count++;
+  return 0;
+}
+
+static void list_free(NodeList *list)
+{
+  free(list->keys);
+  free(list->ids);
+  free(list->counts);
+}
+
+// Νεο block με περιεχομενο data, ή αδειο φυλλο αν data == NULL (μεσα σε πραξη)
+static int new_block(const int file_desc, BPlusMeta *metadata, const char *data)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  const int block_id = bplus_allocate_block(file_desc, metadata, block);
+  if (block_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+  if (data != NULL) {
+    memcpy(BF_Block_GetData(block), data, BF_BLOCK_SIZE);
+  } else {
+    datanode_init(BF_Block_GetData(block));
+  }
+  CALL_BF(bplus_set_dirty(file_desc, block_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return block_id;
+}
+
+// Γραφει ενα τελειωμενο φυλλο στο block του και το βαζει στη λιστα (μεσα σε πραξη)
+static int store_leaf(BPlusBulkLoader *loader, char *data, const int block_id)
+{
+  const BPlusMeta *metadata = loader->metadata;
+  BF_Block *block;
+  BF_Block_Init(&block);
+  CALL_BF(bplus_get_block(loader->file_desc, block_id, block));
+  memcpy(BF_Block_GetData(block), data, BF_BLOCK_SIZE);
+  CALL_BF(bplus_set_dirty(loader->file_desc, block_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  datanode_key(data, &metadata->table_schema, metadata->leaf_capacity, 0, key);
+  return list_append(&loader->leaves, metadata->table_schema.key_size, key, block_id,
+                     ((BPlusDataNode *)data)->key_count);
+}
+
+BPlusBulkLoader *bplus_bulk_load_create(const int file_desc, BPlusMeta *metadata)
+{
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return NULL;
+  }
+  if (metadata->root_block_num != -1) {
+    return NULL;
+  }
+
+  BPlusBulkLoader *loader = calloc(1, sizeof(BPlusBulkLoader));
+  if (loader == NULL) {
+    return NULL;
+  }
+  loader->file_desc = file_desc;
+  loader->metadata = metadata;
+  loader->pending_id = -1;
+  loader->current_id = -1;
+  return loader;
+}
+
+int bplus_bulk_load_add(BPlusBulkLoader *loader, const Record *record)
+{
+  BPlusMeta *metadata = loader->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  const int capacity = metadata->leaf_capacity;
+  const int file_desc = loader->file_desc;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(schema, record, key);
+  if (loader->records > 0 && memcmp(key, loader->last_key, schema->key_size) <= 0) {
+    return 1;
+  }
+
+  // πρωτο φυλλο, ή γεματο φυλλο: το block του επομενου δεσμευεται τωρα, ωστε
+  // το next_block του προηγουμενου να ειναι γνωστο οταν γραφτει
+  BPlusDataNode *current = (BPlusDataNode *)loader->current;
+  if (loader->current_id == -1 || current->key_count == capacity) {
+    bplus_begin_op(file_desc);
+    const int next_id = new_block(file_desc, metadata, NULL);
+    int result = next_id == -1 ? -1 : 0;
+    if (result == 0 && loader->pending_id != -1) {
+      ((BPlusDataNode *)loader->pending)->next_block = loader->current_id;
+      result = store_leaf(loader, loader->pending, loader->pending_id);
+    }
+    if (bplus_commit_op(file_desc) == -1 || result == -1) {
+      return -1;
+    }
+
+    if (loader->current_id != -1) {
+      memcpy(loader->pending, loader->current, BF_BLOCK_SIZE);
+      loader->pending_id = loader->current_id;
+    }
+    loader->current_id = next_id;
+    datanode_init(loader->current);
+  }
+
+  datanode_insert_at(loader->current, schema, capacity, current->key_count, record);
+  memcpy(loader->last_key, key, schema->key_size);
+  loader->records++;
+  return 0;
+}
+
+// Χτιζει το επιπεδο πανω απο τους κομβους του below: ceil(n / (capacity + 1)) κομβοι
+// με ισα μεριδια παιδιων, ωστε ολοι να εχουν τουλαχιστον capacity / 2 κλειδια
+static int build_level(BPlusBulkLoader *loader, const NodeList *below, NodeList *level)
+{
+  BPlusMeta *metadata = loader->metadata;
+  const int capacity = metadata->index_capacity;
+  const int key_size = metadata->table_schema.key_size;
+  const int nodes = (below->count + capacity) / (capacity + 1);
+  char data[BF_BLOCK_SIZE];
+  memset(data, 0, sizeof(data));
+
+  int first = 0;
+  for (int node = 0; node < nodes; node++) {
+    const int children = below->count / nodes + (node < below->count % nodes);
+    indexnode_init(data, capacity, below->ids[first]);
+    indexnode_counts(data, capacity)[0] = below->counts[first];
+    int total = below->counts[first];
+    for (int i = 1; i < children; i++) {
+      indexnode_insert_at(data, capacity, key_size, i - 1, below->keys + (size_t)(first + i) * key_size,
+                          below->ids[first + i], below->counts[first + i]);
+      total += below->counts[first + i];
+    }
+
+    bplus_begin_op(loader->file_desc);
+    const int block_id = new_block(loader->file_desc, metadata, data);
+    if (bplus_commit_op(loader->file_desc) == -1 || block_id == -1 ||
+        list_append(level, key_size, below->keys + (size_t)first * key_size, block_id, total) == -1) {
+      return -1;
+    }
+    loader->index_nodes++;
+    first += children;
+  }
+  return 0;
+}
+
+static void loader_free(BPlusBulkLoader *loader)
+{
+  list_free(&loader->leaves);
+  free(loader);
+}
+
+long bplus_bulk_load_finish(BPlusBulkLoader *loader)
+{
+  BPlusMeta *metadata = loader->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  const int capacity = metadata->leaf_capacity;
+  const int file_desc = loader->file_desc;
+  const long records = loader->records;
+  if (loader->current_id == -1) {
+    loader_free(loader);
+    return 0;
+  }
+
+  // το τελευταιο φυλλο παιρνει απο το προτελευταιο (γεματο) οσες του λειπουν για το μισο
+  BPlusDataNode *current = (BPlusDataNode *)loader->current;
+  if (loader->pending_id != -1) {
+    while (current->key_count < capacity / 2) {
+      datanode_borrow_left(loader->current, loader->pending, schema, capacity);
+    }
+  }
+
+  bplus_begin_op(file_desc);
+  int result = 0;
+  if (loader->pending_id != -1) {
+    ((BPlusDataNode *)loader->pending)->next_block = loader->current_id;
+    result = store_leaf(loader, loader->pending, loader->pending_id);
+  }
+  current->next_block = -1;
+  if (result == 0) {
+    result = store_leaf(loader, loader->current, loader->current_id);
+  }
+  if (bplus_commit_op(file_desc) == -1 || result == -1) {
+    loader_free(loader);
+    return -1;
+  }
+
+  // τα επιπεδα ευρετηριου, ωσπου να μεινει ενας κομβος: η ριζα
+  NodeList below = loader->leaves;
+  memset(&loader->leaves, 0, sizeof(NodeList));
+  const int leaves = below.count;
+  int depth = 1;
+  while (result == 0 && below.count > 1) {
+    NodeList level = {0};
+    result = build_level(loader, &below, &level);
+    list_free(&below);
+    below = level;
+    depth++;
+  }
+
+  // το δεντρο φαινεται μονο τωρα, με μια πραξη που γραφει τα metadata
+  if (result == 0) {
+    bplus_begin_op(file_desc);
+    metadata->root_block_num = below.ids[0];
+    metadata->depth = depth;
+    metadata->data_block_count += leaves;
+    metadata->index_block_count += loader->index_nodes;
+    result = bplus_commit_op(file_desc);
+  }
+  list_free(&below);
+  loader_free(loader);
+
+  // το φιλτρο ξαναχτιζεται για τα νεα κλειδια
+  const BPlusFilter *filter = filter_of(file_desc);
+  if (result == 0 && filter != NULL) {
+    result = bplus_filter_enable(file_desc, metadata, filter->bits_per_key);
+  }
+  return result == -1 ? -1 : records;
+}
+
+void bplus_bulk_load_abort(BPlusBulkLoader *loader)
+{
+  loader_free(loader);
+}
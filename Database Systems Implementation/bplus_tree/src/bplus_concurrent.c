@@ -0,0 +1,625 @@
+// Ταυτόχρονη πρόσβαση στο B+ δέντρο με optimistic lock coupling.
+//
+// Κάθε κόμβος έχει έναν μετρητή έκδοσης (version) σε πίνακα στη μνήμη. Το
+// χαμηλότερο bit είναι το exclusive lock, οπότε ένα unlock (+1) αυξάνει και
+// την έκδοση. Ο αναγνώστης κρατάει την έκδοση που είδε και την ξαναελέγχει
+// αφού διαβάσει τον κόμβο: αν άλλαξε, ξεκινάει από την αρχή.
+//
+// Κάθε κρίσιμο τμήμα ενός writer είναι μια πράξη του log (wal.h) που γίνεται
+// commit πριν ξεκλειδώσουν οι κόμβοι της, οπότε κανείς άλλος δεν αλλάζει τα
+// ίδια bytes πριν το commit και το undo μιας πράξης δεν πειράζει ξένες αλλαγές.
+
+#include "bplus_concurrent.h"
+#include "bplus_file_funcs.h"
+#include "bplus_block.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bplus_filter.h"
+#include "bplus_node_cache.h"
+#include "bplus_page_pool.h"
+#include "wal.h"
+#include "bf.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOCKED_BIT 1u
+#define PIN_ATTEMPTS 10000  // προσπαθειες του pin και του allocate οσο τα frames ειναι ολα pinned
+
+// ο πινακας εκδοσεων χωριζεται σε κομματια που δεσμευονται οταν χρειαστουν
+#define VERSION_CHUNK_BITS 12
+#define VERSION_CHUNK_SIZE (1 << VERSION_CHUNK_BITS)
+#define VERSION_MAX_CHUNKS 4096
+
+typedef _Atomic uint64_t VersionLock;
+
+// Το BF δεν μετραει pins: αν δυο handles καρφιτσωσουν το ιδιο block, το
+// πρωτο unpin το ελευθερωνει. Γι αυτο κραταμε εμεις ενα pin ανα block.
+typedef struct {
+  int block_id;      // -1 αν η θεση ειναι ελευθερη
+  int pins;          // ποσα threads το χρησιμοποιουν τωρα
+  BF_Block *handle;  // το μοναδικο pin προς το BF
+} PinnedFrame;
+
+struct BPlusSharedTree {
+  int file_desc;
+  BPlusMeta *metadata;
+  Wal *wal;                             // NULL αν το αρχειο δεν εχει log
+  VersionLock meta_version;             // προστατευει root_block_num και depth
+  _Atomic(VersionLock *) chunks[VERSION_MAX_CHUNKS];
+  _Atomic long restarts;
+  PinnedFrame frames[BF_BUFFER_SIZE];   // προστατευεται απο το bf_mutex
+};
+
+// το επιπεδο BF δεν ειναι thread safe, ολες οι κλησεις του περνανε απο εδω
+static pthread_mutex_t bf_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static VersionLock *version_of(BPlusSharedTree *tree, const int block_id)
+{
+  const int index = block_id >> VERSION_CHUNK_BITS;
+  if (index >= VERSION_MAX_CHUNKS) {
+    return NULL;
+  }
+
+  VersionLock *chunk = atomic_load_explicit(&tree->chunks[index], memory_order_acquire);
+  if (chunk == NULL) {
+    VersionLock *fresh = calloc(VERSION_CHUNK_SIZE, sizeof(VersionLock));
+    if (fresh == NULL) {
+      return NULL;
+    }
+    // αν καποιο αλλο thread προλαβε, κραταμε το δικο του
+    if (atomic_compare_exchange_strong(&tree->chunks[index], &chunk, fresh)) {
+      chunk = fresh;
+    } else {
+      free(fresh);
+    }
+  }
+
+  return &chunk[block_id & (VERSION_CHUNK_SIZE - 1)];
+}
+
+static int read_lock(VersionLock *lock, uint64_t *version)
+{
+  const uint64_t v = atomic_load_explicit(lock, memory_order_acquire);
+  if (v & LOCKED_BIT) {
+    return 0;
+  }
+  *version = v;
+  return 1;
+}
+
+static int validate(VersionLock *lock, const uint64_t version)
+{
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(lock, memory_order_relaxed) == version;
+}
+
+static int upgrade(VersionLock *lock, uint64_t version)
+{
+  return atomic_compare_exchange_strong(lock, &version, version | LOCKED_BIT);
+}
+
+static void write_unlock(VersionLock *lock)
+{
+  atomic_fetch_add_explicit(lock, LOCKED_BIT, memory_order_release);
+}
+
+static PinnedFrame *find_frame(BPlusSharedTree *tree, const int block_id)
+{
+  for (int i = 0; i < BF_BUFFER_SIZE; i++) {
+    if (tree->frames[i].block_id == block_id) {
+      return &tree->frames[i];
+    }
+  }
+  return NULL;
+}
+
+// Καρφιτσωνει το block (μια φορα στο BF οσα threads κι αν το ζητησουν). Αν ολα
+// τα frames ή ολη η μνημη του BF ειναι pinned απο αλλα threads, που θα τα αφησουν
+// συντομα, ξαναδοκιμαζει· NULL μονο αν το block δεν διαβαζεται ή αν δεν ελευθερωθηκε
+// τιποτα μετα απο PIN_ATTEMPTS προσπαθειες.
+static char *pin(BPlusSharedTree *tree, const int block_id)
+{
+  char *data = NULL;
+  BF_ErrorCode code = BF_FULL_MEMORY_ERROR;
+
+  for (int attempt = 0; data == NULL && code == BF_FULL_MEMORY_ERROR && attempt < PIN_ATTEMPTS; attempt++) {
+    if (attempt > 0) {
+      sched_yield();
+    }
+    pthread_mutex_lock(&bf_mutex);
+
+    PinnedFrame *frame = find_frame(tree, block_id);
+    if (frame != NULL) {
+      frame->pins++;
+      data = BF_Block_GetData(frame->handle);
+    } else if ((frame = find_frame(tree, -1)) != NULL) {
+      code = BF_GetBlock(tree->file_desc, block_id, frame->handle);
+      if (code == BF_OK) {
+        frame->block_id = block_id;
+        frame->pins = 1;
+        data = BF_Block_GetData(frame->handle);
+      }
+    }
+
+    pthread_mutex_unlock(&bf_mutex);
+  }
+
+  if (data == NULL) {
+    BF_PrintError(code);
+  }
+  return data;
+}
+
+static void unpin(BPlusSharedTree *tree, const int block_id, const int dirty)
+{
+  pthread_mutex_lock(&bf_mutex);
+
+  PinnedFrame *frame = find_frame(tree, block_id);
+  if (frame != NULL) {
+    if (dirty) {
+      BF_Block_SetDirty(frame->handle);
+    }
+    if (--frame->pins == 0) {
+      BF_UnpinBlock(frame->handle);
+      frame->block_id = -1;
+    }
+  }
+
+  pthread_mutex_unlock(&bf_mutex);
+}
+
+static void begin(BPlusSharedTree *tree, WalOp *op)
+{
+  if (tree->wal != NULL) {
+    op->nesting = 0;
+    wal_begin(tree->wal, op);
+  }
+}
+
+static int commit(BPlusSharedTree *tree, WalOp *op)
+{
+  return tree->wal == NULL ? 0 : wal_commit(tree->wal, op);
+}
+
+// ο κομβος ειναι κλειδωμενος απο εμας: κραταμε την εικονα του για το undo
+static int track(BPlusSharedTree *tree, WalOp *op, const int block_id, const char *data)
+{
+  return tree->wal == NULL ? 0 : wal_track(op, block_id, data);
+}
+
+// unpin κομβου που αλλαξε, αφου γραφτουν οι αλλαγες του στο log
+static int release(BPlusSharedTree *tree, WalOp *op, const int block_id, const char *data)
+{
+  const int result = tree->wal == NULL ? 0 : wal_log_page(tree->wal, op, block_id, data);
+  unpin(tree, block_id, 1);
+  return result;
+}
+
+// νεα ριζα, με κλειδωμενο το meta lock. Και αυτο το πεδιο του meta αλλαζει
+// μονο κατω απο το bf_mutex, ωστε καθε αλλαγη να γραφεται στην πραξη που την εκανε
+static int set_root(BPlusSharedTree *tree, WalOp *op, const int root_id, const int depth)
+{
+  int result = 0;
+  pthread_mutex_lock(&bf_mutex);
+  tree->metadata->root_block_num = root_id;
+  tree->metadata->depth = depth;
+  if (tree->wal != NULL) {
+    result = wal_log_metadata(tree->wal, op, 0);
+  }
+  pthread_mutex_unlock(&bf_mutex);
+  return result;
+}
+
+// Νεο block για κομβο (μενει pinned), οι μετρητες του meta αλλαζουν μονο κατω απο το bf_mutex.
+// Αυτες οι αλλαγες δεν αναιρουνται ποτε: αλλα threads μπορει να εχουν δεσμευσει blocks στο μεταξυ.
+static char *allocate(BPlusSharedTree *tree, WalOp *op, int *block_id, const int is_leaf)
+{
+  char *data = NULL;
+  pthread_mutex_lock(&bf_mutex);
+
+  // οπως στο pin, περιμενουμε να ελευθερωσει frame καποιο αλλο thread
+  PinnedFrame *frame = find_frame(tree, -1);
+  for (int attempt = 1; frame == NULL && attempt < PIN_ATTEMPTS; attempt++) {
+    pthread_mutex_unlock(&bf_mutex);
+    sched_yield();
+    pthread_mutex_lock(&bf_mutex);
+    frame = find_frame(tree, -1);
+  }
+  if (frame != NULL) {
+    *block_id = bplus_allocate_block(tree->file_desc, tree->metadata, frame->handle);
+    if (*block_id != -1) {
+      frame->block_id = *block_id;
+      frame->pins = 1;
+      data = BF_Block_GetData(frame->handle);
+      if (is_leaf) {
+        tree->metadata->data_block_count++;
+      } else {
+        tree->metadata->index_block_count++;
+      }
+      if (tree->wal != NULL &&
+          (wal_track(op, *block_id, data) == -1 || wal_log_metadata(tree->wal, op, 1) == -1)) {
+        data = NULL;
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&bf_mutex);
+  return data;
+}
+
+static void backoff(BPlusSharedTree *tree)
+{
+  atomic_fetch_add_explicit(&tree->restarts, 1, memory_order_relaxed);
+  sched_yield();
+}
+
+// Προσθέτει separator στον γονέα, που είναι ήδη κλειδωμένος και έχει χώρο.
+// parent_id == -1 σημαίνει ότι έσπασε η ρίζα (και κρατάμε το meta lock).
+static int add_to_parent(BPlusSharedTree *tree, WalOp *op, const int parent_id, const int left_child,
+                         const unsigned char *key, const int right_child)
+{
+  BPlusMeta *metadata = tree->metadata;
+  const int capacity = metadata->index_capacity;
+  const int key_size = metadata->table_schema.key_size;
+
+  if (parent_id == -1) {
+    int root_id;
+    char *data = allocate(tree, op, &root_id, 0);
+    if (data == NULL) {
+      return -1;
+    }
+    indexnode_init(data, capacity, left_child);
+    indexnode_insert_at(data, capacity, key_size, 0, key, right_child, 0);
+    if (release(tree, op, root_id, data) == -1) {
+      return -1;
+    }
+    return set_root(tree, op, root_id, metadata->depth + 1);
+  }
+
+  char *data = pin(tree, parent_id);
+  if (data == NULL) {
+    return -1;
+  }
+  if (track(tree, op, parent_id, data) == -1) {
+    unpin(tree, parent_id, 0);
+    return -1;
+  }
+  const int pos = indexnode_child_slot(data, capacity, key_size, key);
+  indexnode_insert_at(data, capacity, key_size, pos, key, right_child, 0);
+  return release(tree, op, parent_id, data);
+}
+
+BPlusSharedTree *bplus_shared_open(const int file_desc, BPlusMeta *metadata)
+{
+  // τα threads δεν βλεπουν το buffer εισαγωγων, οι εγγραφες του μπαινουν πρωτα στο δεντρο
+  if (bplus_insert_buffer_enable(file_desc, metadata, 0) == -1) {
+    return NULL;
+  }
+  // οι writers αλλαζουν κομβους χωρις να περνουν απο την cache των πανω επιπεδων,
+  // και το page pool δεν ειναι thread safe
+  node_cache_destroy(file_desc);
+  page_pool_detach(file_desc);
+
+  // τα πληθη των υποδεντρων θελουν lock σε ολη τη διαδρομη, οποτε οι writers
+  // δεν τα ενημερωνουν: ξαναμετριουνται στο επομενο bplus_count_range / bplus_select_kth
+  bplus_begin_op(file_desc);
+  metadata->counts_stale = 1;
+  if (bplus_commit_op(file_desc) == -1) {
+    return NULL;
+  }
+  BPlusSharedTree *tree = calloc(1, sizeof(BPlusSharedTree));
+  if (tree == NULL) {
+    return NULL;
+  }
+  tree->file_desc = file_desc;
+  tree->metadata = metadata;
+  tree->wal = wal_of(file_desc);
+  for (int i = 0; i < BF_BUFFER_SIZE; i++) {
+    tree->frames[i].block_id = -1;
+    BF_Block_Init(&tree->frames[i].handle);
+  }
+  return tree;
+}
+
+void bplus_shared_close(BPlusSharedTree *tree)
+{
+  if (tree == NULL) {
+    return;
+  }
+  node_cache_destroy(tree->file_desc);
+  page_pool_attach(tree->file_desc);
+  for (int i = 0; i < VERSION_MAX_CHUNKS; i++) {
+    free(atomic_load(&tree->chunks[i]));
+  }
+  for (int i = 0; i < BF_BUFFER_SIZE; i++) {
+    BF_Block_Destroy(&tree->frames[i].handle);
+  }
+  free(tree);
+}
+
+long bplus_shared_restarts(const BPlusSharedTree *tree)
+{
+  return atomic_load((_Atomic long *)&tree->restarts);
+}
+
+// Αναζητηση με κανονικοποιημενο κλειδι. Τα key_count διαβαζονται χωρις lock,
+// αλλα οι writers γραφουν παντα τιμες μεσα στο [0, capacity], οποτε καθε
+// αναζητηση μενει μεσα στο block, ακομα κι αν το αποτελεσμα της απορριφθει.
+static int shared_find(BPlusSharedTree *tree, const unsigned char *key, Record *out_record)
+{
+  const BPlusMeta *metadata = tree->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  int result = -1;
+  uint64_t meta_v, v, child_v;
+  VersionLock *lock, *child_lock;
+  Record found;
+
+  // το φιλτρο μαθαινει καθε κλειδι πριν φανει στο φυλλο, οποτε μια αρνηση ειναι σιγουρη
+  const BPlusFilter *filter = filter_of(tree->file_desc);
+  if (filter != NULL && !filter_may_contain(filter, key)) {
+    return -1;
+  }
+
+restart:
+  if (!read_lock(&tree->meta_version, &meta_v)) goto retry;
+  int node_id = metadata->root_block_num;
+  const int depth = metadata->depth;
+  if (!validate(&tree->meta_version, meta_v)) goto retry;
+
+  if (node_id == -1) {
+    goto done;
+  }
+
+  lock = version_of(tree, node_id);
+  if (lock == NULL) goto fail;
+  if (!read_lock(lock, &v)) goto retry;
+  if (!validate(&tree->meta_version, meta_v)) goto retry;
+
+  for (int level = 0; level < depth - 1; level++) {
+    char *data = pin(tree, node_id);
+    if (data == NULL) goto fail;
+    const int child = indexnode_child(data, metadata->index_capacity, schema->key_size, key);
+    unpin(tree, node_id, 0);
+
+    // ο κομβος μπορει να αλλαξε οσο τον διαβαζαμε
+    if (!validate(lock, v)) goto retry;
+    child_lock = version_of(tree, child);
+    if (child_lock == NULL) goto retry;
+    if (!read_lock(child_lock, &child_v)) goto retry;
+    if (!validate(lock, v)) goto retry;
+
+    node_id = child;
+    lock = child_lock;
+    v = child_v;
+  }
+
+  char *data = pin(tree, node_id);
+  if (data == NULL) goto fail;
+  int hit;
+  const int pos = datanode_search(data, schema, metadata->leaf_capacity, key, &hit);
+  if (hit) {
+    record_deserialize(schema, datanode_record(data, schema, metadata->leaf_capacity, pos), &found);
+  }
+  unpin(tree, node_id, 0);
+  if (!validate(lock, v)) goto retry;
+
+  if (hit) {
+    *out_record = found;
+    result = 0;
+  }
+
+done:
+  return result;
+
+fail:
+  return BPLUS_SHARED_ERROR;
+
+retry:
+  backoff(tree);
+  goto restart;
+}
+
+int bplus_shared_find(BPlusSharedTree *tree, const int key, Record *out_record)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+  if (bplus_key_from_int(&tree->metadata->table_schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_shared_find_by_key\n");
+    return BPLUS_SHARED_ERROR;
+  }
+  return shared_find(tree, normalized, out_record);
+}
+
+int bplus_shared_find_by_key(BPlusSharedTree *tree, const Record *key_record, Record *out_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&tree->metadata->table_schema, key_record, key);
+  return shared_find(tree, key, out_record);
+}
+
+int bplus_shared_insert(BPlusSharedTree *tree, const Record *record)
+{
+  BPlusMeta *metadata = tree->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  const int capacity = metadata->leaf_capacity;
+  const int index_capacity = metadata->index_capacity;
+  int result = BPLUS_SHARED_ERROR;
+  uint64_t v, parent_v, child_v;
+  VersionLock *lock, *parent_lock, *child_lock;
+  int node_id, parent_id, new_id;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  WalOp op;
+  bplus_key_from_record(schema, record, key);
+
+  BPlusFilter *filter = filter_of(tree->file_desc);
+  if (filter != NULL) {
+    filter_add(filter, key);
+  }
+
+restart:
+  // το meta παιζει τον ρολο του "γονεα" της ριζας
+  parent_id = -1;
+  parent_lock = &tree->meta_version;
+  if (!read_lock(parent_lock, &parent_v)) goto retry;
+  node_id = metadata->root_block_num;
+  const int depth = metadata->depth;
+  if (!validate(parent_lock, parent_v)) goto retry;
+
+  // αδειο δεντρο - το πρωτο φυλλο γινεται ριζα
+  if (node_id == -1) {
+    if (!upgrade(parent_lock, parent_v)) goto retry;
+    begin(tree, &op);
+    char *data = allocate(tree, &op, &node_id, 1);
+    if (data != NULL) {
+      datanode_init(data);
+      datanode_insert_at(data, schema, capacity, 0, record);
+      if (release(tree, &op, node_id, data) != -1 && set_root(tree, &op, node_id, 1) != -1) {
+        result = node_id;
+      }
+    }
+    if (commit(tree, &op) == -1) {
+      result = BPLUS_SHARED_ERROR;
+    }
+    write_unlock(parent_lock);
+    goto done;
+  }
+
+  lock = version_of(tree, node_id);
+  if (lock == NULL) goto done;
+  if (!read_lock(lock, &v)) goto retry;
+  if (!validate(parent_lock, parent_v)) goto retry;
+
+  for (int level = 0; level < depth - 1; level++) {
+    char *data = pin(tree, node_id);
+    if (data == NULL) goto done;
+    const int count = ((BPlusIndexNode *)data)->key_count;
+
+    // γεματος εσωτερικος κομβος: τον σπαμε τωρα ωστε ο γονεας καθε split να εχει χωρο
+    if (count == index_capacity) {
+      if (!upgrade(parent_lock, parent_v)) {
+        unpin(tree, node_id, 0);
+        goto retry;
+      }
+      if (!upgrade(lock, v)) {
+        write_unlock(parent_lock);
+        unpin(tree, node_id, 0);
+        goto retry;
+      }
+
+      begin(tree, &op);
+      int failed = track(tree, &op, node_id, data) == -1;
+      char *new_data = failed ? NULL : allocate(tree, &op, &new_id, 0);
+      failed = new_data == NULL;
+      if (!failed) {
+        unsigned char middle[BPLUS_MAX_KEY_SIZE];
+        indexnode_split_half(data, new_data, index_capacity, schema->key_size, middle);
+        failed = release(tree, &op, new_id, new_data) == -1;
+        failed = failed || add_to_parent(tree, &op, parent_id, node_id, middle, new_id) == -1;
+      }
+
+      failed = release(tree, &op, node_id, data) == -1 || failed;
+      failed = commit(tree, &op) == -1 || failed;
+      write_unlock(lock);
+      write_unlock(parent_lock);
+      if (failed) goto done;
+      goto restart;
+    }
+
+    const int child = indexnode_child(data, index_capacity, schema->key_size, key);
+    unpin(tree, node_id, 0);
+
+    if (!validate(lock, v)) goto retry;
+    child_lock = version_of(tree, child);
+    if (child_lock == NULL) goto retry;
+    if (!read_lock(child_lock, &child_v)) goto retry;
+    if (!validate(lock, v)) goto retry;
+
+    parent_id = node_id;
+    parent_lock = lock;
+    parent_v = v;
+    node_id = child;
+    lock = child_lock;
+    v = child_v;
+  }
+
+  // φτασαμε στο φυλλο
+  char *data = pin(tree, node_id);
+  if (data == NULL) goto done;
+  const int count = ((BPlusDataNode *)data)->key_count;
+  int found;
+  const int pos = datanode_search(data, schema, capacity, key, &found);
+
+  // διπλοτυπο - ισχυει μονο αν ο κομβος δεν αλλαξε στο μεταξυ
+  if (found) {
+    unpin(tree, node_id, 0);
+    if (!validate(lock, v)) goto retry;
+    result = -1;
+    goto done;
+  }
+
+  if (count < capacity) {
+    if (!upgrade(lock, v)) {
+      unpin(tree, node_id, 0);
+      goto retry;
+    }
+    begin(tree, &op);
+    if (track(tree, &op, node_id, data) != -1) {
+      datanode_insert_at(data, schema, capacity, pos, record);
+      if (release(tree, &op, node_id, data) != -1) {
+        result = node_id;
+      }
+    } else {
+      unpin(tree, node_id, 0);
+    }
+    if (commit(tree, &op) == -1) {
+      result = BPLUS_SHARED_ERROR;
+    }
+    write_unlock(lock);
+    goto done;
+  }
+
+  // γεματο φυλλο: κλειδωνουμε γονεα και φυλλο και το σπαμε
+  if (!upgrade(parent_lock, parent_v)) {
+    unpin(tree, node_id, 0);
+    goto retry;
+  }
+  if (!upgrade(lock, v)) {
+    write_unlock(parent_lock);
+    unpin(tree, node_id, 0);
+    goto retry;
+  }
+
+  begin(tree, &op);
+  char *new_data = track(tree, &op, node_id, data) == -1 ? NULL : allocate(tree, &op, &new_id, 1);
+  if (new_data != NULL) {
+    datanode_init(new_data);
+    int in_new;
+    unsigned char separator[BPLUS_MAX_KEY_SIZE];
+    datanode_split(data, new_data, schema, capacity, pos, record, &in_new, separator);
+    ((BPlusDataNode *)new_data)->next_block = ((BPlusDataNode *)data)->next_block;
+    ((BPlusDataNode *)data)->next_block = new_id;
+
+    if (release(tree, &op, new_id, new_data) != -1 &&
+        add_to_parent(tree, &op, parent_id, node_id, separator, new_id) != -1) {
+      result = in_new ? new_id : node_id;
+    }
+  }
+
+  if (release(tree, &op, node_id, data) == -1 || commit(tree, &op) == -1) {
+    result = BPLUS_SHARED_ERROR;
+  }
+  write_unlock(lock);
+  write_unlock(parent_lock);
+
+done:
+  return result;
+
+retry:
+  backoff(tree);
+  goto restart;
+}
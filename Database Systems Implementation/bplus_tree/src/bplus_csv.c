@@ -0,0 +1,446 @@
+// Φόρτωση CSV: το αρχείο γίνεται mmap και κόβεται σε κομμάτια στα όρια γραμμών,
+// νήματα τα μετατρέπουν παράλληλα σε packed εγγραφές και το νήμα που κάλεσε τα
+// παραδίδει με τη σειρά του αρχείου σε έναν sink (π.χ. insert σε B+ αρχείο).
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bplus_bulk_load.h"
+#include "bplus_csv.h"
+#include "bplus_file_funcs.h"
+#include "bplus_insert_buffer.h"
+#include "bplus_key.h"
+#include "record_generator.h"
+
+#define NO_ERROR SIZE_MAX
+#define NUMBER_LENGTH 64  // το μεγαλυτερο πεδιο αριθμου που δεχομαστε
+
+typedef struct {
+  char *records;    // packed εγγραφες του κομματιου
+  size_t capacity;  // bytes του records
+  int count;
+  int ready;        // 1 οταν τελειωσει το parsing
+  size_t error;     // offset της πρωτης κακης γραμμης, NO_ERROR αν δεν υπαρχει
+} CsvSlot;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  size_t body;  // αρχη της πρωτης γραμμης δεδομενων (μετα το header)
+  size_t chunk_size;
+  long chunk_count;
+  const TableSchema *schema;
+  char delimiter;
+
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  long next_chunk;  // το επομενο κομματι που θα παρει ενα νημα
+  long consumed;    // κομματια που εχουν παει στον sink
+  int window;       // κομματια που μπορει να ειναι ταυτοχρονα στη μνημη
+  int stop;
+  CsvSlot *slots;   // το κομματι c ζει στο slots[c % window]
+} CsvLoad;
+
+void bplus_csv_options_default(BPlusCsvOptions *options)
+{
+  options->delimiter = ',';
+  options->header = 0;
+  options->threads = 0;
+  options->chunk_size = BPLUS_CSV_CHUNK_SIZE;
+}
+
+// η αρχη της πρωτης γραμμης που ξεκινα στο offset ή μετα
+static size_t line_start(const CsvLoad *load, const size_t offset)
+{
+  if (offset <= load->body) {
+    return load->body;
+  }
+  if (offset >= load->size) {
+    return load->size;
+  }
+  const char *newline = memchr(load->data + offset - 1, '\n', load->size - offset + 1);
+  return newline != NULL ? (size_t)(newline - load->data) + 1 : load->size;
+}
+
+// Διαβαζει ενα πεδιο απο το *pos ως το delimiter ή το τελος της γραμμης. Τα bytes
+// του πεδιου (χωρις εισαγωγικα) πανε στο out, ως max, και επιστρεφεται το μηκος
+// τους ή -1 για λαθος εισαγωγικα. Το *pos μενει στο delimiter ή στο end.
+static int read_field(const char **pos, const char *end, const char delimiter, char *out, const int max)
+{
+  const char *p = *pos;
+  int length = 0;
+  if (p < end && *p == '"') {
+    p++;
+    for (;;) {
+      if (p == end) {
+        return -1;
+      }
+      if (*p == '"') {
+        if (p + 1 < end && p[1] == '"') {
+          p++;
+        } else {
+          p++;
+          break;
+        }
+      }
+      if (length < max) {
+        out[length] = *p;
+      }
+      length++;
+      p++;
+    }
+    if (p < end && *p != delimiter) {
+      return -1;
+    }
+  } else {
+    while (p < end && *p != delimiter) {
+      if (length < max) {
+        out[length] = *p;
+      }
+      length++;
+      p++;
+    }
+  }
+  *pos = p;
+  return length;
+}
+
+static int parse_int(const char *text, const int length, int *value)
+{
+  const int sign = length > 0 && (text[0] == '-' || text[0] == '+');
+  const int negative = sign && text[0] == '-';
+  int i = sign;
+  if (i == length || length - i > 10) {
+    return -1;
+  }
+  long long result = 0;
+  for (; i < length; i++) {
+    if (text[i] < '0' || text[i] > '9') {
+      return -1;
+    }
+    result = result * 10 + (text[i] - '0');
+  }
+  result = negative ? -result : result;
+  if (result < INT32_MIN || result > INT32_MAX) {
+    return -1;
+  }
+  *value = (int)result;
+  return 0;
+}
+
+static int parse_float(char *text, const int length, float *value)
+{
+  if (length == 0 || length >= NUMBER_LENGTH) {
+    return -1;
+  }
+  text[length] = '\0';
+  char *end;
+  *value = strtof(text, &end);
+  return end == text + length ? 0 : -1;
+}
+
+// μια γραμμη [line, end) στη μορφη του σχηματος, στο packed
+static int parse_line(const TableSchema *schema, const char delimiter, const char *line, const char *end, char *packed)
+{
+  char field[NUMBER_LENGTH];
+  const char *pos = line;
+  for (int c = 0; c < schema->count; c++) {
+    if (c > 0) {
+      if (pos == end) {
+        return -1;  // λειπουν πεδια
+      }
+      pos++;  // το delimiter
+    }
+    const AttributeSchema *attr = &schema->attributes[c];
+    char *out = packed + schema->offsets[c];
+    if (attr->type == TYPE_CHAR) {
+      memset(out, 0, attr->length);
+      if (read_field(&pos, end, delimiter, out, attr->length) == -1) {
+        return -1;
+      }
+      continue;
+    }
+    const int length = read_field(&pos, end, delimiter, field, NUMBER_LENGTH);
+    if (length == -1 || length >= NUMBER_LENGTH) {
+      return -1;
+    }
+    if (attr->type == TYPE_INT) {
+      int value;
+      if (parse_int(field, length, &value) == -1) {
+        return -1;
+      }
+      memcpy(out, &value, sizeof(int));
+    } else {
+      float value;
+      if (parse_float(field, length, &value) == -1) {
+        return -1;
+      }
+      memcpy(out, &value, sizeof(float));
+    }
+  }
+  return pos == end ? 0 : -1;  // περισσοτερα πεδια απο το σχημα
+}
+
+static void parse_chunk(const CsvLoad *load, const long chunk, CsvSlot *slot)
+{
+  const int record_size = load->schema->record_size;
+  const char *pos = load->data + line_start(load, (size_t)chunk * load->chunk_size);
+  const char *stop = load->data + line_start(load, (size_t)(chunk + 1) * load->chunk_size);
+  slot->count = 0;
+  slot->error = NO_ERROR;
+
+  while (pos < stop) {
+    const char *newline = memchr(pos, '\n', stop - pos);
+    const char *next = newline != NULL ? newline + 1 : stop;
+    const char *end = newline != NULL ? newline : stop;
+    if (end > pos && end[-1] == '\r') {
+      end--;
+    }
+    if (end > pos) {
+      if ((size_t)(slot->count + 1) * record_size > slot->capacity) {
+        const size_t capacity = slot->capacity == 0 ? 1024 * (size_t)record_size : 2 * slot->capacity;
+        char *records = realloc(slot->records, capacity);
+        if (records == NULL) {
+          slot->error = (size_t)(pos - load->data);
+          return;
+        }
+        slot->records = records;
+        slot->capacity = capacity;
+      }
+      if (parse_line(load->schema, load->delimiter, pos, end, slot->records + (size_t)slot->count * record_size) ==
+          -1) {
+        slot->error = (size_t)(pos - load->data);
+        return;
+      }
+      slot->count++;
+    }
+    pos = next;
+  }
+}
+
+static void *parse_worker(void *arg)
+{
+  CsvLoad *load = arg;
+  pthread_mutex_lock(&load->lock);
+  while (!load->stop && load->next_chunk < load->chunk_count) {
+    // το slot του κομματιου ελευθερωνεται οταν ο sink παρει το κομματι window θεσεις πιο πισω
+    if (load->next_chunk >= load->consumed + load->window) {
+      pthread_cond_wait(&load->changed, &load->lock);
+      continue;
+    }
+    const long chunk = load->next_chunk++;
+    CsvSlot *slot = &load->slots[chunk % load->window];
+    pthread_mutex_unlock(&load->lock);
+
+    parse_chunk(load, chunk, slot);
+
+    pthread_mutex_lock(&load->lock);
+    slot->ready = 1;
+    pthread_cond_broadcast(&load->changed);
+  }
+  pthread_mutex_unlock(&load->lock);
+  return NULL;
+}
+
+static long line_number(const char *data, const size_t offset)
+{
+  long line = 1;
+  for (const char *p = data; (p = memchr(p, '\n', offset - (p - data))) != NULL; p++) {
+    line++;
+  }
+  return line;
+}
+
+// παραδιδει τα κομματια στον sink με τη σειρα, μολις ετοιμαστει το καθενα
+static long deliver(CsvLoad *load, const char *path, const BPlusCsvSink sink, void *ctx)
+{
+  long total = 0;
+  for (long chunk = 0; chunk < load->chunk_count; chunk++) {
+    CsvSlot *slot = &load->slots[chunk % load->window];
+    pthread_mutex_lock(&load->lock);
+    while (!slot->ready) {
+      pthread_cond_wait(&load->changed, &load->lock);
+    }
+    pthread_mutex_unlock(&load->lock);
+
+    if (slot->error != NO_ERROR) {
+      fprintf(stderr, "Error: %s:%ld: malformed CSV line\n", path, line_number(load->data, slot->error));
+      return -1;
+    }
+    if (slot->count > 0 && sink(slot->records, slot->count, ctx) == -1) {
+      return -1;
+    }
+    total += slot->count;
+
+    pthread_mutex_lock(&load->lock);
+    slot->ready = 0;
+    load->consumed++;
+    pthread_cond_broadcast(&load->changed);
+    pthread_mutex_unlock(&load->lock);
+  }
+  return total;
+}
+
+long bplus_csv_read(const char *path, const TableSchema *schema, const BPlusCsvOptions *options,
+                    const BPlusCsvSink sink, void *ctx)
+{
+  BPlusCsvOptions defaults;
+  if (options == NULL) {
+    bplus_csv_options_default(&defaults);
+    options = &defaults;
+  }
+  const int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd == -1 || fstat(fd, &st) == -1) {
+    perror(path);
+    if (fd != -1) {
+      close(fd);
+    }
+    return -1;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+  char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(path);
+    return -1;
+  }
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  int threads = options->threads > 0 ? options->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+  threads = threads > 0 ? threads : 1;
+  CsvLoad load;
+  memset(&load, 0, sizeof(load));
+  load.data = data;
+  load.size = st.st_size;
+  load.chunk_size = options->chunk_size > 0 ? options->chunk_size : BPLUS_CSV_CHUNK_SIZE;
+  load.schema = schema;
+  load.delimiter = options->delimiter;
+  if (options->header) {
+    const char *newline = memchr(data, '\n', load.size);
+    load.body = newline != NULL ? (size_t)(newline - data) + 1 : load.size;
+  }
+  load.chunk_count = (long)((load.size + load.chunk_size - 1) / load.chunk_size);
+  if (threads > load.chunk_count) {
+    threads = (int)load.chunk_count;
+  }
+  load.window = 2 * threads;
+  load.slots = calloc(load.window, sizeof(CsvSlot));
+  pthread_t *workers = malloc(threads * sizeof(pthread_t));
+  if (load.slots == NULL || workers == NULL) {
+    free(load.slots);
+    free(workers);
+    munmap(data, st.st_size);
+    return -1;
+  }
+  pthread_mutex_init(&load.lock, NULL);
+  pthread_cond_init(&load.changed, NULL);
+
+  int started = 0;
+  while (started < threads && pthread_create(&workers[started], NULL, parse_worker, &load) == 0) {
+    started++;
+  }
+  const long total = started > 0 ? deliver(&load, path, sink, ctx) : -1;
+
+  pthread_mutex_lock(&load.lock);
+  load.stop = 1;
+  pthread_cond_broadcast(&load.changed);
+  pthread_mutex_unlock(&load.lock);
+  for (int t = 0; t < started; t++) {
+    pthread_join(workers[t], NULL);
+  }
+  for (int s = 0; s < load.window; s++) {
+    free(load.slots[s].records);
+  }
+  pthread_cond_destroy(&load.changed);
+  pthread_mutex_destroy(&load.lock);
+  free(load.slots);
+  free(workers);
+  munmap(data, st.st_size);
+  return total;
+}
+
+typedef struct {
+  int file_desc;
+  BPlusMeta *metadata;
+  BPlusBulkLoader *bulk;                  // οσο το αρχειο γεμιζει απο κατω προς τα πανω, αλλιως NULL
+  int bulk_rows;                          // γραμμες της φορτωσης αυτης
+  unsigned char last[BPLUS_MAX_KEY_SIZE]; // το κλειδι της τελευταιας της
+} CsvTarget;
+
+static int insert_chunk(const char *records, const int count, void *ctx)
+{
+  CsvTarget *target = ctx;
+  const TableSchema *schema = &target->metadata->table_schema;
+  const RecordDeserializer deserialize = record_deserializer(schema);
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  Record record;
+  for (int i = 0; i < count; i++) {
+    deserialize(schema, records + (size_t)i * schema->record_size, &record);
+    bplus_key_from_record(schema, &record, key);
+    // αδειο αρχειο και γραμμες με αυξουσα σειρα: φορτωση απο κατω προς τα πανω, με
+    // τις επαναληψεις του προηγουμενου κλειδιου να προσπερνιουνται. Στην πρωτη
+    // γραμμη εκτος σειρας το δεντρο ολοκληρωνεται και συνεχιζουμε με το buffer
+    if (target->bulk != NULL) {
+      if (target->bulk_rows > 0 && memcmp(key, target->last, schema->key_size) == 0) {
+        continue;
+      }
+      const int added = bplus_bulk_load_add(target->bulk, &record);
+      if (added == 0) {
+        memcpy(target->last, key, schema->key_size);
+        target->bulk_rows++;
+        continue;
+      }
+      const long loaded = added == -1 ? -1 : bplus_bulk_load_finish(target->bulk);
+      if (added == -1) {
+        bplus_bulk_load_abort(target->bulk);
+      }
+      target->bulk = NULL;
+      if (loaded == -1 ||
+          bplus_insert_buffer_enable(target->file_desc, target->metadata, BPLUS_CSV_BUFFER_RECORDS) == -1) {
+        return -1;
+      }
+    }
+
+    // κλειδι που ηδη περιμενει στο buffer: η γραμμη προσπερνιεται. Τα διπλοτυπα
+    // κλειδια του δεντρου τα πεταει το flush, οποτε καθε αλλο -1 ειναι αποτυχια
+    BPlusInsertBuffer *buffer = insert_buffer_of(target->file_desc);
+    if (buffer != NULL && insert_buffer_get(buffer, key) != NULL) {
+      continue;
+    }
+    if (bplus_record_insert(target->file_desc, target->metadata, &record) == -1) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+long bplus_csv_load(const char *path, const int file_desc, BPlusMeta *metadata, const BPlusCsvOptions *options)
+{
+  CsvTarget target = {file_desc, metadata, bplus_bulk_load_create(file_desc, metadata), 0, {0}};
+  if (target.bulk == NULL && bplus_insert_buffer_enable(file_desc, metadata, BPLUS_CSV_BUFFER_RECORDS) == -1) {
+    return -1;
+  }
+  long rows = bplus_csv_read(path, &metadata->table_schema, options, insert_chunk, &target);
+  if (target.bulk != NULL) {
+    if (rows == -1) {
+      bplus_bulk_load_abort(target.bulk);
+    } else if (bplus_bulk_load_finish(target.bulk) == -1) {
+      rows = -1;
+    }
+  }
+  if (bplus_insert_buffer_enable(file_desc, metadata, 0) == -1) {
+    return -1;
+  }
+  return rows;
+}
@@ -1,14 +1,186 @@
-#ifndef BPLUS_DATANODE_H
-#define BPLUS_DATANODE_H
+// Βοηθητικές συναρτήσεις για την επεξεργασία Κόμβων Δεδομένων.
+//
+// Διάταξη block: [BPlusDataNode][heads[capacity]][records[capacity]]
+// τα heads (πρωτα 4 bytes του κανονικοποιημενου κλειδιου) είναι συνεχόμενα ώστε
+// η αναζήτηση να μην αγγίζει τις εγγραφές, και κάθε εγγραφή πιάνει ακριβώς
+// schema->record_size bytes. Το υπολοιπο κλειδι διαβαζεται απο την ιδια την
+// εγγραφη, μονο οταν δυο heads ειναι ισα.
 
-#include "record.h"
+#include <string.h>
 
-// Απλός κόμβος δεδομένων (leaf node) του B+ Tree
-typedef struct {
-    int is_leaf;          // 1 αν είναι φύλλο, αλλιώς 0
-    int next_block;       // block number του επόμενου leaf node (ή -1)
-    int key_count;        // πόσες εγγραφές περιέχει
-    Record records[4];    // 4 εγγραφές ανά κόμβο (512 bytes block size)
-} BPlusDataNode;
+#include "bf.h"
+#include "bplus_datanode.h"
+#include "record_generator.h"
+#include "bplus_key.h"
+#include "bplus_search.h"
 
-#endif
+int datanode_capacity(const TableSchema *schema)
+{
+  return (int)((BF_BLOCK_SIZE - sizeof(BPlusDataNode)) / (sizeof(int) + schema->record_size));
+}
+
+void datanode_init(char *data)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  node->is_leaf = 1;
+  node->key_count = 0;
+  node->next_block = -1;
+}
+
+int *datanode_heads(char *data)
+{
+  return (int *)(data + sizeof(BPlusDataNode));
+}
+
+// αρχη του πινακα των packed εγγραφων
+static char *datanode_payload(char *data, const int capacity)
+{
+  return data + sizeof(BPlusDataNode) + capacity * sizeof(int);
+}
+
+char *datanode_record(char *data, const TableSchema *schema, const int capacity, const int pos)
+{
+  return datanode_payload(data, capacity) + pos * schema->record_size;
+}
+
+void datanode_key(char *data, const TableSchema *schema, const int capacity, const int pos, unsigned char *key)
+{
+  bplus_key_from_packed(schema, datanode_record(data, schema, capacity, pos), key);
+}
+
+int datanode_search(char *data, const TableSchema *schema, const int capacity, const unsigned char *key, int *found)
+{
+  const BPlusDataNode *node = (const BPlusDataNode *)data;
+  const int *heads = datanode_heads(data);
+  const int head = bplus_key_head(key);
+  int lo = bplus_rank_lower(heads, node->key_count, head);
+
+  if (schema->key_size == 4) {
+    *found = lo < node->key_count && heads[lo] == head;
+    return lo;
+  }
+
+  // ιδια heads: συγκρινουμε ολοκληρο το κλειδι με τις packed εγγραφες
+  int hi = bplus_rank_upper(heads, node->key_count, head);
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (bplus_key_compare_packed(schema, key, datanode_record(data, schema, capacity, mid)) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *found = lo < node->key_count &&
+           bplus_key_compare_packed(schema, key, datanode_record(data, schema, capacity, lo)) == 0;
+  return lo;
+}
+
+void datanode_insert_at(char *data, const TableSchema *schema, const int capacity, const int pos,
+                        const Record *record)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  int *heads = datanode_heads(data);
+  char *slot = datanode_record(data, schema, capacity, pos);
+  const int tail = node->key_count - pos;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+
+  // ανοιγουμε χωρο και στους δυο πινακες
+  memmove(&heads[pos + 1], &heads[pos], tail * sizeof(int));
+  memmove(slot + schema->record_size, slot, tail * schema->record_size);
+
+  // η εγγραφη γραφεται κατευθειαν στο block χωρις ενδιαμεσο αντιγραφο
+  const RecordSerializer serialize = record_serializer(schema);
+  serialize(schema, record, slot);
+  bplus_key_from_packed(schema, slot, key);
+  heads[pos] = bplus_key_head(key);
+  node->key_count++;
+}
+
+void datanode_split(char *data, char *new_data, const TableSchema *schema, const int capacity,
+                    const int pos, const Record *record, int *in_new, unsigned char *separator)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  BPlusDataNode *new_node = (BPlusDataNode *)new_data;
+  int *heads = datanode_heads(data);
+  int *new_heads = datanode_heads(new_data);
+
+  // μετα το split ο αριστερος κραταει left_count εγγραφες (μαζι με τη νεα αν πεφτει εκει)
+  const int left_count = (capacity + 1) / 2;
+  *in_new = pos >= left_count;
+
+  // απο ποια θεση και μετα μετακινουνται οι εγγραφες στο νεο κομβο
+  const int move_from = *in_new ? left_count : left_count - 1;
+  const int moved = capacity - move_from;
+
+  memcpy(new_heads, &heads[move_from], moved * sizeof(int));
+  memcpy(datanode_payload(new_data, capacity), datanode_record(data, schema, capacity, move_from),
+         moved * schema->record_size);
+  new_node->key_count = moved;
+  node->key_count = move_from;
+
+  if (*in_new) {
+    datanode_insert_at(new_data, schema, capacity, pos - left_count, record);
+  } else {
+    datanode_insert_at(data, schema, capacity, pos, record);
+  }
+
+  datanode_key(new_data, schema, capacity, 0, separator);
+}
+
+void datanode_remove_at(char *data, const TableSchema *schema, const int capacity, const int pos)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  int *heads = datanode_heads(data);
+  char *slot = datanode_record(data, schema, capacity, pos);
+  const int tail = node->key_count - pos - 1;
+
+  memmove(&heads[pos], &heads[pos + 1], tail * sizeof(int));
+  memmove(slot, slot + schema->record_size, tail * schema->record_size);
+  node->key_count--;
+}
+
+void datanode_borrow_left(char *data, char *left_data, const TableSchema *schema, const int capacity)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  BPlusDataNode *left = (BPlusDataNode *)left_data;
+  const int last = left->key_count - 1;
+  int *heads = datanode_heads(data);
+  char *records = datanode_record(data, schema, capacity, 0);
+
+  // ανοιγουμε την πρωτη θεση και φερνουμε εκει την τελευταια του αριστερου
+  memmove(&heads[1], &heads[0], node->key_count * sizeof(int));
+  memmove(records + schema->record_size, records, node->key_count * schema->record_size);
+  heads[0] = datanode_heads(left_data)[last];
+  memcpy(records, datanode_record(left_data, schema, capacity, last), schema->record_size);
+
+  node->key_count++;
+  left->key_count--;
+}
+
+void datanode_borrow_right(char *data, char *right_data, const TableSchema *schema, const int capacity)
+{
+  BPlusDataNode *node = (BPlusDataNode *)data;
+  const int end = node->key_count;
+
+  datanode_heads(data)[end] = datanode_heads(right_data)[0];
+  memcpy(datanode_record(data, schema, capacity, end), datanode_record(right_data, schema, capacity, 0),
+         schema->record_size);
+  node->key_count++;
+
+  datanode_remove_at(right_data, schema, capacity, 0);
+}
+
+void datanode_merge(char *left_data, char *right_data, const TableSchema *schema, const int capacity)
+{
+  BPlusDataNode *left = (BPlusDataNode *)left_data;
+  BPlusDataNode *right = (BPlusDataNode *)right_data;
+  const int end = left->key_count;
+
+  memcpy(&datanode_heads(left_data)[end], datanode_heads(right_data), right->key_count * sizeof(int));
+  memcpy(datanode_record(left_data, schema, capacity, end), datanode_record(right_data, schema, capacity, 0),
+         right->key_count * schema->record_size);
+
+  left->key_count += right->key_count;
+  left->next_block = right->next_block;
+  right->key_count = 0;
+}
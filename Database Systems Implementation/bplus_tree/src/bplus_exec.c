@@ -0,0 +1,656 @@
+// Vectorized εκτέλεση: τελεστές που ανταλλάσσουν batches κατά στήλες, με
+// selection vector αντί για αντιγραφή των γραμμών που περνούν ένα φίλτρο.
+
+#include <float.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "bplus_datanode.h"
+#include "bplus_exec.h"
+#include "bplus_file_funcs.h"
+#include "bplus_heap.h"
+#include "bplus_index_node.h"
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+typedef struct {
+  ExecOperator base;
+  int file_desc;
+  int heap;             // 1 για heap file, 0 για φυλλα B+ δεντρου
+  int block_id;         // το επομενο block, -1 στο τελος
+  int pos;              // πρωτη εγγραφη του block που δεν εχει διαβαστει
+  int last_block;       // heap: το τελευταιο block δεδομενων
+  int record_stride;
+  int leaf_capacity;
+  BF_Block *block;
+  ExecBatch batch;
+  char *storage;
+} ScanOperator;
+
+typedef struct {
+  ExecOperator base;
+  ExecOperator *child;
+  int column;
+  ExecCompare compare;
+  FieldValue value;
+  ExecBatch batch;
+  unsigned short selection[EXEC_BATCH_SIZE];
+} FilterOperator;
+
+typedef struct {
+  ExecOperator base;
+  ExecOperator *child;
+  int columns[MAX_ATTRIBUTES];
+  ExecBatch batch;
+} ProjectOperator;
+
+typedef struct {
+  ExecOperator base;
+  ExecOperator *child;
+  long remaining;
+  ExecBatch batch;
+} LimitOperator;
+
+typedef struct {
+  long long int_sum;
+  double float_sum;
+  int int_min;
+  int int_max;
+  float float_min;
+  float float_max;
+} AggregateState;
+
+typedef struct {
+  ExecOperator base;
+  ExecOperator *child;
+  ExecAggregateSpec specs[MAX_ATTRIBUTES];
+  AggregateState states[MAX_ATTRIBUTES];
+  int count;
+  long rows;
+  int done;
+  double values[MAX_ATTRIBUTES];
+  ExecBatch batch;
+  FieldValue output[MAX_ATTRIBUTES];
+} AggregateOperator;
+
+static int column_width(const AttributeSchema *attr)
+{
+  return attr->type == TYPE_CHAR ? attr->length : 4;
+}
+
+static void batch_view(ExecBatch *batch, const ExecOperator *owner, const ExecBatch *in)
+{
+  *batch = *in;
+  batch->schema = &owner->schema;
+}
+
+int exec_next(ExecOperator *op, ExecBatch **batch)
+{
+  return op->next(op, batch);
+}
+
+void exec_close(ExecOperator *op)
+{
+  if (op != NULL) {
+    op->close(op);
+  }
+}
+
+// ---------------------------------------------------------------- scans
+
+// n εγγραφες απο records (με βημα stride) στο τελος του batch, μια στηλη τη φορα
+static void copy_rows(ExecBatch *batch, const TableSchema *schema, const char *records, const int stride, const int n)
+{
+  for (int c = 0; c < schema->count; c++) {
+    const int width = column_width(&schema->attributes[c]);
+    const char *in = records + schema->offsets[c];
+    char *out = batch->columns[c] + (size_t)batch->count * width;
+    if (width == 4) {
+      for (int r = 0; r < n; r++) {
+        memcpy(out + r * 4, in + (size_t)r * stride, 4);
+      }
+    } else {
+      for (int r = 0; r < n; r++) {
+        memcpy(out + (size_t)r * width, in + (size_t)r * stride, width);
+      }
+    }
+  }
+  batch->count += n;
+}
+
+static int scan_next(ExecOperator *self, ExecBatch **batch)
+{
+  ScanOperator *scan = (ScanOperator *)self;
+  const TableSchema *schema = &self->schema;
+  scan->batch.count = 0;
+
+  while (scan->batch.count < EXEC_BATCH_SIZE && scan->block_id != -1) {
+    CALL_BF(BF_GetBlock(scan->file_desc, scan->block_id, scan->block));
+    char *data = BF_Block_GetData(scan->block);
+
+    int rows, next;
+    const char *records;
+    if (scan->heap) {
+      rows = *(int *)data;
+      records = data + sizeof(int);
+      next = scan->block_id < scan->last_block ? scan->block_id + 1 : -1;
+    } else {
+      rows = ((BPlusDataNode *)data)->key_count;
+      records = datanode_record(data, schema, scan->leaf_capacity, 0);
+      next = ((BPlusDataNode *)data)->next_block;
+    }
+
+    // ενα block μπορει να μοιραστει σε δυο batches
+    int n = rows - scan->pos;
+    if (n > EXEC_BATCH_SIZE - scan->batch.count) {
+      n = EXEC_BATCH_SIZE - scan->batch.count;
+    }
+    copy_rows(&scan->batch, schema, records + (size_t)scan->pos * scan->record_stride, scan->record_stride, n);
+    scan->pos += n;
+    if (scan->pos >= rows) {
+      scan->block_id = next;
+      scan->pos = 0;
+    }
+    CALL_BF(BF_UnpinBlock(scan->block));
+  }
+
+  scan->batch.selected = scan->batch.count;
+  *batch = &scan->batch;
+  return scan->batch.count;
+}
+
+static void scan_close(ExecOperator *self)
+{
+  ScanOperator *scan = (ScanOperator *)self;
+  BF_Block_Destroy(&scan->block);
+  free(scan->storage);
+  free(scan);
+}
+
+static ScanOperator *scan_create(const int file_desc, const TableSchema *schema, const int record_stride)
+{
+  ScanOperator *scan = calloc(1, sizeof(ScanOperator));
+  size_t row_width = 0;
+  for (int c = 0; c < schema->count; c++) {
+    row_width += column_width(&schema->attributes[c]);
+  }
+  char *storage = malloc(row_width * EXEC_BATCH_SIZE);
+  if (scan == NULL || storage == NULL) {
+    free(scan);
+    free(storage);
+    return NULL;
+  }
+
+  scan->base.next = scan_next;
+  scan->base.close = scan_close;
+  scan->base.schema = *schema;
+  scan->file_desc = file_desc;
+  scan->record_stride = record_stride;
+  scan->storage = storage;
+  scan->batch.schema = &scan->base.schema;
+  for (int c = 0; c < schema->count; c++) {
+    scan->batch.columns[c] = storage;
+    storage += (size_t)column_width(&schema->attributes[c]) * EXEC_BATCH_SIZE;
+  }
+  BF_Block_Init(&scan->block);
+  return scan;
+}
+
+// το αριστεροτερο φυλλο, απο τα πρωτα παιδια των κομβων ευρετηριου
+static int leftmost_leaf(const int file_desc, const BPlusMeta *metadata, BF_Block *block)
+{
+  int block_id = metadata->root_block_num;
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const int child = indexnode_children(BF_Block_GetData(block), metadata->index_capacity)[0];
+    CALL_BF(BF_UnpinBlock(block));
+    block_id = child;
+  }
+  return block_id;
+}
+
+ExecOperator *exec_bplus_scan(const int file_desc, const BPlusMeta *metadata)
+{
+  // οτι περιμενει στο insert buffer πρεπει να φτασει στα φυλλα
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return NULL;
+  }
+  ScanOperator *scan = scan_create(file_desc, &metadata->table_schema, metadata->table_schema.record_size);
+  if (scan == NULL) {
+    return NULL;
+  }
+  scan->leaf_capacity = metadata->leaf_capacity;
+  scan->block_id = -1;
+  if (metadata->root_block_num != -1) {
+    scan->block_id = leftmost_leaf(file_desc, metadata, scan->block);
+    if (scan->block_id == -1) {
+      scan_close(&scan->base);
+      return NULL;
+    }
+  }
+  return &scan->base;
+}
+
+ExecOperator *exec_heap_scan(const int file_desc, const TableSchema *schema, const int record_stride)
+{
+  if (record_stride < schema->record_size) {
+    fprintf(stderr, "Error: record stride %d is smaller than the record size %d\n", record_stride,
+            schema->record_size);
+    return NULL;
+  }
+  ScanOperator *scan = scan_create(file_desc, schema, record_stride);
+  if (scan == NULL) {
+    return NULL;
+  }
+  scan->heap = 1;
+  BPlusHeapHeader header;
+  if (bplus_heap_header(file_desc, &header) == -1) {
+    scan_close(&scan->base);
+    return NULL;
+  }
+  scan->last_block = header.last_data_block;
+  scan->block_id = scan->last_block >= 1 ? 1 : -1;
+  return &scan->base;
+}
+
+// ---------------------------------------------------------------- filter
+
+// γραφει τη θεση καθε γραμμης και προχωραει μονο αν περασε: χωρις branch ανα γραμμη
+#define FILTER_ROWS(test)                        \
+  if (sel == NULL) {                             \
+    for (int r = 0; r < rows; r++) {             \
+      out[n] = (unsigned short)r;                \
+      n += (test);                               \
+    }                                            \
+  } else {                                       \
+    for (int k = 0; k < rows; k++) {             \
+      const int r = sel[k];                      \
+      out[n] = (unsigned short)r;                \
+      n += (test);                               \
+    }                                            \
+  }
+
+#define FILTER_COMPARE(value, constant)                    \
+  switch (compare) {                                       \
+    case EXEC_EQ: FILTER_ROWS((value) == (constant)) break; \
+    case EXEC_NE: FILTER_ROWS((value) != (constant)) break; \
+    case EXEC_LT: FILTER_ROWS((value) < (constant)) break;  \
+    case EXEC_LE: FILTER_ROWS((value) <= (constant)) break; \
+    case EXEC_GT: FILTER_ROWS((value) > (constant)) break;  \
+    case EXEC_GE: FILTER_ROWS((value) >= (constant)) break; \
+  }
+
+static int filter_batch(const FilterOperator *filter, const ExecBatch *in, unsigned short *out)
+{
+  const AttributeSchema *attr = &in->schema->attributes[filter->column];
+  const char *column = in->columns[filter->column];
+  const unsigned short *sel = in->selection;
+  const int rows = in->selected;
+  const ExecCompare compare = filter->compare;
+  int n = 0;
+
+  switch (attr->type) {
+    case TYPE_INT: {
+      const int *values = (const int *)column;
+      const int constant = filter->value.int_value;
+      FILTER_COMPARE(values[r], constant)
+      break;
+    }
+    case TYPE_FLOAT: {
+      const float *values = (const float *)column;
+      const float constant = filter->value.float_value;
+      FILTER_COMPARE(values[r], constant)
+      break;
+    }
+    default: {
+      const int width = attr->length;
+      const char *constant = filter->value.string_value;
+      // strncmp: στο heap file τα bytes μετα το NUL δεν ειναι μηδενικα
+      FILTER_COMPARE(strncmp(column + (size_t)r * width, constant, width), 0)
+      break;
+    }
+  }
+  return n;
+}
+
+static int filter_next(ExecOperator *self, ExecBatch **batch)
+{
+  FilterOperator *filter = (FilterOperator *)self;
+  ExecBatch *in;
+  int rows;
+
+  // batches που δεν αφηνουν καμια γραμμη δεν επιστρεφονται
+  while ((rows = exec_next(filter->child, &in)) > 0) {
+    const int n = filter_batch(filter, in, filter->selection);
+    if (n > 0) {
+      batch_view(&filter->batch, self, in);
+      filter->batch.selection = filter->selection;
+      filter->batch.selected = n;
+      *batch = &filter->batch;
+      return n;
+    }
+  }
+  return rows;
+}
+
+static void filter_close(ExecOperator *self)
+{
+  FilterOperator *filter = (FilterOperator *)self;
+  exec_close(filter->child);
+  free(filter);
+}
+
+ExecOperator *exec_filter(ExecOperator *child, const int column, const ExecCompare compare, const FieldValue *value)
+{
+  if (child == NULL) {
+    return NULL;
+  }
+  FilterOperator *filter = calloc(1, sizeof(FilterOperator));
+  if (filter == NULL || column < 0 || column >= child->schema.count) {
+    fprintf(stderr, "Error: cannot filter on column %d\n", column);
+    free(filter);
+    exec_close(child);
+    return NULL;
+  }
+
+  filter->base.next = filter_next;
+  filter->base.close = filter_close;
+  filter->base.schema = child->schema;
+  filter->child = child;
+  filter->column = column;
+  filter->compare = compare;
+  filter->value = *value;
+  // τα CHAR συγκρινονται το πολυ σε ολο το πλατος της στηλης
+  const AttributeSchema *attr = &child->schema.attributes[column];
+  if (attr->type == TYPE_CHAR) {
+    memset(filter->value.string_value, 0, sizeof(filter->value.string_value));
+    strncpy(filter->value.string_value, value->string_value, attr->length);
+  }
+  return &filter->base;
+}
+
+// ---------------------------------------------------------------- project
+
+static int project_next(ExecOperator *self, ExecBatch **batch)
+{
+  ProjectOperator *project = (ProjectOperator *)self;
+  ExecBatch *in;
+  const int rows = exec_next(project->child, &in);
+  if (rows <= 0) {
+    return rows;
+  }
+  batch_view(&project->batch, self, in);
+  for (int c = 0; c < self->schema.count; c++) {
+    project->batch.columns[c] = in->columns[project->columns[c]];
+  }
+  *batch = &project->batch;
+  return rows;
+}
+
+static void project_close(ExecOperator *self)
+{
+  ProjectOperator *project = (ProjectOperator *)self;
+  exec_close(project->child);
+  free(project);
+}
+
+ExecOperator *exec_project(ExecOperator *child, const int *columns, const int count)
+{
+  if (child == NULL) {
+    return NULL;
+  }
+  ProjectOperator *project = calloc(1, sizeof(ProjectOperator));
+  int valid = project != NULL && count > 0 && count <= MAX_ATTRIBUTES;
+  for (int c = 0; valid && c < count; c++) {
+    valid = columns[c] >= 0 && columns[c] < child->schema.count;
+  }
+  if (!valid) {
+    fprintf(stderr, "Error: invalid projection\n");
+    free(project);
+    exec_close(child);
+    return NULL;
+  }
+
+  AttributeSchema attrs[MAX_ATTRIBUTES];
+  for (int c = 0; c < count; c++) {
+    attrs[c] = child->schema.attributes[columns[c]];
+    project->columns[c] = columns[c];
+  }
+  project->base.next = project_next;
+  project->base.close = project_close;
+  schema_init(&project->base.schema, attrs, count, attrs[0].name);
+  project->child = child;
+  return &project->base;
+}
+
+// ---------------------------------------------------------------- limit
+
+static int limit_next(ExecOperator *self, ExecBatch **batch)
+{
+  LimitOperator *limit = (LimitOperator *)self;
+  ExecBatch *in;
+  if (limit->remaining <= 0) {
+    return 0;
+  }
+  const int rows = exec_next(limit->child, &in);
+  if (rows <= 0) {
+    return rows;
+  }
+
+  batch_view(&limit->batch, self, in);
+  if (rows > limit->remaining) {
+    limit->batch.selected = (int)limit->remaining;
+    if (limit->batch.selection == NULL) {
+      limit->batch.count = (int)limit->remaining;
+    }
+  }
+  limit->remaining -= limit->batch.selected;
+  *batch = &limit->batch;
+  return limit->batch.selected;
+}
+
+static void limit_close(ExecOperator *self)
+{
+  LimitOperator *limit = (LimitOperator *)self;
+  exec_close(limit->child);
+  free(limit);
+}
+
+ExecOperator *exec_limit(ExecOperator *child, const long limit_rows)
+{
+  if (child == NULL) {
+    return NULL;
+  }
+  LimitOperator *limit = calloc(1, sizeof(LimitOperator));
+  if (limit == NULL) {
+    exec_close(child);
+    return NULL;
+  }
+  limit->base.next = limit_next;
+  limit->base.close = limit_close;
+  limit->base.schema = child->schema;
+  limit->child = child;
+  limit->remaining = limit_rows;
+  return &limit->base;
+}
+
+// ---------------------------------------------------------------- aggregate
+
+// αθροισμα, min και max μαζι, σε ενα περασμα χωρις branches
+#define AGGREGATE_ROWS(type, sum, min, max)                        \
+  {                                                                \
+    const type *values = (const type *)column;                     \
+    if (sel == NULL) {                                             \
+      for (int r = 0; r < rows; r++) {                             \
+        const type v = values[r];                                  \
+        sum += v;                                                  \
+        min = v < min ? v : min;                                   \
+        max = v > max ? v : max;                                   \
+      }                                                            \
+    } else {                                                       \
+      for (int k = 0; k < rows; k++) {                             \
+        const type v = values[sel[k]];                             \
+        sum += v;                                                  \
+        min = v < min ? v : min;                                   \
+        max = v > max ? v : max;                                   \
+      }                                                            \
+    }                                                              \
+  }
+
+static void aggregate_batch(AggregateOperator *aggregate, const ExecBatch *in)
+{
+  const unsigned short *sel = in->selection;
+  const int rows = in->selected;
+  for (int i = 0; i < aggregate->count; i++) {
+    if (aggregate->specs[i].function == EXEC_COUNT) {
+      continue;
+    }
+    AggregateState *state = &aggregate->states[i];
+    const char *column = in->columns[aggregate->specs[i].column];
+    if (in->schema->attributes[aggregate->specs[i].column].type == TYPE_INT) {
+      long long sum = 0;
+      int min = state->int_min;
+      int max = state->int_max;
+      AGGREGATE_ROWS(int, sum, min, max)
+      state->int_sum += sum;
+      state->int_min = min;
+      state->int_max = max;
+    } else {
+      double sum = 0;
+      float min = state->float_min;
+      float max = state->float_max;
+      AGGREGATE_ROWS(float, sum, min, max)
+      state->float_sum += sum;
+      state->float_min = min;
+      state->float_max = max;
+    }
+  }
+  aggregate->rows += rows;
+}
+
+static double aggregate_result(const AggregateOperator *aggregate, const int i)
+{
+  const AggregateState *state = &aggregate->states[i];
+  const ExecAggregateSpec *spec = &aggregate->specs[i];
+  if (spec->function == EXEC_COUNT) {
+    return (double)aggregate->rows;
+  }
+  const int is_int = aggregate->child->schema.attributes[spec->column].type == TYPE_INT;
+  const double sum = is_int ? (double)state->int_sum : state->float_sum;
+  if (aggregate->rows == 0) {
+    return 0;
+  }
+  switch (spec->function) {
+    case EXEC_SUM: return sum;
+    case EXEC_MIN: return is_int ? (double)state->int_min : (double)state->float_min;
+    case EXEC_MAX: return is_int ? (double)state->int_max : (double)state->float_max;
+    default: return sum / aggregate->rows;
+  }
+}
+
+static int aggregate_next(ExecOperator *self, ExecBatch **batch)
+{
+  AggregateOperator *aggregate = (AggregateOperator *)self;
+  if (aggregate->done) {
+    return 0;
+  }
+
+  ExecBatch *in;
+  int rows;
+  while ((rows = exec_next(aggregate->child, &in)) > 0) {
+    aggregate_batch(aggregate, in);
+  }
+  if (rows == -1) {
+    return -1;
+  }
+
+  for (int i = 0; i < aggregate->count; i++) {
+    aggregate->values[i] = aggregate_result(aggregate, i);
+    if (self->schema.attributes[i].type == TYPE_INT) {
+      aggregate->output[i].int_value = (int)aggregate->values[i];
+    } else {
+      aggregate->output[i].float_value = (float)aggregate->values[i];
+    }
+  }
+  aggregate->done = 1;
+  aggregate->batch.count = 1;
+  aggregate->batch.selected = 1;
+  *batch = &aggregate->batch;
+  return 1;
+}
+
+static void aggregate_close(ExecOperator *self)
+{
+  AggregateOperator *aggregate = (AggregateOperator *)self;
+  exec_close(aggregate->child);
+  free(aggregate);
+}
+
+ExecOperator *exec_aggregate(ExecOperator *child, const ExecAggregateSpec *specs, const int count)
+{
+  static const char *function_names[] = {"count", "sum", "min", "max", "avg"};
+  if (child == NULL) {
+    return NULL;
+  }
+  AggregateOperator *aggregate = calloc(1, sizeof(AggregateOperator));
+  int valid = aggregate != NULL && count > 0 && count <= MAX_ATTRIBUTES;
+  for (int i = 0; valid && i < count; i++) {
+    valid = specs[i].function == EXEC_COUNT ||
+            (specs[i].column >= 0 && specs[i].column < child->schema.count &&
+             child->schema.attributes[specs[i].column].type != TYPE_CHAR);
+  }
+  if (!valid) {
+    fprintf(stderr, "Error: aggregates need INT or FLOAT columns\n");
+    free(aggregate);
+    exec_close(child);
+    return NULL;
+  }
+
+  AttributeSchema attrs[MAX_ATTRIBUTES];
+  memset(attrs, 0, sizeof(attrs));
+  for (int i = 0; i < count; i++) {
+    aggregate->specs[i] = specs[i];
+    AggregateState *state = &aggregate->states[i];
+    state->int_min = INT_MAX;
+    state->int_max = INT_MIN;
+    state->float_min = FLT_MAX;
+    state->float_max = -FLT_MAX;
+
+    DataType type = TYPE_FLOAT;
+    if (specs[i].function == EXEC_COUNT) {
+      type = TYPE_INT;
+    } else if (specs[i].function == EXEC_MIN || specs[i].function == EXEC_MAX) {
+      type = child->schema.attributes[specs[i].column].type;
+    }
+    strcpy(attrs[i].name, function_names[specs[i].function]);
+    attrs[i].type = type;
+  }
+
+  aggregate->base.next = aggregate_next;
+  aggregate->base.close = aggregate_close;
+  schema_init(&aggregate->base.schema, attrs, count, attrs[0].name);
+  aggregate->child = child;
+  aggregate->count = count;
+  aggregate->batch.schema = &aggregate->base.schema;
+  for (int i = 0; i < count; i++) {
+    aggregate->batch.columns[i] = (char *)&aggregate->output[i];
+  }
+  return &aggregate->base;
+}
+
+double exec_aggregate_value(const ExecOperator *aggregate, const int index)
+{
+  return ((const AggregateOperator *)aggregate)->values[index];
+}
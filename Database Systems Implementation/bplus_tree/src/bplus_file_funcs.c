@@ -1,345 +1,1651 @@
-#include "bplus_file_funcs.h"
-#include "bplus_datanode.h"
-#include "bf.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
-#define CALL_BF(call)         \
-  {                           \
-    BF_ErrorCode code = call; \
-    if (code != BF_OK)        \
-    {                         \
-      BF_PrintError(code);    \
-      return -1;              \
-    }                         \
-  }
-
-
-int bplus_create_file(const TableSchema *schema, const char *fileName)
-{
-  // Δημιουργία νέου αρχείου
-  CALL_BF(BF_CreateFile(fileName));
-  
-  // Άνοιγμα για να γράψουμε τα metadata
-  int fd;
-  CALL_BF(BF_OpenFile(fileName, &fd));
-  
-  // Δέσμευση πρώτου block για metadata
-  BF_Block *meta_block;
-  BF_Block_Init(&meta_block);
-  CALL_BF(BF_AllocateBlock(fd, meta_block));
-  
-  // Αρχικοποίηση metadata structure
-  BPlusMeta meta;
-  meta.root_block_num = -1;  // αρχικά δεν έχουμε root
-  meta.depth = 0;
-  meta.data_block_count = 0;
-  meta.index_block_count = 0;
-  meta.table_schema = *schema;
-  
-  // Γράψιμο metadata στο block
-  char *data = BF_Block_GetData(meta_block);
-  memcpy(data, &meta, sizeof(BPlusMeta));
-  
-  BF_Block_SetDirty(meta_block);
-  CALL_BF(BF_UnpinBlock(meta_block));
-  BF_Block_Destroy(&meta_block);
-  
-  CALL_BF(BF_CloseFile(fd));
-  
-  return 0;
-}
-
-
-int bplus_open_file(const char *fileName, int *file_desc, BPlusMeta **metadata)
-{
-  // Άνοιγμα του αρχείου
-  BF_ErrorCode code = BF_OpenFile(fileName, file_desc);
-  
-  if (code != BF_OK) {
-    BF_PrintError(code);
-    return -1;
-  }
-  
-  // διάβασμα του πρώτου block που έχει τα metadata
-  BF_Block *meta_block;
-  BF_Block_Init(&meta_block);
-  CALL_BF(BF_GetBlock(*file_desc, 0, meta_block));
-  
-  // δεσμευση μνημης για τα metadata
-  *metadata = malloc(sizeof(BPlusMeta));
-  if (*metadata == NULL) {
-    BF_UnpinBlock(meta_block);
-    BF_Block_Destroy(&meta_block);
-    return -1;
-  }
-  
-  // αντιγραφη των metadata απο το block
-  char *data = BF_Block_GetData(meta_block);
-  memcpy(*metadata, data, sizeof(BPlusMeta));
-  
-  CALL_BF(BF_UnpinBlock(meta_block));
-  BF_Block_Destroy(&meta_block);
-  
-  return 0;
-}
-
-int bplus_close_file(const int file_desc, BPlusMeta* metadata)
-{
-  // πρεπει να σωσουμε τα metadata πισω στο αρχειο πριν κλεισουμε
-  BF_Block *meta_block;
-  BF_Block_Init(&meta_block);
-  CALL_BF(BF_GetBlock(file_desc, 0, meta_block));
-  
-  // γραψιμο των updated metadata
-  char *data = BF_Block_GetData(meta_block);
-  memcpy(data, metadata, sizeof(BPlusMeta));
-  
-  BF_Block_SetDirty(meta_block);
-  CALL_BF(BF_UnpinBlock(meta_block));
-  BF_Block_Destroy(&meta_block);
-  
-  // κλεισιμο αρχειου
-  CALL_BF(BF_CloseFile(file_desc));
-  
-  // ελευθερωση μνημης
-  free(metadata);
-  
-  return 0;
-}
-
-int bplus_record_insert(const int file_desc, BPlusMeta *metadata, const Record *record)
-{
-  // βρισκουμε το key απο το record
-  int key_idx = metadata->table_schema.key_index;
-  int key = record->values[key_idx].int_value;
-  
-  
-  BF_Block *block = NULL;
-  BF_Block_Init(&block);
-  
-  
-  // αν εχουμε αδειο δεντρο - φτιαχνουμε το πρωτο leaf
-  if (metadata->root_block_num == -1) {
-    
-    BF_ErrorCode code = BF_AllocateBlock(file_desc, block);
-    if (code != BF_OK) {
-      BF_PrintError(code);
-      BF_Block_Destroy(&block);
-      return -1;
-    }
-    
-    int block_count;
-    code = BF_GetBlockCounter(file_desc, &block_count);
-    if (code != BF_OK) {
-      BF_PrintError(code);
-      BF_UnpinBlock(block);
-      BF_Block_Destroy(&block);
-      return -1;
-    }
-    
-    int new_block_id = block_count - 1;
-    
-    // αρχικοποιηση νεου data node
-    BPlusDataNode node;
-    node.is_leaf = 1;
-    node.next_block = -1;
-    node.key_count = 1;
-    node.records[0] = *record;
-    
-    // γραψιμο στο block
-    char *data = BF_Block_GetData(block);
-    memcpy(data, &node, sizeof(BPlusDataNode));
-    
-    BF_Block_SetDirty(block);
-    
-    code = BF_UnpinBlock(block);
-    if (code != BF_OK) {
-      BF_PrintError(code);
-    }
-    
-    BF_Block_Destroy(&block);
-    
-    // ενημερωση metadata
-    metadata->root_block_num = new_block_id;
-    metadata->data_block_count = 1;
-    metadata->depth = 1;
-    
-    return new_block_id;
-  }
-  
-  // αν υπαρχει ηδη δεντρο - ψαχνουμε το σωστο leaf
-  int current_block_id = metadata->root_block_num;
-  
-  while (current_block_id != -1) {
-    CALL_BF(BF_GetBlock(file_desc, current_block_id, block));
-    
-    char *data = BF_Block_GetData(block);
-    BPlusDataNode node;
-    memcpy(&node, data, sizeof(BPlusDataNode));
-    
-    // ελεγχος για duplicate key
-    int i;
-    for (i = 0; i < node.key_count; i++) {
-      int existing_key = node.records[i].values[key_idx].int_value;
-      if (existing_key == key) {
-        // διπλοτυπο! δεν το επιτρεπουμε
-        CALL_BF(BF_UnpinBlock(block));
-        BF_Block_Destroy(&block);
-        return -1;
-      }
-    }
-    
-    // αν ο κομβος εχει χωρο και το key ταιριαζει εδω
-    if (node.key_count < 4) {
-      int last_key = -1;
-      if (node.key_count > 0) {
-        last_key = node.records[node.key_count - 1].values[key_idx].int_value;
-      }
-      
-      // αν το key πρεπει να μπει εδω (ειναι μεγαλυτερο απο το τελευταιο ή δεν υπαρχει επομενος)
-      if (key > last_key || node.next_block == -1) {
-        // βρισκουμε τη σωστη θεση (sorted insertion)
-        int insert_pos = node.key_count;
-        for (i = 0; i < node.key_count; i++) {
-          int curr_key = node.records[i].values[key_idx].int_value;
-          if (key < curr_key) {
-            insert_pos = i;
-            break;
-          }
-        }
-        
-        // μετακινηση records για να ανοιξουμε χωρο
-        for (i = node.key_count; i > insert_pos; i--) {
-          node.records[i] = node.records[i-1];
-        }
-        
-        // εισαγωγη του νεου record
-        node.records[insert_pos] = *record;
-        node.key_count++;
-        
-        // αποθηκευση
-        memcpy(data, &node, sizeof(BPlusDataNode));
-        BF_Block_SetDirty(block);
-        CALL_BF(BF_UnpinBlock(block));
-        BF_Block_Destroy(&block);
-        
-        return current_block_id;
-      }
-    }
-    
-    // αν ο κομβος ειναι full και δεν υπαρχει επομενος, φτιαχνουμε νεο
-    if (node.key_count >= 4 && node.next_block == -1) {
-      int prev_block_id = current_block_id;
-      
-      // πρωτα κανουμε unpin τον τρεχοντα κομβο
-      CALL_BF(BF_UnpinBlock(block));
-      
-      // δημιουργια νεου block για νεο leaf
-      BF_Block *new_block;
-      BF_Block_Init(&new_block);
-      CALL_BF(BF_AllocateBlock(file_desc, new_block));
-      int block_count;
-      CALL_BF(BF_GetBlockCounter(file_desc, &block_count));
-      int new_block_id = block_count - 1;
-      
-      // αρχικοποιηση νεου node
-      BPlusDataNode new_node;
-      new_node.is_leaf = 1;
-      new_node.next_block = -1;
-      new_node.key_count = 1;
-      new_node.records[0] = *record;
-      
-      char *new_data = BF_Block_GetData(new_block);
-      memcpy(new_data, &new_node, sizeof(BPlusDataNode));
-      BF_Block_SetDirty(new_block);
-      CALL_BF(BF_UnpinBlock(new_block));
-      BF_Block_Destroy(&new_block);
-      
-      // τωρα ενημερωνουμε τον παλιο node να δειχνει στο νεο
-      CALL_BF(BF_GetBlock(file_desc, prev_block_id, block));
-      data = BF_Block_GetData(block);
-      memcpy(&node, data, sizeof(BPlusDataNode));
-      node.next_block = new_block_id;
-      memcpy(data, &node, sizeof(BPlusDataNode));
-      BF_Block_SetDirty(block);
-      CALL_BF(BF_UnpinBlock(block));
-      BF_Block_Destroy(&block);
-      
-      metadata->data_block_count++;
-      
-      return new_block_id;
-    }
-    
-    // προχωραμε στον επομενο κομβο
-    int next = node.next_block;
-    CALL_BF(BF_UnpinBlock(block));
-    current_block_id = next;
-  }
-  
-  BF_Block_Destroy(&block);
-  return -1;
-}
-
-int bplus_record_find(const int file_desc, const BPlusMeta *metadata, const int key, Record** out_record)
-{  
-  *out_record = NULL;
-  
-  // αν το δεντρο ειναι αδειο
-  if (metadata->root_block_num == -1) {
-    return -1;
-  }
-  
-  BF_Block *block;
-  BF_Block_Init(&block);
-  
-  int key_idx = metadata->table_schema.key_index;
-  
-  // διατρεχουμε τα leaf nodes μεσω του linked list
-  int current_block_id = metadata->root_block_num;
-  
-  while (current_block_id != -1) {
-    CALL_BF(BF_GetBlock(file_desc, current_block_id, block));
-    
-    char *data = BF_Block_GetData(block);
-    BPlusDataNode node;
-    memcpy(&node, data, sizeof(BPlusDataNode));
-    
-    // ψαχνουμε στα records του κομβου
-    int i;
-    for (i = 0; i < node.key_count; i++) {
-      int curr_key = node.records[i].values[key_idx].int_value;
-      
-      if (curr_key == key) {
-        *out_record = malloc(sizeof(Record));
-        if (*out_record == NULL) {
-          CALL_BF(BF_UnpinBlock(block));
-          BF_Block_Destroy(&block);
-          return -1;
-        }
-        
-        memcpy(*out_record, &node.records[i], sizeof(Record));
-        
-        CALL_BF(BF_UnpinBlock(block));
-        BF_Block_Destroy(&block);
-        return 0;
-      }
-      
-      //αν τα keys ειναι sorted και το curr_key > key, δεν χρειαζεται να συνεχισουμε
-      if (curr_key > key) {
-        break;
-      }
-    }
-    
-    // επομενος κομβος
-    int next = node.next_block;
-    CALL_BF(BF_UnpinBlock(block));
-    current_block_id = next;
-  }
-  
-  BF_Block_Destroy(&block);
-  return -1; 
-}
-
+#include "bplus_file_funcs.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bplus_block.h"
+#include "bplus_insert_buffer.h"
+#include "bplus_filter.h"
+#include "bplus_node_cache.h"
+#include "bplus_page_pool.h"
+#include "record_generator.h"
+#include "wal.h"
+#include "bf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+
+// Το αντιγραφο του παιδιου slot, ή NULL. Παιδι που λειπει μεσα στα επιπεδα που
+// κραταει η cache (νεος κομβος απο split) μετραει ως αστοχια.
+static const BPlusCachedNode *next_cached(const int file_desc, const BPlusCachedNode *cached, const int slot,
+                                          const int level)
+{
+  const BPlusCachedNode *child = cached->children[slot];
+  if (child == NULL) {
+    BPlusNodeCache *cache = node_cache_of(file_desc);
+    if (level + 1 < cache->levels) {
+      cache->misses++;
+    }
+  }
+  return child;
+}
+
+// Σελιδα μονο για αναγνωση: απο το page pool, αλλιως pinned απο το BF, οποτε
+// το *pinned γινεται 1 και θελει unpin. NULL σε λαθος του BF.
+static char *read_page(const int file_desc, const int block_id, BF_Block *block, int *pinned)
+{
+  const char *copy = page_pool_read(file_desc, block_id);
+  *pinned = copy == NULL;
+  if (copy != NULL) {
+    return (char *)copy;
+  }
+  const BF_ErrorCode code = BF_GetBlock(file_desc, block_id, block);
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    return NULL;
+  }
+  return BF_Block_GetData(block);
+}
+
+// Κατεβαίνει από τη ρίζα ως το φύλλο που πρέπει να περιέχει το key.
+// Στο path[] γράφονται τα index blocks της διαδρομής (depth - 1 το πλήθος)
+// και στο slots[] η θέση του παιδιού που ακολουθήσαμε σε καθένα. Αν upper
+// δεν είναι NULL, παίρνει το μικρότερο κλειδί που ανήκει σε επόμενο φύλλο
+// και το *bounded γίνεται 0 όταν το φύλλο είναι το τελευταίο.
+static int find_leaf(const int file_desc, const BPlusMeta *metadata, const unsigned char *key, int *path,
+                     int *slots, unsigned char *upper, int *bounded, BF_Block *block)
+{
+  const int key_size = metadata->table_schema.key_size;
+  int current_block_id = metadata->root_block_num;
+  if (upper != NULL) {
+    *bounded = 0;
+  }
+
+  // τα πανω επιπεδα διαβαζονται απο τα αντιγραφα της cache, οσο υπαρχουν
+  const BPlusCachedNode *cached = node_cache_root(file_desc, metadata);
+
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    if (path != NULL) {
+      path[level] = current_block_id;
+    }
+
+    // κατω απο τα επιπεδα της cache, απο το page pool οσο μπορει
+    char *data;
+    int pinned = 0;
+    if (cached != NULL) {
+      data = (char *)cached->data;
+    } else if ((data = read_page(file_desc, current_block_id, block, &pinned)) == NULL) {
+      return -1;
+    }
+    const int slot = indexnode_child_slot(data, metadata->index_capacity, key_size, key);
+    const int child = indexnode_children(data, metadata->index_capacity)[slot];
+    // το separator δεξια του παιδιου, οσο πιο βαθια τοσο πιο στενο οριο
+    if (upper != NULL && slot < ((BPlusIndexNode *)data)->key_count) {
+      indexnode_key(data, metadata->index_capacity, key_size, slot, upper);
+      *bounded = 1;
+    }
+    if (cached != NULL) {
+      cached = next_cached(file_desc, cached, slot, level);
+    } else if (pinned) {
+      CALL_BF(BF_UnpinBlock(block));
+    }
+
+    if (slots != NULL) {
+      slots[level] = slot;
+    }
+    current_block_id = child;
+  }
+
+  return current_block_id;
+}
+
+// Προσθέτει delta εγγραφές στο πλήθος του παιδιού που ακολουθήσαμε σε καθένα
+// από τα πρώτα levels επίπεδα της διαδρομής.
+static int adjust_counts(const int file_desc, const int *path, const int *slots, const int levels,
+                         const int capacity, const int delta)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  for (int level = 0; level < levels; level++) {
+    CALL_BF(bplus_get_block(file_desc, path[level], block));
+    indexnode_counts(BF_Block_GetData(block), capacity)[slots[level]] += delta;
+    CALL_BF(bplus_set_dirty(file_desc, path[level], block));
+    CALL_BF(BF_UnpinBlock(block));
+  }
+  BF_Block_Destroy(&block);
+  return 0;
+}
+
+// Προσθέτει το (key, right_child) στον γονέα του επιπέδου level, σπάζοντας
+// κόμβους προς τα πάνω όσο χρειάζεται. Αν σπάσει η ρίζα φτιάχνουμε νέα.
+// Τα left_count / right_count είναι οι εγγραφές των δύο μισών που
+// προέκυψαν από το split στο από κάτω επίπεδο.
+static int insert_into_parent(const int file_desc, BPlusMeta *metadata, const int *path, const int *slots,
+                              int level, const unsigned char *separator, int right_child, int left_count,
+                              int right_count)
+{
+  const int capacity = metadata->index_capacity;
+  const int key_size = metadata->table_schema.key_size;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  memcpy(key, separator, key_size);
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  while (level >= 0) {
+    CALL_BF(bplus_get_block(file_desc, path[level], block));
+    char *data = BF_Block_GetData(block);
+    BPlusIndexNode *node = (BPlusIndexNode *)data;
+    const int pos = indexnode_child_slot(data, capacity, key_size, key);
+    indexnode_counts(data, capacity)[pos] = left_count;
+
+    // υπαρχει χωρος στον γονεα
+    if (node->key_count < capacity) {
+      indexnode_insert_at(data, capacity, key_size, pos, key, right_child, right_count);
+      CALL_BF(bplus_set_dirty(file_desc, path[level], block));
+      CALL_BF(BF_UnpinBlock(block));
+      BF_Block_Destroy(&block);
+      // πιο πανω τα υποδεντρα απλως κερδισαν την εγγραφη που μπηκε
+      return adjust_counts(file_desc, path, slots, level, capacity, 1);
+    }
+
+    // γεματος γονεας - τον σπαμε και συνεχιζουμε ενα επιπεδο πανω
+    BF_Block *new_block;
+    BF_Block_Init(&new_block);
+    const int new_block_id = bplus_allocate_block(file_desc, metadata, new_block);
+    if (new_block_id == -1) {
+      BF_UnpinBlock(block);
+      BF_Block_Destroy(&block);
+      BF_Block_Destroy(&new_block);
+      return -1;
+    }
+
+    unsigned char up_key[BPLUS_MAX_KEY_SIZE];
+    char *new_data = BF_Block_GetData(new_block);
+    indexnode_split(data, new_data, capacity, key_size, pos, key, right_child, right_count, up_key);
+    memcpy(key, up_key, key_size);
+    right_child = new_block_id;
+    left_count = (int)indexnode_total(data, capacity);
+    right_count = (int)indexnode_total(new_data, capacity);
+    metadata->index_block_count++;
+
+    CALL_BF(bplus_set_dirty(file_desc, new_block_id, new_block));
+    CALL_BF(BF_UnpinBlock(new_block));
+    BF_Block_Destroy(&new_block);
+    CALL_BF(bplus_set_dirty(file_desc, path[level], block));
+    CALL_BF(BF_UnpinBlock(block));
+    level--;
+  }
+
+  // εσπασε η ριζα - νεα ριζα με δυο παιδια
+  const int root_id = bplus_allocate_block(file_desc, metadata, block);
+  if (root_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  char *data = BF_Block_GetData(block);
+  indexnode_init(data, capacity, metadata->root_block_num);
+  indexnode_counts(data, capacity)[0] = left_count;
+  indexnode_insert_at(data, capacity, key_size, 0, key, right_child, right_count);
+  CALL_BF(bplus_set_dirty(file_desc, root_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+
+  metadata->root_block_num = root_id;
+  metadata->index_block_count++;
+  metadata->depth++;
+
+  return 0;
+}
+
+// Φτιαχνει το φιλτρο απο την αρχη διατρεχοντας τη λιστα των φυλλων.
+static int build_filter(const int file_desc, const BPlusMeta *metadata, const int bits_per_key)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  int expected = metadata->data_block_count * metadata->leaf_capacity;
+  if (expected < 1024) {
+    expected = 1024;
+  }
+
+  BPlusFilter *filter = filter_create(file_desc, schema->key_size, expected, bits_per_key);
+  if (filter == NULL) {
+    return -1;
+  }
+  if (metadata->root_block_num == -1) {
+    return 0;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  // το αριστεροτερο φυλλο, ακολουθωντας παντα το πρωτο παιδι
+  int block_id = metadata->root_block_num;
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const int child = indexnode_children(BF_Block_GetData(block), metadata->index_capacity)[0];
+    CALL_BF(BF_UnpinBlock(block));
+    block_id = child;
+  }
+
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  while (block_id != -1) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    char *data = BF_Block_GetData(block);
+    const BPlusDataNode *leaf = (const BPlusDataNode *)data;
+    for (int i = 0; i < leaf->key_count; i++) {
+      datanode_key(data, schema, metadata->leaf_capacity, i, key);
+      filter_add(filter, key);
+    }
+    block_id = leaf->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  BF_Block_Destroy(&block);
+  return 0;
+}
+
+// Οι διαγραμμενοι κρατανε τα bits τους και οι νεοι γεμιζουν το φιλτρο: οταν
+// τα false positives ανεβουν αρκετα, το ξαναφτιαχνουμε στο σημερινο μεγεθος.
+static int refresh_filter(const int file_desc, const BPlusMeta *metadata)
+{
+  BPlusFilter *filter = filter_of(file_desc);
+  if (filter == NULL || (filter->stale * 2 <= filter->keys && filter->keys <= 2L * filter->capacity)) {
+    return 0;
+  }
+  const int bits_per_key = filter->bits_per_key;
+  filter_destroy(file_desc);
+  return build_filter(file_desc, metadata, bits_per_key);
+}
+
+int bplus_filter_enable(const int file_desc, const BPlusMeta *metadata, const int bits_per_key)
+{
+  filter_destroy(file_desc);
+  if (bits_per_key <= 0) {
+    return 0;
+  }
+  if (build_filter(file_desc, metadata, bits_per_key) == -1) {
+    filter_destroy(file_desc);
+    return -1;
+  }
+  return 0;
+}
+
+
+int bplus_create_file(const TableSchema *schema, const char *fileName)
+{
+  // Δημιουργία νέου αρχείου
+  CALL_BF(BF_CreateFile(fileName));
+  
+  // Άνοιγμα για να γράψουμε τα metadata
+  int fd;
+  CALL_BF(BF_OpenFile(fileName, &fd));
+  
+  // Δέσμευση πρώτου block για metadata
+  BF_Block *meta_block;
+  BF_Block_Init(&meta_block);
+  CALL_BF(BF_AllocateBlock(fd, meta_block));
+  
+  // Αρχικοποίηση metadata structure
+  BPlusMeta meta;
+  meta.root_block_num = -1;  // αρχικά δεν έχουμε root
+  meta.depth = 0;
+  meta.data_block_count = 0;
+  meta.index_block_count = 0;
+  meta.leaf_capacity = datanode_capacity(schema);
+  meta.index_capacity = indexnode_capacity(schema->key_size);
+  meta.free_block_head = -1;
+  meta.counts_stale = 0;
+  meta.table_schema = *schema;
+  
+  // Γράψιμο metadata στο block
+  char *data = BF_Block_GetData(meta_block);
+  memcpy(data, &meta, sizeof(BPlusMeta));
+  
+  BF_Block_SetDirty(meta_block);
+  CALL_BF(BF_UnpinBlock(meta_block));
+  BF_Block_Destroy(&meta_block);
+  
+  CALL_BF(BF_CloseFile(fd));
+  
+  return 0;
+}
+
+
+// Τα blocks που δεσμευσε στο τελος του αρχειου μια πραξη που αναιρεθηκε στο
+// recovery μενουν γεματα μηδενικα, οπως τα εδωσε το BF. Κανενας κομβος του δεντρου
+// δεν μοιαζει ετσι (ενας κομβος ευρετηριου εχει παντα κλειδια, τα αλλα blocks
+// σημειωνονται στο is_leaf), οποτε μπαινουν στη λιστα ελευθερων.
+static int reclaim_rolled_back_blocks(const int file_desc, BPlusMeta *metadata)
+{
+  int block_count;
+  CALL_BF(BF_GetBlockCounter(file_desc, &block_count));
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  for (int block_id = block_count - 1; block_id > 0; block_id--) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const BPlusIndexNode *node = (const BPlusIndexNode *)BF_Block_GetData(block);
+    const int unused = node->is_leaf == 0 && node->key_count == 0;
+    CALL_BF(BF_UnpinBlock(block));
+    if (!unused) {
+      break;
+    }
+
+    // μια πραξη για καθε block, ωστε να μην ξεπερνιεται το WAL_OP_MAX_PAGES
+    bplus_begin_op(file_desc);
+    const int freed = bplus_free_block(file_desc, metadata, block_id);
+    if (bplus_commit_op(file_desc) == -1 || freed == -1) {
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+  }
+  BF_Block_Destroy(&block);
+  return 0;
+}
+
+int bplus_open_file(const char *fileName, int *file_desc, BPlusMeta **metadata)
+{
+  // Άνοιγμα του αρχείου
+  BF_ErrorCode code = BF_OpenFile(fileName, file_desc);
+  
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    return -1;
+  }
+
+  // αν το αρχειο δεν εκλεισε σωστα, το log φερνει τα blocks στην κατασταση
+  // του τελευταιου commit (το file_desc μπορει να αλλαξει)
+  if (wal_recover(fileName, file_desc) == -1) {
+    fprintf(stderr, "Error: recovery of %s failed\n", fileName);
+    BF_CloseFile(*file_desc);
+    return -1;
+  }
+  
+  // διάβασμα του πρώτου block που έχει τα metadata
+  BF_Block *meta_block;
+  BF_Block_Init(&meta_block);
+  CALL_BF(BF_GetBlock(*file_desc, 0, meta_block));
+  
+  // δεσμευση μνημης για τα metadata
+  *metadata = malloc(sizeof(BPlusMeta));
+  if (*metadata == NULL) {
+    BF_UnpinBlock(meta_block);
+    BF_Block_Destroy(&meta_block);
+    return -1;
+  }
+  
+  // αντιγραφη των metadata απο το block
+  char *data = BF_Block_GetData(meta_block);
+  memcpy(*metadata, data, sizeof(BPlusMeta));
+  
+  CALL_BF(BF_UnpinBlock(meta_block));
+  BF_Block_Destroy(&meta_block);
+
+  // απο εδω και περα καθε αλλαγη γραφεται πρωτα στο log
+  if (wal_open(fileName, *file_desc, *metadata, sizeof(BPlusMeta)) == NULL) {
+    fprintf(stderr, "Error: cannot open the log of %s\n", fileName);
+    free(*metadata);
+    BF_CloseFile(*file_desc);
+    return -1;
+  }
+  // αν αποτυχει, τα blocks απλως μενουν αχρησιμοποιητα, το δεντρο ειναι σωστο
+  if (reclaim_rolled_back_blocks(*file_desc, *metadata) == -1) {
+    fprintf(stderr, "Warning: unused blocks at the end of %s were not reclaimed\n", fileName);
+  }
+  page_pool_attach(*file_desc);
+  
+  return 0;
+}
+
+int bplus_close_file(const int file_desc, BPlusMeta* metadata)
+{
+  // οι εγγραφες που περιμενουν στο buffer μπαινουν πρωτα στο δεντρο
+  if (bplus_insert_buffer_enable(file_desc, metadata, 0) == -1) {
+    return -1;
+  }
+
+  // πρεπει να σωσουμε τα metadata πισω στο αρχειο πριν κλεισουμε
+  BF_Block *meta_block;
+  BF_Block_Init(&meta_block);
+  CALL_BF(BF_GetBlock(file_desc, 0, meta_block));
+  
+  // γραψιμο των updated metadata
+  char *data = BF_Block_GetData(meta_block);
+  memcpy(data, metadata, sizeof(BPlusMeta));
+  
+  BF_Block_SetDirty(meta_block);
+  CALL_BF(BF_UnpinBlock(meta_block));
+  BF_Block_Destroy(&meta_block);
+  
+  // κλεισιμο αρχειου
+  filter_destroy(file_desc);
+  node_cache_destroy(file_desc);
+  page_pool_detach(file_desc);
+  Wal *wal = wal_of(file_desc);
+  CALL_BF(BF_CloseFile(file_desc));
+
+  // τα blocks εχουν γραφτει, το log δεν χρειαζεται πια
+  const int result = wal == NULL ? 0 : wal_close(wal);
+  
+  // ελευθερωση μνημης
+  free(metadata);
+  
+  return result;
+}
+
+int bplus_sync(const int file_desc)
+{
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return -1;
+  }
+  Wal *wal = wal_of(file_desc);
+  return wal == NULL ? -1 : wal_sync(wal);
+}
+
+void bplus_set_synchronous_commit(const int file_desc, const int synchronous)
+{
+  Wal *wal = wal_of(file_desc);
+  if (wal != NULL) {
+    wal_set_synchronous(wal, synchronous);
+  }
+}
+
+static int insert_record(const int file_desc, BPlusMeta *metadata, const Record *record)
+{
+  // βρισκουμε το κανονικοποιημενο key απο το record
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&metadata->table_schema, record, key);
+  const int capacity = metadata->leaf_capacity;
+
+  // ενα κλειδι στο φιλτρο που τελικα δεν μπηκε κοστιζει μονο ενα false positive
+  BPlusFilter *filter = filter_of(file_desc);
+  if (filter != NULL) {
+    filter_add(filter, key);
+  }
+
+  BF_Block *block = NULL;
+  BF_Block_Init(&block);
+
+  // αν εχουμε αδειο δεντρο - φτιαχνουμε το πρωτο leaf που ειναι και ριζα
+  if (metadata->root_block_num == -1) {
+    int new_block_id = bplus_allocate_block(file_desc, metadata, block);
+    if (new_block_id == -1) {
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+
+    char *data = BF_Block_GetData(block);
+    datanode_init(data);
+    datanode_insert_at(data, &metadata->table_schema, capacity, 0, record);
+
+    CALL_BF(bplus_set_dirty(file_desc, new_block_id, block));
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+
+    // ενημερωση metadata
+    metadata->root_block_num = new_block_id;
+    metadata->data_block_count = 1;
+    metadata->depth = 1;
+
+    return new_block_id;
+  }
+
+  // κατεβαινουμε στο σωστο leaf κρατωντας τη διαδρομη για τα splits
+  int path[BPLUS_MAX_DEPTH];
+  int slots[BPLUS_MAX_DEPTH];
+  int leaf_id = find_leaf(file_desc, metadata, key, path, slots, NULL, NULL, block);
+  if (leaf_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  CALL_BF(bplus_get_block(file_desc, leaf_id, block));
+  char *data = BF_Block_GetData(block);
+  BPlusDataNode *leaf = (BPlusDataNode *)data;
+  int found;
+  int pos = datanode_search(data, &metadata->table_schema, capacity, key, &found);
+
+  // ελεγχος για duplicate key - δεν το επιτρεπουμε
+  if (found) {
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  // αν ο κομβος εχει χωρο απλα το βαζουμε στη θεση του
+  if (leaf->key_count < capacity) {
+    datanode_insert_at(data, &metadata->table_schema, capacity, pos, record);
+    CALL_BF(bplus_set_dirty(file_desc, leaf_id, block));
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    if (adjust_counts(file_desc, path, slots, metadata->depth - 1, metadata->index_capacity, 1) == -1) {
+      return -1;
+    }
+    return leaf_id;
+  }
+
+  // γεματο φυλλο - split σε δυο και το νεο μπαινει δεξια στη λιστα
+  BF_Block *new_block;
+  BF_Block_Init(&new_block);
+  int new_block_id = bplus_allocate_block(file_desc, metadata, new_block);
+  if (new_block_id == -1) {
+    BF_UnpinBlock(block);
+    BF_Block_Destroy(&block);
+    BF_Block_Destroy(&new_block);
+    return -1;
+  }
+
+  char *new_data = BF_Block_GetData(new_block);
+  datanode_init(new_data);
+
+  int in_new;
+  unsigned char separator[BPLUS_MAX_KEY_SIZE];
+  datanode_split(data, new_data, &metadata->table_schema, capacity, pos, record, &in_new, separator);
+  ((BPlusDataNode *)new_data)->next_block = leaf->next_block;
+  leaf->next_block = new_block_id;
+  const int left_count = leaf->key_count;
+  const int right_count = ((BPlusDataNode *)new_data)->key_count;
+
+  CALL_BF(bplus_set_dirty(file_desc, new_block_id, new_block));
+  CALL_BF(BF_UnpinBlock(new_block));
+  BF_Block_Destroy(&new_block);
+  CALL_BF(bplus_set_dirty(file_desc, leaf_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+
+  metadata->data_block_count++;
+
+  if (insert_into_parent(file_desc, metadata, path, slots, metadata->depth - 2, separator, new_block_id,
+                         left_count, right_count) == -1) {
+    return -1;
+  }
+
+  return in_new ? new_block_id : leaf_id;
+}
+
+// Αδειάζει το buffer στο δέντρο κατά σειρά κλειδιών. Κάθε φύλλο παίρνει με μία
+// επίσκεψη (και μία εγγραφή στο log) όσες εγγραφές του ανήκουν και χωράνε.
+static int flush_buffer(const int file_desc, BPlusInsertBuffer *buffer)
+{
+  BPlusMeta *metadata = buffer->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  const int capacity = metadata->leaf_capacity;
+  const RecordDeserializer deserialize = record_deserializer(schema);
+  int *order = insert_buffer_sorted(buffer);
+  if (order == NULL) {
+    return -1;
+  }
+
+  BPlusFilter *filter = filter_of(file_desc);
+  BF_Block *block;
+  BF_Block_Init(&block);
+  Record record;
+  int next = 0;
+  int result = 0;
+
+  while (result == 0 && next < buffer->count) {
+    const unsigned char *key = insert_buffer_key(buffer, order[next]);
+    unsigned char upper[BPLUS_MAX_KEY_SIZE];
+    int bounded;
+    int full = 1;
+    int path[BPLUS_MAX_DEPTH];
+    int slots[BPLUS_MAX_DEPTH];
+
+    const int leaf_id = metadata->root_block_num == -1
+                          ? -1
+                          : find_leaf(file_desc, metadata, key, path, slots, upper, &bounded, block);
+
+    if (leaf_id != -1) {
+      bplus_begin_op(file_desc);
+      if (bplus_get_block(file_desc, leaf_id, block) != BF_OK) {
+        bplus_commit_op(file_desc);
+        result = -1;
+        break;
+      }
+      char *data = BF_Block_GetData(block);
+      BPlusDataNode *leaf = (BPlusDataNode *)data;
+      int added = 0;
+      full = 0;
+
+      while (next < buffer->count) {
+        key = insert_buffer_key(buffer, order[next]);
+        if (bounded && memcmp(key, upper, schema->key_size) >= 0) {
+          break;
+        }
+        int found;
+        const int pos = datanode_search(data, schema, capacity, key, &found);
+        if (found) {
+          buffer->duplicates++;
+          next++;
+          continue;
+        }
+        if (leaf->key_count == capacity) {
+          full = 1;
+          break;
+        }
+        deserialize(schema, insert_buffer_record(buffer, order[next]), &record);
+        datanode_insert_at(data, schema, capacity, pos, &record);
+        if (filter != NULL) {
+          filter_add(filter, key);
+        }
+        added++;
+        next++;
+      }
+
+      if (added > 0 && bplus_set_dirty(file_desc, leaf_id, block) != BF_OK) {
+        result = -1;
+      }
+      if (BF_UnpinBlock(block) != BF_OK) {
+        result = -1;
+      }
+      if (added > 0 && adjust_counts(file_desc, path, slots, metadata->depth - 1, metadata->index_capacity,
+                                     added) == -1) {
+        result = -1;
+      }
+      if (bplus_commit_op(file_desc) == -1) {
+        result = -1;
+      }
+    }
+
+    // γεματο φυλλο (ή αδειο δεντρο): η επομενη εγγραφη μπαινει με split και ξανακατεβαινουμε
+    if (result == 0 && full && next < buffer->count) {
+      deserialize(schema, insert_buffer_record(buffer, order[next]), &record);
+      bplus_begin_op(file_desc);
+      const int inserted = insert_record(file_desc, metadata, &record);
+      if (bplus_commit_op(file_desc) == -1 || inserted == -1) {
+        result = -1;
+      } else {
+        next++;
+      }
+    }
+  }
+
+  // οτι δεν προλαβε να μπει μενει στο buffer
+  if (insert_buffer_retain(buffer, order + next, buffer->count - next) == -1) {
+    result = -1;
+  }
+  buffer->flushes++;
+  free(order);
+  BF_Block_Destroy(&block);
+  if (result == 0 && refresh_filter(file_desc, metadata) == -1) {
+    result = -1;
+  }
+  return result;
+}
+
+// Μια εγγραφη του buffer με κλειδι που υπαρχει ηδη στο δεντρο ειναι διπλοτυπο που απορριπτεται
+static void drop_duplicate(BPlusInsertBuffer *buffer, const unsigned char *key)
+{
+  if (insert_buffer_remove(buffer, key) == 0) {
+    buffer->duplicates++;
+  }
+}
+
+int bplus_insert_buffer_enable(const int file_desc, BPlusMeta *metadata, const int max_records)
+{
+  if (insert_buffer_of(file_desc) != NULL) {
+    if (flush_buffer(file_desc, insert_buffer_of(file_desc)) == -1) {
+      return -1;
+    }
+    insert_buffer_destroy(file_desc);
+  }
+  if (max_records <= 0) {
+    return 0;
+  }
+  return insert_buffer_create(file_desc, metadata, max_records) == NULL ? -1 : 0;
+}
+
+int bplus_insert_buffer_flush(const int file_desc)
+{
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  if (buffer == NULL) {
+    return 0;
+  }
+  const long duplicates = buffer->duplicates;
+  if (flush_buffer(file_desc, buffer) == -1) {
+    return -1;
+  }
+  return (int)(buffer->duplicates - duplicates);
+}
+
+int bplus_record_insert(const int file_desc, BPlusMeta *metadata, const Record *record)
+{
+  // με buffer η εγγραφη μενει στη μνημη ως το επομενο flush
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  if (buffer != NULL) {
+    unsigned char key[BPLUS_MAX_KEY_SIZE];
+    bplus_key_from_record(&metadata->table_schema, record, key);
+    if (insert_buffer_get(buffer, key) != NULL) {
+      return -1;
+    }
+    if (buffer->count == buffer->capacity && flush_buffer(file_desc, buffer) == -1) {
+      return -1;
+    }
+    return insert_buffer_add(buffer, key, record);
+  }
+
+  bplus_begin_op(file_desc);
+  const int result = insert_record(file_desc, metadata, record);
+  if (bplus_commit_op(file_desc) == -1 || refresh_filter(file_desc, metadata) == -1) {
+    return -1;
+  }
+  return result;
+}
+
+// Αναζητηση στο δεντρο με ετοιμο κανονικοποιημενο κλειδι.
+static int find_in_tree(const int file_desc, const BPlusMeta *metadata, const unsigned char *key,
+                       Record **out_record)
+{
+  *out_record = NULL;
+
+  // αν το δεντρο ειναι αδειο
+  if (metadata->root_block_num == -1) {
+    return -1;
+  }
+
+  // κλειδι που το φιλτρο δεν εχει δει σιγουρα δεν υπαρχει - καμια σελιδα
+  const BPlusFilter *filter = filter_of(file_desc);
+  if (filter != NULL && !filter_may_contain(filter, key)) {
+    return -1;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  int leaf_id = find_leaf(file_desc, metadata, key, NULL, NULL, NULL, NULL, block);
+  if (leaf_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  int pinned;
+  char *data = read_page(file_desc, leaf_id, block, &pinned);
+  if (data == NULL) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  // ψαχνουμε μονο στον πινακα των heads, οι εγγραφες διαβαζονται σε ισοπαλια
+  const TableSchema *schema = &metadata->table_schema;
+  int found;
+  const int pos = datanode_search(data, schema, metadata->leaf_capacity, key, &found);
+  int result = -1;
+  if (found && (*out_record = malloc(sizeof(Record))) != NULL) {
+    record_deserialize(schema, datanode_record(data, schema, metadata->leaf_capacity, pos), *out_record);
+    result = 0;
+  }
+
+  if (pinned) {
+    CALL_BF(BF_UnpinBlock(block));
+  }
+  BF_Block_Destroy(&block);
+  return result;
+}
+
+// Αναζητηση κοινη για ολες τις μορφες του find: πρωτα στο buffer, μετα στο δεντρο.
+static int find_record(const int file_desc, const BPlusMeta *metadata, const unsigned char *key,
+                       Record **out_record)
+{
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  const char *buffered = buffer != NULL ? insert_buffer_get(buffer, key) : NULL;
+  if (buffered == NULL) {
+    return find_in_tree(file_desc, metadata, key, out_record);
+  }
+
+  // η εγγραφη του buffer ισχυει μονο αν το κλειδι δεν ειναι ηδη στο δεντρο
+  if (find_in_tree(file_desc, metadata, key, out_record) == 0) {
+    drop_duplicate(buffer, key);
+    return 0;
+  }
+  *out_record = malloc(sizeof(Record));
+  if (*out_record == NULL) {
+    return -1;
+  }
+  record_deserialize(&metadata->table_schema, buffered, *out_record);
+  return 0;
+}
+
+int bplus_record_find(const int file_desc, const BPlusMeta *metadata, const int key, Record** out_record)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+  *out_record = NULL;
+
+  if (bplus_key_from_int(&metadata->table_schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_record_find_by_key\n");
+    return -1;
+  }
+  return find_record(file_desc, metadata, normalized, out_record);
+}
+
+int bplus_record_find_by_key(const int file_desc, const BPlusMeta *metadata, const Record *key_record,
+                             Record **out_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&metadata->table_schema, key_record, key);
+  return find_record(file_desc, metadata, key, out_record);
+}
+
+// Ταξινομει τις θεσεις των κλειδιων κατα κλειδι (merge sort απο κατω προς τα πανω).
+// Επιστρεφει τον πινακα απο τους δυο (order, tmp) που κρατησε το αποτελεσμα.
+static int *sort_probes(const unsigned char *keys, const int key_size, int *order, int *tmp, const int n)
+{
+  for (int width = 1; width < n; width *= 2) {
+    for (int lo = 0; lo < n; lo += 2 * width) {
+      const int mid = lo + width < n ? lo + width : n;
+      const int hi = lo + 2 * width < n ? lo + 2 * width : n;
+      int a = lo, b = mid, k = lo;
+      while (a < mid && b < hi) {
+        tmp[k++] = memcmp(keys + order[b] * key_size, keys + order[a] * key_size, key_size) < 0 ? order[b++]
+                                                                                                : order[a++];
+      }
+      while (a < mid) {
+        tmp[k++] = order[a++];
+      }
+      while (b < hi) {
+        tmp[k++] = order[b++];
+      }
+    }
+    int *swap = order;
+    order = tmp;
+    tmp = swap;
+  }
+  return order;
+}
+
+// Πολλες αναζητησεις μαζι. Τα κλειδια εξεταζονται ταξινομημενα και κραταμε τη
+// διαδρομη της τελευταιας καταβασης μαζι με το ανω οριο καθε κομβου της: το
+// επομενο κλειδι ξεκιναει απο τον βαθυτερο κομβο που το περιεχει ακομα, οποτε
+// κλειδια του ιδιου φυλλου λυνονται με μια αναγνωση του και γειτονικα φυλλα
+// χρειαζονται μονο τον κοινο γονεα.
+static int find_many(const int file_desc, const BPlusMeta *metadata, const unsigned char *keys, const int n,
+                     Record *out, int *found)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  const int key_size = schema->key_size;
+  const RecordDeserializer deserialize = record_deserializer(schema);
+  const int leaf_level = metadata->depth - 1;
+  const BPlusFilter *filter = filter_of(file_desc);
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+
+  int *order = malloc(2 * (size_t)(n > 0 ? n : 1) * sizeof(int));
+  if (order == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+    found[i] = 0;
+  }
+  const int *sorted = sort_probes(keys, key_size, order, order + n, n);
+
+  // path[l] ο κομβος του επιπεδου l και uppers[l] το πρωτο κλειδι που δεν του ανηκει
+  int path[BPLUS_MAX_DEPTH];
+  int bounded[BPLUS_MAX_DEPTH];
+  unsigned char uppers[BPLUS_MAX_DEPTH][BPLUS_MAX_KEY_SIZE];
+  const BPlusCachedNode *cached[BPLUS_MAX_DEPTH];
+  int level = -1; // βαθυτερο επιπεδο της διαδρομης που ισχυει
+  int leaf_pinned = 0;
+  int result = 0;
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  for (int s = 0; s < n && metadata->root_block_num != -1; s++) {
+    const int i = sorted[s];
+    const unsigned char *key = keys + i * key_size;
+    if (filter != NULL && !filter_may_contain(filter, key)) {
+      continue;
+    }
+
+    // ανεβαινουμε οσο το κλειδι ειναι περα απο το οριο του κομβου
+    while (level >= 0 && bounded[level] && memcmp(key, uppers[level], key_size) >= 0) {
+      level--;
+    }
+
+    if (level < leaf_level) {
+      if (leaf_pinned) {
+        leaf_pinned = 0;
+        if (BF_UnpinBlock(block) != BF_OK) {
+          result = -1;
+          break;
+        }
+      }
+      if (level < 0) {
+        level = 0;
+        path[0] = metadata->root_block_num;
+        cached[0] = node_cache_root(file_desc, metadata);
+        bounded[0] = 0;
+      }
+
+      // καταβαση απο τον κοινο προγονο, τα ορια στενευουν σε καθε επιπεδο
+      while (level < leaf_level) {
+        char *data;
+        if (cached[level] != NULL) {
+          data = (char *)cached[level]->data;
+        } else if (BF_GetBlock(file_desc, path[level], block) == BF_OK) {
+          data = BF_Block_GetData(block);
+        } else {
+          result = -1;
+          break;
+        }
+        const int slot = indexnode_child_slot(data, metadata->index_capacity, key_size, key);
+        path[level + 1] = indexnode_children(data, metadata->index_capacity)[slot];
+        if (slot < ((BPlusIndexNode *)data)->key_count) {
+          indexnode_key(data, metadata->index_capacity, key_size, slot, uppers[level + 1]);
+          bounded[level + 1] = 1;
+        } else {
+          memcpy(uppers[level + 1], uppers[level], key_size);
+          bounded[level + 1] = bounded[level];
+        }
+        if (cached[level] != NULL) {
+          cached[level + 1] = next_cached(file_desc, cached[level], slot, level);
+        } else {
+          cached[level + 1] = NULL;
+          if (BF_UnpinBlock(block) != BF_OK) {
+            result = -1;
+            break;
+          }
+        }
+        level++;
+      }
+      if (result == -1 || BF_GetBlock(file_desc, path[leaf_level], block) != BF_OK) {
+        result = -1;
+        break;
+      }
+      leaf_pinned = 1;
+    }
+
+    char *data = BF_Block_GetData(block);
+    int hit;
+    const int pos = datanode_search(data, schema, metadata->leaf_capacity, key, &hit);
+    if (hit) {
+      deserialize(schema, datanode_record(data, schema, metadata->leaf_capacity, pos), &out[i]);
+      found[i] = 1;
+    }
+  }
+
+  if (leaf_pinned && BF_UnpinBlock(block) != BF_OK) {
+    result = -1;
+  }
+  BF_Block_Destroy(&block);
+  free(order);
+  if (result == -1) {
+    return -1;
+  }
+
+  // οι εγγραφες του buffer ισχυουν οπως στο find_record
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    const unsigned char *key = keys + i * key_size;
+    const char *buffered = buffer != NULL ? insert_buffer_get(buffer, key) : NULL;
+    if (buffered != NULL && found[i]) {
+      drop_duplicate(buffer, key);
+    } else if (buffered != NULL) {
+      deserialize(schema, buffered, &out[i]);
+      found[i] = 1;
+    }
+    count += found[i];
+  }
+  return count;
+}
+
+int bplus_record_find_many(const int file_desc, const BPlusMeta *metadata, const int *keys, const int n,
+                           Record *out, int *found)
+{
+  const int key_size = metadata->table_schema.key_size;
+  unsigned char *normalized = malloc((size_t)(n > 0 ? n : 1) * key_size);
+  if (normalized == NULL) {
+    return -1;
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (bplus_key_from_int(&metadata->table_schema, keys[i], normalized + i * key_size) == -1) {
+      fprintf(stderr, "Error: key is not a single INT attribute, use bplus_record_find_many_by_key\n");
+      free(normalized);
+      return -1;
+    }
+  }
+
+  const int result = find_many(file_desc, metadata, normalized, n, out, found);
+  free(normalized);
+  return result;
+}
+
+int bplus_record_find_many_by_key(const int file_desc, const BPlusMeta *metadata, const Record *key_records,
+                                  const int n, Record *out, int *found)
+{
+  const int key_size = metadata->table_schema.key_size;
+  unsigned char *normalized = malloc((size_t)(n > 0 ? n : 1) * key_size);
+  if (normalized == NULL) {
+    return -1;
+  }
+
+  for (int i = 0; i < n; i++) {
+    bplus_key_from_record(&metadata->table_schema, &key_records[i], normalized + i * key_size);
+  }
+
+  const int result = find_many(file_desc, metadata, normalized, n, out, found);
+  free(normalized);
+  return result;
+}
+
+// Ξαναμετραει τα πληθη του υποδεντρου του block_id και επιστρεφει ποσες εγγραφες
+// εχει (-1 σε σφαλμα). Καθε κομβος γραφεται σε δικη του πραξη, ωστε καμια πραξη
+// του log να μη χρειαζεται ολο το δεντρο.
+static long recount(const int file_desc, const BPlusMeta *metadata, const int block_id, const int level)
+{
+  const int capacity = metadata->index_capacity;
+  BF_Block *block;
+  BF_Block_Init(&block);
+  CALL_BF(BF_GetBlock(file_desc, block_id, block));
+  char *data = BF_Block_GetData(block);
+
+  if (level == metadata->depth - 1) {
+    const long count = ((BPlusDataNode *)data)->key_count;
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return count;
+  }
+
+  int children[BF_BLOCK_SIZE / sizeof(int)];
+  int counts[BF_BLOCK_SIZE / sizeof(int)];
+  const int child_count = ((BPlusIndexNode *)data)->key_count + 1;
+  memcpy(children, indexnode_children(data, capacity), child_count * sizeof(int));
+  CALL_BF(BF_UnpinBlock(block));
+
+  long total = 0;
+  for (int c = 0; c < child_count; c++) {
+    const long count = recount(file_desc, metadata, children[c], level + 1);
+    if (count == -1) {
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+    counts[c] = (int)count;
+    total += count;
+  }
+
+  bplus_begin_op(file_desc);
+  if (bplus_get_block(file_desc, block_id, block) != BF_OK) {
+    bplus_commit_op(file_desc);
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+  memcpy(indexnode_counts(BF_Block_GetData(block), capacity), counts, child_count * sizeof(int));
+  const int failed = bplus_set_dirty(file_desc, block_id, block) != BF_OK || BF_UnpinBlock(block) != BF_OK;
+  BF_Block_Destroy(&block);
+  if (bplus_commit_op(file_desc) == -1 || failed) {
+    return -1;
+  }
+  return total;
+}
+
+// Οι εγγραφες του buffer μπαινουν στο δεντρο και τα πληθη ξαναμετριουνται αν
+// τα πειραξαν writers που δεν τα ενημερωνουν (bplus_shared_open).
+static int prepare_counts(const int file_desc, BPlusMeta *metadata)
+{
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return -1;
+  }
+  if (!metadata->counts_stale) {
+    return 0;
+  }
+  if (metadata->root_block_num != -1 && recount(file_desc, metadata, metadata->root_block_num, 0) == -1) {
+    return -1;
+  }
+  bplus_begin_op(file_desc);
+  metadata->counts_stale = 0;
+  return bplus_commit_op(file_desc);
+}
+
+// Ποσες εγγραφες εχουν κλειδι μικροτερο απο το key: τα πληθη των παιδιων αριστερα
+// της διαδρομης και η θεση του key στο φυλλο. Το *found γινεται 1 αν το key υπαρχει.
+static long rank_of(const int file_desc, const BPlusMeta *metadata, const unsigned char *key, int *found)
+{
+  const int capacity = metadata->index_capacity;
+  long rank = 0;
+  *found = 0;
+  if (metadata->root_block_num == -1) {
+    return 0;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int block_id = metadata->root_block_num;
+
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    char *data = BF_Block_GetData(block);
+    const int slot = indexnode_child_slot(data, capacity, metadata->table_schema.key_size, key);
+    const int *counts = indexnode_counts(data, capacity);
+    for (int c = 0; c < slot; c++) {
+      rank += counts[c];
+    }
+    block_id = indexnode_children(data, capacity)[slot];
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  CALL_BF(BF_GetBlock(file_desc, block_id, block));
+  rank += datanode_search(BF_Block_GetData(block), &metadata->table_schema, metadata->leaf_capacity, key, found);
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return rank;
+}
+
+static int count_range(const int file_desc, BPlusMeta *metadata, const unsigned char *lo, const unsigned char *hi)
+{
+  if (prepare_counts(file_desc, metadata) == -1) {
+    return -1;
+  }
+  if (memcmp(lo, hi, metadata->table_schema.key_size) > 0) {
+    return 0;
+  }
+
+  int lo_found, hi_found;
+  const long below_lo = rank_of(file_desc, metadata, lo, &lo_found);
+  const long below_hi = rank_of(file_desc, metadata, hi, &hi_found);
+  if (below_lo == -1 || below_hi == -1) {
+    return -1;
+  }
+  return (int)(below_hi + hi_found - below_lo);
+}
+
+int bplus_count_range(const int file_desc, BPlusMeta *metadata, const int lo, const int hi)
+{
+  unsigned char lo_key[BPLUS_MAX_KEY_SIZE];
+  unsigned char hi_key[BPLUS_MAX_KEY_SIZE];
+
+  if (bplus_key_from_int(&metadata->table_schema, lo, lo_key) == -1 ||
+      bplus_key_from_int(&metadata->table_schema, hi, hi_key) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_count_range_by_key\n");
+    return -1;
+  }
+  return count_range(file_desc, metadata, lo_key, hi_key);
+}
+
+int bplus_count_range_by_key(const int file_desc, BPlusMeta *metadata, const Record *lo_record,
+                             const Record *hi_record)
+{
+  unsigned char lo_key[BPLUS_MAX_KEY_SIZE];
+  unsigned char hi_key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&metadata->table_schema, lo_record, lo_key);
+  bplus_key_from_record(&metadata->table_schema, hi_record, hi_key);
+  return count_range(file_desc, metadata, lo_key, hi_key);
+}
+
+// Απο το φυλλο του lo και μετα κατα μηκος της λιστας των φυλλων, ως το πρωτο κλειδι > hi
+static int range_scan(const int file_desc, const BPlusMeta *metadata, const unsigned char *lo,
+                      const unsigned char *hi, int (*visit)(const Record *record, void *ctx), void *ctx)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  const RecordDeserializer deserialize = record_deserializer(schema);
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return -1;
+  }
+  if (metadata->root_block_num == -1 || memcmp(lo, hi, schema->key_size) > 0) {
+    return 0;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int block_id = find_leaf(file_desc, metadata, lo, NULL, NULL, NULL, NULL, block);
+  if (block_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  // ενα φυλλο απο το page pool αντιγραφεται, γιατι το visit μπορει να ξανακαλεσει το pool
+  char copy[BF_BLOCK_SIZE];
+  int visited = 0;
+  int done = 0;
+  int found;
+  int pinned;
+  char *data = read_page(file_desc, block_id, block, &pinned);
+  if (data == NULL) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+  if (!pinned) {
+    data = memcpy(copy, data, BF_BLOCK_SIZE);
+  }
+  int pos = datanode_search(data, schema, metadata->leaf_capacity, lo, &found);
+
+  while (1) {
+    const BPlusDataNode *leaf = (const BPlusDataNode *)data;
+    for (; pos < leaf->key_count && !done; pos++) {
+      const char *packed = datanode_record(data, schema, metadata->leaf_capacity, pos);
+      if (bplus_key_compare_packed(schema, hi, packed) < 0) {
+        done = 1;
+        break;
+      }
+      Record record;
+      deserialize(schema, packed, &record);
+      visited++;
+      done = visit(&record, ctx) != 0;
+    }
+
+    const int next = leaf->next_block;
+    if (pinned) {
+      CALL_BF(BF_UnpinBlock(block));
+    }
+    if (done || next == -1) {
+      break;
+    }
+    if ((data = read_page(file_desc, next, block, &pinned)) == NULL) {
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+    if (!pinned) {
+      data = memcpy(copy, data, BF_BLOCK_SIZE);
+    }
+    pos = 0;
+  }
+
+  BF_Block_Destroy(&block);
+  return visited;
+}
+
+int bplus_range_scan(const int file_desc, const BPlusMeta *metadata, const int lo, const int hi,
+                     int (*visit)(const Record *record, void *ctx), void *ctx)
+{
+  unsigned char lo_key[BPLUS_MAX_KEY_SIZE];
+  unsigned char hi_key[BPLUS_MAX_KEY_SIZE];
+
+  if (bplus_key_from_int(&metadata->table_schema, lo, lo_key) == -1 ||
+      bplus_key_from_int(&metadata->table_schema, hi, hi_key) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_range_scan_by_key\n");
+    return -1;
+  }
+  return range_scan(file_desc, metadata, lo_key, hi_key, visit, ctx);
+}
+
+int bplus_range_scan_by_key(const int file_desc, const BPlusMeta *metadata, const Record *lo_record,
+                            const Record *hi_record, int (*visit)(const Record *record, void *ctx), void *ctx)
+{
+  unsigned char lo_key[BPLUS_MAX_KEY_SIZE];
+  unsigned char hi_key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&metadata->table_schema, lo_record, lo_key);
+  bplus_key_from_record(&metadata->table_schema, hi_record, hi_key);
+  return range_scan(file_desc, metadata, lo_key, hi_key, visit, ctx);
+}
+
+int bplus_select_kth(const int file_desc, BPlusMeta *metadata, int k, Record *out_record)
+{
+  if (prepare_counts(file_desc, metadata) == -1 || metadata->root_block_num == -1 || k < 1) {
+    return -1;
+  }
+
+  const int capacity = metadata->index_capacity;
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int block_id = metadata->root_block_num;
+
+  // σε καθε κομβο προσπερναμε ολοκληρα τα υποδεντρα που εχουν λιγοτερες απο k εγγραφες
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    char *data = BF_Block_GetData(block);
+    const int *counts = indexnode_counts(data, capacity);
+    const int key_count = ((BPlusIndexNode *)data)->key_count;
+    int c = 0;
+    while (c < key_count && k > counts[c]) {
+      k -= counts[c];
+      c++;
+    }
+    block_id = indexnode_children(data, capacity)[c];
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  CALL_BF(BF_GetBlock(file_desc, block_id, block));
+  char *data = BF_Block_GetData(block);
+  const int found = k <= ((BPlusDataNode *)data)->key_count;
+  if (found) {
+    record_deserialize(&metadata->table_schema,
+                       datanode_record(data, &metadata->table_schema, metadata->leaf_capacity, k - 1), out_record);
+  }
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return found ? 0 : -1;
+}
+
+static int update_record(const int file_desc, const BPlusMeta *metadata, const Record *record)
+{
+  if (metadata->root_block_num == -1) {
+    return -1;
+  }
+
+  const TableSchema *schema = &metadata->table_schema;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(schema, record, key);
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  const int leaf_id = find_leaf(file_desc, metadata, key, NULL, NULL, NULL, NULL, block);
+  if (leaf_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  CALL_BF(bplus_get_block(file_desc, leaf_id, block));
+  char *data = BF_Block_GetData(block);
+  int found;
+  const int pos = datanode_search(data, schema, metadata->leaf_capacity, key, &found);
+
+  // το κλειδι δεν αλλαζει, οποτε η εγγραφη ξαναγραφεται στην ιδια θεση
+  if (found) {
+    const RecordSerializer serialize = record_serializer(schema);
+    serialize(schema, record, datanode_record(data, schema, metadata->leaf_capacity, pos));
+    CALL_BF(bplus_set_dirty(file_desc, leaf_id, block));
+  }
+
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return found ? leaf_id : -1;
+}
+
+int bplus_record_update(const int file_desc, const BPlusMeta *metadata, const Record *record)
+{
+  bplus_begin_op(file_desc);
+  int result = update_record(file_desc, metadata, record);
+  if (bplus_commit_op(file_desc) == -1) {
+    return -1;
+  }
+
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  if (buffer != NULL) {
+    unsigned char key[BPLUS_MAX_KEY_SIZE];
+    bplus_key_from_record(&metadata->table_schema, record, key);
+    char *buffered = insert_buffer_get(buffer, key);
+    if (buffered != NULL && result != -1) {
+      drop_duplicate(buffer, key);
+    } else if (buffered != NULL) {
+      const RecordSerializer serialize = record_serializer(&metadata->table_schema);
+      serialize(&metadata->table_schema, record, buffered);
+      result = 0;
+    }
+  }
+  return result;
+}
+
+// Αποκαθιστά τους κόμβους ευρετηρίου από το επίπεδο level και πάνω μετά από
+// merge στα παιδιά τους: δανεισμός από αδελφό, αλλιώς συγχώνευση με αυτόν.
+static int rebalance_index(const int file_desc, BPlusMeta *metadata, const int *path, const int *slots, int level)
+{
+  const int capacity = metadata->index_capacity;
+  const int key_size = metadata->table_schema.key_size;
+  const int min_keys = capacity / 2;
+  int result = 0;
+
+  BF_Block *block, *parent_block, *sibling_block;
+  BF_Block_Init(&block);
+  BF_Block_Init(&parent_block);
+  BF_Block_Init(&sibling_block);
+
+  while (level >= 0) {
+    const int node_id = path[level];
+    CALL_BF(bplus_get_block(file_desc, node_id, block));
+    char *data = BF_Block_GetData(block);
+    BPlusIndexNode *node = (BPlusIndexNode *)data;
+
+    // η ριζα μπορει να εχει λιγοτερα κλειδια, αν μεινει με ενα παιδι το δεντρο κονταινει
+    if (level == 0) {
+      const int only_child = indexnode_children(data, capacity)[0];
+      const int collapse = node->key_count == 0;
+      CALL_BF(BF_UnpinBlock(block));
+
+      if (collapse) {
+        metadata->root_block_num = only_child;
+        metadata->depth--;
+        metadata->index_block_count--;
+        if (bplus_free_block(file_desc, metadata, node_id) == -1) {
+          result = -1;
+        }
+      }
+      break;
+    }
+
+    if (node->key_count >= min_keys) {
+      CALL_BF(BF_UnpinBlock(block));
+      break;
+    }
+
+    CALL_BF(bplus_get_block(file_desc, path[level - 1], parent_block));
+    char *parent_data = BF_Block_GetData(parent_block);
+    int *parent_children = indexnode_children(parent_data, capacity);
+    const int slot = slots[level - 1];
+
+    // προτιμαμε τον αριστερο αδελφο, ο πρωτος κομβος εχει μονο δεξι
+    const int use_left = slot > 0;
+    const int sibling_id = use_left ? parent_children[slot - 1] : parent_children[slot + 1];
+    const int sep_pos = use_left ? slot - 1 : slot;
+    CALL_BF(bplus_get_block(file_desc, sibling_id, sibling_block));
+    char *sibling_data = BF_Block_GetData(sibling_block);
+    int freed = -1;
+
+    if (((BPlusIndexNode *)sibling_data)->key_count > min_keys) {
+      if (use_left) {
+        indexnode_borrow_left(data, sibling_data, parent_data, capacity, key_size, sep_pos);
+      } else {
+        indexnode_borrow_right(data, sibling_data, parent_data, capacity, key_size, sep_pos);
+      }
+    } else {
+      if (use_left) {
+        indexnode_merge(sibling_data, data, parent_data, capacity, key_size, sep_pos);
+        freed = node_id;
+      } else {
+        indexnode_merge(data, sibling_data, parent_data, capacity, key_size, sep_pos);
+        freed = sibling_id;
+      }
+      metadata->index_block_count--;
+    }
+
+    CALL_BF(bplus_set_dirty(file_desc, node_id, block));
+    CALL_BF(bplus_set_dirty(file_desc, sibling_id, sibling_block));
+    CALL_BF(bplus_set_dirty(file_desc, path[level - 1], parent_block));
+    CALL_BF(BF_UnpinBlock(block));
+    CALL_BF(BF_UnpinBlock(sibling_block));
+    CALL_BF(BF_UnpinBlock(parent_block));
+
+    // μετα απο δανεισμο ο γονεας εχει τα ιδια κλειδια, δεν χρειαζεται κατι αλλο
+    if (freed == -1) {
+      break;
+    }
+    if (bplus_free_block(file_desc, metadata, freed) == -1) {
+      result = -1;
+      break;
+    }
+    level--;
+  }
+
+  BF_Block_Destroy(&block);
+  BF_Block_Destroy(&parent_block);
+  BF_Block_Destroy(&sibling_block);
+  return result;
+}
+
+// Διαγραφη με ετοιμο κανονικοποιημενο κλειδι, κοινη για ολες τις μορφες του delete.
+static int delete_record(const int file_desc, BPlusMeta *metadata, const unsigned char *key)
+{
+  // αν το δεντρο ειναι αδειο
+  if (metadata->root_block_num == -1) {
+    return -1;
+  }
+
+  const TableSchema *schema = &metadata->table_schema;
+  const int capacity = metadata->leaf_capacity;
+  const int min_keys = capacity / 2;
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  int path[BPLUS_MAX_DEPTH];
+  int slots[BPLUS_MAX_DEPTH];
+  const int leaf_id = find_leaf(file_desc, metadata, key, path, slots, NULL, NULL, block);
+  if (leaf_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  CALL_BF(bplus_get_block(file_desc, leaf_id, block));
+  char *data = BF_Block_GetData(block);
+  BPlusDataNode *leaf = (BPlusDataNode *)data;
+  int found;
+  const int pos = datanode_search(data, schema, capacity, key, &found);
+
+  if (!found) {
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  datanode_remove_at(data, schema, capacity, pos);
+  CALL_BF(bplus_set_dirty(file_desc, leaf_id, block));
+  if (adjust_counts(file_desc, path, slots, metadata->depth - 1, metadata->index_capacity, -1) == -1) {
+    BF_UnpinBlock(block);
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  // φυλλο-ριζα: δεν εχει ελαχιστο, αν αδειασει το δεντρο γινεται αδειο
+  if (metadata->depth == 1) {
+    const int empty = leaf->key_count == 0;
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+
+    if (empty) {
+      metadata->root_block_num = -1;
+      metadata->depth = 0;
+      metadata->data_block_count = 0;
+      return bplus_free_block(file_desc, metadata, leaf_id);
+    }
+    return 0;
+  }
+
+  if (leaf->key_count >= min_keys) {
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return 0;
+  }
+
+  // underflow - κοιταμε τον αδελφο μεσω του γονεα
+  const int level = metadata->depth - 2;
+  BF_Block *parent_block, *sibling_block;
+  BF_Block_Init(&parent_block);
+  BF_Block_Init(&sibling_block);
+
+  CALL_BF(bplus_get_block(file_desc, path[level], parent_block));
+  char *parent_data = BF_Block_GetData(parent_block);
+  int *parent_children = indexnode_children(parent_data, metadata->index_capacity);
+  int *parent_counts = indexnode_counts(parent_data, metadata->index_capacity);
+  const int slot = slots[level];
+
+  const int use_left = slot > 0;
+  const int sibling_id = use_left ? parent_children[slot - 1] : parent_children[slot + 1];
+  const int sep_pos = use_left ? slot - 1 : slot;
+  CALL_BF(bplus_get_block(file_desc, sibling_id, sibling_block));
+  char *sibling_data = BF_Block_GetData(sibling_block);
+  int freed = -1;
+
+  if (((BPlusDataNode *)sibling_data)->key_count > min_keys) {
+    // δανεισμος μιας εγγραφης και ενημερωση του separator στον γονεα
+    unsigned char separator[BPLUS_MAX_KEY_SIZE];
+    if (use_left) {
+      datanode_borrow_left(data, sibling_data, schema, capacity);
+      datanode_key(data, schema, capacity, 0, separator);
+    } else {
+      datanode_borrow_right(data, sibling_data, schema, capacity);
+      datanode_key(sibling_data, schema, capacity, 0, separator);
+    }
+    indexnode_set_key(parent_data, metadata->index_capacity, schema->key_size, sep_pos, separator);
+    // μια εγγραφη περασε απο τον αδελφο στο φυλλο
+    parent_counts[sep_pos] += use_left ? -1 : 1;
+    parent_counts[sep_pos + 1] += use_left ? 1 : -1;
+  } else {
+    // συγχωνευση: ο δεξιος αδειαζει στον αριστερο και φευγει απο τη λιστα
+    if (use_left) {
+      datanode_merge(sibling_data, data, schema, capacity);
+      freed = leaf_id;
+    } else {
+      datanode_merge(data, sibling_data, schema, capacity);
+      freed = sibling_id;
+    }
+    parent_counts[sep_pos] += parent_counts[sep_pos + 1];
+    indexnode_remove_at(parent_data, metadata->index_capacity, schema->key_size, sep_pos);
+    metadata->data_block_count--;
+  }
+
+  CALL_BF(bplus_set_dirty(file_desc, leaf_id, block));
+  CALL_BF(bplus_set_dirty(file_desc, sibling_id, sibling_block));
+  CALL_BF(bplus_set_dirty(file_desc, path[level], parent_block));
+  CALL_BF(BF_UnpinBlock(block));
+  CALL_BF(BF_UnpinBlock(sibling_block));
+  CALL_BF(BF_UnpinBlock(parent_block));
+  BF_Block_Destroy(&block);
+  BF_Block_Destroy(&sibling_block);
+  BF_Block_Destroy(&parent_block);
+
+  if (freed == -1) {
+    return 0;
+  }
+  if (bplus_free_block(file_desc, metadata, freed) == -1) {
+    return -1;
+  }
+  return rebalance_index(file_desc, metadata, path, slots, level);
+}
+
+// Διαγραφη απο το δεντρο, και απο το buffer αν το κλειδι περιμενει εκει
+static int delete_key(const int file_desc, BPlusMeta *metadata, const unsigned char *key)
+{
+  bplus_begin_op(file_desc);
+  int result = delete_record(file_desc, metadata, key);
+  if (bplus_commit_op(file_desc) == -1) {
+    return -1;
+  }
+
+  BPlusFilter *filter = filter_of(file_desc);
+  if (filter != NULL && result == 0) {
+    filter->stale++;
+    if (refresh_filter(file_desc, metadata) == -1) {
+      return -1;
+    }
+  }
+
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  if (buffer != NULL && insert_buffer_get(buffer, key) != NULL) {
+    if (result == 0) {
+      drop_duplicate(buffer, key);
+    } else {
+      insert_buffer_remove(buffer, key);
+      result = 0;
+    }
+  }
+  return result;
+}
+
+int bplus_record_delete(const int file_desc, BPlusMeta *metadata, const int key)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+
+  if (bplus_key_from_int(&metadata->table_schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_record_delete_by_key\n");
+    return -1;
+  }
+  return delete_key(file_desc, metadata, normalized);
+}
+
+int bplus_record_delete_by_key(const int file_desc, BPlusMeta *metadata, const Record *key_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&metadata->table_schema, key_record, key);
+  return delete_key(file_desc, metadata, key);
+}
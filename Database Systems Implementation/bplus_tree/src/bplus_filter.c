@@ -0,0 +1,114 @@
+// Blocked Bloom filter: κάθε κλειδί πέφτει σε ένα block των 64 bytes (μία
+// cache line) και ανάβει ένα bit σε καθεμία από τις 8 λέξεις του.
+
+#include "bplus_filter.h"
+#include "bf.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WORDS_PER_BLOCK 8
+
+static BPlusFilter *registry[BF_MAX_OPEN_FILES];
+
+// περιττοι πολλαπλασιαστες, ενας ανα λεξη, για να βγαινουν ανεξαρτητα bits απο ενα hash
+static const uint32_t salts[WORDS_PER_BLOCK] = {
+  0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+};
+
+static uint64_t hash_key(const unsigned char *key, const int size)
+{
+  uint64_t h = 0x9e3779b97f4a7c15ull ^ (uint64_t)size;
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    memcpy(&word, key + i, 8);
+    h = (h ^ word) * 0xff51afd7ed558ccdull;
+    h ^= h >> 32;
+  }
+  for (; i < size; i++) {
+    h = (h ^ key[i]) * 0xc4ceb9fe1a85ec53ull;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return h;
+}
+
+BPlusFilter *filter_create(const int file_desc, const int key_size, const int capacity, const int bits_per_key)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES || registry[file_desc] != NULL || bits_per_key <= 0) {
+    return NULL;
+  }
+
+  BPlusFilter *filter = calloc(1, sizeof(BPlusFilter));
+  if (filter == NULL) {
+    return NULL;
+  }
+
+  // 512 bits ανα block, ο αριθμος των blocks στρογγυλευεται σε δυναμη του 2
+  const uint64_t bits = (uint64_t)(capacity > 0 ? capacity : 1) * bits_per_key;
+  uint32_t block_count = 1;
+  while ((uint64_t)block_count * 512 < bits && block_count < (1u << 30)) {
+    block_count *= 2;
+  }
+
+  filter->words = calloc((size_t)block_count * WORDS_PER_BLOCK, sizeof(uint64_t));
+  if (filter->words == NULL) {
+    free(filter);
+    return NULL;
+  }
+  filter->block_mask = block_count - 1;
+  filter->key_size = key_size;
+  filter->bits_per_key = bits_per_key;
+  filter->capacity = capacity;
+
+  registry[file_desc] = filter;
+  return filter;
+}
+
+BPlusFilter *filter_of(const int file_desc)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES) {
+    return NULL;
+  }
+  return registry[file_desc];
+}
+
+void filter_destroy(const int file_desc)
+{
+  BPlusFilter *filter = filter_of(file_desc);
+  if (filter == NULL) {
+    return;
+  }
+  registry[file_desc] = NULL;
+  free(filter->words);
+  free(filter);
+}
+
+void filter_add(BPlusFilter *filter, const unsigned char *key)
+{
+  const uint64_t h = hash_key(key, filter->key_size);
+  uint64_t *block = filter->words + (size_t)((uint32_t)(h >> 32) & filter->block_mask) * WORDS_PER_BLOCK;
+  const uint32_t low = (uint32_t)h;
+
+  for (int i = 0; i < WORDS_PER_BLOCK; i++) {
+    const uint64_t bit = 1ull << ((low * salts[i]) >> 26);
+    __atomic_fetch_or(&block[i], bit, __ATOMIC_RELAXED);
+  }
+  __atomic_fetch_add(&filter->keys, 1, __ATOMIC_RELAXED);
+}
+
+int filter_may_contain(const BPlusFilter *filter, const unsigned char *key)
+{
+  const uint64_t h = hash_key(key, filter->key_size);
+  const uint64_t *block = filter->words + (size_t)((uint32_t)(h >> 32) & filter->block_mask) * WORDS_PER_BLOCK;
+  const uint32_t low = (uint32_t)h;
+
+  for (int i = 0; i < WORDS_PER_BLOCK; i++) {
+    const uint64_t bit = 1ull << ((low * salts[i]) >> 26);
+    if ((__atomic_load_n(&block[i], __ATOMIC_RELAXED) & bit) == 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
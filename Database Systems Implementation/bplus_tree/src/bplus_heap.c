@@ -0,0 +1,32 @@
+// Η κεφαλίδα των heap files του Heapfolder, σε ένα σημείο για όσους τα διαβάζουν.
+
+#include "bplus_heap.h"
+#include "bf.h"
+#include <stdio.h>
+#include <string.h>
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+int bplus_heap_header(const int file_desc, BPlusHeapHeader *header)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  CALL_BF(BF_GetBlock(file_desc, 0, block));
+  memcpy(header, BF_Block_GetData(block), sizeof(BPlusHeapHeader));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  if (header->is_heap_file != 1 || header->last_data_block < 0 || header->records_per_block < 0) {
+    fprintf(stderr, "Error: file %d is not a heap file\n", file_desc);
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,619 @@
+// Χτίσιμο δευτερεύοντος ευρετηρίου από heap file με εξωτερική ταξινόμηση: το
+// scan γεμίζει buffers με ζεύγη (κλειδί, θέση), ένα νήμα τα ταξινομεί και τα
+// γράφει σε runs, και η συγχώνευση των runs φορτώνει το ευρετήριο με τη σειρά.
+
+#define _GNU_SOURCE  // qsort_r
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "bplus_heap.h"
+#include "bplus_index_build.h"
+#include "bplus_key.h"
+#include "bplus_secondary.h"
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+#define LOCATION_SIZE 4
+#define MIN_MEMORY (1 << 20)
+#define MIN_READ_BUFFER (64 << 10)      // bytes για καθε run που διαβαζεται στο merge
+#define INSERT_BUFFER_RECORDS 16384     // insert buffer του καταλογου
+
+typedef struct {
+  char *pairs;
+  size_t count;
+} SortBuffer;
+
+typedef struct {
+  const TableSchema *schema;  // σχημα του ευρετηριου, το κλειδι του ειναι η τιμη
+  size_t key_size;
+  size_t pair_size;           // κλειδι και θεση σε big-endian, ωστε να αρκει ενα memcmp
+  size_t buffer_pairs;        // χωρητικοτητα καθε buffer ταξινομησης
+  const BPlusBuildOptions *options;
+  BPlusBuildProgress progress;
+  long reported;
+  long scanned;               // εγγραφες του heap file
+
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  SortBuffer *pending;        // περιμενει ή περναει απο τον sorter
+  int done;                   // το scan τελειωσε
+  int failed;
+
+  FILE **runs;                // οσο τρεχει το scan τα αλλαζει ο sorter με το lock
+  int run_count;
+  int run_capacity;
+} IndexBuild;
+
+// Ενα run στη συγχωνευση: ενα παραθυρο του αρχειου του, ή ολο το run στη μνημη
+typedef struct {
+  FILE *file;                 // NULL αν το buffer ειναι ολο το run
+  char *buffer;
+  size_t capacity;
+  size_t count;
+  size_t pos;
+} RunReader;
+
+typedef int (*PairSink)(const char *pair, void *ctx);
+
+static void put_be32(const uint32_t value, unsigned char *out)
+{
+  out[0] = (unsigned char)(value >> 24);
+  out[1] = (unsigned char)(value >> 16);
+  out[2] = (unsigned char)(value >> 8);
+  out[3] = (unsigned char)value;
+}
+
+static uint32_t get_be32(const unsigned char *in)
+{
+  return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+static int compare_pairs(const void *a, const void *b, void *size)
+{
+  return memcmp(a, b, *(const size_t *)size);
+}
+
+static void report(IndexBuild *build, const BPlusBuildPhase phase, const long done, const int force)
+{
+  if (build->options->progress == NULL ||
+      (!force && build->progress.phase == phase && done - build->reported < BPLUS_BUILD_PROGRESS_PAIRS)) {
+    return;
+  }
+  // στο scan τα runs τα γραφει ο sorter
+  pthread_mutex_lock(&build->lock);
+  build->progress.runs = build->run_count;
+  pthread_mutex_unlock(&build->lock);
+  build->progress.phase = phase;
+  build->progress.done = done;
+  build->reported = done;
+  build->options->progress(&build->progress, build->options->progress_ctx);
+}
+
+// ---------------------------------------------------------------- runs
+
+// προσωρινο αρχειο που σβηνεται μονο του οταν κλεισει
+static FILE *run_open(const IndexBuild *build)
+{
+  const char *dir = build->options->temp_dir;
+  if (dir == NULL) {
+    FILE *file = tmpfile();
+    if (file == NULL) {
+      perror("tmpfile");
+    }
+    return file;
+  }
+
+  char path[4096];
+  snprintf(path, sizeof(path), "%s/bplus_runXXXXXX", dir);
+  const int fd = mkstemp(path);
+  if (fd == -1) {
+    perror(path);
+    return NULL;
+  }
+  unlink(path);
+  FILE *file = fdopen(fd, "w+b");
+  if (file == NULL) {
+    close(fd);
+  }
+  return file;
+}
+
+static int run_add(IndexBuild *build, FILE *file)
+{
+  if (build->run_count == build->run_capacity) {
+    const int capacity = build->run_capacity == 0 ? 16 : 2 * build->run_capacity;
+    FILE **runs = realloc(build->runs, capacity * sizeof(FILE *));
+    if (runs == NULL) {
+      return -1;
+    }
+    build->runs = runs;
+    build->run_capacity = capacity;
+  }
+  build->runs[build->run_count++] = file;
+  return 0;
+}
+
+static FILE *write_run(const IndexBuild *build, const SortBuffer *buffer)
+{
+  FILE *file = run_open(build);
+  if (file != NULL &&
+      (fwrite(buffer->pairs, build->pair_size, buffer->count, file) != buffer->count || fflush(file) != 0)) {
+    perror("index build run");
+    fclose(file);
+    return NULL;
+  }
+  return file;
+}
+
+// ---------------------------------------------------------------- scan και ταξινομηση
+
+static void *sort_worker(void *arg)
+{
+  IndexBuild *build = arg;
+  pthread_mutex_lock(&build->lock);
+  for (;;) {
+    while (build->pending == NULL && !build->done) {
+      pthread_cond_wait(&build->changed, &build->lock);
+    }
+    if (build->pending == NULL) {
+      break;
+    }
+    SortBuffer *buffer = build->pending;
+    pthread_mutex_unlock(&build->lock);
+
+    qsort_r(buffer->pairs, buffer->count, build->pair_size, compare_pairs, &build->pair_size);
+    FILE *run = write_run(build, buffer);
+
+    pthread_mutex_lock(&build->lock);
+    if (run == NULL || run_add(build, run) == -1) {
+      if (run != NULL) {
+        fclose(run);
+      }
+      build->failed = 1;
+    }
+    build->pending = NULL;
+    pthread_cond_broadcast(&build->changed);
+  }
+  pthread_mutex_unlock(&build->lock);
+  return NULL;
+}
+
+// περιμενει να τελειωσει ο sorter με το προηγουμενο buffer
+static int wait_sorter(IndexBuild *build)
+{
+  pthread_mutex_lock(&build->lock);
+  while (build->pending != NULL) {
+    pthread_cond_wait(&build->changed, &build->lock);
+  }
+  const int failed = build->failed;
+  pthread_mutex_unlock(&build->lock);
+  return failed ? -1 : 0;
+}
+
+// δινει ενα γεματο buffer στον sorter, αφου τελειωσει με το προηγουμενο
+static int hand_off(IndexBuild *build, SortBuffer *buffer)
+{
+  if (wait_sorter(build) == -1) {
+    return -1;
+  }
+  pthread_mutex_lock(&build->lock);
+  build->pending = buffer;
+  pthread_cond_broadcast(&build->changed);
+  pthread_mutex_unlock(&build->lock);
+  return 0;
+}
+
+// Διαβαζει τα blocks δεδομενων του heap file. Στο τελος το *last δειχνει
+// το buffer που δεν εφυγε για ταξινομηση.
+static int scan_heap(IndexBuild *build, const int heap_desc, const TableSchema *heap_schema, const int record_stride,
+                     const int attr, SortBuffer *buffers, SortBuffer **last)
+{
+  BPlusHeapHeader header;
+  if (bplus_heap_header(heap_desc, &header) == -1) {
+    return -1;
+  }
+  const int last_block = header.last_data_block;
+  const int records_per_block = header.records_per_block;
+  build->progress.total = header.total_records;
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  SortBuffer *current = &buffers[0];
+  const int field = heap_schema->offsets[attr];
+  report(build, BPLUS_BUILD_SCAN, 0, 1);
+
+  for (int block_id = 1; block_id <= last_block; block_id++) {
+    CALL_BF(BF_GetBlock(heap_desc, block_id, block));
+    const char *data = BF_Block_GetData(block);
+    const int rows = *(const int *)data;
+    const char *records = data + sizeof(int);
+    if ((long long)block_id * records_per_block + records_per_block > INT32_MAX) {
+      fprintf(stderr, "Error: heap file %d is too large for int locations\n", heap_desc);
+      BF_UnpinBlock(block);
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+
+    for (int slot = 0; slot < rows; slot++) {
+      if (current->count == build->buffer_pairs) {
+        if (hand_off(build, current) == -1) {
+          BF_UnpinBlock(block);
+          BF_Block_Destroy(&block);
+          return -1;
+        }
+        current = current == &buffers[0] ? &buffers[1] : &buffers[0];
+        current->count = 0;
+      }
+      unsigned char *pair = (unsigned char *)current->pairs + current->count++ * build->pair_size;
+      bplus_key_from_packed(build->schema, records + (size_t)slot * record_stride + field, pair);
+      put_be32((uint32_t)(block_id * records_per_block + slot), pair + build->key_size);
+    }
+    CALL_BF(BF_UnpinBlock(block));
+    build->scanned += rows;
+    report(build, BPLUS_BUILD_SCAN, build->scanned, 0);
+  }
+
+  BF_Block_Destroy(&block);
+  report(build, BPLUS_BUILD_SCAN, build->scanned, 1);
+  *last = current;
+  return wait_sorter(build);
+}
+
+// ---------------------------------------------------------------- συγχωνευση
+
+static int reader_fill(const IndexBuild *build, RunReader *reader)
+{
+  reader->pos = 0;
+  if (reader->file == NULL) {
+    reader->count = 0;
+    return 0;
+  }
+  reader->count = fread(reader->buffer, build->pair_size, reader->capacity, reader->file);
+  if (reader->count == 0 && ferror(reader->file)) {
+    perror("index build run");
+    return -1;
+  }
+  return 0;
+}
+
+static const char *reader_pair(const IndexBuild *build, const RunReader *reader)
+{
+  return reader->buffer + reader->pos * build->pair_size;
+}
+
+static void sift_down(const IndexBuild *build, const RunReader *readers, int *heap, const int size, int i)
+{
+  for (;;) {
+    const int left = 2 * i + 1;
+    const int right = left + 1;
+    int smallest = i;
+    if (left < size && memcmp(reader_pair(build, &readers[heap[left]]),
+                              reader_pair(build, &readers[heap[smallest]]), build->pair_size) < 0) {
+      smallest = left;
+    }
+    if (right < size && memcmp(reader_pair(build, &readers[heap[right]]),
+                               reader_pair(build, &readers[heap[smallest]]), build->pair_size) < 0) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      return;
+    }
+    const int swap = heap[i];
+    heap[i] = heap[smallest];
+    heap[smallest] = swap;
+    i = smallest;
+  }
+}
+
+// k-way merge με ενα min-heap των runs, καθε ζευγος παει με τη σειρα στο sink
+static int merge_runs(IndexBuild *build, RunReader *readers, const int n, const BPlusBuildPhase phase,
+                      const PairSink sink, void *ctx)
+{
+  int *heap = malloc(n * sizeof(int));
+  if (heap == NULL) {
+    return -1;
+  }
+  int size = 0;
+  for (int r = 0; r < n; r++) {
+    if (readers[r].file != NULL && reader_fill(build, &readers[r]) == -1) {
+      free(heap);
+      return -1;
+    }
+    if (readers[r].count > 0) {
+      heap[size++] = r;
+    }
+  }
+  for (int i = size / 2 - 1; i >= 0; i--) {
+    sift_down(build, readers, heap, size, i);
+  }
+
+  long merged = 0;
+  int result = 0;
+  report(build, phase, 0, 1);
+  while (size > 0 && result == 0) {
+    RunReader *reader = &readers[heap[0]];
+    if (sink(reader_pair(build, reader), ctx) == -1) {
+      result = -1;
+      break;
+    }
+    report(build, phase, ++merged, 0);
+
+    if (++reader->pos == reader->count) {
+      if (reader_fill(build, reader) == -1) {
+        result = -1;
+      } else if (reader->count == 0) {
+        heap[0] = heap[--size];
+      }
+    }
+    sift_down(build, readers, heap, size, 0);
+  }
+  free(heap);
+  report(build, phase, merged, 1);
+  return result;
+}
+
+typedef struct {
+  FILE *file;
+  size_t pair_size;
+} RunTarget;
+
+static int write_pair(const char *pair, void *ctx)
+{
+  const RunTarget *target = ctx;
+  return fwrite(pair, target->pair_size, 1, target->file) == 1 ? 0 : -1;
+}
+
+// Συγχωνευει τα runs [0, n) σε ενα νεο run στο τελος της λιστας
+static int merge_into_run(IndexBuild *build, RunReader *readers, const int n)
+{
+  FILE *out = run_open(build);
+  if (out == NULL) {
+    return -1;
+  }
+  for (int r = 0; r < n; r++) {
+    readers[r].file = build->runs[r];
+    rewind(readers[r].file);
+  }
+  RunTarget target = {out, build->pair_size};
+  if (merge_runs(build, readers, n, BPLUS_BUILD_MERGE, write_pair, &target) == -1 || fflush(out) != 0 ||
+      run_add(build, out) == -1) {
+    perror("index build run");
+    fclose(out);
+    return -1;
+  }
+
+  for (int r = 0; r < n; r++) {
+    fclose(build->runs[r]);
+  }
+  build->run_count -= n;
+  memmove(build->runs, build->runs + n, build->run_count * sizeof(FILE *));
+  return 0;
+}
+
+typedef struct {
+  const IndexBuild *build;
+  BPlusSecondaryLoader *loader;
+  Record record;              // η τρεχουσα τιμη, αποκωδικοποιημενη
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  int has_key;
+} LoadTarget;
+
+static int load_pair(const char *pair, void *ctx)
+{
+  LoadTarget *target = ctx;
+  const IndexBuild *build = target->build;
+  const unsigned char *bytes = (const unsigned char *)pair;
+  if (!target->has_key || memcmp(bytes, target->key, build->key_size) != 0) {
+    memcpy(target->key, bytes, build->key_size);
+    bplus_key_to_record(build->schema, bytes, &target->record);
+    target->has_key = 1;
+  }
+  return bplus_secondary_loader_add(target->loader, &target->record.values[0],
+                                    (int)get_be32(bytes + build->key_size));
+}
+
+// Συγχωνευει τα runs και το τελευταιο buffer στο ευρετηριο. Η μνημη του αλλου
+// buffer γινεται buffers αναγνωσης, και αν δεν φτανει για ολα τα runs μαζι
+// ομαδες τους συγχωνευονται πρωτα σε μεγαλυτερα runs.
+static int merge_into_index(IndexBuild *build, SortBuffer *memory_run, char *read_memory, const size_t read_bytes,
+                            const int file_desc, BPlusMeta *metadata)
+{
+  size_t fan_in = read_bytes / MIN_READ_BUFFER;
+  if (fan_in < 2) {
+    fan_in = 2;
+  }
+  RunReader *readers = calloc(fan_in + 1, sizeof(RunReader));
+  if (readers == NULL) {
+    return -1;
+  }
+
+  while ((size_t)build->run_count > fan_in) {
+    const size_t capacity = read_bytes / fan_in / build->pair_size;
+    for (size_t r = 0; r < fan_in; r++) {
+      readers[r].buffer = read_memory + r * capacity * build->pair_size;
+      readers[r].capacity = capacity;
+    }
+    if (merge_into_run(build, readers, (int)fan_in) == -1) {
+      free(readers);
+      return -1;
+    }
+  }
+
+  const int n = build->run_count;
+  const size_t capacity = n > 0 ? read_bytes / n / build->pair_size : 0;
+  for (int r = 0; r < n; r++) {
+    readers[r].file = build->runs[r];
+    readers[r].buffer = read_memory + r * capacity * build->pair_size;
+    readers[r].capacity = capacity;
+    rewind(readers[r].file);
+  }
+  readers[n].file = NULL;
+  readers[n].buffer = memory_run->pairs;
+  readers[n].count = memory_run->count;
+  readers[n].pos = 0;
+
+  LoadTarget target;
+  target.build = build;
+  target.has_key = 0;
+  target.loader = bplus_secondary_loader_create(file_desc, metadata);
+  int result = target.loader == NULL ? -1 : 0;
+  if (result == 0) {
+    result = merge_runs(build, readers, n + 1, BPLUS_BUILD_LOAD, load_pair, &target);
+    if (bplus_secondary_loader_finish(target.loader) == -1) {
+      result = -1;
+    }
+  }
+  free(readers);
+  return result;
+}
+
+// ---------------------------------------------------------------- build
+
+void bplus_build_options_default(BPlusBuildOptions *options)
+{
+  options->memory = BPLUS_BUILD_MEMORY;
+  options->temp_dir = NULL;
+  options->progress = NULL;
+  options->progress_ctx = NULL;
+}
+
+// ενα ευρετηριο που δεν χτιστηκε ολο σβηνεται, μαζι με το log του
+static void remove_index(const char *index_file)
+{
+  char path[4096];
+  snprintf(path, sizeof(path), "%s.wal", index_file);
+  unlink(index_file);
+  unlink(path);
+}
+
+static int find_attribute(const TableSchema *schema, const char *attr_name)
+{
+  for (int i = 0; i < schema->count; i++) {
+    if (strcmp(schema->attributes[i].name, attr_name) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// scan με τον sorter σε δικο του νημα, μετα ταξινομηση του τελευταιου buffer
+static int sort_heap(IndexBuild *build, const int heap_desc, const TableSchema *heap_schema, const int record_stride,
+                     const int attr, SortBuffer *buffers, SortBuffer **last)
+{
+  pthread_t sorter;
+  if (pthread_create(&sorter, NULL, sort_worker, build) != 0) {
+    return -1;
+  }
+  int result = scan_heap(build, heap_desc, heap_schema, record_stride, attr, buffers, last);
+
+  // ο sorter τελειωνει μολις αδειασει, και μετα απο αποτυχια του scan
+  pthread_mutex_lock(&build->lock);
+  build->done = 1;
+  pthread_cond_broadcast(&build->changed);
+  pthread_mutex_unlock(&build->lock);
+  pthread_join(sorter, NULL);
+  if (build->failed) {
+    result = -1;
+  }
+
+  if (result == 0) {
+    qsort_r((*last)->pairs, (*last)->count, build->pair_size, compare_pairs, &build->pair_size);
+  }
+  return result;
+}
+
+long bplus_build_index(const int heap_desc, const TableSchema *heap_schema, const int record_stride,
+                       const char *attr_name, const char *index_file, const BPlusBuildOptions *options)
+{
+  BPlusBuildOptions defaults;
+  if (options == NULL) {
+    bplus_build_options_default(&defaults);
+    options = &defaults;
+  }
+  const int attr = find_attribute(heap_schema, attr_name);
+  if (attr == -1 || record_stride < heap_schema->record_size) {
+    fprintf(stderr, "Error: cannot index attribute '%s' of a heap file with record stride %d\n", attr_name,
+            record_stride);
+    return -1;
+  }
+  // ενα αρχειο που ηδη υπαρχει δεν ειναι δικο μας για να σβηστει
+  if (bplus_secondary_create(heap_schema, attr_name, index_file) == -1) {
+    return -1;
+  }
+  int file_desc;
+  BPlusMeta *metadata;
+  if (bplus_open_file(index_file, &file_desc, &metadata) == -1) {
+    remove_index(index_file);
+    return -1;
+  }
+
+  IndexBuild build;
+  memset(&build, 0, sizeof(build));
+  build.schema = &metadata->table_schema;
+  build.key_size = build.schema->key_size;
+  build.pair_size = build.key_size + LOCATION_SIZE;
+  build.options = options;
+  const size_t memory = options->memory > MIN_MEMORY ? options->memory : MIN_MEMORY;
+  build.buffer_pairs = memory / 2 / build.pair_size;
+  pthread_mutex_init(&build.lock, NULL);
+  pthread_cond_init(&build.changed, NULL);
+
+  SortBuffer buffers[2];
+  memset(buffers, 0, sizeof(buffers));
+  buffers[0].pairs = malloc(build.buffer_pairs * build.pair_size);
+  buffers[1].pairs = malloc(build.buffer_pairs * build.pair_size);
+  SortBuffer *last = NULL;
+  int result = buffers[0].pairs != NULL && buffers[1].pairs != NULL ? 0 : -1;
+  if (result == 0) {
+    result = sort_heap(&build, heap_desc, heap_schema, record_stride, attr, buffers, &last);
+  }
+
+  long indexed = 0;
+  if (result == 0) {
+    // το buffer που δεν κραταει το τελευταιο run διαβαζει τα runs
+    SortBuffer *spare = last == &buffers[0] ? &buffers[1] : &buffers[0];
+    indexed = build.scanned;
+    result = bplus_insert_buffer_enable(file_desc, metadata, INSERT_BUFFER_RECORDS);
+    if (result == 0) {
+      result = merge_into_index(&build, last, spare->pairs, build.buffer_pairs * build.pair_size, file_desc,
+                                metadata);
+    }
+    if (bplus_insert_buffer_enable(file_desc, metadata, 0) == -1) {
+      result = -1;
+    }
+  }
+
+  for (int r = 0; r < build.run_count; r++) {
+    fclose(build.runs[r]);
+  }
+  free(build.runs);
+  free(buffers[0].pairs);
+  free(buffers[1].pairs);
+  pthread_cond_destroy(&build.changed);
+  pthread_mutex_destroy(&build.lock);
+  if (bplus_close_file(file_desc, metadata) == -1) {
+    result = -1;
+  }
+  if (result == -1) {
+    remove_index(index_file);
+    return -1;
+  }
+  return indexed;
+}
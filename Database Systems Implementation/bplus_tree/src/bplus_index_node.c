@@ -1 +1,259 @@
-// Μπορείτε να προσθέσετε εδώ βοηθητικές συναρτήσεις για την επεξεργασία Κόμβων Δεδομένων.
\ No newline at end of file
+// Βοηθητικές συναρτήσεις για την επεξεργασία Κόμβων Ευρετηρίου.
+//
+// Διάταξη block: [BPlusIndexNode][heads[capacity]][children[capacity + 1]][counts[capacity + 1]][suffixes[capacity]]
+// τα heads ειναι τα πρωτα 4 bytes καθε κανονικοποιημενου κλειδιου (bplus_key.h),
+// τα suffixes τα υπολοιπα key_size - 4 bytes (κενα για κλειδια INT), και το
+// counts[i] ποσες εγγραφες εχει το υποδεντρο του children[i].
+
+#include <string.h>
+
+#include "bf.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bplus_search.h"
+
+int indexnode_capacity(const int key_size)
+{
+  return (int)((BF_BLOCK_SIZE - sizeof(BPlusIndexNode) - 2 * sizeof(int)) / (key_size + 2 * sizeof(int)));
+}
+
+void indexnode_init(char *data, const int capacity, const int first_child)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  node->is_leaf = 0;
+  node->key_count = 0;
+  indexnode_children(data, capacity)[0] = first_child;
+  indexnode_counts(data, capacity)[0] = 0;
+}
+
+int *indexnode_heads(char *data)
+{
+  return (int *)(data + sizeof(BPlusIndexNode));
+}
+
+int *indexnode_children(char *data, const int capacity)
+{
+  return indexnode_heads(data) + capacity;
+}
+
+int *indexnode_counts(char *data, const int capacity)
+{
+  return indexnode_children(data, capacity) + capacity + 1;
+}
+
+long indexnode_total(char *data, const int capacity)
+{
+  const int *counts = indexnode_counts(data, capacity);
+  long total = 0;
+  for (int i = 0; i <= ((BPlusIndexNode *)data)->key_count; i++) {
+    total += counts[i];
+  }
+  return total;
+}
+
+// αρχη του suffix του κλειδιου pos
+static unsigned char *indexnode_suffix(char *data, const int capacity, const int key_size, const int pos)
+{
+  return (unsigned char *)(indexnode_counts(data, capacity) + capacity + 1) + pos * (key_size - 4);
+}
+
+// μεταφερει count παιδια μαζι με τα πληθη τους
+static void move_children(char *dst, const int dst_pos, char *src, const int src_pos, const int count,
+                          const int capacity)
+{
+  memmove(&indexnode_children(dst, capacity)[dst_pos], &indexnode_children(src, capacity)[src_pos],
+          count * sizeof(int));
+  memmove(&indexnode_counts(dst, capacity)[dst_pos], &indexnode_counts(src, capacity)[src_pos],
+          count * sizeof(int));
+}
+
+// μεταφερει count κλειδια (heads και suffixes) αναμεσα σε κομβους ιδιας χωρητικοτητας
+static void move_keys(char *dst, const int dst_pos, char *src, const int src_pos, const int count,
+                      const int capacity, const int key_size)
+{
+  memmove(&indexnode_heads(dst)[dst_pos], &indexnode_heads(src)[src_pos], count * sizeof(int));
+  memmove(indexnode_suffix(dst, capacity, key_size, dst_pos), indexnode_suffix(src, capacity, key_size, src_pos),
+          count * (key_size - 4));
+}
+
+void indexnode_key(char *data, const int capacity, const int key_size, const int pos, unsigned char *key)
+{
+  bplus_key_set_head(indexnode_heads(data)[pos], key);
+  memcpy(key + 4, indexnode_suffix(data, capacity, key_size, pos), key_size - 4);
+}
+
+void indexnode_set_key(char *data, const int capacity, const int key_size, const int pos, const unsigned char *key)
+{
+  indexnode_heads(data)[pos] = bplus_key_head(key);
+  memcpy(indexnode_suffix(data, capacity, key_size, pos), key + 4, key_size - 4);
+}
+
+int indexnode_child_slot(char *data, const int capacity, const int key_size, const unsigned char *key)
+{
+  const BPlusIndexNode *node = (const BPlusIndexNode *)data;
+  const int *heads = indexnode_heads(data);
+  const int head = bplus_key_head(key);
+
+  if (key_size == 4) {
+    return bplus_rank_upper(heads, node->key_count, head);
+  }
+
+  // μονο τα κλειδια με ιδιο head χρειαζονται συγκριση στα suffixes
+  int lo = bplus_rank_lower(heads, node->key_count, head);
+  int hi = bplus_rank_upper(heads, node->key_count, head);
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (memcmp(indexnode_suffix(data, capacity, key_size, mid), key + 4, key_size - 4) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int indexnode_child(char *data, const int capacity, const int key_size, const unsigned char *key)
+{
+  return indexnode_children(data, capacity)[indexnode_child_slot(data, capacity, key_size, key)];
+}
+
+void indexnode_insert_at(char *data, const int capacity, const int key_size, const int pos,
+                         const unsigned char *key, const int right_child, const int right_count)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  const int tail = node->key_count - pos;
+
+  move_keys(data, pos + 1, data, pos, tail, capacity, key_size);
+  move_children(data, pos + 2, data, pos + 1, tail, capacity);
+
+  indexnode_set_key(data, capacity, key_size, pos, key);
+  indexnode_children(data, capacity)[pos + 1] = right_child;
+  indexnode_counts(data, capacity)[pos + 1] = right_count;
+  node->key_count++;
+}
+
+void indexnode_split(char *data, char *new_data, const int capacity, const int key_size, const int pos,
+                     const unsigned char *key, const int right_child, const int right_count, unsigned char *up_key)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  BPlusIndexNode *new_node = (BPlusIndexNode *)new_data;
+
+  // απο τα capacity + 1 κλειδια τα mid μενουν αριστερα, το μεσαιο ανεβαινει
+  // στον γονεα και τα υπολοιπα capacity - mid πανε στον νεο κομβο
+  const int mid = (capacity + 1) / 2;
+  new_node->is_leaf = 0;
+
+  if (pos < mid) {
+    indexnode_key(data, capacity, key_size, mid - 1, up_key);
+    move_keys(new_data, 0, data, mid, capacity - mid, capacity, key_size);
+    move_children(new_data, 0, data, mid, capacity - mid + 1, capacity);
+    new_node->key_count = capacity - mid;
+    node->key_count = mid - 1;
+    indexnode_insert_at(data, capacity, key_size, pos, key, right_child, right_count);
+  } else if (pos == mid) {
+    // το νεο κλειδι ειναι το ιδιο το μεσαιο
+    memcpy(up_key, key, key_size);
+    move_keys(new_data, 0, data, mid, capacity - mid, capacity, key_size);
+    indexnode_children(new_data, capacity)[0] = right_child;
+    indexnode_counts(new_data, capacity)[0] = right_count;
+    move_children(new_data, 1, data, mid + 1, capacity - mid, capacity);
+    new_node->key_count = capacity - mid;
+    node->key_count = mid;
+  } else {
+    indexnode_key(data, capacity, key_size, mid, up_key);
+    move_keys(new_data, 0, data, mid + 1, capacity - mid - 1, capacity, key_size);
+    move_children(new_data, 0, data, mid + 1, capacity - mid, capacity);
+    new_node->key_count = capacity - mid - 1;
+    node->key_count = mid;
+    indexnode_insert_at(new_data, capacity, key_size, pos - mid - 1, key, right_child, right_count);
+  }
+}
+
+void indexnode_split_half(char *data, char *new_data, const int capacity, const int key_size, unsigned char *up_key)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  BPlusIndexNode *new_node = (BPlusIndexNode *)new_data;
+
+  const int mid = node->key_count / 2;
+  const int right_count = node->key_count - mid - 1;
+
+  new_node->is_leaf = 0;
+  new_node->key_count = right_count;
+  move_keys(new_data, 0, data, mid + 1, right_count, capacity, key_size);
+  move_children(new_data, 0, data, mid + 1, right_count + 1, capacity);
+
+  indexnode_key(data, capacity, key_size, mid, up_key);
+  node->key_count = mid;
+}
+
+void indexnode_remove_at(char *data, const int capacity, const int key_size, const int pos)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  const int tail = node->key_count - pos - 1;
+
+  move_keys(data, pos, data, pos + 1, tail, capacity, key_size);
+  move_children(data, pos + 1, data, pos + 2, tail, capacity);
+  node->key_count--;
+}
+
+void indexnode_borrow_left(char *data, char *left_data, char *parent_data, const int capacity,
+                           const int key_size, const int sep_pos)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  BPlusIndexNode *left = (BPlusIndexNode *)left_data;
+  int *parent_counts = indexnode_counts(parent_data, capacity);
+
+  // το separator κατεβαινει στον κομβο, το τελευταιο κλειδι του αριστερου ανεβαινει
+  move_keys(data, 1, data, 0, node->key_count, capacity, key_size);
+  move_children(data, 1, data, 0, node->key_count + 1, capacity);
+  move_keys(data, 0, parent_data, sep_pos, 1, capacity, key_size);
+  move_children(data, 0, left_data, left->key_count, 1, capacity);
+  node->key_count++;
+
+  // το παιδι που αλλαξε κομβο παιρνει μαζι και τις εγγραφες του
+  const int moved = indexnode_counts(data, capacity)[0];
+  parent_counts[sep_pos] -= moved;
+  parent_counts[sep_pos + 1] += moved;
+
+  left->key_count--;
+  move_keys(parent_data, sep_pos, left_data, left->key_count, 1, capacity, key_size);
+}
+
+void indexnode_borrow_right(char *data, char *right_data, char *parent_data, const int capacity,
+                            const int key_size, const int sep_pos)
+{
+  BPlusIndexNode *node = (BPlusIndexNode *)data;
+  BPlusIndexNode *right = (BPlusIndexNode *)right_data;
+  int *parent_counts = indexnode_counts(parent_data, capacity);
+
+  move_keys(data, node->key_count, parent_data, sep_pos, 1, capacity, key_size);
+  move_children(data, node->key_count + 1, right_data, 0, 1, capacity);
+  node->key_count++;
+
+  const int moved = indexnode_counts(right_data, capacity)[0];
+  parent_counts[sep_pos] += moved;
+  parent_counts[sep_pos + 1] -= moved;
+
+  move_keys(parent_data, sep_pos, right_data, 0, 1, capacity, key_size);
+  move_keys(right_data, 0, right_data, 1, right->key_count - 1, capacity, key_size);
+  move_children(right_data, 0, right_data, 1, right->key_count, capacity);
+  right->key_count--;
+}
+
+void indexnode_merge(char *left_data, char *right_data, char *parent_data, const int capacity,
+                     const int key_size, const int sep_pos)
+{
+  BPlusIndexNode *left = (BPlusIndexNode *)left_data;
+  BPlusIndexNode *right = (BPlusIndexNode *)right_data;
+  int *parent_counts = indexnode_counts(parent_data, capacity);
+  const int end = left->key_count;
+
+  move_keys(left_data, end, parent_data, sep_pos, 1, capacity, key_size);
+  move_keys(left_data, end + 1, right_data, 0, right->key_count, capacity, key_size);
+  move_children(left_data, end + 1, right_data, 0, right->key_count + 1, capacity);
+
+  left->key_count += right->key_count + 1;
+  right->key_count = 0;
+  parent_counts[sep_pos] += parent_counts[sep_pos + 1];
+  indexnode_remove_at(parent_data, capacity, key_size, sep_pos);
+}
@@ -0,0 +1,213 @@
+// Buffer εισαγωγών στη μνήμη: hash table στο κανονικοποιημένο κλειδί για τις
+// αναζητήσεις, και ταξινόμηση κατά κλειδί μόνο όταν αδειάζει προς το δέντρο.
+
+#include "bplus_insert_buffer.h"
+#include "bf.h"
+#include "record_generator.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static BPlusInsertBuffer *registry[BF_MAX_OPEN_FILES];
+
+static int key_size(const BPlusInsertBuffer *buffer)
+{
+  return buffer->metadata->table_schema.key_size;
+}
+
+// FNV-1a στα bytes του κλειδιου
+static uint32_t hash_key(const unsigned char *key, const int size)
+{
+  uint32_t h = 2166136261u;
+  for (int i = 0; i < size; i++) {
+    h = (h ^ key[i]) * 16777619u;
+  }
+  return h ^ (h >> 15);
+}
+
+unsigned char *insert_buffer_key(const BPlusInsertBuffer *buffer, const int entry)
+{
+  return (unsigned char *)buffer->entries + (size_t)entry * buffer->entry_size;
+}
+
+char *insert_buffer_record(const BPlusInsertBuffer *buffer, const int entry)
+{
+  return (char *)insert_buffer_key(buffer, entry) + key_size(buffer);
+}
+
+// θεση του κλειδιου στο table, ή η αδεια θεση οπου θα μπει
+static int probe(const BPlusInsertBuffer *buffer, const unsigned char *key)
+{
+  const int size = key_size(buffer);
+  int slot = (int)(hash_key(key, size) & buffer->table_mask);
+  while (buffer->table[slot] != -1 && memcmp(insert_buffer_key(buffer, buffer->table[slot]), key, size) != 0) {
+    slot = (slot + 1) & buffer->table_mask;
+  }
+  return slot;
+}
+
+BPlusInsertBuffer *insert_buffer_create(const int file_desc, BPlusMeta *metadata, const int capacity)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES || registry[file_desc] != NULL || capacity <= 0) {
+    return NULL;
+  }
+
+  BPlusInsertBuffer *buffer = calloc(1, sizeof(BPlusInsertBuffer));
+  if (buffer == NULL) {
+    return NULL;
+  }
+
+  // το table μενει το πολυ μισογεματο
+  int table_size = 2;
+  while (table_size < 2 * capacity) {
+    table_size *= 2;
+  }
+
+  buffer->metadata = metadata;
+  buffer->capacity = capacity;
+  buffer->entry_size = metadata->table_schema.key_size + metadata->table_schema.record_size;
+  buffer->entries = malloc((size_t)capacity * buffer->entry_size);
+  buffer->table = malloc(table_size * sizeof(int));
+  buffer->table_mask = table_size - 1;
+  if (buffer->entries == NULL || buffer->table == NULL) {
+    free(buffer->entries);
+    free(buffer->table);
+    free(buffer);
+    return NULL;
+  }
+  memset(buffer->table, -1, table_size * sizeof(int));
+
+  registry[file_desc] = buffer;
+  return buffer;
+}
+
+BPlusInsertBuffer *insert_buffer_of(const int file_desc)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES) {
+    return NULL;
+  }
+  return registry[file_desc];
+}
+
+void insert_buffer_destroy(const int file_desc)
+{
+  BPlusInsertBuffer *buffer = insert_buffer_of(file_desc);
+  if (buffer == NULL) {
+    return;
+  }
+  registry[file_desc] = NULL;
+  free(buffer->entries);
+  free(buffer->table);
+  free(buffer);
+}
+
+char *insert_buffer_get(BPlusInsertBuffer *buffer, const unsigned char *key)
+{
+  const int entry = buffer->table[probe(buffer, key)];
+  return entry == -1 ? NULL : insert_buffer_record(buffer, entry);
+}
+
+int insert_buffer_add(BPlusInsertBuffer *buffer, const unsigned char *key, const Record *record)
+{
+  const int slot = probe(buffer, key);
+  if (buffer->table[slot] != -1 || buffer->count == buffer->capacity) {
+    return -1;
+  }
+
+  const int entry = buffer->count++;
+  memcpy(insert_buffer_key(buffer, entry), key, key_size(buffer));
+  const RecordSerializer serialize = record_serializer(&buffer->metadata->table_schema);
+  serialize(&buffer->metadata->table_schema, record, insert_buffer_record(buffer, entry));
+  buffer->table[slot] = entry;
+  return 0;
+}
+
+int insert_buffer_remove(BPlusInsertBuffer *buffer, const unsigned char *key)
+{
+  int slot = probe(buffer, key);
+  const int entry = buffer->table[slot];
+  if (entry == -1) {
+    return -1;
+  }
+
+  // linear probing: τα επομενα της ιδιας αλυσιδας μετακινουνται πισω στο κενο
+  buffer->table[slot] = -1;
+  int next = (slot + 1) & buffer->table_mask;
+  while (buffer->table[next] != -1) {
+    const int moved = buffer->table[next];
+    buffer->table[next] = -1;
+    buffer->table[probe(buffer, insert_buffer_key(buffer, moved))] = moved;
+    next = (next + 1) & buffer->table_mask;
+  }
+
+  // η τελευταια εγγραφη γεμιζει την τρυπα ωστε ο πινακας να μενει συνεχης
+  const int last = --buffer->count;
+  if (entry != last) {
+    buffer->table[probe(buffer, insert_buffer_key(buffer, last))] = entry;
+    memcpy(insert_buffer_key(buffer, entry), insert_buffer_key(buffer, last), buffer->entry_size);
+  }
+  return 0;
+}
+
+// merge sort των αριθμων εγγραφων κατα κλειδι, απο πανω προς τα κατω
+static void sort_entries(const BPlusInsertBuffer *buffer, int *entries, int *scratch, const int count)
+{
+  if (count < 2) {
+    return;
+  }
+  const int half = count / 2;
+  sort_entries(buffer, entries, scratch, half);
+  sort_entries(buffer, entries + half, scratch, count - half);
+
+  const int size = key_size(buffer);
+  int i = 0, j = half, k = 0;
+  while (i < half && j < count) {
+    if (memcmp(insert_buffer_key(buffer, entries[j]), insert_buffer_key(buffer, entries[i]), size) < 0) {
+      scratch[k++] = entries[j++];
+    } else {
+      scratch[k++] = entries[i++];
+    }
+  }
+  while (i < half) {
+    scratch[k++] = entries[i++];
+  }
+  memcpy(entries, scratch, k * sizeof(int));
+}
+
+int *insert_buffer_sorted(const BPlusInsertBuffer *buffer)
+{
+  int *entries = malloc((buffer->count + 1) * sizeof(int));
+  int *scratch = malloc((buffer->count + 1) * sizeof(int));
+  if (entries == NULL || scratch == NULL) {
+    free(entries);
+    free(scratch);
+    return NULL;
+  }
+
+  for (int i = 0; i < buffer->count; i++) {
+    entries[i] = i;
+  }
+  sort_entries(buffer, entries, scratch, buffer->count);
+  free(scratch);
+  return entries;
+}
+
+int insert_buffer_retain(BPlusInsertBuffer *buffer, const int *keep, const int keep_count)
+{
+  char *kept = malloc((size_t)(keep_count + 1) * buffer->entry_size);
+  if (kept == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < keep_count; i++) {
+    memcpy(kept + (size_t)i * buffer->entry_size, insert_buffer_key(buffer, keep[i]), buffer->entry_size);
+  }
+
+  memcpy(buffer->entries, kept, (size_t)keep_count * buffer->entry_size);
+  free(kept);
+  memset(buffer->table, -1, (buffer->table_mask + 1) * sizeof(int));
+  buffer->count = keep_count;
+  for (int i = 0; i < keep_count; i++) {
+    buffer->table[probe(buffer, insert_buffer_key(buffer, i))] = i;
+  }
+  return 0;
+}
@@ -0,0 +1,275 @@
+// Joins χωρίς hash table: merge join δύο B+ αρχείων στα κλειδιά τους και
+// index nested loop join ενός scan με ένα B+ αρχείο, σε batches αναζητήσεων.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "bplus_datanode.h"
+#include "bplus_file_funcs.h"
+#include "bplus_index_node.h"
+#include "bplus_join.h"
+#include "bplus_key.h"
+#include "record_generator.h"
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+// ---------------------------------------------------------------- merge join
+
+typedef struct {
+  int file_desc;
+  const BPlusMeta *metadata;
+  BF_Block *block;
+  int block_id;  // το φυλλο που κραταμε pinned, -1 στο τελος
+  int pos;
+  int count;
+  char *data;
+  RecordDeserializer deserialize;  // ο μεταγλωττισμενος τυπος της εγγραφης, αν υπαρχει
+} JoinCursor;
+
+static int keys_compatible(const TableSchema *a, const TableSchema *b)
+{
+  if (a->key_attr_count != b->key_attr_count) {
+    return 0;
+  }
+  for (int k = 0; k < a->key_attr_count; k++) {
+    const AttributeSchema *x = &a->attributes[a->key_indexes[k]];
+    const AttributeSchema *y = &b->attributes[b->key_indexes[k]];
+    if (x->type != y->type || (x->type == TYPE_CHAR && x->length != y->length)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// φερνει το φυλλο block_id, προσπερνωντας αδεια φυλλα
+static int cursor_load(JoinCursor *cursor)
+{
+  while (cursor->block_id != -1) {
+    CALL_BF(BF_GetBlock(cursor->file_desc, cursor->block_id, cursor->block));
+    cursor->data = BF_Block_GetData(cursor->block);
+    cursor->count = ((BPlusDataNode *)cursor->data)->key_count;
+    cursor->pos = 0;
+    if (cursor->count > 0) {
+      return 0;
+    }
+    const int next = ((BPlusDataNode *)cursor->data)->next_block;
+    CALL_BF(BF_UnpinBlock(cursor->block));
+    cursor->block_id = next;
+  }
+  return 0;
+}
+
+static int cursor_next_leaf(JoinCursor *cursor)
+{
+  const int next = ((BPlusDataNode *)cursor->data)->next_block;
+  CALL_BF(BF_UnpinBlock(cursor->block));
+  cursor->block_id = next;
+  return cursor_load(cursor);
+}
+
+static int cursor_open(JoinCursor *cursor, const int file_desc, const BPlusMeta *metadata)
+{
+  cursor->file_desc = file_desc;
+  cursor->metadata = metadata;
+  cursor->block_id = -1;
+  cursor->deserialize = record_deserializer(&metadata->table_schema);
+  BF_Block_Init(&cursor->block);
+  // οτι περιμενει στο insert buffer πρεπει να φτασει στα φυλλα
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return -1;
+  }
+  if (metadata->root_block_num == -1) {
+    return 0;
+  }
+
+  // το αριστεροτερο φυλλο, απο τα πρωτα παιδια των κομβων ευρετηριου
+  int block_id = metadata->root_block_num;
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, cursor->block));
+    const int child = indexnode_children(BF_Block_GetData(cursor->block), metadata->index_capacity)[0];
+    CALL_BF(BF_UnpinBlock(cursor->block));
+    block_id = child;
+  }
+  cursor->block_id = block_id;
+  return cursor_load(cursor);
+}
+
+static void cursor_close(JoinCursor *cursor)
+{
+  if (cursor->block_id != -1) {
+    BF_UnpinBlock(cursor->block);
+  }
+  BF_Block_Destroy(&cursor->block);
+}
+
+static void cursor_key(const JoinCursor *cursor, unsigned char *key)
+{
+  datanode_key(cursor->data, &cursor->metadata->table_schema, cursor->metadata->leaf_capacity, cursor->pos, key);
+}
+
+static void cursor_record(const JoinCursor *cursor, Record *record)
+{
+  const TableSchema *schema = &cursor->metadata->table_schema;
+  cursor->deserialize(schema, datanode_record(cursor->data, schema, cursor->metadata->leaf_capacity, cursor->pos),
+                      record);
+}
+
+static int cursor_advance(JoinCursor *cursor)
+{
+  if (++cursor->pos < cursor->count) {
+    return 0;
+  }
+  return cursor_next_leaf(cursor);
+}
+
+static int merge(JoinCursor *left, JoinCursor *right, const BPlusJoinVisit visit, void *ctx)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  Record left_record, right_record;
+  JoinCursor *lead = right;
+  JoinCursor *follow = left;
+  int matches = 0;
+
+  while (left->block_id != -1 && right->block_id != -1) {
+    // ο follow φτανει στο πρωτο του κλειδι >= του lead, με δυαδικη αναζητηση στο φυλλο του
+    int found;
+    cursor_key(lead, key);
+    const int pos = datanode_search(follow->data, &follow->metadata->table_schema, follow->metadata->leaf_capacity,
+                                    key, &found);
+    if (pos > follow->pos) {
+      follow->pos = pos;
+    }
+    if (follow->pos >= follow->count) {
+      if (cursor_next_leaf(follow) == -1) {
+        return -1;
+      }
+      continue;
+    }
+    if (!found || pos < follow->pos) {
+      // το κλειδι του follow ειναι μεγαλυτερο: αλλαζουν ρολους
+      JoinCursor *swap = lead;
+      lead = follow;
+      follow = swap;
+      continue;
+    }
+
+    cursor_record(left, &left_record);
+    cursor_record(right, &right_record);
+    matches++;
+    if (visit(&left_record, &right_record, ctx) != 0) {
+      break;
+    }
+    if (cursor_advance(left) == -1 || cursor_advance(right) == -1) {
+      return -1;
+    }
+  }
+  return matches;
+}
+
+int bplus_merge_join(const int left_desc, const BPlusMeta *left, const int right_desc, const BPlusMeta *right,
+                     const BPlusJoinVisit visit, void *ctx)
+{
+  if (!keys_compatible(&left->table_schema, &right->table_schema)) {
+    fprintf(stderr, "Error: merge join needs keys of the same types on both files\n");
+    return -1;
+  }
+  JoinCursor left_cursor, right_cursor;
+  int result = cursor_open(&left_cursor, left_desc, left);
+  if (result == 0) {
+    result = cursor_open(&right_cursor, right_desc, right);
+    if (result == 0) {
+      result = merge(&left_cursor, &right_cursor, visit, ctx);
+    }
+    cursor_close(&right_cursor);
+  }
+  cursor_close(&left_cursor);
+  return result;
+}
+
+// ---------------------------------------------------------------- index nested loop join
+
+// η γραμμη r ενος batch ως Record του σχηματος του batch
+static void batch_record(const ExecBatch *batch, const int r, Record *record)
+{
+  const TableSchema *schema = batch->schema;
+  for (int c = 0; c < schema->count; c++) {
+    const AttributeSchema *attr = &schema->attributes[c];
+    if (attr->type == TYPE_INT) {
+      record->values[c].int_value = ((const int *)batch->columns[c])[r];
+    } else if (attr->type == TYPE_FLOAT) {
+      record->values[c].float_value = ((const float *)batch->columns[c])[r];
+    } else {
+      // ως το πρωτο NUL: στο heap file τα επομενα bytes μπορει να ειναι σκουπιδια
+      const char *bytes = batch->columns[c] + (size_t)r * attr->length;
+      const int length = attr->length < MAX_STRING_LENGTH ? attr->length : MAX_STRING_LENGTH;
+      memset(record->values[c].string_value, 0, MAX_STRING_LENGTH);
+      strncpy(record->values[c].string_value, bytes, length);
+    }
+  }
+}
+
+int bplus_index_join(ExecOperator *outer, const int outer_column, const int inner_desc, const BPlusMeta *inner,
+                     const BPlusJoinVisit visit, void *ctx)
+{
+  if (outer == NULL) {
+    return -1;
+  }
+  const TableSchema *schema = &inner->table_schema;
+  const AttributeSchema *key_attr = &schema->attributes[schema->key_index];
+  const AttributeSchema *outer_attr = &outer->schema.attributes[outer_column];
+  if (outer_column < 0 || outer_column >= outer->schema.count || schema->key_attr_count != 1 ||
+      key_attr->type != outer_attr->type || (key_attr->type == TYPE_CHAR && key_attr->length != outer_attr->length)) {
+    fprintf(stderr, "Error: index join needs an outer column of the type of the single inner key\n");
+    exec_close(outer);
+    return -1;
+  }
+
+  // probes[i] κραταει την εξωτερικη γραμμη, keys[i] το κλειδι της στο σχημα του inner
+  Record *probes = malloc(EXEC_BATCH_SIZE * sizeof(Record));
+  Record *keys = malloc(EXEC_BATCH_SIZE * sizeof(Record));
+  Record *found_records = malloc(EXEC_BATCH_SIZE * sizeof(Record));
+  int *found = malloc(EXEC_BATCH_SIZE * sizeof(int));
+  int result = probes != NULL && keys != NULL && found_records != NULL && found != NULL ? 0 : -1;
+  int matches = 0;
+  int stopped = 0;
+  ExecBatch *batch;
+  int n;
+
+  while (result == 0 && !stopped && (n = exec_next(outer, &batch)) != 0) {
+    if (n == -1) {
+      result = -1;
+      break;
+    }
+    for (int k = 0; k < n; k++) {
+      batch_record(batch, batch->selection != NULL ? batch->selection[k] : k, &probes[k]);
+      keys[k].values[schema->key_index] = probes[k].values[outer_column];
+    }
+    if (bplus_record_find_many_by_key(inner_desc, inner, keys, n, found_records, found) == -1) {
+      result = -1;
+      break;
+    }
+    for (int k = 0; k < n && !stopped; k++) {
+      if (found[k]) {
+        matches++;
+        stopped = visit(&probes[k], &found_records[k], ctx) != 0;
+      }
+    }
+  }
+  free(found);
+  free(found_records);
+  free(keys);
+  free(probes);
+  exec_close(outer);
+  return result == -1 ? -1 : matches;
+}
@@ -0,0 +1,138 @@
+// Κανονικοποιημένα κλειδιά: τα πεδία του κλειδιού γίνονται bytes που
+// συγκρίνονται σωστά με memcmp, ώστε ένας comparator να αρκεί για κάθε σχήμα.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bplus_key.h"
+
+#define SIGN_BIT 0x80000000u
+
+static void put_be32(const uint32_t value, unsigned char *out)
+{
+  out[0] = (unsigned char)(value >> 24);
+  out[1] = (unsigned char)(value >> 16);
+  out[2] = (unsigned char)(value >> 8);
+  out[3] = (unsigned char)value;
+}
+
+static uint32_t get_be32(const unsigned char *in)
+{
+  return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+// οι αρνητικοι πρεπει να βγαινουν πρωτοι: αναποδογυριζουμε το sign bit
+static void normalize_int(const int value, unsigned char *out)
+{
+  put_be32((uint32_t)value ^ SIGN_BIT, out);
+}
+
+// IEEE float: οι θετικοι με αναποδο sign bit, οι αρνητικοι με ολα τα bits αναποδα
+static void normalize_float(const float value, unsigned char *out)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & SIGN_BIT) ? ~bits : bits ^ SIGN_BIT;
+  put_be32(bits, out);
+}
+
+// γραφει ενα πεδιο του κλειδιου και επιστρεφει ποσα bytes πηρε
+static int normalize_field(const AttributeSchema *attr, const char *field, unsigned char *out)
+{
+  switch (attr->type) {
+    case TYPE_INT: {
+      int value;
+      memcpy(&value, field, sizeof(int));
+      normalize_int(value, out);
+      return sizeof(int);
+    }
+    case TYPE_FLOAT: {
+      float value;
+      memcpy(&value, field, sizeof(float));
+      normalize_float(value, out);
+      return sizeof(float);
+    }
+    case TYPE_CHAR:
+      // strncpy γεμιζει με μηδενικα, οποτε το "Anna" ερχεται πριν το "Annabel"
+      strncpy((char *)out, field, attr->length);
+      return attr->length;
+    default:
+      return 0;
+  }
+}
+
+void bplus_key_from_record(const TableSchema *schema, const Record *record, unsigned char *key)
+{
+  int offset = 0;
+  memset(key, 0, schema->key_size);
+  for (int k = 0; k < schema->key_attr_count; k++) {
+    const int i = schema->key_indexes[k];
+    offset += normalize_field(&schema->attributes[i], (const char *)&record->values[i], key + offset);
+  }
+}
+
+void bplus_key_from_packed(const TableSchema *schema, const char *packed, unsigned char *key)
+{
+  int offset = 0;
+  memset(key, 0, schema->key_size);
+  for (int k = 0; k < schema->key_attr_count; k++) {
+    const int i = schema->key_indexes[k];
+    offset += normalize_field(&schema->attributes[i], packed + schema->offsets[i], key + offset);
+  }
+}
+
+int bplus_key_from_int(const TableSchema *schema, const int value, unsigned char *key)
+{
+  if (schema->key_attr_count != 1 || schema->attributes[schema->key_index].type != TYPE_INT) {
+    return -1;
+  }
+  normalize_int(value, key);
+  return 0;
+}
+
+// το αντιστροφο του normalize_field, επιστρεφει ποσα bytes διαβασε
+static int denormalize_field(const AttributeSchema *attr, const unsigned char *in, FieldValue *value)
+{
+  uint32_t bits = get_be32(in);
+  switch (attr->type) {
+    case TYPE_INT:
+      value->int_value = (int)(bits ^ SIGN_BIT);
+      return sizeof(int);
+    case TYPE_FLOAT:
+      bits = (bits & SIGN_BIT) ? bits ^ SIGN_BIT : ~bits;
+      memcpy(&value->float_value, &bits, sizeof(float));
+      return sizeof(float);
+    case TYPE_CHAR:
+      memset(value->string_value, 0, MAX_STRING_LENGTH);
+      memcpy(value->string_value, in, attr->length < MAX_STRING_LENGTH ? attr->length : MAX_STRING_LENGTH);
+      return attr->length;
+    default:
+      return 0;
+  }
+}
+
+void bplus_key_to_record(const TableSchema *schema, const unsigned char *key, Record *record)
+{
+  int offset = 0;
+  for (int k = 0; k < schema->key_attr_count; k++) {
+    const int i = schema->key_indexes[k];
+    offset += denormalize_field(&schema->attributes[i], key + offset, &record->values[i]);
+  }
+}
+
+int bplus_key_head(const unsigned char *key)
+{
+  return (int)(get_be32(key) ^ SIGN_BIT);
+}
+
+void bplus_key_set_head(const int head, unsigned char *key)
+{
+  normalize_int(head, key);
+}
+
+int bplus_key_compare_packed(const TableSchema *schema, const unsigned char *key, const char *packed)
+{
+  unsigned char other[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_packed(schema, packed, other);
+  return memcmp(key, other, schema->key_size);
+}
@@ -0,0 +1,193 @@
+// Συμπίεση σελίδων: LZ77 στη μορφή block του LZ4, με πίνακα κατακερματισμού
+// τετράδων για τα matches και χωρίς entropy coding.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bplus_lz.h"
+
+#define HASH_BITS 12
+#define LAST_LITERALS 5  // τα τελευταια bytes μενουν παντα literals
+#define MATCH_LIMIT 12   // κανενα match δεν ξεκιναει τοσο κοντα στο τελος
+#define MAX_OFFSET 65535
+#define WILD_COPY 16     // bytes που αντιγραφονται μαζι οταν υπαρχει χωρος
+
+static uint32_t read32(const char *p)
+{
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static int hash(const uint32_t sequence)
+{
+  return (int)((sequence * 2654435761u) >> (32 - HASH_BITS));
+}
+
+// ενα μηκος στο nibble του token, και οτι περισσευει σε bytes των 255
+static char *write_length(char *out, int length)
+{
+  for (length -= 15; length >= 255; length -= 255) {
+    *out++ = (char)255;
+  }
+  *out++ = (char)length;
+  return out;
+}
+
+// Ενα sequence: literals [literal, literal + literals) και ενα match, ή χωρις match
+// (match_length 0) για το τελευταιο. Επιστρεφει NULL αν δεν χωραει
+static char *write_sequence(char *out, const char *end, const char *literal, const int literals, const int offset,
+                            const int match_length)
+{
+  const int match_code = match_length > 0 ? match_length - BPLUS_LZ_MIN_MATCH : 0;
+  if (end - out < 1 + literals / 255 + 1 + literals + 2 + match_code / 255 + 1) {
+    return NULL;
+  }
+
+  char *token = out++;
+  *token = (char)((literals < 15 ? literals : 15) << 4);
+  if (literals >= 15) {
+    out = write_length(out, literals);
+  }
+  memcpy(out, literal, literals);
+  out += literals;
+  if (match_length == 0) {
+    return out;
+  }
+
+  *out++ = (char)(offset & 0xFF);
+  *out++ = (char)(offset >> 8);
+  *token |= (char)(match_code < 15 ? match_code : 15);
+  if (match_code >= 15) {
+    out = write_length(out, match_code);
+  }
+  return out;
+}
+
+int bplus_lz_compress(const char *in, const int n, char *out, const int capacity)
+{
+  int table[1 << HASH_BITS];
+  const char *end = out + capacity;
+  char *next = out;
+  int anchor = 0;
+  int i = 0;
+
+  for (int h = 0; h < 1 << HASH_BITS; h++) {
+    table[h] = -1;
+  }
+  while (i < n - MATCH_LIMIT) {
+    const uint32_t sequence = read32(in + i);
+    const int h = hash(sequence);
+    const int candidate = table[h];
+    table[h] = i;
+    if (candidate < 0 || i - candidate > MAX_OFFSET || read32(in + candidate) != sequence) {
+      i++;
+      continue;
+    }
+
+    // επεκταση προς τα πισω μεσα στα literals και μετα προς τα εμπρος
+    int start = i;
+    int from = candidate;
+    while (start > anchor && from > 0 && in[start - 1] == in[from - 1]) {
+      start--;
+      from--;
+    }
+    int length = i - start + BPLUS_LZ_MIN_MATCH;
+    while (start + length < n - LAST_LITERALS && in[from + length] == in[start + length]) {
+      length++;
+    }
+
+    next = write_sequence(next, end, in + anchor, start - anchor, start - from, length);
+    if (next == NULL) {
+      return -1;
+    }
+    i = start + length;
+    anchor = i;
+    // η θεση λιγο πριν το τελος του match βοηθαει τα επαναλαμβανομενα μοτιβα
+    if (i - 2 < n - MATCH_LIMIT) {
+      table[hash(read32(in + i - 2))] = i - 2;
+    }
+  }
+
+  next = write_sequence(next, end, in + anchor, n - anchor, 0, 0);
+  return next == NULL ? -1 : (int)(next - out);
+}
+
+// διαβαζει τη συνεχεια ενος μηκους 15, -1 αν τελειωσει η εισοδος
+static int read_length(const unsigned char **in, const unsigned char *end, int length)
+{
+  unsigned char byte;
+  do {
+    if (*in >= end) {
+      return -1;
+    }
+    byte = *(*in)++;
+    length += byte;
+  } while (byte == 255);
+  return length;
+}
+
+int bplus_lz_decompress(const char *in, const int n, char *out, const int capacity)
+{
+  const unsigned char *next = (const unsigned char *)in;
+  const unsigned char *end = next + n;
+  int written = 0;
+
+  while (next < end) {
+    const unsigned char token = *next++;
+    int literals = token >> 4;
+    if (literals == 15 && (literals = read_length(&next, end, literals)) == -1) {
+      return -1;
+    }
+    if (literals > end - next || literals > capacity - written) {
+      return -1;
+    }
+    // με χωρο και στις δυο μεριες αντιγραφονται σταθερα WILD_COPY bytes, που γινεται
+    // χωρις κληση του memcpy· τα παραπανω τα ξαναγραφει το επομενο sequence
+    if (literals <= WILD_COPY && end - next >= WILD_COPY && capacity - written >= WILD_COPY) {
+      memcpy(out + written, next, WILD_COPY);
+    } else {
+      memcpy(out + written, next, literals);
+    }
+    next += literals;
+    written += literals;
+    // μονο το τελευταιο sequence τελειωνει χωρις match, και το token του το λεει
+    if (next == end) {
+      return (token & 15) == 0 ? written : -1;
+    }
+
+    if (end - next < 2) {
+      return -1;
+    }
+    const int offset = next[0] | next[1] << 8;
+    next += 2;
+    int length = token & 15;
+    if (length == 15 && (length = read_length(&next, end, length)) == -1) {
+      return -1;
+    }
+    length += BPLUS_LZ_MIN_MATCH;
+    if (offset == 0 || offset > written || length > capacity - written) {
+      return -1;
+    }
+
+    // το match μπορει να επικαλυπτει οσα γραφει: τα bytes επαναλαμβανονται με περιοδο
+    // offset, οποτε αντιγραφεται σε κομματια που διπλασιαζονται και δεν επικαλυπτονται
+    char *target = out + written;
+    if (offset >= WILD_COPY && capacity - written >= length + WILD_COPY) {
+      for (int done = 0; done < length; done += WILD_COPY) {
+        memcpy(target + done, target + done - offset, WILD_COPY);
+      }
+    } else {
+      int span = offset;
+      for (int done = 0; done < length;) {
+        const int chunk = span < length - done ? span : length - done;
+        memcpy(target + done, target + done - span, chunk);
+        done += chunk;
+        span += chunk;
+      }
+    }
+    written += length;
+  }
+  // η εισοδος τελειωσε μετα απο match, χωρις το τελευταιο sequence: ειναι κομμενη
+  return -1;
+}
@@ -0,0 +1,607 @@
+// B+ δέντρο στη μνήμη με ομάδες παιδιών (CSB+), με τον ίδιο τύπο φύλλων με
+// τα αρχεία και checkpoint των αλλαγών του πίσω στο αρχείο.
+//
+// Διάταξη κόμβου ευρετηρίου: [BPlusMemIndexNode][heads[capacity]][suffixes[capacity]]
+// και τα παιδια του, ολα ιδιου μεγεθους, ειναι συνεχομενα στο children.
+
+#include "bplus_memtree.h"
+#include "bplus_file_funcs.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bplus_search.h"
+#include "record_generator.h"
+#include "bf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LEAF_CAPACITY BPLUS_MEMTREE_LEAF_RECORDS
+#define MIN_INDEX_CAPACITY 4
+#define LOG_INSERT 1
+#define LOG_DELETE 2
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+static int align64(const int value)
+{
+  return (value + 63) & ~63;
+}
+
+static char *alloc_nodes(const int count, const int size)
+{
+  return aligned_alloc(64, (size_t)count * size);
+}
+
+static int *mem_heads(char *node)
+{
+  return (int *)(node + sizeof(BPlusMemIndexNode));
+}
+
+static unsigned char *mem_suffix(const BPlusMemTree *tree, char *node, const int pos)
+{
+  return (unsigned char *)(mem_heads(node) + tree->index_capacity) + pos * (tree->schema.key_size - 4);
+}
+
+static void mem_key(const BPlusMemTree *tree, char *node, const int pos, unsigned char *key)
+{
+  bplus_key_set_head(mem_heads(node)[pos], key);
+  memcpy(key + 4, mem_suffix(tree, node, pos), tree->schema.key_size - 4);
+}
+
+// ποιο παιδι καλυπτει το key, οπως στο indexnode_child_slot
+static int mem_child_slot(const BPlusMemTree *tree, char *node, const unsigned char *key)
+{
+  const int key_count = ((BPlusMemIndexNode *)node)->key_count;
+  const int *heads = mem_heads(node);
+  const int head = bplus_key_head(key);
+  const int suffix_size = tree->schema.key_size - 4;
+
+  if (suffix_size == 0) {
+    return bplus_rank_upper(heads, key_count, head);
+  }
+
+  int lo = bplus_rank_lower(heads, key_count, head);
+  int hi = bplus_rank_upper(heads, key_count, head);
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (memcmp(mem_suffix(tree, node, mid), key + 4, suffix_size) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// μεγεθος των παιδιων ενος κομβου του επιπεδου level
+static int child_size(const BPlusMemTree *tree, const int level)
+{
+  return level + 1 < tree->depth - 1 ? tree->index_size : tree->leaf_size;
+}
+
+static char *mem_child(const BPlusMemTree *tree, char *node, const int level, const int slot)
+{
+  return ((BPlusMemIndexNode *)node)->children + (long)slot * child_size(tree, level);
+}
+
+// κανει χωρο για ενα παιδι στη θεση slot της ομαδας (ο κομβος δεν ειναι γεματος)
+static void open_slot(const BPlusMemTree *tree, char *node, const int level, const int slot)
+{
+  const int size = child_size(tree, level);
+  char *children = ((BPlusMemIndexNode *)node)->children;
+  memmove(children + (long)(slot + 1) * size, children + (long)slot * size,
+          (long)(((BPlusMemIndexNode *)node)->key_count + 1 - slot) * size);
+}
+
+// βαζει το key στη θεση pos, με δεξι παιδι αυτο που μολις μπηκε στη θεση pos + 1
+static void insert_key(const BPlusMemTree *tree, char *node, const int pos, const unsigned char *key)
+{
+  BPlusMemIndexNode *index = (BPlusMemIndexNode *)node;
+  const int suffix_size = tree->schema.key_size - 4;
+  const int tail = index->key_count - pos;
+
+  memmove(&mem_heads(node)[pos + 1], &mem_heads(node)[pos], tail * sizeof(int));
+  memmove(mem_suffix(tree, node, pos + 1), mem_suffix(tree, node, pos), tail * suffix_size);
+  mem_heads(node)[pos] = bplus_key_head(key);
+  memcpy(mem_suffix(tree, node, pos), key + 4, suffix_size);
+  index->key_count++;
+}
+
+// Σπαει το γεματο παιδι slot ενος κομβου ευρετηριου (που δεν ειναι γεματος):
+// ο νεος κομβος μπαινει διπλα του στην ομαδα και παιρνει τα μισα εγγονια σε νεα ομαδα
+static int split_index_child(const BPlusMemTree *tree, char *node, const int level, const int slot)
+{
+  const int capacity = tree->index_capacity;
+  const int suffix_size = tree->schema.key_size - 4;
+  const int grandchild_size = child_size(tree, level + 1);
+  char *group = alloc_nodes(capacity + 1, grandchild_size);
+  if (group == NULL) {
+    return -1;
+  }
+
+  open_slot(tree, node, level, slot + 1);
+  char *child = mem_child(tree, node, level, slot);
+  char *sibling = mem_child(tree, node, level, slot + 1);
+  BPlusMemIndexNode *left = (BPlusMemIndexNode *)child;
+  BPlusMemIndexNode *right = (BPlusMemIndexNode *)sibling;
+
+  // τα mid πρωτα κλειδια μενουν, το μεσαιο ανεβαινει, τα υπολοιπα φευγουν
+  const int mid = capacity / 2;
+  unsigned char separator[BPLUS_MAX_KEY_SIZE];
+  mem_key(tree, child, mid, separator);
+
+  right->key_count = capacity - mid - 1;
+  right->children = group;
+  memcpy(mem_heads(sibling), &mem_heads(child)[mid + 1], right->key_count * sizeof(int));
+  memcpy(mem_suffix(tree, sibling, 0), mem_suffix(tree, child, mid + 1), right->key_count * suffix_size);
+  memcpy(group, left->children + (long)(mid + 1) * grandchild_size, (long)(capacity - mid) * grandchild_size);
+  left->key_count = mid;
+
+  insert_key(tree, node, slot, separator);
+  return 0;
+}
+
+// Νεα ριζα με μοναδικο παιδι την παλια
+static int grow(BPlusMemTree *tree)
+{
+  const int old_size = tree->depth == 1 ? tree->leaf_size : tree->index_size;
+  char *root = alloc_nodes(1, tree->index_size);
+  char *group = alloc_nodes(tree->index_capacity + 1, old_size);
+  if (root == NULL || group == NULL) {
+    free(root);
+    free(group);
+    return -1;
+  }
+
+  memcpy(group, tree->root, old_size);
+  free(tree->root);
+  ((BPlusMemIndexNode *)root)->key_count = 0;
+  ((BPlusMemIndexNode *)root)->children = group;
+  tree->root = root;
+  tree->depth++;
+  return 0;
+}
+
+static char *find_leaf(const BPlusMemTree *tree, const unsigned char *key)
+{
+  char *node = tree->root;
+  for (int level = 0; level < tree->depth - 1; level++) {
+    node = mem_child(tree, node, level, mem_child_slot(tree, node, key));
+  }
+  return node;
+}
+
+// Εισαγωγη με σπασιμο απο πανω προς τα κατω: καθε γεματος κομβος ευρετηριου
+// στη διαδρομη σπαει πριν κατεβουμε, οποτε ο γονεας ενος φυλλου εχει παντα χωρο
+static int insert(BPlusMemTree *tree, const Record *record)
+{
+  const TableSchema *schema = &tree->schema;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(schema, record, key);
+
+  if (tree->depth == 1 && ((BPlusDataNode *)tree->root)->key_count == LEAF_CAPACITY) {
+    if (grow(tree) == -1) {
+      return -1;
+    }
+  } else if (tree->depth > 1 && ((BPlusMemIndexNode *)tree->root)->key_count == tree->index_capacity) {
+    if (grow(tree) == -1 || split_index_child(tree, tree->root, 0, 0) == -1) {
+      return -1;
+    }
+  }
+
+  char *parent = NULL;
+  int parent_slot = 0;
+  char *node = tree->root;
+  for (int level = 0; level < tree->depth - 1; level++) {
+    int slot = mem_child_slot(tree, node, key);
+    if (level + 2 < tree->depth &&
+        ((BPlusMemIndexNode *)mem_child(tree, node, level, slot))->key_count == tree->index_capacity) {
+      if (split_index_child(tree, node, level, slot) == -1) {
+        return -1;
+      }
+      slot = mem_child_slot(tree, node, key);
+    }
+    parent = node;
+    parent_slot = slot;
+    node = mem_child(tree, node, level, slot);
+  }
+
+  int found;
+  const int pos = datanode_search(node, schema, LEAF_CAPACITY, key, &found);
+  if (found) {
+    return -1;
+  }
+
+  if (((BPlusDataNode *)node)->key_count < LEAF_CAPACITY) {
+    datanode_insert_at(node, schema, LEAF_CAPACITY, pos, record);
+  } else {
+    open_slot(tree, parent, tree->depth - 2, parent_slot + 1);
+    char *sibling = mem_child(tree, parent, tree->depth - 2, parent_slot + 1);
+    int in_new;
+    unsigned char separator[BPLUS_MAX_KEY_SIZE];
+    datanode_init(sibling);
+    datanode_split(node, sibling, schema, LEAF_CAPACITY, pos, record, &in_new, separator);
+    insert_key(tree, parent, parent_slot, separator);
+  }
+
+  tree->record_count++;
+  return 0;
+}
+
+static void free_children(const BPlusMemTree *tree, char *node, const int level)
+{
+  if (level == tree->depth - 1) {
+    return;
+  }
+  BPlusMemIndexNode *index = (BPlusMemIndexNode *)node;
+  for (int i = 0; i <= index->key_count; i++) {
+    free_children(tree, mem_child(tree, node, level, i), level + 1);
+  }
+  free(index->children);
+}
+
+static int log_entry_size(const BPlusMemTree *tree)
+{
+  return sizeof(int) + tree->schema.record_size;
+}
+
+// εξασφαλιζει χωρο για μια ακομα εγγραφη στο log
+static int reserve_log(BPlusMemTree *tree)
+{
+  if (tree->log_count < tree->log_allocated) {
+    return 0;
+  }
+  const int allocated = tree->log_allocated == 0 ? 1024 : tree->log_allocated * 2;
+  char *log = realloc(tree->log, (size_t)allocated * log_entry_size(tree));
+  if (log == NULL) {
+    return -1;
+  }
+  tree->log = log;
+  tree->log_allocated = allocated;
+  return 0;
+}
+
+static char *append_log(BPlusMemTree *tree, const int op)
+{
+  char *entry = tree->log + (long)tree->log_count++ * log_entry_size(tree);
+  memcpy(entry, &op, sizeof(int));
+  return entry + sizeof(int);
+}
+
+static void after_change(BPlusMemTree *tree)
+{
+  if (tree->checkpoint_every > 0 && tree->log_count >= tree->checkpoint_every &&
+      bplus_memtree_checkpoint(tree) == -1) {
+    fprintf(stderr, "Error: checkpoint failed, %d changes are only in memory\n", tree->log_count);
+  }
+}
+
+// διαβαζει τις εγγραφες του αρχειου με τη σειρα, ακολουθωντας τη λιστα των φυλλων
+typedef struct {
+  int file_desc;
+  const BPlusMeta *metadata;
+  BF_Block *block;  // το φυλλο της επομενης εγγραφης
+  int pinned;       // 0 αφου τελειωσει η λιστα ή αποτυχει το διαβασμα
+  int pos;
+  RecordDeserializer deserialize;
+} LeafCursor;
+
+// το αριστερο φυλλο του αρχειου, -1 σε αποτυχια
+static int leftmost_leaf(const int file_desc, const BPlusMeta *metadata)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int block_id = metadata->root_block_num;
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const int child = indexnode_children(BF_Block_GetData(block), metadata->index_capacity)[0];
+    CALL_BF(BF_UnpinBlock(block));
+    block_id = child;
+  }
+  BF_Block_Destroy(&block);
+  return block_id;
+}
+
+static const char *cursor_next(LeafCursor *cursor)
+{
+  const BPlusDataNode *leaf = (const BPlusDataNode *)BF_Block_GetData(cursor->block);
+  while (cursor->pos == leaf->key_count) {
+    const int next = leaf->next_block;
+    cursor->pinned = 0;
+    if (BF_UnpinBlock(cursor->block) != BF_OK || next == -1 ||
+        BF_GetBlock(cursor->file_desc, next, cursor->block) != BF_OK) {
+      return NULL;
+    }
+    cursor->pinned = 1;
+    leaf = (const BPlusDataNode *)BF_Block_GetData(cursor->block);
+    cursor->pos = 0;
+  }
+  return datanode_record(BF_Block_GetData(cursor->block), &cursor->metadata->table_schema,
+                         cursor->metadata->leaf_capacity, cursor->pos++);
+}
+
+// ποσες εγγραφες χωρανε στο υποδεντρο ενος κομβου του επιπεδου level
+static long subtree_records(const BPlusMemTree *tree, const int level)
+{
+  long records = LEAF_CAPACITY;
+  for (int i = level; i < tree->depth - 1; i++) {
+    records *= tree->index_capacity + 1;
+  }
+  return records;
+}
+
+// Χτιζει τον κομβο node του επιπεδου level με τις επομενες count εγγραφες. Τα παιδια
+// ενος κομβου ευρετηριου ειναι οσα λιγοτερα χωρανε, με ισα μεριδια εγγραφων, οποτε
+// τα φυλλα βγαινουν σχεδον γεματα. Σε αποτυχια ελευθερωνει οτι εφτιαξε
+static int build_node(BPlusMemTree *tree, char *node, const int level, const long count, LeafCursor *cursor,
+                      unsigned char *first_key)
+{
+  const TableSchema *schema = &tree->schema;
+  if (level == tree->depth - 1) {
+    datanode_init(node);
+    for (int i = 0; i < count; i++) {
+      const char *data = cursor_next(cursor);
+      if (data == NULL) {
+        return -1;
+      }
+      Record record;
+      cursor->deserialize(schema, data, &record);
+      datanode_insert_at(node, schema, LEAF_CAPACITY, i, &record);
+    }
+    datanode_key(node, schema, LEAF_CAPACITY, 0, first_key);
+    return 0;
+  }
+
+  BPlusMemIndexNode *index = (BPlusMemIndexNode *)node;
+  const long below = subtree_records(tree, level + 1);
+  const int children = (int)((count + below - 1) / below);
+  index->key_count = 0;
+  index->children = alloc_nodes(tree->index_capacity + 1, child_size(tree, level));
+  if (index->children == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < children; i++) {
+    unsigned char key[BPLUS_MAX_KEY_SIZE];
+    const long share = count / children + (i < count % children);
+    if (build_node(tree, mem_child(tree, node, level, i), level + 1, share, cursor, key) == -1) {
+      for (int j = 0; j < i; j++) {
+        free_children(tree, mem_child(tree, node, level, j), level + 1);
+      }
+      free(index->children);
+      return -1;
+    }
+    if (i == 0) {
+      memcpy(first_key, key, schema->key_size);
+    } else {
+      insert_key(tree, node, i - 1, key);
+    }
+  }
+  return 0;
+}
+
+// Φορτωνει ολες τις εγγραφες του αρχειου απο κατω προς τα πανω: πρωτα μετραει τις
+// εγγραφες των φυλλων, μετα διαλεγει το μικροτερο βαθος που τις χωραει και χτιζει
+static int load_records(BPlusMemTree *tree)
+{
+  const BPlusMeta *metadata = tree->metadata;
+  if (metadata->root_block_num == -1) {
+    return 0;
+  }
+  const int first_leaf = leftmost_leaf(tree->file_desc, metadata);
+  if (first_leaf == -1) {
+    return -1;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  long count = 0;
+  for (int block_id = first_leaf; block_id != -1;) {
+    CALL_BF(BF_GetBlock(tree->file_desc, block_id, block));
+    const BPlusDataNode *leaf = (const BPlusDataNode *)BF_Block_GetData(block);
+    count += leaf->key_count;
+    block_id = leaf->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+  }
+  if (count == 0) {
+    BF_Block_Destroy(&block);
+    return 0;
+  }
+
+  while (subtree_records(tree, 0) < count) {
+    tree->depth++;
+  }
+  if (tree->depth > 1) {
+    char *root = alloc_nodes(1, tree->index_size);
+    if (root == NULL) {
+      tree->depth = 1;
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+    free(tree->root);
+    tree->root = root;
+  }
+
+  LeafCursor cursor = {tree->file_desc, metadata, block, 1, 0, record_deserializer(&tree->schema)};
+  unsigned char first_key[BPLUS_MAX_KEY_SIZE];
+  CALL_BF(BF_GetBlock(tree->file_desc, first_leaf, block));
+  const int result = build_node(tree, tree->root, 0, count, &cursor, first_key);
+  if (cursor.pinned) {
+    BF_UnpinBlock(block);
+  }
+  if (result == 0) {
+    tree->record_count = count;
+  } else {
+    // τα παιδια της ριζας τα ελευθερωσε το build_node, η ριζα μενει για τον καλουντα
+    tree->depth = 1;
+  }
+  BF_Block_Destroy(&block);
+  return result;
+}
+
+BPlusMemTree *bplus_memtree_load(const int file_desc, BPlusMeta *metadata, const int checkpoint_every)
+{
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return NULL;
+  }
+
+  BPlusMemTree *tree = calloc(1, sizeof(BPlusMemTree));
+  if (tree == NULL) {
+    return NULL;
+  }
+  tree->schema = metadata->table_schema;
+  tree->file_desc = file_desc;
+  tree->metadata = metadata;
+  tree->checkpoint_every = checkpoint_every;
+  tree->depth = 1;
+
+  const int key_size = tree->schema.key_size;
+  tree->index_capacity = (int)((BPLUS_MEMTREE_NODE_BYTES - sizeof(BPlusMemIndexNode)) / key_size);
+  if (tree->index_capacity < MIN_INDEX_CAPACITY) {
+    tree->index_capacity = MIN_INDEX_CAPACITY;
+  }
+  tree->index_size = align64(sizeof(BPlusMemIndexNode) + tree->index_capacity * key_size);
+  tree->leaf_size = align64(sizeof(BPlusDataNode) + LEAF_CAPACITY * (sizeof(int) + tree->schema.record_size));
+
+  tree->root = alloc_nodes(1, tree->leaf_size);
+  if (tree->root == NULL) {
+    free(tree);
+    return NULL;
+  }
+  datanode_init(tree->root);
+
+  if (load_records(tree) == -1) {
+    fprintf(stderr, "Error: cannot load the B+ tree into memory\n");
+    free_children(tree, tree->root, 0);
+    free(tree->root);
+    free(tree);
+    return NULL;
+  }
+  return tree;
+}
+
+int bplus_memtree_checkpoint(BPlusMemTree *tree)
+{
+  const int entry_size = log_entry_size(tree);
+  const RecordDeserializer deserialize = record_deserializer(&tree->schema);
+  int result = 0;
+  int done = 0;
+
+  // οι αλλαγες με τη σειρα τους, ωστε μια διαγραφη και επανεισαγωγη να βγαινει σωστα
+  for (; done < tree->log_count; done++) {
+    const char *entry = tree->log + (long)done * entry_size;
+    int op;
+    memcpy(&op, entry, sizeof(int));
+    Record record;
+    deserialize(&tree->schema, entry + sizeof(int), &record);
+
+    const int applied = op == LOG_INSERT ? bplus_record_insert(tree->file_desc, tree->metadata, &record)
+                                         : bplus_record_delete_by_key(tree->file_desc, tree->metadata, &record);
+    if (applied == -1) {
+      result = -1;
+      break;
+    }
+  }
+  if (bplus_insert_buffer_flush(tree->file_desc) == -1) {
+    result = -1;
+  }
+
+  // οσες γραφτηκαν φευγουν απο το log, οι υπολοιπες μενουν για την επομενη φορα
+  memmove(tree->log, tree->log + (long)done * entry_size, (long)(tree->log_count - done) * entry_size);
+  tree->log_count -= done;
+  return result == -1 ? -1 : done;
+}
+
+int bplus_memtree_close(BPlusMemTree *tree)
+{
+  const int result = bplus_memtree_checkpoint(tree) == -1 ? -1 : 0;
+  free_children(tree, tree->root, 0);
+  free(tree->root);
+  free(tree->log);
+  free(tree);
+  return result;
+}
+
+int bplus_memtree_insert(BPlusMemTree *tree, const Record *record)
+{
+  if (reserve_log(tree) == -1 || insert(tree, record) == -1) {
+    return -1;
+  }
+  const RecordSerializer serialize = record_serializer(&tree->schema);
+  serialize(&tree->schema, record, append_log(tree, LOG_INSERT));
+  after_change(tree);
+  return 0;
+}
+
+static int find(const BPlusMemTree *tree, const unsigned char *key, Record *out_record)
+{
+  char *leaf = find_leaf(tree, key);
+  int found;
+  const int pos = datanode_search(leaf, &tree->schema, LEAF_CAPACITY, key, &found);
+  if (!found) {
+    return -1;
+  }
+  record_deserialize(&tree->schema, datanode_record(leaf, &tree->schema, LEAF_CAPACITY, pos), out_record);
+  return 0;
+}
+
+int bplus_memtree_find(const BPlusMemTree *tree, const int key, Record *out_record)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+  if (bplus_key_from_int(&tree->schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_memtree_find_by_key\n");
+    return -1;
+  }
+  return find(tree, normalized, out_record);
+}
+
+int bplus_memtree_find_by_key(const BPlusMemTree *tree, const Record *key_record, Record *out_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&tree->schema, key_record, key);
+  return find(tree, key, out_record);
+}
+
+// Διαγραφη χωρις αναδιοργανωση: το φυλλο απλα μικραινει
+static int delete_key(BPlusMemTree *tree, const unsigned char *key)
+{
+  char *leaf = find_leaf(tree, key);
+  int found;
+  const int pos = datanode_search(leaf, &tree->schema, LEAF_CAPACITY, key, &found);
+  if (!found || reserve_log(tree) == -1) {
+    return -1;
+  }
+
+  memcpy(append_log(tree, LOG_DELETE), datanode_record(leaf, &tree->schema, LEAF_CAPACITY, pos),
+         tree->schema.record_size);
+  datanode_remove_at(leaf, &tree->schema, LEAF_CAPACITY, pos);
+  tree->record_count--;
+  after_change(tree);
+  return 0;
+}
+
+int bplus_memtree_delete(BPlusMemTree *tree, const int key)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+  if (bplus_key_from_int(&tree->schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_memtree_delete_by_key\n");
+    return -1;
+  }
+  return delete_key(tree, normalized);
+}
+
+int bplus_memtree_delete_by_key(BPlusMemTree *tree, const Record *key_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&tree->schema, key_record, key);
+  return delete_key(tree, key);
+}
@@ -0,0 +1,211 @@
+// Αντίγραφα των πάνω επιπέδων του ευρετηρίου στη μνήμη, με δείκτες από κάθε
+// κόμβο κατευθείαν στα αντίγραφα των παιδιών του.
+
+#include "bplus_node_cache.h"
+#include "bplus_index_node.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static BPlusNodeCache *registry[BF_MAX_OPEN_FILES];
+
+static int slot_of(const BPlusNodeCache *cache, const int block_id)
+{
+  return (int)(((uint32_t)block_id * 2654435761u) & (uint32_t)cache->table_mask);
+}
+
+static BPlusCachedNode *lookup(const BPlusNodeCache *cache, const int block_id)
+{
+  int slot = slot_of(cache, block_id);
+  while (cache->table[slot] != NULL) {
+    if (cache->table[slot]->block_id == block_id) {
+      return cache->table[slot];
+    }
+    slot = (slot + 1) & cache->table_mask;
+  }
+  return NULL;
+}
+
+static void clear(BPlusNodeCache *cache)
+{
+  for (int i = 0; i < cache->node_count; i++) {
+    free(cache->nodes[i]);
+  }
+  cache->node_count = 0;
+  cache->levels = 0;
+  cache->misses = 0;
+  memset(cache->table, 0, (cache->table_mask + 1) * sizeof(BPlusCachedNode *));
+}
+
+// διαβαζει ενα block στο επομενο αντιγραφο και το βαζει στον πινακα
+static BPlusCachedNode *add_node(const int file_desc, BPlusNodeCache *cache, const int block_id,
+                                 const int index_capacity)
+{
+  BPlusCachedNode *node = calloc(1, sizeof(BPlusCachedNode) + (index_capacity + 1) * sizeof(BPlusCachedNode *));
+  if (node == NULL) {
+    return NULL;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  if (BF_GetBlock(file_desc, block_id, block) != BF_OK) {
+    BF_Block_Destroy(&block);
+    free(node);
+    return NULL;
+  }
+  memcpy(node->data, BF_Block_GetData(block), BF_BLOCK_SIZE);
+  BF_UnpinBlock(block);
+  BF_Block_Destroy(&block);
+
+  node->block_id = block_id;
+  cache->nodes[cache->node_count++] = node;
+  int slot = slot_of(cache, block_id);
+  while (cache->table[slot] != NULL) {
+    slot = (slot + 1) & cache->table_mask;
+  }
+  cache->table[slot] = node;
+  return node;
+}
+
+// Χτιζει την cache επιπεδο προς επιπεδο, οσο χωραει ολοκληρο το επομενο επιπεδο.
+// Τα φυλλα δεν μπαινουν ποτε.
+static int build(const int file_desc, const BPlusMeta *metadata, BPlusNodeCache *cache)
+{
+  const int capacity = metadata->index_capacity;
+  clear(cache);
+  cache->root_block_num = metadata->root_block_num;
+  cache->depth = metadata->depth;
+  cache->index_capacity = capacity;
+  cache->rebuilds++;
+
+  if (metadata->depth < 2) {
+    return 0;
+  }
+  if (add_node(file_desc, cache, metadata->root_block_num, capacity) == NULL) {
+    clear(cache);
+    return -1;
+  }
+  cache->levels = 1;
+
+  int begin = 0;
+  while (cache->levels < metadata->depth - 1) {
+    const int end = cache->node_count;
+    int next = 0;
+    for (int i = begin; i < end; i++) {
+      next += ((BPlusIndexNode *)cache->nodes[i]->data)->key_count + 1;
+    }
+    if (end + next > BPLUS_NODE_CACHE_MAX_NODES) {
+      break;
+    }
+
+    for (int i = begin; i < end; i++) {
+      BPlusCachedNode *parent = cache->nodes[i];
+      const int *children = indexnode_children(parent->data, capacity);
+      for (int c = 0; c <= ((BPlusIndexNode *)parent->data)->key_count; c++) {
+        parent->children[c] = add_node(file_desc, cache, children[c], capacity);
+        if (parent->children[c] == NULL) {
+          clear(cache);
+          return -1;
+        }
+      }
+    }
+    begin = end;
+    cache->levels++;
+  }
+  return 0;
+}
+
+BPlusCachedNode *node_cache_root(const int file_desc, const BPlusMeta *metadata)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES || metadata->depth < 2) {
+    return NULL;
+  }
+
+  BPlusNodeCache *cache = registry[file_desc];
+  if (cache == NULL) {
+    cache = calloc(1, sizeof(BPlusNodeCache));
+    if (cache == NULL) {
+      return NULL;
+    }
+    int table_size = 1;
+    while (table_size < 2 * BPLUS_NODE_CACHE_MAX_NODES) {
+      table_size *= 2;
+    }
+    cache->nodes = malloc(BPLUS_NODE_CACHE_MAX_NODES * sizeof(BPlusCachedNode *));
+    cache->table = calloc(table_size, sizeof(BPlusCachedNode *));
+    if (cache->nodes == NULL || cache->table == NULL) {
+      free(cache->nodes);
+      free(cache->table);
+      free(cache);
+      return NULL;
+    }
+    cache->table_mask = table_size - 1;
+    cache->root_block_num = -1;
+    registry[file_desc] = cache;
+  }
+
+  // νεα ριζα ή νεο βαθος, ή αρκετες αστοχιες για να αξιζει το ξαναχτισιμο
+  if (cache->node_count == 0 || cache->root_block_num != metadata->root_block_num ||
+      cache->depth != metadata->depth || cache->misses > cache->node_count) {
+    if (build(file_desc, metadata, cache) == -1) {
+      return NULL;
+    }
+  }
+  return cache->node_count > 0 ? cache->nodes[0] : NULL;
+}
+
+BPlusNodeCache *node_cache_of(const int file_desc)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES) {
+    return NULL;
+  }
+  return registry[file_desc];
+}
+
+void node_cache_update(const int file_desc, const int *block_ids, const char (*images)[BF_BLOCK_SIZE],
+                       const int count)
+{
+  BPlusNodeCache *cache = node_cache_of(file_desc);
+  if (cache == NULL || cache->node_count == 0) {
+    return;
+  }
+
+  // πρωτα τα περιεχομενα, ωστε οι δεικτες να βλεπουν μονο κομβους που ειναι ακομα ευρετηριο
+  for (int i = 0; i < count; i++) {
+    BPlusCachedNode *node = lookup(cache, block_ids[i]);
+    if (node == NULL) {
+      continue;
+    }
+    if (((const BPlusIndexNode *)images[i])->is_leaf != 0) {
+      node->block_id = -1; // ελευθερωθηκε, μενει στον πινακα μονο ως ενδιαμεση θεση
+      continue;
+    }
+    memcpy(node->data, images[i], BF_BLOCK_SIZE);
+  }
+
+  // τα παιδια ενος κομβου που αλλαξε μπορει να μετακινηθηκαν
+  for (int i = 0; i < count; i++) {
+    BPlusCachedNode *node = lookup(cache, block_ids[i]);
+    if (node == NULL) {
+      continue;
+    }
+    const int *children = indexnode_children(node->data, cache->index_capacity);
+    const int key_count = ((BPlusIndexNode *)node->data)->key_count;
+    for (int c = 0; c <= cache->index_capacity; c++) {
+      node->children[c] = c <= key_count ? lookup(cache, children[c]) : NULL;
+    }
+  }
+}
+
+void node_cache_destroy(const int file_desc)
+{
+  BPlusNodeCache *cache = node_cache_of(file_desc);
+  if (cache == NULL) {
+    return;
+  }
+  registry[file_desc] = NULL;
+  clear(cache);
+  free(cache->nodes);
+  free(cache->table);
+  free(cache);
+}
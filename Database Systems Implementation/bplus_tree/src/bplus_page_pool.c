@@ -0,0 +1,308 @@
+// Page pool πάνω από το BF: αντίγραφα σελίδων σε frames που ζουν σε extents των
+// 2 MiB (huge pages όταν γίνεται), με μέγεθος που αλλάζει ενώ τρέχουμε.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "bplus_page_pool.h"
+#include "wal.h"
+
+#define EXTENT_FRAMES (BPLUS_POOL_EXTENT / BF_BLOCK_SIZE)
+#define NO_FRAME -1
+
+typedef struct {
+  int file_desc;        // -1 για ελευθερο frame
+  int block_id;
+  int next;             // επομενο στην αλυσιδα του bucket, ή στη λιστα ελευθερων
+  unsigned char referenced;
+} PoolFrame;
+
+typedef struct {
+  char *data;
+  int huge;             // 1 αν ειναι απο τις δεσμευμενες huge pages
+} PoolExtent;
+
+static struct {
+  PoolExtent *extents;
+  int extent_count;
+  PoolFrame *frames;    // extent_count * EXTENT_FRAMES
+  int *buckets;         // αλυσιδες στο (file_desc, block_id)
+  int bucket_mask;
+  int free_head;
+  int hand;             // δεικτης του clock
+  long hits;
+  long misses;
+  unsigned char attached[BF_MAX_OPEN_FILES];
+} pool = {.free_head = NO_FRAME};
+
+static int frame_count(void)
+{
+  return pool.extent_count * EXTENT_FRAMES;
+}
+
+static char *frame_data(const int f)
+{
+  return pool.extents[f / EXTENT_FRAMES].data + (size_t)(f % EXTENT_FRAMES) * BF_BLOCK_SIZE;
+}
+
+static int bucket_of(const int file_desc, const int block_id)
+{
+  return (int)((((uint32_t)block_id * 2654435761u) ^ (uint32_t)file_desc) & (uint32_t)pool.bucket_mask);
+}
+
+static int lookup(const int file_desc, const int block_id)
+{
+  if (pool.buckets == NULL) {
+    return NO_FRAME;
+  }
+  int f = pool.buckets[bucket_of(file_desc, block_id)];
+  while (f != NO_FRAME && (pool.frames[f].block_id != block_id || pool.frames[f].file_desc != file_desc)) {
+    f = pool.frames[f].next;
+  }
+  return f;
+}
+
+static void unlink_frame(const int f)
+{
+  int *link = &pool.buckets[bucket_of(pool.frames[f].file_desc, pool.frames[f].block_id)];
+  while (*link != f) {
+    link = &pool.frames[*link].next;
+  }
+  *link = pool.frames[f].next;
+  pool.frames[f].file_desc = -1;
+}
+
+// Ενα extent των 2 MiB: πρωτα απο τις δεσμευμενες huge pages, αλλιως απλη μνημη
+// ευθυγραμμισμενη στα 2 MiB ωστε να μπορει να γινει transparent huge page
+static int map_extent(PoolExtent *extent)
+{
+  void *data = mmap(NULL, BPLUS_POOL_EXTENT, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1,
+                    0);
+  if (data != MAP_FAILED) {
+    extent->data = data;
+    extent->huge = 1;
+    return 0;
+  }
+
+  char *raw = mmap(NULL, 2 * BPLUS_POOL_EXTENT, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    perror("page pool");
+    return -1;
+  }
+  char *aligned = (char *)(((uintptr_t)raw + BPLUS_POOL_EXTENT - 1) & ~((uintptr_t)BPLUS_POOL_EXTENT - 1));
+  if (aligned > raw) {
+    munmap(raw, aligned - raw);
+  }
+  munmap(aligned + BPLUS_POOL_EXTENT, raw + BPLUS_POOL_EXTENT - aligned);
+#ifdef MADV_HUGEPAGE
+  madvise(aligned, BPLUS_POOL_EXTENT, MADV_HUGEPAGE);
+#endif
+  extent->data = aligned;
+  extent->huge = 0;
+  return 0;
+}
+
+// ο πινακας κατακερματισμου ξαναχτιζεται με αλλο πληθος frames
+static int rehash(void)
+{
+  const int frames = frame_count();
+  int size = 1;
+  while (size < frames) {
+    size <<= 1;
+  }
+  int *buckets = malloc(size * sizeof(int));
+  if (buckets == NULL) {
+    return -1;
+  }
+  free(pool.buckets);
+  pool.buckets = buckets;
+  pool.bucket_mask = size - 1;
+  for (int b = 0; b < size; b++) {
+    buckets[b] = NO_FRAME;
+  }
+
+  pool.free_head = NO_FRAME;
+  for (int f = frames - 1; f >= 0; f--) {
+    PoolFrame *frame = &pool.frames[f];
+    if (frame->file_desc == -1) {
+      frame->next = pool.free_head;
+      pool.free_head = f;
+    } else {
+      const int b = bucket_of(frame->file_desc, frame->block_id);
+      frame->next = buckets[b];
+      buckets[b] = f;
+    }
+  }
+  return 0;
+}
+
+static int grow(const int extent_count)
+{
+  PoolExtent *extents = realloc(pool.extents, extent_count * sizeof(PoolExtent));
+  if (extents == NULL) {
+    return -1;
+  }
+  pool.extents = extents;
+  PoolFrame *frames = realloc(pool.frames, (size_t)extent_count * EXTENT_FRAMES * sizeof(PoolFrame));
+  if (frames == NULL) {
+    return -1;
+  }
+  pool.frames = frames;
+
+  int result = 0;
+  while (pool.extent_count < extent_count) {
+    if (map_extent(&pool.extents[pool.extent_count]) == -1) {
+      result = -1;
+      break;
+    }
+    for (int i = 0; i < EXTENT_FRAMES; i++) {
+      pool.frames[pool.extent_count * EXTENT_FRAMES + i].file_desc = -1;
+    }
+    pool.extent_count++;
+  }
+  return rehash() == -1 ? -1 : result;
+}
+
+static void shrink(const int extent_count)
+{
+  while (pool.extent_count > extent_count) {
+    PoolExtent *extent = &pool.extents[--pool.extent_count];
+    munmap(extent->data, BPLUS_POOL_EXTENT);
+  }
+  // τα frames που εμειναν κρατανε τις σελιδες τους, ο πινακας ξαναχτιζεται χωρις τα αλλα
+  if (pool.extent_count == 0) {
+    free(pool.buckets);
+    pool.buckets = NULL;
+    pool.free_head = NO_FRAME;
+  } else {
+    rehash();
+  }
+  if (pool.hand >= frame_count()) {
+    pool.hand = 0;
+  }
+}
+
+int bplus_pool_resize(const size_t bytes)
+{
+  const int extent_count = (int)((bytes + BPLUS_POOL_EXTENT - 1) / BPLUS_POOL_EXTENT);
+  if (extent_count > pool.extent_count) {
+    return grow(extent_count);
+  }
+  shrink(extent_count);
+  return 0;
+}
+
+int bplus_pool_init(const size_t bytes)
+{
+  bplus_pool_close();
+  return bplus_pool_resize(bytes);
+}
+
+void bplus_pool_close(void)
+{
+  shrink(0);
+  free(pool.extents);
+  free(pool.frames);
+  pool.extents = NULL;
+  pool.frames = NULL;
+  pool.hits = 0;
+  pool.misses = 0;
+}
+
+void bplus_pool_stats(BPlusPoolStats *stats)
+{
+  stats->bytes = (size_t)pool.extent_count * BPLUS_POOL_EXTENT;
+  stats->frames = frame_count();
+  stats->huge_extents = 0;
+  for (int e = 0; e < pool.extent_count; e++) {
+    stats->huge_extents += pool.extents[e].huge;
+  }
+  stats->hits = pool.hits;
+  stats->misses = pool.misses;
+}
+
+// ελευθερο frame, ή το πρωτο που βρισκει το clock χωρις referenced bit
+static int victim(void)
+{
+  if (pool.free_head != NO_FRAME) {
+    const int f = pool.free_head;
+    pool.free_head = pool.frames[f].next;
+    return f;
+  }
+  for (;;) {
+    const int f = pool.hand;
+    pool.hand = pool.hand + 1 < frame_count() ? pool.hand + 1 : 0;
+    if (!pool.frames[f].referenced) {
+      unlink_frame(f);
+      return f;
+    }
+    pool.frames[f].referenced = 0;
+  }
+}
+
+const char *page_pool_read(const int file_desc, const int block_id)
+{
+  if (pool.extent_count == 0 || !pool.attached[file_desc] || wal_current(wal_of(file_desc)) != NULL) {
+    return NULL;
+  }
+  int f = lookup(file_desc, block_id);
+  if (f != NO_FRAME) {
+    pool.frames[f].referenced = 1;
+    pool.hits++;
+    return frame_data(f);
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+  if (BF_GetBlock(file_desc, block_id, block) != BF_OK) {
+    BF_Block_Destroy(&block);
+    return NULL;
+  }
+  f = victim();
+  memcpy(frame_data(f), BF_Block_GetData(block), BF_BLOCK_SIZE);
+  BF_UnpinBlock(block);
+  BF_Block_Destroy(&block);
+
+  PoolFrame *frame = &pool.frames[f];
+  const int b = bucket_of(file_desc, block_id);
+  frame->file_desc = file_desc;
+  frame->block_id = block_id;
+  frame->referenced = 1;
+  frame->next = pool.buckets[b];
+  pool.buckets[b] = f;
+  pool.misses++;
+  return frame_data(f);
+}
+
+void page_pool_update(const int file_desc, const int *block_ids, const char (*images)[BF_BLOCK_SIZE], const int count)
+{
+  if (pool.extent_count == 0 || !pool.attached[file_desc]) {
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    const int f = lookup(file_desc, block_ids[i]);
+    if (f != NO_FRAME) {
+      memcpy(frame_data(f), images[i], BF_BLOCK_SIZE);
+    }
+  }
+}
+
+void page_pool_attach(const int file_desc)
+{
+  pool.attached[file_desc] = 1;
+}
+
+void page_pool_detach(const int file_desc)
+{
+  pool.attached[file_desc] = 0;
+  for (int f = 0; f < frame_count(); f++) {
+    if (pool.frames[f].file_desc == file_desc) {
+      unlink_frame(f);
+      pool.frames[f].next = pool.free_head;
+      pool.free_head = f;
+    }
+  }
+}
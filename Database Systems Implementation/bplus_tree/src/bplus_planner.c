@@ -0,0 +1,292 @@
+// Επιλογή τρόπου πρόσβασης για ένα κατηγόρημα (full scan, index scan, bitmap scan)
+// με κόστος σε αναγνώσεις σελίδων, από τα στατιστικά του bplus_analyze.
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bplus_file_funcs.h"
+#include "bplus_planner.h"
+#include "bplus_secondary.h"
+
+#define BITMAP_CHUNK 256  // θεσεις ανα κληση του bplus_record_find_many
+
+// base^exp για ακεραιο εκθετη (χωρις libm)
+static double power(double base, long exp)
+{
+  double result = 1;
+  while (exp > 0) {
+    if (exp & 1) {
+      result *= base;
+    }
+    base *= base;
+    exp >>= 1;
+  }
+  return result;
+}
+
+static int primary_key_column(const TableSchema *schema)
+{
+  if (schema->key_attr_count != 1 || schema->attributes[schema->key_index].type != TYPE_INT) {
+    return -1;
+  }
+  return schema->key_index;
+}
+
+// η στηλη του πινακα που ευρετηριαζει ενα secondary index (το πρωτο του πεδιο)
+static int secondary_column(const BPlusAccessPaths *paths, const int secondary)
+{
+  const BPlusMeta *index = paths->secondaries[secondary].metadata;
+  return schema_attribute_index(&paths->metadata->table_schema, index->table_schema.attributes[0].name);
+}
+
+// Cardenas: σελιδες που αγγιζουν m τυχαιες γραμμες σε L σελιδες
+static double pages_touched(const double pages, const double matches)
+{
+  if (pages <= 1) {
+    return pages;
+  }
+  return pages * (1 - power(1 - 1 / pages, (long)(matches + 0.5)));
+}
+
+int bplus_plan(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, BPlusPlan *plan)
+{
+  const TableSchema *schema = &paths->metadata->table_schema;
+  if (predicate->column < 0 || predicate->column >= schema->count) {
+    fprintf(stderr, "Error: predicate column %d out of range\n", predicate->column);
+    return -1;
+  }
+  const BPlusTableStats *stats = paths->stats;
+  const double rows = (double)stats->row_count;
+  const double leaves = stats->page_count > 0 ? stats->page_count : 1;
+  const double selectivity = bplus_stats_selectivity(stats, predicate->column, predicate->compare, &predicate->value);
+  const double matches = selectivity * rows;
+
+  memset(plan, 0, sizeof(*plan));
+  plan->kind = BPLUS_PLAN_FULL_SCAN;
+  plan->secondary = -1;
+  plan->estimated_rows = matches;
+  plan->full_scan_cost = leaves * BPLUS_COST_SEQ_PAGE + rows * BPLUS_COST_CPU_ROW;
+  plan->index_cost = -1;
+  plan->bitmap_cost = -1;
+  int index_secondary = -1;
+  int bitmap_secondary = -1;
+
+  // primary key: μια καθοδος και μετα τα φυλλα του διαστηματος στη σειρα
+  if (predicate->column == primary_key_column(schema) && predicate->compare != EXEC_NE) {
+    plan->index_cost = paths->metadata->depth * BPLUS_COST_RANDOM_PAGE + selectivity * leaves * BPLUS_COST_SEQ_PAGE +
+                       matches * BPLUS_COST_CPU_ROW;
+  }
+
+  if (predicate->compare == EXEC_EQ) {
+    for (int s = 0; s < paths->secondary_count; s++) {
+      if (secondary_column(paths, s) != predicate->column) {
+        continue;
+      }
+      const double lookup = paths->secondaries[s].metadata->depth * BPLUS_COST_RANDOM_PAGE;
+
+      // καθε θεση μια αναζητηση στο primary, σε τυχαια σελιδα
+      const double index = lookup + matches * (BPLUS_COST_RANDOM_PAGE + BPLUS_COST_CPU_ROW);
+      if (plan->index_cost < 0 || index < plan->index_cost) {
+        plan->index_cost = index;
+        index_secondary = s;
+      }
+
+      // ταξινομημενες θεσεις: καθε σελιδα μια φορα, πιο φθηνα οσο πλησιαζουν στο full scan
+      const double pages = pages_touched(leaves, matches);
+      const double per_page = BPLUS_COST_RANDOM_PAGE - (BPLUS_COST_RANDOM_PAGE - BPLUS_COST_SEQ_PAGE) * (pages / leaves);
+      const double bitmap = lookup + pages * per_page + matches * BPLUS_COST_CPU_BITMAP;
+      if (plan->bitmap_cost < 0 || bitmap < plan->bitmap_cost) {
+        plan->bitmap_cost = bitmap;
+        bitmap_secondary = s;
+      }
+    }
+  }
+
+  plan->cost = plan->full_scan_cost;
+  if (plan->index_cost >= 0 && plan->index_cost < plan->cost) {
+    plan->kind = BPLUS_PLAN_INDEX_SCAN;
+    plan->secondary = index_secondary;
+    plan->cost = plan->index_cost;
+  }
+  if (plan->bitmap_cost >= 0 && plan->bitmap_cost < plan->cost) {
+    plan->kind = BPLUS_PLAN_BITMAP_SCAN;
+    plan->secondary = bitmap_secondary;
+    plan->cost = plan->bitmap_cost;
+  }
+  return 0;
+}
+
+static int compare_values(const AttributeSchema *attr, const FieldValue *a, const FieldValue *b)
+{
+  switch (attr->type) {
+    case TYPE_INT: return (a->int_value > b->int_value) - (a->int_value < b->int_value);
+    case TYPE_FLOAT: return (a->float_value > b->float_value) - (a->float_value < b->float_value);
+    default: return strncmp(a->string_value, b->string_value, attr->length);
+  }
+}
+
+static int record_matches(const TableSchema *schema, const BPlusPredicate *predicate, const Record *record)
+{
+  const int c = compare_values(&schema->attributes[predicate->column], &record->values[predicate->column],
+                               &predicate->value);
+  switch (predicate->compare) {
+    case EXEC_EQ: return c == 0;
+    case EXEC_NE: return c != 0;
+    case EXEC_LT: return c < 0;
+    case EXEC_LE: return c <= 0;
+    case EXEC_GT: return c > 0;
+    default: return c >= 0;
+  }
+}
+
+typedef struct {
+  const TableSchema *schema;
+  const BPlusPredicate *predicate;
+  int (*visit)(const Record *record, void *ctx);
+  void *ctx;
+  int visited;
+  int stopped;
+} PlanScan;
+
+static int visit_matching(const Record *record, void *ctx)
+{
+  PlanScan *scan = ctx;
+  if (!record_matches(scan->schema, scan->predicate, record)) {
+    return 0;
+  }
+  scan->visited++;
+  scan->stopped = scan->visit(record, scan->ctx) != 0;
+  return scan->stopped;
+}
+
+// το διαστημα κλειδιων [lo, hi] ενος κατηγορηματος στο INT primary key, 0 αν ειναι αδειο
+static int key_range(const BPlusPredicate *predicate, int *lo, int *hi)
+{
+  const int v = predicate->value.int_value;
+  *lo = INT_MIN;
+  *hi = INT_MAX;
+  switch (predicate->compare) {
+    case EXEC_EQ:
+      *lo = v;
+      *hi = v;
+      return 1;
+    case EXEC_LT:
+      if (v == INT_MIN) {
+        return 0;
+      }
+      *hi = v - 1;
+      return 1;
+    case EXEC_LE:
+      *hi = v;
+      return 1;
+    case EXEC_GT:
+      if (v == INT_MAX) {
+        return 0;
+      }
+      *lo = v + 1;
+      return 1;
+    case EXEC_GE:
+      *lo = v;
+      return 1;
+    default:
+      return 1;
+  }
+}
+
+static int secondary_scan(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, const int secondary,
+                          PlanScan *scan)
+{
+  const BPlusSecondaryPath *index = &paths->secondaries[secondary];
+  int *locations;
+  const int n = bplus_secondary_find(index->file_desc, index->metadata, &predicate->value, &locations);
+  if (n <= 0) {
+    return n;
+  }
+  for (int i = 0; i < n && !scan->stopped; i++) {
+    Record *record;
+    if (bplus_record_find(paths->file_desc, paths->metadata, locations[i], &record) == -1) {
+      continue;  // θεση χωρις εγγραφη στο primary
+    }
+    visit_matching(record, scan);
+    free(record);
+  }
+  free(locations);
+  return 0;
+}
+
+static int bitmap_scan(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, const int secondary,
+                       PlanScan *scan)
+{
+  const BPlusSecondaryPath *index = &paths->secondaries[secondary];
+  int *locations;
+  const int n = bplus_secondary_find(index->file_desc, index->metadata, &predicate->value, &locations);
+  if (n <= 0) {
+    return n;
+  }
+  Record *records = malloc(BITMAP_CHUNK * sizeof(Record));
+  int *found = malloc(BITMAP_CHUNK * sizeof(int));
+  int result = records != NULL && found != NULL ? 0 : -1;
+
+  // οι θεσεις ειναι ηδη ταξινομημενες, αρα καθε κομματι διαβαζει διαδοχικα φυλλα
+  for (int start = 0; start < n && result == 0 && !scan->stopped; start += BITMAP_CHUNK) {
+    const int count = n - start < BITMAP_CHUNK ? n - start : BITMAP_CHUNK;
+    if (bplus_record_find_many(paths->file_desc, paths->metadata, locations + start, count, records, found) == -1) {
+      result = -1;
+      break;
+    }
+    for (int i = 0; i < count && !scan->stopped; i++) {
+      if (found[i]) {
+        visit_matching(&records[i], scan);
+      }
+    }
+  }
+  free(found);
+  free(records);
+  free(locations);
+  return result;
+}
+
+int bplus_plan_execute(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, const BPlusPlan *plan,
+                       int (*visit)(const Record *record, void *ctx), void *ctx)
+{
+  PlanScan scan = {&paths->metadata->table_schema, predicate, visit, ctx, 0, 0};
+  int result;
+  if (plan->kind == BPLUS_PLAN_FULL_SCAN || (plan->kind == BPLUS_PLAN_INDEX_SCAN && plan->secondary == -1)) {
+    int lo = INT_MIN;
+    int hi = INT_MAX;
+    if (plan->kind == BPLUS_PLAN_INDEX_SCAN) {
+      if (!key_range(predicate, &lo, &hi)) {
+        return 0;
+      }
+    }
+    result = bplus_range_scan(paths->file_desc, paths->metadata, lo, hi, visit_matching, &scan);
+  } else if (plan->kind == BPLUS_PLAN_INDEX_SCAN) {
+    result = secondary_scan(paths, predicate, plan->secondary, &scan);
+  } else {
+    result = bitmap_scan(paths, predicate, plan->secondary, &scan);
+  }
+  return result == -1 ? -1 : scan.visited;
+}
+
+void bplus_plan_print(const BPlusPlan *plan)
+{
+  static const char *names[] = {"full scan", "index scan", "bitmap scan"};
+  printf("Plan: %s", names[plan->kind]);
+  if (plan->kind != BPLUS_PLAN_FULL_SCAN) {
+    if (plan->secondary == -1) {
+      printf(" on the primary key");
+    } else {
+      printf(" on secondary index %d", plan->secondary);
+    }
+  }
+  printf(", %.0f rows, cost %.1f (full %.1f", plan->estimated_rows, plan->cost, plan->full_scan_cost);
+  if (plan->index_cost >= 0) {
+    printf(", index %.1f", plan->index_cost);
+  }
+  if (plan->bitmap_cost >= 0) {
+    printf(", bitmap %.1f", plan->bitmap_cost);
+  }
+  printf(")\n");
+}
@@ -0,0 +1,73 @@
+#include "bplus_search.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// κάτω από τόσα κλειδιά σταματάμε τη δυαδική αναζήτηση και απλά μετράμε
+#define LINEAR_WINDOW 16
+
+// πόσα κλειδιά ειναι < key (χωρις branches στο loop)
+static inline int count_less(const int *keys, const int n, const int key)
+{
+  int count = 0;
+  int i = 0;
+#ifdef __AVX2__
+  const __m256i needle = _mm256_set1_epi32(key);
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(keys + i));
+    __m256i lt = _mm256_cmpgt_epi32(needle, v);
+    count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+  }
+#endif
+  for (; i < n; i++) {
+    count += keys[i] < key;
+  }
+  return count;
+}
+
+// πόσα κλειδιά ειναι <= key
+static inline int count_less_equal(const int *keys, const int n, const int key)
+{
+  int count = 0;
+  int i = 0;
+#ifdef __AVX2__
+  const __m256i needle = _mm256_set1_epi32(key);
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(keys + i));
+    __m256i gt = _mm256_cmpgt_epi32(v, needle);
+    count += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+  }
+#endif
+  for (; i < n; i++) {
+    count += keys[i] <= key;
+  }
+  return count;
+}
+
+int bplus_rank_lower(const int *keys, int n, const int key)
+{
+  const int *base = keys;
+
+  // δυαδικη αναζητηση με conditional move αντι για branch
+  while (n > LINEAR_WINDOW) {
+    const int half = n / 2;
+    base = (base[half - 1] < key) ? base + half : base;
+    n -= half;
+  }
+
+  return (int)(base - keys) + count_less(base, n, key);
+}
+
+int bplus_rank_upper(const int *keys, int n, const int key)
+{
+  const int *base = keys;
+
+  while (n > LINEAR_WINDOW) {
+    const int half = n / 2;
+    base = (base[half - 1] <= key) ? base + half : base;
+    n -= half;
+  }
+
+  return (int)(base - keys) + count_less_equal(base, n, key);
+}
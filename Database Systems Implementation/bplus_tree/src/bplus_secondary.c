@@ -0,0 +1,656 @@
+// Δευτερεύοντα ευρετήρια: κάθε τιμή ενός πεδίου δείχνει σε posting list με
+// τις θέσεις των εγγραφών που την έχουν.
+//
+// Ο κατάλογος είναι κανονικό B+ δέντρο με εγγραφές {value, count, postings,
+// first, second}. Οι μικρές λίστες μένουν μέσα στην εγγραφή, οι μεγαλύτερες
+// σε αλυσίδα σελίδων υπερχείλισης στο ίδιο αρχείο.
+
+#include "bplus_secondary.h"
+#include "bplus_file_funcs.h"
+#include "bplus_block.h"
+#include "bplus_bulk_load.h"
+#include "bplus_search.h"
+#include "bplus_key.h"
+#include "bf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+// πεδια της εγγραφης του καταλογου
+#define ENTRY_VALUE 0
+#define ENTRY_COUNT 1
+#define ENTRY_POSTINGS 2
+#define ENTRY_FIRST 3
+
+// bytes για θεσεις σε μια σελιδα, και το πολυ ποσες θεσεις χωρανε (1 byte η καθε μια)
+#define PAGE_BYTES ((int)(BF_BLOCK_SIZE - sizeof(BPlusPostingPage)))
+#define PAGE_MAX_VALUES PAGE_BYTES
+
+// ενα varint θελει το πολυ 5 bytes για 32 bits
+#define VARINT_MAX 5
+
+int bplus_secondary_create(const TableSchema *table_schema, const char *attr_name, const char *fileName)
+{
+  int attr = -1;
+  for (int i = 0; i < table_schema->count; i++) {
+    if (strcmp(table_schema->attributes[i].name, attr_name) == 0) {
+      attr = i;
+    }
+  }
+  if (attr == -1) {
+    fprintf(stderr, "Error: attribute '%s' not found in schema\n", attr_name);
+    return -1;
+  }
+
+  AttributeSchema attrs[ENTRY_FIRST + BPLUS_POSTING_INLINE] = {
+    table_schema->attributes[attr],
+    {"count", TYPE_INT, 0},
+    {"postings", TYPE_INT, 0},
+    {"first", TYPE_INT, 0},
+    {"second", TYPE_INT, 0}
+  };
+
+  TableSchema schema;
+  schema_init(&schema, attrs, ENTRY_FIRST + BPLUS_POSTING_INLINE, attr_name);
+  return bplus_create_file(&schema, fileName);
+}
+
+static unsigned char *page_bytes(char *data)
+{
+  return (unsigned char *)data + sizeof(BPlusPostingPage);
+}
+
+// Κωδικοποιεί ταξινομημένες θέσεις: η πρώτη ολόκληρη, οι επόμενες ως διαφορά
+// από την προηγούμενη, όλες ως varint (7 bits ανά byte). Επιστρέφει τα bytes.
+static int encode(const int *values, const int count, unsigned char *out)
+{
+  int used = 0;
+  for (int i = 0; i < count; i++) {
+    unsigned int delta = i == 0 ? (unsigned int)values[0] : (unsigned int)(values[i] - values[i - 1]);
+    do {
+      const unsigned char low = delta & 0x7f;
+      delta >>= 7;
+      out[used++] = delta ? (low | 0x80) : low;
+    } while (delta);
+  }
+  return used;
+}
+
+static void decode(const unsigned char *in, const int count, int *values)
+{
+  int pos = 0;
+  unsigned int previous = 0;
+  for (int i = 0; i < count; i++) {
+    unsigned int delta = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+      byte = in[pos++];
+      delta |= (unsigned int)(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    previous = i == 0 ? delta : previous + delta;
+    values[i] = (int)previous;
+  }
+}
+
+// Γράφει τις θέσεις στη σελίδα, -1 αν δεν χωράνε (ο πίνακας δεν αλλάζει τότε)
+static int write_page(char *data, const int *values, const int count)
+{
+  BPlusPostingPage *page = (BPlusPostingPage *)data;
+  unsigned char buffer[(PAGE_MAX_VALUES + 1) * VARINT_MAX];
+  const int used = encode(values, count, buffer);
+  if (used > PAGE_BYTES) {
+    return -1;
+  }
+
+  memcpy(page_bytes(data), buffer, used);
+  page->count = count;
+  page->bytes_used = used;
+  page->last_value = count > 0 ? values[count - 1] : -1;
+  return 0;
+}
+
+// βαζει το location στη θεση του, επιστρεφει το νεο πληθος ή -1 αν υπαρχει ηδη
+static int sorted_insert(int *values, const int count, const int location)
+{
+  const int pos = bplus_rank_lower(values, count, location);
+  if (pos < count && values[pos] == location) {
+    return -1;
+  }
+  memmove(&values[pos + 1], &values[pos], (count - pos) * sizeof(int));
+  values[pos] = location;
+  return count + 1;
+}
+
+// βγαζει το location, επιστρεφει το νεο πληθος ή -1 αν δεν υπαρχει
+static int sorted_remove(int *values, const int count, const int location)
+{
+  const int pos = bplus_rank_lower(values, count, location);
+  if (pos == count || values[pos] != location) {
+    return -1;
+  }
+  memmove(&values[pos], &values[pos + 1], (count - pos - 1) * sizeof(int));
+  return count - 1;
+}
+
+static int inline_get(const Record *entry, int *values)
+{
+  const int count = entry->values[ENTRY_COUNT].int_value;
+  for (int i = 0; i < count; i++) {
+    values[i] = entry->values[ENTRY_FIRST + i].int_value;
+  }
+  return count;
+}
+
+static void inline_set(Record *entry, const int *values, const int count)
+{
+  for (int i = 0; i < BPLUS_POSTING_INLINE; i++) {
+    entry->values[ENTRY_FIRST + i].int_value = i < count ? values[i] : -1;
+  }
+}
+
+// Νέα σελίδα με τις δοσμένες θέσεις, που συνεχίζει στην next_block
+static int new_page(const int file_desc, BPlusMeta *metadata, const int *values, const int count,
+                    const int next_block)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  const int block_id = bplus_allocate_block(file_desc, metadata, block);
+  if (block_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  char *data = BF_Block_GetData(block);
+  BPlusPostingPage *page = (BPlusPostingPage *)data;
+  page->is_leaf = BPLUS_POSTING_BLOCK;
+  page->next_block = next_block;
+  write_page(data, values, count);
+
+  CALL_BF(bplus_set_dirty(file_desc, block_id, block));
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return block_id;
+}
+
+// Διαβάζει όλες τις θέσεις μιας αλυσίδας στο values (χωρητικότητας capacity)
+static int read_chain(const int file_desc, int block_id, int *values, const int capacity)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int filled = 0;
+
+  while (block_id != -1) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    char *data = BF_Block_GetData(block);
+    const BPlusPostingPage *page = (const BPlusPostingPage *)data;
+
+    if (filled + page->count > capacity) {
+      BF_UnpinBlock(block);
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+    decode(page_bytes(data), page->count, values + filled);
+    filled += page->count;
+    block_id = page->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  BF_Block_Destroy(&block);
+  return filled;
+}
+
+static int free_chain(const int file_desc, BPlusMeta *metadata, int block_id)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  while (block_id != -1) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const int next = ((BPlusPostingPage *)BF_Block_GetData(block))->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+    if (bplus_free_block(file_desc, metadata, block_id) == -1) {
+      BF_Block_Destroy(&block);
+      return -1;
+    }
+    block_id = next;
+  }
+
+  BF_Block_Destroy(&block);
+  return 0;
+}
+
+// Προσθέτει θέση στην αλυσίδα. Η θέση μπαίνει στην πρώτη σελίδα που φτάνει
+// ως αυτήν, και μια σελίδα που γεμίζει σπάει στα δύο.
+static int chain_insert(const int file_desc, BPlusMeta *metadata, int block_id, const int location)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  for (;;) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const BPlusPostingPage *page = (const BPlusPostingPage *)BF_Block_GetData(block);
+    if (page->next_block == -1 || location <= page->last_value) {
+      break;
+    }
+    const int next = page->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+    block_id = next;
+  }
+
+  CALL_BF(bplus_track_block(file_desc, block_id, block));
+  char *data = BF_Block_GetData(block);
+  BPlusPostingPage *page = (BPlusPostingPage *)data;
+  int values[PAGE_MAX_VALUES + 1];
+  decode(page_bytes(data), page->count, values);
+
+  const int count = sorted_insert(values, page->count, location);
+  int result = 0;
+  if (count == -1) {
+    result = -1;
+  } else if (write_page(data, values, count) == -1) {
+    // δεν χωραει: το δευτερο μισο παει σε νεα σελιδα αμεσως μετα
+    const int half = count / 2;
+    const int new_id = new_page(file_desc, metadata, values + half, count - half, page->next_block);
+    if (new_id == -1) {
+      result = -1;
+    } else {
+      write_page(data, values, half);
+      page->next_block = new_id;
+    }
+  }
+
+  if (result == 0) {
+    CALL_BF(bplus_set_dirty(file_desc, block_id, block));
+  }
+  CALL_BF(BF_UnpinBlock(block));
+  BF_Block_Destroy(&block);
+  return result;
+}
+
+// Βγάζει θέση από την αλυσίδα. Μια σελίδα που αδειάζει αποσυνδέεται και
+// ελευθερώνεται. Το *head αλλάζει αν φύγει η πρώτη σελίδα.
+static int chain_remove(const int file_desc, BPlusMeta *metadata, int *head, const int location)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int previous = -1;
+  int block_id = *head;
+
+  while (block_id != -1) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const BPlusPostingPage *page = (const BPlusPostingPage *)BF_Block_GetData(block);
+    if (location <= page->last_value) {
+      break;
+    }
+    const int next = page->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+    previous = block_id;
+    block_id = next;
+  }
+
+  if (block_id == -1) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  CALL_BF(bplus_track_block(file_desc, block_id, block));
+  char *data = BF_Block_GetData(block);
+  BPlusPostingPage *page = (BPlusPostingPage *)data;
+  int values[PAGE_MAX_VALUES + 1];
+  decode(page_bytes(data), page->count, values);
+
+  const int count = sorted_remove(values, page->count, location);
+  if (count == -1) {
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  if (count > 0) {
+    write_page(data, values, count);
+    CALL_BF(bplus_set_dirty(file_desc, block_id, block));
+    CALL_BF(BF_UnpinBlock(block));
+    BF_Block_Destroy(&block);
+    return 0;
+  }
+
+  // αδεια σελιδα - την παρακαμπτει ο προηγουμενος κρικος
+  const int next = page->next_block;
+  CALL_BF(BF_UnpinBlock(block));
+
+  if (previous == -1) {
+    *head = next;
+  } else {
+    CALL_BF(bplus_get_block(file_desc, previous, block));
+    ((BPlusPostingPage *)BF_Block_GetData(block))->next_block = next;
+    CALL_BF(bplus_set_dirty(file_desc, previous, block));
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  BF_Block_Destroy(&block);
+  return bplus_free_block(file_desc, metadata, block_id);
+}
+
+static void make_entry(const FieldValue *value, Record *entry)
+{
+  memset(entry, 0, sizeof(Record));
+  entry->values[ENTRY_VALUE] = *value;
+  entry->values[ENTRY_COUNT].int_value = 0;
+  entry->values[ENTRY_POSTINGS].int_value = -1;
+  inline_set(entry, NULL, 0);
+}
+
+static int insert_location(const int file_desc, BPlusMeta *metadata, const FieldValue *value, const int location)
+{
+  if (location < 0) {
+    return -1;
+  }
+
+  Record entry;
+  Record *stored;
+  make_entry(value, &entry);
+
+  // πρωτη εμφανιση της τιμης - νεα εγγραφη στον καταλογο
+  if (bplus_record_find_by_key(file_desc, metadata, &entry, &stored) == -1) {
+    entry.values[ENTRY_COUNT].int_value = 1;
+    inline_set(&entry, &location, 1);
+    return bplus_record_insert(file_desc, metadata, &entry) == -1 ? -1 : 0;
+  }
+  entry = *stored;
+  free(stored);
+
+  const int count = entry.values[ENTRY_COUNT].int_value;
+  if (count <= BPLUS_POSTING_INLINE) {
+    int values[BPLUS_POSTING_INLINE + 1];
+    inline_get(&entry, values);
+    if (sorted_insert(values, count, location) == -1) {
+      return -1;
+    }
+
+    if (count < BPLUS_POSTING_INLINE) {
+      inline_set(&entry, values, count + 1);
+    } else {
+      // η λιστα δεν χωραει πια στην εγγραφη - μεταφερεται σε σελιδα υπερχειλισης
+      const int page_id = new_page(file_desc, metadata, values, count + 1, -1);
+      if (page_id == -1) {
+        return -1;
+      }
+      entry.values[ENTRY_POSTINGS].int_value = page_id;
+      inline_set(&entry, NULL, 0);
+    }
+  } else if (chain_insert(file_desc, metadata, entry.values[ENTRY_POSTINGS].int_value, location) == -1) {
+    return -1;
+  }
+
+  entry.values[ENTRY_COUNT].int_value = count + 1;
+  return bplus_record_update(file_desc, metadata, &entry) == -1 ? -1 : 0;
+}
+
+static int delete_location(const int file_desc, BPlusMeta *metadata, const FieldValue *value, const int location)
+{
+  Record entry;
+  Record *stored;
+  make_entry(value, &entry);
+
+  if (bplus_record_find_by_key(file_desc, metadata, &entry, &stored) == -1) {
+    return -1;
+  }
+  entry = *stored;
+  free(stored);
+
+  const int count = entry.values[ENTRY_COUNT].int_value;
+  if (count <= BPLUS_POSTING_INLINE) {
+    int values[BPLUS_POSTING_INLINE];
+    inline_get(&entry, values);
+    if (sorted_remove(values, count, location) == -1) {
+      return -1;
+    }
+    // η τελευταια θεση της τιμης - η τιμη φευγει απο τον καταλογο
+    if (count == 1) {
+      return bplus_record_delete_by_key(file_desc, metadata, &entry);
+    }
+    inline_set(&entry, values, count - 1);
+  } else {
+    int head = entry.values[ENTRY_POSTINGS].int_value;
+    if (chain_remove(file_desc, metadata, &head, location) == -1) {
+      return -1;
+    }
+    entry.values[ENTRY_POSTINGS].int_value = head;
+
+    // αρκετα μικρη για να ξαναγυρισει μεσα στην εγγραφη
+    if (count - 1 == BPLUS_POSTING_INLINE) {
+      int values[BPLUS_POSTING_INLINE];
+      if (read_chain(file_desc, head, values, BPLUS_POSTING_INLINE) != BPLUS_POSTING_INLINE ||
+          free_chain(file_desc, metadata, head) == -1) {
+        return -1;
+      }
+      entry.values[ENTRY_POSTINGS].int_value = -1;
+      inline_set(&entry, values, BPLUS_POSTING_INLINE);
+    }
+  }
+
+  entry.values[ENTRY_COUNT].int_value = count - 1;
+  return bplus_record_update(file_desc, metadata, &entry) == -1 ? -1 : 0;
+}
+
+// οι αλλαγες στις σελιδες και στον καταλογο γινονται commit ολες μαζι
+int bplus_secondary_insert(const int file_desc, BPlusMeta *metadata, const FieldValue *value, const int location)
+{
+  bplus_begin_op(file_desc);
+  const int result = insert_location(file_desc, metadata, value, location);
+  return bplus_commit_op(file_desc) == -1 ? -1 : result;
+}
+
+int bplus_secondary_delete(const int file_desc, BPlusMeta *metadata, const FieldValue *value, const int location)
+{
+  bplus_begin_op(file_desc);
+  const int result = delete_location(file_desc, metadata, value, location);
+  return bplus_commit_op(file_desc) == -1 ? -1 : result;
+}
+
+int bplus_secondary_find(const int file_desc, const BPlusMeta *metadata, const FieldValue *value,
+                         int **out_locations)
+{
+  Record entry;
+  Record *stored;
+  *out_locations = NULL;
+  make_entry(value, &entry);
+
+  if (bplus_record_find_by_key(file_desc, metadata, &entry, &stored) == -1) {
+    return 0;
+  }
+
+  const int count = stored->values[ENTRY_COUNT].int_value;
+  const int head = stored->values[ENTRY_POSTINGS].int_value;
+  *out_locations = malloc(count * sizeof(int));
+  if (*out_locations == NULL) {
+    free(stored);
+    return -1;
+  }
+
+  int found = count;
+  if (count <= BPLUS_POSTING_INLINE) {
+    inline_get(stored, *out_locations);
+  } else {
+    found = read_chain(file_desc, head, *out_locations, count);
+  }
+  free(stored);
+
+  if (found != count) {
+    free(*out_locations);
+    *out_locations = NULL;
+    return -1;
+  }
+  return count;
+}
+
+// ---------------------------------------------------------------- φόρτωση με τη σειρά
+
+struct BPlusSecondaryLoader {
+  int file_desc;
+  BPlusMeta *metadata;
+  BPlusBulkLoader *bulk;                 // για αδειο ευρετηριο, αλλιως NULL και απλες εισαγωγες
+  int active;                            // υπαρχει τρεχουσα τιμη
+  Record entry;                          // η εγγραφη καταλογου της τρεχουσας τιμης
+  unsigned char key[BPLUS_MAX_KEY_SIZE]; // το κλειδι της τρεχουσας τιμης
+  int count;                             // θεσεις της τρεχουσας τιμης
+  int last;                              // η τελευταια της θεση
+  int head;                              // πρωτη και τελευταια γραμμενη σελιδα, -1 αν δεν υπαρχουν
+  int tail;
+  int page[PAGE_MAX_VALUES];             // η σελιδα που γεμιζει ακομα
+  int page_count;
+  int page_used;                         // bytes της κωδικοποιησης της
+};
+
+static int varint_length(unsigned int value)
+{
+  int length = 1;
+  while (value >>= 7) {
+    length++;
+  }
+  return length;
+}
+
+// γραφει τη σελιδα που γεμιζει στο τελος της αλυσιδας της τρεχουσας τιμης
+static int loader_flush_page(BPlusSecondaryLoader *loader)
+{
+  const int file_desc = loader->file_desc;
+  bplus_begin_op(file_desc);
+  const int page_id = new_page(file_desc, loader->metadata, loader->page, loader->page_count, -1);
+  int result = page_id == -1 ? -1 : 0;
+
+  if (result == 0 && loader->tail != -1) {
+    BF_Block *block;
+    BF_Block_Init(&block);
+    if (bplus_get_block(file_desc, loader->tail, block) != BF_OK) {
+      result = -1;
+    } else {
+      ((BPlusPostingPage *)BF_Block_GetData(block))->next_block = page_id;
+      if (bplus_set_dirty(file_desc, loader->tail, block) != BF_OK) {
+        result = -1;
+      }
+      BF_UnpinBlock(block);
+    }
+    BF_Block_Destroy(&block);
+  }
+  if (bplus_commit_op(file_desc) == -1 || result == -1) {
+    return -1;
+  }
+
+  if (loader->head == -1) {
+    loader->head = page_id;
+  }
+  loader->tail = page_id;
+  loader->page_count = 0;
+  loader->page_used = 0;
+  return 0;
+}
+
+// η τρεχουσα τιμη τελειωσε: η εγγραφη της μπαινει στον καταλογο
+static int loader_finish_value(BPlusSecondaryLoader *loader)
+{
+  Record *entry = &loader->entry;
+  entry->values[ENTRY_COUNT].int_value = loader->count;
+  if (loader->count <= BPLUS_POSTING_INLINE) {
+    inline_set(entry, loader->page, loader->count);
+  } else {
+    if (loader->page_count > 0 && loader_flush_page(loader) == -1) {
+      return -1;
+    }
+    entry->values[ENTRY_POSTINGS].int_value = loader->head;
+  }
+
+  // το insert κανει τις δικες του πραξεις, και με insert buffer πολλες μαζι στο flush
+  loader->active = 0;
+  if (loader->bulk != NULL) {
+    return bplus_bulk_load_add(loader->bulk, entry) == 0 ? 0 : -1;
+  }
+  return bplus_record_insert(loader->file_desc, loader->metadata, entry) == -1 ? -1 : 0;
+}
+
+BPlusSecondaryLoader *bplus_secondary_loader_create(const int file_desc, BPlusMeta *metadata)
+{
+  BPlusSecondaryLoader *loader = malloc(sizeof(BPlusSecondaryLoader));
+  if (loader == NULL) {
+    return NULL;
+  }
+  loader->file_desc = file_desc;
+  loader->metadata = metadata;
+  loader->bulk = bplus_bulk_load_create(file_desc, metadata);
+  loader->active = 0;
+  return loader;
+}
+
+int bplus_secondary_loader_add(BPlusSecondaryLoader *loader, const FieldValue *value, const int location)
+{
+  const TableSchema *schema = &loader->metadata->table_schema;
+  Record record;
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  record.values[ENTRY_VALUE] = *value;
+  bplus_key_from_record(schema, &record, key);
+
+  const int order = loader->active ? memcmp(key, loader->key, schema->key_size) : 1;
+  if (location < 0 || order < 0 || (order == 0 && location <= loader->last)) {
+    fprintf(stderr, "Error: secondary index load out of order\n");
+    return -1;
+  }
+
+  // νεα τιμη: η προηγουμενη κλεινει
+  if (order > 0) {
+    if (loader->active && loader_finish_value(loader) == -1) {
+      return -1;
+    }
+    make_entry(value, &loader->entry);
+    memcpy(loader->key, key, schema->key_size);
+    loader->active = 1;
+    loader->count = 0;
+    loader->head = -1;
+    loader->tail = -1;
+    loader->page_count = 0;
+    loader->page_used = 0;
+  }
+
+  const unsigned int delta =
+    loader->page_count == 0 ? (unsigned int)location : (unsigned int)(location - loader->last);
+  const int length = varint_length(delta);
+  if (loader->page_count == PAGE_MAX_VALUES || loader->page_used + length > PAGE_BYTES) {
+    if (loader_flush_page(loader) == -1) {
+      return -1;
+    }
+    // η πρωτη θεση της νεας σελιδας γραφεται ολοκληρη
+    loader->page_used = varint_length((unsigned int)location);
+  } else {
+    loader->page_used += length;
+  }
+  loader->page[loader->page_count++] = location;
+  loader->last = location;
+  loader->count++;
+  return 0;
+}
+
+int bplus_secondary_loader_finish(BPlusSecondaryLoader *loader)
+{
+  int result = loader->active ? loader_finish_value(loader) : 0;
+  if (loader->bulk != NULL) {
+    if (result == 0) {
+      result = bplus_bulk_load_finish(loader->bulk) == -1 ? -1 : 0;
+    } else {
+      bplus_bulk_load_abort(loader->bulk);
+    }
+  }
+  free(loader);
+  return result;
+}
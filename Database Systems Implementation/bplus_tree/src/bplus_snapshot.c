@@ -0,0 +1,702 @@
+// Στατικό αντίγραφο μόνο για ανάγνωση: ευρετήριο σε διάταξη van Emde Boas με
+// κλειδιά σε σειρά Eytzinger μέσα σε κάθε κόμβο, που διαβάζεται με mmap,
+// προαιρετικό μοντέλο δύο σταδίων που προβλέπει τη θέση ενός κλειδιού INT και
+// προαιρετικά συμπιεσμένες ομάδες εγγραφών.
+
+#include "bplus_snapshot.h"
+#include "bplus_file_funcs.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "bplus_lz.h"
+#include "bf.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC "BPSNAP3"
+#define SEPARATORS (BPLUS_SNAPSHOT_FANOUT - 1)
+#define STEPS 4 // log2(BPLUS_SNAPSHOT_FANOUT), βηματα μεσα σε εναν κομβο
+
+// Macro για error handling - αν αποτύχει κάποια κλήση BF επιστρέφουμε -1
+#define CALL_BF(call)         \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK)        \
+    {                         \
+      BF_PrintError(code);    \
+      return -1;              \
+    }                         \
+  }
+
+static long power(const long base, const int exponent)
+{
+  long result = 1;
+  for (int i = 0; i < exponent; i++) {
+    result *= base;
+  }
+  return result;
+}
+
+static long align64(const long value)
+{
+  return (value + 63) & ~63L;
+}
+
+// Ολες οι εγγραφες του δεντρου με τη σειρα των κλειδιων τους, απο τη λιστα των φυλλων
+static int collect(const int file_desc, const BPlusMeta *metadata, unsigned char **keys, char **records,
+                   int *count)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  int allocated = 0;
+  *keys = NULL;
+  *records = NULL;
+  *count = 0;
+  if (metadata->root_block_num == -1) {
+    return 0;
+  }
+
+  BF_Block *block;
+  BF_Block_Init(&block);
+
+  int block_id = metadata->root_block_num;
+  for (int level = 0; level < metadata->depth - 1; level++) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    const int child = indexnode_children(BF_Block_GetData(block), metadata->index_capacity)[0];
+    CALL_BF(BF_UnpinBlock(block));
+    block_id = child;
+  }
+
+  while (block_id != -1) {
+    CALL_BF(BF_GetBlock(file_desc, block_id, block));
+    char *data = BF_Block_GetData(block);
+    const BPlusDataNode *leaf = (const BPlusDataNode *)data;
+
+    if (*count + leaf->key_count > allocated) {
+      allocated = allocated == 0 ? 1024 : allocated;
+      while (allocated < *count + leaf->key_count) {
+        allocated *= 2;
+      }
+      unsigned char *new_keys = realloc(*keys, (size_t)allocated * schema->key_size);
+      if (new_keys != NULL) {
+        *keys = new_keys;
+      }
+      char *new_records = realloc(*records, (size_t)allocated * schema->record_size);
+      if (new_records != NULL) {
+        *records = new_records;
+      }
+      if (new_keys == NULL || new_records == NULL) {
+        BF_UnpinBlock(block);
+        BF_Block_Destroy(&block);
+        return -1;
+      }
+    }
+
+    for (int i = 0; i < leaf->key_count; i++, (*count)++) {
+      datanode_key(data, schema, metadata->leaf_capacity, i, *keys + (size_t)*count * schema->key_size);
+      memcpy(*records + (size_t)*count * schema->record_size,
+             datanode_record(data, schema, metadata->leaf_capacity, i), schema->record_size);
+    }
+    block_id = leaf->next_block;
+    CALL_BF(BF_UnpinBlock(block));
+  }
+
+  BF_Block_Destroy(&block);
+  return 0;
+}
+
+// Διάταξη van Emde Boas: το υποδεντρο υψους height με ριζα τον κομβο index του
+// επιπεδου level κοβεται στη μεση, πρωτα μπαινει το πανω μισο και μετα καθε
+// κατω υποδεντρο με τη σειρα. Ολα τα κατω υποδεντρα εχουν το ιδιο μεγεθος,
+// οποτε τα παιδια ενος κομβου απεχουν σταθερα strides[level] θεσεις.
+static void place(long **positions, long *strides, const int level, const long index, const int height, long *next)
+{
+  if (height == 1) {
+    positions[level][index] = (*next)++;
+    return;
+  }
+
+  const int top = height / 2;
+  const int bottom = height - top;
+  place(positions, strides, level, index, top, next);
+
+  const long roots = power(BPLUS_SNAPSHOT_FANOUT, top);
+  strides[level + top - 1] = (power(BPLUS_SNAPSHOT_FANOUT, bottom) - 1) / (BPLUS_SNAPSHOT_FANOUT - 1);
+  for (long b = 0; b < roots; b++) {
+    place(positions, strides, level + top, index * roots + b, bottom, next);
+  }
+}
+
+// Γεμιζει τη σειρα Eytzinger: ο κομβος i του δυαδικου δεντρου εχει παιδια 2i και 2i + 1
+static void eytzinger(const unsigned char *sorted, unsigned char *out, const int key_size, const int i, int *next)
+{
+  if (i > SEPARATORS) {
+    return;
+  }
+  eytzinger(sorted, out, key_size, 2 * i, next);
+  memcpy(out + (i - 1) * key_size, sorted + (*next)++ * key_size, key_size);
+  eytzinger(sorted, out, key_size, 2 * i + 1, next);
+}
+
+// Φτιαχνει τους κομβους του ευρετηριου πανω απο τις ομαδες εγγραφων
+static char *build_nodes(const BPlusSnapshotHeader *header, const unsigned char *keys, long *strides)
+{
+  const int height = header->height;
+  const int key_size = header->key_size;
+  char *nodes = calloc(header->node_count > 0 ? header->node_count : 1, header->node_size);
+  long *positions[BPLUS_SNAPSHOT_MAX_HEIGHT];
+  if (nodes == NULL) {
+    return NULL;
+  }
+  if (height == 0) {
+    return nodes;
+  }
+
+  for (int level = 0; level < height; level++) {
+    positions[level] = malloc(power(BPLUS_SNAPSHOT_FANOUT, level) * sizeof(long));
+    if (positions[level] == NULL) {
+      for (int i = 0; i < level; i++) {
+        free(positions[i]);
+      }
+      free(nodes);
+      return NULL;
+    }
+  }
+  long next = 0;
+  place(positions, strides, 0, 0, height, &next);
+
+  // τα separators που δεν αντιστοιχουν σε ομαδα ειναι "απειρο" και δεν επιλεγονται ποτε
+  unsigned char sorted[SEPARATORS * BPLUS_MAX_KEY_SIZE];
+  for (int level = 0; level < height; level++) {
+    const long child_span = power(BPLUS_SNAPSHOT_FANOUT, height - level - 1);
+    for (long index = 0; index < power(BPLUS_SNAPSHOT_FANOUT, level); index++) {
+      char *node = nodes + positions[level][index] * header->node_size;
+      for (int j = 0; j < SEPARATORS; j++) {
+        const long group = (index * BPLUS_SNAPSHOT_FANOUT + j + 1) * child_span;
+        if (group < header->group_count) {
+          memcpy(sorted + j * key_size, keys + group * BPLUS_SNAPSHOT_FANOUT * key_size, key_size);
+        } else {
+          memset(sorted + j * key_size, 0xFF, key_size);
+        }
+      }
+      int taken = 0;
+      eytzinger(sorted, (unsigned char *)node + sizeof(int), key_size, 1, &taken);
+
+      const int first_child = level < height - 1 ? (int)positions[level + 1][index * BPLUS_SNAPSHOT_FANOUT] : 0;
+      memcpy(node, &first_child, sizeof(int));
+    }
+  }
+
+  for (int level = 0; level < height; level++) {
+    free(positions[level]);
+  }
+  return nodes;
+}
+
+// πρωτο σταδιο: σε ποιο μοντελο πεφτει ενα κλειδι, μονοτονα ως προς το κλειδι
+static int model_slot(const BPlusSnapshotHeader *header, const int key)
+{
+  if (key < header->min_key) {
+    return 0;
+  }
+  const long slot = ((long)key - header->min_key) * header->model_count / header->key_range;
+  return slot < header->model_count ? (int)slot : header->model_count - 1;
+}
+
+// δευτερο σταδιο: γραμμικη παρεμβολη αναμεσα στο πρωτο και το τελευταιο κλειδι του
+// μοντελου, σε ακεραιους ωστε η προβλεψη να ειναι ιδια στην κατασκευη και στην αναζητηση
+static long predict(const BPlusSnapshotModel *model, const int key)
+{
+  if (model->key_span == 0) {
+    return model->first;
+  }
+  return model->first + ((long)key - model->first_key) * (model->count - 1) / (long)model->key_span;
+}
+
+static int key_value(const unsigned char *keys, const long pos)
+{
+  return bplus_key_head(keys + pos * sizeof(int));
+}
+
+// Τα μοντελα του δευτερου σταδιου, μονο για κλειδι ενα INT (αλλιως model_count = 0)
+static BPlusSnapshotModel *build_models(BPlusSnapshotHeader *header, const unsigned char *keys)
+{
+  const TableSchema *schema = &header->schema;
+  const int count = header->record_count;
+  if (count == 0 || schema->key_attr_count != 1 || schema->attributes[schema->key_index].type != TYPE_INT) {
+    return NULL;
+  }
+
+  header->model_count = (count + BPLUS_SNAPSHOT_MODEL_KEYS - 1) / BPLUS_SNAPSHOT_MODEL_KEYS;
+  header->min_key = key_value(keys, 0);
+  header->key_range = (long)key_value(keys, count - 1) - header->min_key + 1;
+  BPlusSnapshotModel *models = calloc(header->model_count, sizeof(BPlusSnapshotModel));
+  if (models == NULL) {
+    return NULL;
+  }
+
+  // τα κλειδια ειναι ταξινομημενα, οποτε καθε μοντελο παιρνει ενα συνεχομενο κομματι
+  int pos = 0;
+  for (int m = 0; m < header->model_count; m++) {
+    BPlusSnapshotModel *model = &models[m];
+    model->first = pos;
+    while (pos < count && model_slot(header, key_value(keys, pos)) == m) {
+      pos++;
+    }
+    model->count = pos - model->first;
+    if (model->count == 0) {
+      continue;
+    }
+
+    model->first_key = key_value(keys, model->first);
+    model->key_span = (unsigned int)((long)key_value(keys, pos - 1) - model->first_key);
+    model->error_low = model->error_high = 0;
+    for (int i = model->first; i < pos; i++) {
+      const long error = i - predict(model, key_value(keys, i));
+      model->error_low = error < model->error_low ? (int)error : model->error_low;
+      model->error_high = error > model->error_high ? (int)error : model->error_high;
+    }
+  }
+  return models;
+}
+
+static int write_padded(FILE *file, const void *data, const size_t size, const long offset)
+{
+  static const char zeros[64];
+  while (ftell(file) < offset) {
+    const long gap = offset - ftell(file);
+    if (fwrite(zeros, 1, gap < 64 ? gap : 64, file) == 0) {
+      return -1;
+    }
+  }
+  return size == 0 || fwrite(data, 1, size, file) == size ? 0 : -1;
+}
+
+// Καθε ομαδα εγγραφων συμπιεζεται στο δικο της slot, ή μενει οπως ειναι αν δεν μικραινει.
+// Γεμιζει τον πινακα των slots και επιστρεφει τα bytes ολων, -1 αν δεν υπαρχει μνημη
+static long compress_groups(const BPlusSnapshotHeader *header, const char *records, long *slots, char **out)
+{
+  const int group_bytes = BPLUS_SNAPSHOT_FANOUT * header->record_size;
+  char *slot_data = malloc((size_t)(header->group_count > 0 ? header->group_count : 1) *
+                           BPLUS_LZ_BOUND(group_bytes));
+  *out = slot_data;
+  if (slot_data == NULL) {
+    return -1;
+  }
+
+  long size = 0;
+  for (long g = 0; g < header->group_count; g++) {
+    const long first = g * BPLUS_SNAPSHOT_FANOUT;
+    const int count = first + BPLUS_SNAPSHOT_FANOUT < header->record_count ? BPLUS_SNAPSHOT_FANOUT
+                                                                           : header->record_count - (int)first;
+    const char *group = records + first * header->record_size;
+    const int raw = count * header->record_size;
+    slots[g] = size;
+    const int compressed = bplus_lz_compress(group, raw, slot_data + size, raw - 1);
+    if (compressed == -1) {
+      memcpy(slot_data + size, group, raw);
+      size += raw;
+    } else {
+      size += compressed;
+    }
+  }
+  slots[header->group_count] = size;
+  return size;
+}
+
+static int export_snapshot(const int file_desc, BPlusMeta *metadata, const char *snapshot_name, const int compress)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  if (bplus_insert_buffer_flush(file_desc) == -1) {
+    return -1;
+  }
+
+  unsigned char *keys;
+  char *records;
+  int count;
+  if (collect(file_desc, metadata, &keys, &records, &count) == -1) {
+    free(keys);
+    free(records);
+    return -1;
+  }
+
+  BPlusSnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.key_size = schema->key_size;
+  header.record_size = schema->record_size;
+  header.record_count = count;
+  header.group_count = (count + BPLUS_SNAPSHOT_FANOUT - 1) / BPLUS_SNAPSHOT_FANOUT;
+  while (power(BPLUS_SNAPSHOT_FANOUT, header.height) < header.group_count) {
+    header.height++;
+  }
+  header.node_size = (int)align64(sizeof(int) + SEPARATORS * schema->key_size);
+  header.node_count = (power(BPLUS_SNAPSHOT_FANOUT, header.height) - 1) / (BPLUS_SNAPSHOT_FANOUT - 1);
+  header.nodes_offset = align64(sizeof(header));
+  header.keys_offset = align64(header.nodes_offset + header.node_count * header.node_size);
+  header.records_offset = align64(header.keys_offset + (long)count * schema->key_size);
+  header.records_bytes = (long)count * schema->record_size;
+  header.schema = *schema;
+
+  // συμπιεσμενες εγγραφες: μετα τα κλειδια ο πινακας των slots και μετα τα slots
+  long *slots = NULL;
+  char *stored = records;
+  if (compress && schema->record_size <= (int)sizeof(Record)) {
+    slots = malloc((size_t)(header.group_count + 1) * sizeof(long));
+    header.records_bytes = slots == NULL ? -1 : compress_groups(&header, records, slots, &stored);
+    if (header.records_bytes == -1) {
+      if (stored != records) {
+        free(stored);
+      }
+      free(slots);
+      free(keys);
+      free(records);
+      return -1;
+    }
+    header.compressed = 1;
+    header.slots_offset = header.records_offset;
+    header.records_offset = align64(header.slots_offset + (long)(header.group_count + 1) * (long)sizeof(long));
+  }
+  header.models_offset = align64(header.records_offset + header.records_bytes);
+
+  BPlusSnapshotModel *models = build_models(&header, keys);
+  char *nodes = build_nodes(&header, keys, header.strides);
+  FILE *file = nodes == NULL ? NULL : fopen(snapshot_name, "wb");
+  int result = file == NULL ? -1 : 0;
+  if (file != NULL) {
+    if (write_padded(file, &header, sizeof(header), 0) == -1 ||
+        write_padded(file, nodes, (size_t)header.node_count * header.node_size, header.nodes_offset) == -1 ||
+        write_padded(file, keys, (size_t)count * schema->key_size, header.keys_offset) == -1 ||
+        (slots != NULL && write_padded(file, slots, (size_t)(header.group_count + 1) * sizeof(long),
+                                       header.slots_offset) == -1) ||
+        write_padded(file, stored, header.records_bytes, header.records_offset) == -1 ||
+        write_padded(file, models, (size_t)header.model_count * sizeof(BPlusSnapshotModel),
+                     header.models_offset) == -1) {
+      result = -1;
+    }
+    if (fclose(file) != 0) {
+      result = -1;
+    }
+  }
+  if (result == -1) {
+    fprintf(stderr, "Error: cannot write snapshot %s\n", snapshot_name);
+  }
+
+  if (stored != records) {
+    free(stored);
+  }
+  free(slots);
+  free(models);
+  free(nodes);
+  free(keys);
+  free(records);
+  return result;
+}
+
+int bplus_export_snapshot(const int file_desc, BPlusMeta *metadata, const char *snapshot_name)
+{
+  return export_snapshot(file_desc, metadata, snapshot_name, 0);
+}
+
+int bplus_export_snapshot_compressed(const int file_desc, BPlusMeta *metadata, const char *snapshot_name)
+{
+  return export_snapshot(file_desc, metadata, snapshot_name, 1);
+}
+
+BPlusSnapshot *bplus_snapshot_open(const char *snapshot_name)
+{
+  const int os_fd = open(snapshot_name, O_RDONLY);
+  if (os_fd == -1) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(os_fd, &info) == -1 || (size_t)info.st_size < sizeof(BPlusSnapshotHeader)) {
+    close(os_fd);
+    return NULL;
+  }
+
+  void *map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, os_fd, 0);
+  close(os_fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+
+  const BPlusSnapshotHeader *header = map;
+  BPlusSnapshot *snapshot = malloc(sizeof(BPlusSnapshot));
+  if (snapshot == NULL || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+      header->models_offset + (long)header->model_count * (long)sizeof(BPlusSnapshotModel) > info.st_size) {
+    fprintf(stderr, "Error: %s is not a B+ snapshot\n", snapshot_name);
+    munmap(map, info.st_size);
+    free(snapshot);
+    return NULL;
+  }
+
+  snapshot->header = header;
+  snapshot->nodes = (const char *)map + header->nodes_offset;
+  snapshot->keys = (const unsigned char *)map + header->keys_offset;
+  snapshot->records = (const char *)map + header->records_offset;
+  snapshot->slots = header->compressed ? (const long *)((const char *)map + header->slots_offset) : NULL;
+  snapshot->models = (const BPlusSnapshotModel *)((const char *)map + header->models_offset);
+  snapshot->search = header->model_count > 0 ? BPLUS_SNAPSHOT_SEARCH_MODEL : BPLUS_SNAPSHOT_SEARCH_TREE;
+  snapshot->size = info.st_size;
+  return snapshot;
+}
+
+void bplus_snapshot_close(BPlusSnapshot *snapshot)
+{
+  if (snapshot == NULL) {
+    return;
+  }
+  munmap((void *)snapshot->header, snapshot->size);
+  free(snapshot);
+}
+
+int bplus_snapshot_set_search(BPlusSnapshot *snapshot, const BPlusSnapshotSearch search)
+{
+  if (search == BPLUS_SNAPSHOT_SEARCH_MODEL && snapshot->header->model_count == 0) {
+    return -1;
+  }
+  snapshot->search = search;
+  return 0;
+}
+
+// <0, 0, >0 οπως το memcmp· για κλειδια 4 bytes μια συγκριση ακεραιων
+static int compare(const unsigned char *a, const unsigned char *b, const int key_size)
+{
+  if (key_size == 4) {
+    uint32_t x, y;
+    memcpy(&x, a, 4);
+    memcpy(&y, b, 4);
+    x = __builtin_bswap32(x);
+    y = __builtin_bswap32(y);
+    return (x > y) - (x < y);
+  }
+  return memcmp(a, b, key_size);
+}
+
+// Θεση του πρωτου κλειδιου >= key στο [low, high), δυαδικη αναζητηση χωρις branches
+static long lower_bound(const unsigned char *keys, const int key_size, long low, const long high,
+                        const unsigned char *key, int *comparisons)
+{
+  long n = high - low;
+  while (n > 1) {
+    const long half = n / 2;
+    low = compare(keys + (low + half - 1) * key_size, key, key_size) < 0 ? low + half : low;
+    n -= half;
+    (*comparisons)++;
+  }
+  if (n == 1) {
+    low += compare(keys + low * key_size, key, key_size) < 0;
+    (*comparisons)++;
+  }
+  return low;
+}
+
+static long tree_rank(const BPlusSnapshot *snapshot, const unsigned char *key, int *comparisons)
+{
+  const BPlusSnapshotHeader *header = snapshot->header;
+  const int key_size = header->key_size;
+
+  // σε καθε κομβο τεσσερα βηματα χωρις διακλαδωσεις: δεξια οταν separator <= key
+  long group = 0;
+  long node = 0;
+  for (int level = 0; level < header->height; level++) {
+    const char *data = snapshot->nodes + node * header->node_size;
+    const unsigned char *separators = (const unsigned char *)data + sizeof(int);
+    unsigned int i = 1;
+    for (int step = 0; step < STEPS; step++) {
+      i = 2 * i + (compare(separators + (i - 1) * key_size, key, key_size) <= 0);
+    }
+    *comparisons += STEPS;
+    const int child = (int)i - BPLUS_SNAPSHOT_FANOUT;
+    int first_child;
+    memcpy(&first_child, data, sizeof(int));
+    group = group * BPLUS_SNAPSHOT_FANOUT + child;
+    node = first_child + child * header->strides[level];
+  }
+
+  // ενα κλειδι ισο με το "απειρο" καταληγει σε ομαδα-γεμισμα, ανηκει στην τελευταια
+  if (group >= header->group_count) {
+    group = header->group_count - 1;
+  }
+
+  long pos = group * BPLUS_SNAPSHOT_FANOUT;
+  const long end = pos + BPLUS_SNAPSHOT_FANOUT < header->record_count ? pos + BPLUS_SNAPSHOT_FANOUT
+                                                                        : header->record_count;
+  while (pos < end && ((*comparisons)++, compare(snapshot->keys + pos * key_size, key, key_size) < 0)) {
+    pos++;
+  }
+  return pos;
+}
+
+// Το παραθυρο [low, high] οπου βρισκεται το πρωτο κλειδι >= key συμφωνα με το μοντελο:
+// η προβλεψη ειναι μονοτονη, οποτε και για κλειδια που λειπουν το σφαλμα ξεπερνα
+// το μεγιστο των υπαρχοντων το πολυ κατα μια θεση
+static void model_window(const BPlusSnapshot *snapshot, const int key, long *low, long *high)
+{
+  const BPlusSnapshotModel *model = &snapshot->models[model_slot(snapshot->header, key)];
+  const long predicted = predict(model, key);
+  const long end = model->first + model->count;
+
+  *low = predicted + model->error_low;
+  *high = predicted + model->error_high + 1;
+  *low = *low < model->first ? model->first : (*low > end ? end : *low);
+  *high = *high < model->first ? model->first : (*high > end ? end : *high);
+}
+
+static long model_rank(const BPlusSnapshot *snapshot, const unsigned char *key, int *comparisons)
+{
+  long low, high;
+  model_window(snapshot, bplus_key_head(key), &low, &high);
+  return lower_bound(snapshot->keys, sizeof(int), low, high, key, comparisons);
+}
+
+// η κλασικη αναζητηση, μονο για συγκριση στην αναφορα
+static long binary_rank(const BPlusSnapshot *snapshot, const unsigned char *key, int *comparisons)
+{
+  const BPlusSnapshotHeader *header = snapshot->header;
+  return lower_bound(snapshot->keys, header->key_size, 0, header->record_count, key, comparisons);
+}
+
+static int find(const BPlusSnapshot *snapshot, const unsigned char *key, Record *out_record)
+{
+  const BPlusSnapshotHeader *header = snapshot->header;
+  const int key_size = header->key_size;
+  if (header->record_count == 0) {
+    return -1;
+  }
+
+  int comparisons = 0;
+  const long pos = snapshot->search == BPLUS_SNAPSHOT_SEARCH_MODEL ? model_rank(snapshot, key, &comparisons)
+                                                                   : tree_rank(snapshot, key, &comparisons);
+  if (pos == header->record_count || compare(snapshot->keys + pos * key_size, key, key_size) != 0) {
+    return -1;
+  }
+
+  if (snapshot->slots == NULL) {
+    record_deserialize(&header->schema, snapshot->records + pos * header->record_size, out_record);
+    return 0;
+  }
+
+  // μονο η ομαδα της εγγραφης αποσυμπιεζεται, σε buffer της στοιβας ωστε να αντεχει πολλα threads
+  char group[BPLUS_SNAPSHOT_FANOUT * sizeof(Record)];
+  const long g = pos / BPLUS_SNAPSHOT_FANOUT;
+  const long first = g * BPLUS_SNAPSHOT_FANOUT;
+  const int count = first + BPLUS_SNAPSHOT_FANOUT < header->record_count ? BPLUS_SNAPSHOT_FANOUT
+                                                                         : header->record_count - (int)first;
+  const int raw = count * header->record_size;
+  const char *slot = snapshot->records + snapshot->slots[g];
+  const long length = snapshot->slots[g + 1] - snapshot->slots[g];
+  if (length != raw) {
+    if (bplus_lz_decompress(slot, (int)length, group, (int)sizeof(group)) != raw) {
+      fprintf(stderr, "Error: corrupt slot %ld in snapshot\n", g);
+      return -1;
+    }
+    slot = group;
+  }
+  record_deserialize(&header->schema, slot + (pos - first) * header->record_size, out_record);
+  return 0;
+}
+
+int bplus_snapshot_find(const BPlusSnapshot *snapshot, const int key, Record *out_record)
+{
+  unsigned char normalized[BPLUS_MAX_KEY_SIZE];
+  if (bplus_key_from_int(&snapshot->header->schema, key, normalized) == -1) {
+    fprintf(stderr, "Error: key is not a single INT attribute, use bplus_snapshot_find_by_key\n");
+    return -1;
+  }
+  return find(snapshot, normalized, out_record);
+}
+
+int bplus_snapshot_find_by_key(const BPlusSnapshot *snapshot, const Record *key_record, Record *out_record)
+{
+  unsigned char key[BPLUS_MAX_KEY_SIZE];
+  bplus_key_from_record(&snapshot->header->schema, key_record, key);
+  return find(snapshot, key, out_record);
+}
+
+static double now_ns(void)
+{
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+int bplus_snapshot_report(const BPlusSnapshot *snapshot, const int lookups, BPlusSnapshotReport *report)
+{
+  const BPlusSnapshotHeader *header = snapshot->header;
+  if (header->model_count == 0 || lookups <= 0) {
+    return -1;
+  }
+  unsigned char *probes = malloc((size_t)lookups * sizeof(int));
+  if (probes == NULL) {
+    return -1;
+  }
+
+  memset(report, 0, sizeof(*report));
+  report->model_count = header->model_count;
+
+  // ακριβεια: ποσο απεχει η προβλεψη απο τη θεση καθε κλειδιου
+  double error_sum = 0;
+  for (int m = 0; m < header->model_count; m++) {
+    const BPlusSnapshotModel *model = &snapshot->models[m];
+    for (int i = model->first; i < model->first + model->count; i++) {
+      const long error = labs(i - predict(model, key_value(snapshot->keys, i)));
+      error_sum += error;
+      report->max_error = error > report->max_error ? (int)error : report->max_error;
+    }
+  }
+  report->mean_error = error_sum / header->record_count;
+
+  // μισα κλειδια που υπαρχουν, μισα τυχαιες τιμες αναμεσα στο μικροτερο και το μεγαλυτερο
+  double window_sum = 0;
+  for (int i = 0; i < lookups; i++) {
+    const int value = i % 2 == 0 ? key_value(snapshot->keys, rand() % header->record_count)
+                                 : (int)(header->min_key + (long)(rand() / (RAND_MAX + 1.0) * header->key_range));
+    bplus_key_set_head(value, probes + i * sizeof(int));
+    long low, high;
+    model_window(snapshot, value, &low, &high);
+    window_sum += high - low;
+  }
+  report->mean_window = window_sum / lookups;
+
+  // κοστος: οι τρεις αναζητησεις στα ιδια κλειδια, πρεπει να δινουν τις ιδιες θεσεις
+  long (*const ranks[3])(const BPlusSnapshot *, const unsigned char *, int *) = {model_rank, tree_rank, binary_rank};
+  double *const comparisons_out[3] = {&report->model_comparisons, &report->tree_comparisons,
+                                      &report->binary_comparisons};
+  double *const ns_out[3] = {&report->model_ns, &report->tree_ns, &report->binary_ns};
+  long checksums[3];
+  for (int s = 0; s < 3; s++) {
+    int comparisons = 0;
+    long checksum = 0;
+    const double start = now_ns();
+    for (int i = 0; i < lookups; i++) {
+      checksum += ranks[s](snapshot, probes + i * sizeof(int), &comparisons);
+    }
+    *ns_out[s] = (now_ns() - start) / lookups;
+    *comparisons_out[s] = (double)comparisons / lookups;
+    checksums[s] = checksum;
+  }
+
+  free(probes);
+  if (checksums[0] != checksums[1] || checksums[0] != checksums[2]) {
+    fprintf(stderr, "Error: snapshot searches disagree\n");
+    return -1;
+  }
+  return 0;
+}
+
+void bplus_snapshot_report_print(const BPlusSnapshotReport *report)
+{
+  printf("Learned model: %d models, mean error %.2f, max error %d, mean window %.1f keys\n",
+         report->model_count, report->mean_error, report->max_error, report->mean_window);
+  printf("  model:  %5.1f comparisons %6.1f ns per lookup\n", report->model_comparisons, report->model_ns);
+  printf("  tree:   %5.1f comparisons %6.1f ns per lookup\n", report->tree_comparisons, report->tree_ns);
+  printf("  binary: %5.1f comparisons %6.1f ns per lookup\n", report->binary_comparisons, report->binary_ns);
+}
@@ -0,0 +1,276 @@
+// Στατιστικά πίνακα (ANALYZE): πλήθος γραμμών, διακριτές τιμές και ιστόγραμμα
+// ίσου βάθους ανά στήλη, και εκτίμηση επιλεκτικότητας κατηγορημάτων από αυτά.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bplus_stats.h"
+
+typedef struct {
+  double *positions;   // μια θεση στην κλιμακα ανα γραμμη
+  uint64_t *hashes;    // CHAR: hash ολου του string, για τις διακριτες τιμες
+} ColumnValues;
+
+static int compare_doubles(const void *a, const void *b)
+{
+  const double x = *(const double *)a;
+  const double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static int compare_hashes(const void *a, const void *b)
+{
+  const uint64_t x = *(const uint64_t *)a;
+  const uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// τα bytes μετα το πρωτο NUL δεν μετρανε (στο heap file μπορει να ειναι σκουπιδια)
+static int char_length(const char *bytes, const int width)
+{
+  const char *end = memchr(bytes, '\0', width);
+  return end != NULL ? (int)(end - bytes) : width;
+}
+
+static double char_position(const char *bytes, const int width)
+{
+  const int length = char_length(bytes, width);
+  double position = 0;
+  for (int i = 0; i < BPLUS_STATS_CHAR_PREFIX; i++) {
+    position = position * 256 + (i < length ? (unsigned char)bytes[i] : 0);
+  }
+  return position;
+}
+
+// FNV-1a
+static uint64_t char_hash(const char *bytes, const int width)
+{
+  const int length = char_length(bytes, width);
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < length; i++) {
+    hash = (hash ^ (unsigned char)bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+double bplus_stats_position(const AttributeSchema *attr, const FieldValue *value)
+{
+  switch (attr->type) {
+    case TYPE_INT: return value->int_value;
+    case TYPE_FLOAT: return value->float_value;
+    default: return char_position(value->string_value, attr->length);
+  }
+}
+
+// προσθετει τις γραμμες ενος batch στις τιμες των στηλων, απο τη θεση row
+static void append_batch(const ExecBatch *batch, ColumnValues *values, const long row)
+{
+  const TableSchema *schema = batch->schema;
+  for (int c = 0; c < schema->count; c++) {
+    const AttributeSchema *attr = &schema->attributes[c];
+    double *positions = values[c].positions + row;
+    for (int k = 0; k < batch->selected; k++) {
+      const int r = batch->selection != NULL ? batch->selection[k] : k;
+      if (attr->type == TYPE_INT) {
+        positions[k] = ((const int *)batch->columns[c])[r];
+      } else if (attr->type == TYPE_FLOAT) {
+        positions[k] = ((const float *)batch->columns[c])[r];
+      } else {
+        const char *bytes = batch->columns[c] + (size_t)r * attr->length;
+        positions[k] = char_position(bytes, attr->length);
+        values[c].hashes[row + k] = char_hash(bytes, attr->length);
+      }
+    }
+  }
+}
+
+static long count_distinct_doubles(const double *sorted, const long n)
+{
+  long distinct = n > 0;
+  for (long i = 1; i < n; i++) {
+    distinct += sorted[i] != sorted[i - 1];
+  }
+  return distinct;
+}
+
+static long count_distinct_hashes(uint64_t *hashes, const long n)
+{
+  qsort(hashes, n, sizeof(uint64_t), compare_hashes);
+  long distinct = n > 0;
+  for (long i = 1; i < n; i++) {
+    distinct += hashes[i] != hashes[i - 1];
+  }
+  return distinct;
+}
+
+static void build_column(BPlusColumnStats *column, const AttributeSchema *attr, ColumnValues *values, const long n)
+{
+  memset(column, 0, sizeof(*column));
+  if (n == 0) {
+    return;
+  }
+  qsort(values->positions, n, sizeof(double), compare_doubles);
+  column->min = values->positions[0];
+  column->max = values->positions[n - 1];
+  column->distinct_count = attr->type == TYPE_CHAR ? count_distinct_hashes(values->hashes, n)
+                                                   : count_distinct_doubles(values->positions, n);
+
+  // τα ορια των buckets ειναι οι τιμες στις θεσεις 0, n/B, 2n/B, ..., n - 1
+  column->bucket_count = n < BPLUS_STATS_BUCKETS ? (int)n : BPLUS_STATS_BUCKETS;
+  long previous = 0;
+  for (int b = 0; b <= column->bucket_count; b++) {
+    const long index = (long)((double)b * (n - 1) / column->bucket_count);
+    column->bounds[b] = values->positions[index];
+    if (b > 0) {
+      column->bucket_distinct[b - 1] = count_distinct_doubles(values->positions + previous, index - previous + 1);
+    }
+    previous = index;
+  }
+}
+
+int bplus_analyze_scan(ExecOperator *scan, const int page_count, BPlusTableStats *stats)
+{
+  if (scan == NULL) {
+    return -1;
+  }
+  memset(stats, 0, sizeof(*stats));
+  stats->schema = scan->schema;
+  stats->page_count = page_count;
+  const TableSchema *schema = &stats->schema;
+
+  ColumnValues values[MAX_ATTRIBUTES];
+  memset(values, 0, sizeof(values));
+  long allocated = 0;
+  long rows = 0;
+  int result = 0;
+  ExecBatch *batch;
+  int n;
+
+  while ((n = exec_next(scan, &batch)) > 0) {
+    if (rows + n > allocated) {
+      allocated = allocated == 0 ? 4 * EXEC_BATCH_SIZE : allocated * 2;
+      for (int c = 0; c < schema->count && result == 0; c++) {
+        double *positions = realloc(values[c].positions, allocated * sizeof(double));
+        if (positions != NULL) {
+          values[c].positions = positions;
+        }
+        uint64_t *hashes = values[c].hashes;
+        if (schema->attributes[c].type == TYPE_CHAR) {
+          hashes = realloc(values[c].hashes, allocated * sizeof(uint64_t));
+          if (hashes != NULL) {
+            values[c].hashes = hashes;
+          }
+        }
+        result = positions == NULL || (schema->attributes[c].type == TYPE_CHAR && hashes == NULL) ? -1 : 0;
+      }
+      if (result == -1) {
+        break;
+      }
+    }
+    append_batch(batch, values, rows);
+    rows += n;
+  }
+  if (n == -1) {
+    result = -1;
+  }
+
+  if (result == 0) {
+    stats->row_count = rows;
+    for (int c = 0; c < schema->count; c++) {
+      build_column(&stats->columns[c], &schema->attributes[c], &values[c], rows);
+    }
+  }
+  for (int c = 0; c < schema->count; c++) {
+    free(values[c].positions);
+    free(values[c].hashes);
+  }
+  exec_close(scan);
+  return result;
+}
+
+int bplus_analyze(const int file_desc, const BPlusMeta *metadata, BPlusTableStats *stats)
+{
+  return bplus_analyze_scan(exec_bplus_scan(file_desc, metadata), metadata->data_block_count, stats);
+}
+
+// ποσοστο των γραμμων με τιμη < x, με γραμμικη παρεμβολη μεσα στο bucket
+static double fraction_below(const BPlusColumnStats *column, const double x)
+{
+  const int buckets = column->bucket_count;
+  if (buckets == 0 || x <= column->bounds[0]) {
+    return 0;
+  }
+  if (x > column->bounds[buckets]) {
+    return 1;
+  }
+  double below = 0;
+  for (int b = 0; b < buckets; b++) {
+    const double lo = column->bounds[b];
+    const double hi = column->bounds[b + 1];
+    if (x > hi) {
+      below += 1;
+    } else {
+      if (x > lo && hi > lo) {
+        below += (x - lo) / (hi - lo);
+      }
+      break;
+    }
+  }
+  return below / buckets;
+}
+
+// Τιμες που γεμιζουν ολοκληρα buckets (lo == hi) ειναι οι συχνες και παιρνουν
+// το μεριδιο των buckets τους. Οι υπολοιπες μοιραζονται ισα το bucket τους.
+static double fraction_equal(const BPlusColumnStats *column, const double x)
+{
+  const int buckets = column->bucket_count;
+  if (buckets == 0 || x < column->min || x > column->max) {
+    return 0;
+  }
+  int x_buckets = 0;
+  int bucket = -1;
+  for (int b = 0; b < buckets; b++) {
+    const double lo = column->bounds[b];
+    const double hi = column->bounds[b + 1];
+    if (lo == hi) {
+      x_buckets += lo == x;
+    } else if (bucket == -1 && lo <= x && x <= hi) {
+      bucket = b;
+    }
+  }
+  if (x_buckets > 0) {
+    return (double)x_buckets / buckets;
+  }
+  return bucket != -1 ? 1.0 / buckets / column->bucket_distinct[bucket] : 0;
+}
+
+double bplus_stats_selectivity(const BPlusTableStats *stats, const int column, const ExecCompare compare,
+                               const FieldValue *value)
+{
+  const BPlusColumnStats *c = &stats->columns[column];
+  const double x = bplus_stats_position(&stats->schema.attributes[column], value);
+  const double equal = fraction_equal(c, x);
+  const double below = fraction_below(c, x);
+  double selectivity;
+  switch (compare) {
+    case EXEC_EQ: selectivity = equal; break;
+    case EXEC_NE: selectivity = 1 - equal; break;
+    case EXEC_LT: selectivity = below; break;
+    case EXEC_LE: selectivity = below + equal; break;
+    case EXEC_GT: selectivity = 1 - below - equal; break;
+    default: selectivity = 1 - below; break;
+  }
+  return selectivity < 0 ? 0 : selectivity > 1 ? 1 : selectivity;
+}
+
+void bplus_stats_print(const BPlusTableStats *stats)
+{
+  printf("Statistics: %ld rows in %d pages\n", stats->row_count, stats->page_count);
+  for (int c = 0; c < stats->schema.count; c++) {
+    const BPlusColumnStats *column = &stats->columns[c];
+    printf("  %-12s distinct %-8ld min %-14.6g max %-14.6g buckets %d\n", stats->schema.attributes[c].name,
+           column->distinct_count, column->min, column->max, column->bucket_count);
+  }
+}
@@ -1,171 +1,294 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdarg.h>
-
-#include "record.h"
-
-void schema_init(TableSchema *schema, const AttributeSchema *attrs, const int attribute_count, const char *key_attr_name) {
-    schema->count = attribute_count < MAX_ATTRIBUTES ? attribute_count : MAX_ATTRIBUTES;
-    schema->key_index = -1;
-    schema->record_size = 0;
-    // Calculate offsets and copy attributes
-    for (int i = 0; i < schema->count; i++) {
-        schema->attributes[i] = attrs[i];
-        // Set current offset for this attribute
-        schema->offsets[i] = schema->record_size;
-        // Calculate size for this attribute and advance record size
-        switch (attrs[i].type) {
-            case TYPE_INT:
-                schema->record_size += sizeof(int);
-                break;
-            case TYPE_FLOAT:
-                schema->record_size += sizeof(float);
-                break;
-            case TYPE_CHAR:
-                schema->record_size += attrs[i].length;
-                break;
-            default:
-                break;
-        }
-        // Assign primary key if name matches
-        if (strcmp(attrs[i].name, key_attr_name) == 0) {
-            schema->key_index = i;
-        }
-    }
-    if (schema->key_index == -1) {
-        printf("Warning: Key attribute '%s' not found in schema!\n", key_attr_name);
-    }
-}
-
-void record_create(const TableSchema *schema, Record* record, ...) {
-    va_list args;
-    va_start(args, record);
-    for (int i = 0; i < schema->count; i++) {
-        const AttributeSchema *attr = &schema->attributes[i];
-
-        switch (attr->type) {
-            case TYPE_INT:
-                record->values[i].int_value = va_arg(args, int);
-                break;
-            case TYPE_FLOAT:
-                record->values[i].float_value = (float)va_arg(args, double);
-                break;
-            case TYPE_CHAR: {
-                const char *str = va_arg(args, char *);
-                strncpy(record->values[i].string_value, str, attr->length);
-                record->values[i].string_value[attr->length] = '\0';
-                break;
-            }
-            default: break;
-        }
-    }
-    va_end(args);
-}
-
-
-int record_get_key(const TableSchema *schema, const Record *record) {
-    if (schema->key_index < 0) {
-        printf("Error: No primary key defined in schema!\n");
-        return -1;
-    }
-
-    if (schema->attributes[schema->key_index].type != TYPE_INT) {
-        printf("Error: Primary key must be of type INT!\n");
-        return -1;
-    }
-
-    return record->values[schema->key_index].int_value;
-}
-
-void schema_print(const TableSchema *schema){
-    printf("Table Schema:\n");
-    printf("  Attribute count: %d\n", schema->count);
-    for (int i = 0; i < schema->count; i++) {
-        const AttributeSchema *attr = &schema->attributes[i];
-        printf("  %s ", attr->name);
-        switch (attr->type) {
-            case TYPE_INT:
-                printf("INT");
-                break;
-            case TYPE_FLOAT:
-                printf("FLOAT");
-                break;
-            case TYPE_CHAR:
-                printf("CHAR(%d)", attr->length);
-                break;
-            default:
-                printf("UNKNOWN");
-                break;
-        }
-        if (i == schema->key_index) {
-            printf(" PRIMARY KEY");
-        }
-        printf("\n");
-    }
-}
-
-void record_print(const TableSchema *schema, const Record *record) {
-    printf("(");
-    for (int i = 0; i < schema->count; i++) {
-        const AttributeSchema *attr = &schema->attributes[i];
-        switch (attr->type) {
-            case TYPE_INT:
-                printf("%d", record->values[i].int_value);
-                break;
-            case TYPE_FLOAT:
-                printf("%.2f", record->values[i].float_value);
-                break;
-            case TYPE_CHAR:
-                printf("%s", record->values[i].string_value);
-                break;
-            default:
-                printf("NULL");
-                break;
-        }
-        if (i < schema->count - 1) printf(", ");
-    }
-    printf(")\n");
-}
-
-DataType get_type(const TableSchema *schema, const char *attr_name) {
-    for (int i = 0; i < schema->count; i++) {
-        if (strcmp(schema->attributes[i].name, attr_name) == 0) {
-            const AttributeSchema *attr = &schema->attributes[i];
-            switch (attr->type) {
-                case TYPE_INT:
-                    return TYPE_INT; // Success
-                case TYPE_FLOAT:
-                    return TYPE_FLOAT; // Success
-                case TYPE_CHAR:
-                    return TYPE_CHAR;
-                default:
-                    return TYPE_NULL;
-            }
-        }
-    }
-    return TYPE_NULL; // Attribute not found
-}
-
-DataType record_get_value(const TableSchema *schema, const Record *record, const char *attr_name, char *output) {
-    for (int i = 0; i < schema->count; i++) {
-        if (strcmp(schema->attributes[i].name, attr_name) == 0) {
-            const AttributeSchema *attr = &schema->attributes[i];
-
-
-            switch (attr->type) {
-                case TYPE_INT: {
-                    *(int *) output = record->values[i].int_value;
-                    return TYPE_INT; // Success
-                }case TYPE_FLOAT: {
-                    *(float *) output = record->values[i].float_value;
-                    return TYPE_FLOAT; // Success
-                }case TYPE_CHAR: {
-                    memcpy(output, record->values[i].string_value, attr->length);
-                    return TYPE_CHAR; // Success
-                }
-                default: return TYPE_NULL;
-            }
-        }
-    }
-    return TYPE_NULL; // Attribute not found
-}
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "record.h"
+
+void schema_init(TableSchema *schema, const AttributeSchema *attrs, const int attribute_count, const char *key_attr_name) {
+    schema->count = attribute_count < MAX_ATTRIBUTES ? attribute_count : MAX_ATTRIBUTES;
+    schema->key_index = -1;
+    schema->record_size = 0;
+    // Calculate offsets and copy attributes
+    for (int i = 0; i < schema->count; i++) {
+        schema->attributes[i] = attrs[i];
+        // Set current offset for this attribute
+        schema->offsets[i] = schema->record_size;
+        // Calculate size for this attribute and advance record size
+        switch (attrs[i].type) {
+            case TYPE_INT:
+                schema->record_size += sizeof(int);
+                break;
+            case TYPE_FLOAT:
+                schema->record_size += sizeof(float);
+                break;
+            case TYPE_CHAR:
+                schema->record_size += attrs[i].length;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Key attributes come as a comma separated list, in key order
+    schema->key_attr_count = 0;
+    schema->key_size = 0;
+    const char *name = key_attr_name;
+    while (*name != '\0' && schema->key_attr_count < MAX_ATTRIBUTES) {
+        const size_t length = strcspn(name, ",");
+        int found = -1;
+        for (int i = 0; i < schema->count; i++) {
+            if (strlen(schema->attributes[i].name) == length &&
+                strncmp(schema->attributes[i].name, name, length) == 0) {
+                found = i;
+                break;
+            }
+        }
+        if (found == -1) {
+            printf("Warning: Key attribute '%.*s' not found in schema!\n", (int)length, name);
+        } else {
+            schema->key_indexes[schema->key_attr_count++] = found;
+            schema->key_size += schema->attributes[found].type == TYPE_CHAR
+                                    ? schema->attributes[found].length
+                                    : (int)sizeof(int);
+        }
+        name += length;
+        if (*name == ',') name++;
+    }
+
+    // Assign primary key (the first key attribute)
+    if (schema->key_attr_count > 0) {
+        schema->key_index = schema->key_indexes[0];
+    }
+    // Normalized keys always have at least a full 4-byte head
+    if (schema->key_size < (int)sizeof(int)) {
+        schema->key_size = sizeof(int);
+    }
+}
+
+void record_create(const TableSchema *schema, Record* record, ...) {
+    va_list args;
+    va_start(args, record);
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+
+        switch (attr->type) {
+            case TYPE_INT:
+                record->values[i].int_value = va_arg(args, int);
+                break;
+            case TYPE_FLOAT:
+                record->values[i].float_value = (float)va_arg(args, double);
+                break;
+            case TYPE_CHAR: {
+                const char *str = va_arg(args, char *);
+                strncpy(record->values[i].string_value, str, attr->length);
+                record->values[i].string_value[attr->length] = '\0';
+                break;
+            }
+            default: break;
+        }
+    }
+    va_end(args);
+}
+
+
+int record_get_key(const TableSchema *schema, const Record *record) {
+    if (schema->key_index < 0) {
+        printf("Error: No primary key defined in schema!\n");
+        return -1;
+    }
+
+    if (schema->key_attr_count != 1 || schema->attributes[schema->key_index].type != TYPE_INT) {
+        printf("Error: Primary key must be of type INT!\n");
+        return -1;
+    }
+
+    return record->values[schema->key_index].int_value;
+}
+
+void schema_print(const TableSchema *schema){
+    printf("Table Schema:\n");
+    printf("  Attribute count: %d\n", schema->count);
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+        printf("  %s ", attr->name);
+        switch (attr->type) {
+            case TYPE_INT:
+                printf("INT");
+                break;
+            case TYPE_FLOAT:
+                printf("FLOAT");
+                break;
+            case TYPE_CHAR:
+                printf("CHAR(%d)", attr->length);
+                break;
+            default:
+                printf("UNKNOWN");
+                break;
+        }
+        for (int k = 0; k < schema->key_attr_count; k++) {
+            if (schema->key_indexes[k] == i) {
+                printf(" PRIMARY KEY");
+                if (schema->key_attr_count > 1) printf(" (%d)", k + 1);
+            }
+        }
+        printf("\n");
+    }
+}
+
+void record_print(const TableSchema *schema, const Record *record) {
+    printf("(");
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+        switch (attr->type) {
+            case TYPE_INT:
+                printf("%d", record->values[i].int_value);
+                break;
+            case TYPE_FLOAT:
+                printf("%.2f", record->values[i].float_value);
+                break;
+            case TYPE_CHAR:
+                // a string of MAX_STRING_LENGTH bytes has no NUL
+                printf("%.*s", MAX_STRING_LENGTH, record->values[i].string_value);
+                break;
+            default:
+                printf("NULL");
+                break;
+        }
+        if (i < schema->count - 1) printf(", ");
+    }
+    printf(")\n");
+}
+
+int schema_attribute_index(const TableSchema *schema, const char *attr_name) {
+    for (int i = 0; i < schema->count; i++) {
+        if (strcmp(schema->attributes[i].name, attr_name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+DataType get_type(const TableSchema *schema, const char *attr_name) {
+    const int i = schema_attribute_index(schema, attr_name);
+    if (i == -1) {
+        return TYPE_NULL; // Attribute not found
+    }
+    switch (schema->attributes[i].type) {
+        case TYPE_INT:
+            return TYPE_INT; // Success
+        case TYPE_FLOAT:
+            return TYPE_FLOAT; // Success
+        case TYPE_CHAR:
+            return TYPE_CHAR;
+        default:
+            return TYPE_NULL;
+    }
+}
+
+DataType record_get_value(const TableSchema *schema, const Record *record, const char *attr_name, char *output) {
+    const int i = schema_attribute_index(schema, attr_name);
+    if (i == -1) {
+        return TYPE_NULL; // Attribute not found
+    }
+    const AttributeSchema *attr = &schema->attributes[i];
+    switch (attr->type) {
+        case TYPE_INT: {
+            *(int *) output = record->values[i].int_value;
+            return TYPE_INT; // Success
+        }case TYPE_FLOAT: {
+            *(float *) output = record->values[i].float_value;
+            return TYPE_FLOAT; // Success
+        }case TYPE_CHAR: {
+            memcpy(output, record->values[i].string_value, attr->length);
+            return TYPE_CHAR; // Success
+        }
+        default: return TYPE_NULL;
+    }
+}
+
+
+void record_serialize(const TableSchema *schema, const Record *record, char *out) {
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+        char *field = out + schema->offsets[i];
+        switch (attr->type) {
+            case TYPE_INT:
+                memcpy(field, &record->values[i].int_value, sizeof(int));
+                break;
+            case TYPE_FLOAT:
+                memcpy(field, &record->values[i].float_value, sizeof(float));
+                break;
+            case TYPE_CHAR:
+                // strncpy pads with zeros, so equal strings give equal bytes
+                strncpy(field, record->values[i].string_value, attr->length);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void record_deserialize(const TableSchema *schema, const char *packed, Record *record) {
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+        const char *field = packed + schema->offsets[i];
+        switch (attr->type) {
+            case TYPE_INT:
+                memcpy(&record->values[i].int_value, field, sizeof(int));
+                break;
+            case TYPE_FLOAT:
+                memcpy(&record->values[i].float_value, field, sizeof(float));
+                break;
+            case TYPE_CHAR: {
+                const int length = attr->length < MAX_STRING_LENGTH ? attr->length : MAX_STRING_LENGTH;
+                memcpy(record->values[i].string_value, field, length);
+                if (length < MAX_STRING_LENGTH) {
+                    record->values[i].string_value[length] = '\0';
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+const char *record_field(const TableSchema *schema, const char *packed, const int attr_index) {
+    return packed + schema->offsets[attr_index];
+}
+
+int record_field_int(const TableSchema *schema, const char *packed, const int attr_index) {
+    int value;
+    memcpy(&value, packed + schema->offsets[attr_index], sizeof(int));
+    return value;
+}
+
+float record_field_float(const TableSchema *schema, const char *packed, const int attr_index) {
+    float value;
+    memcpy(&value, packed + schema->offsets[attr_index], sizeof(float));
+    return value;
+}
+
+void record_print_packed(const TableSchema *schema, const char *packed) {
+    printf("(");
+    for (int i = 0; i < schema->count; i++) {
+        const AttributeSchema *attr = &schema->attributes[i];
+        switch (attr->type) {
+            case TYPE_INT:
+                printf("%d", record_field_int(schema, packed, i));
+                break;
+            case TYPE_FLOAT:
+                printf("%.2f", record_field_float(schema, packed, i));
+                break;
+            case TYPE_CHAR:
+                // the field is not NUL-terminated when the string fills it
+                printf("%.*s", attr->length, record_field(schema, packed, i));
+                break;
+            default:
+                printf("NULL");
+                break;
+        }
+        if (i < schema->count - 1) printf(", ");
+    }
+    printf(")\n");
+}
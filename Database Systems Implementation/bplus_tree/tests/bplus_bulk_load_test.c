@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_bulk_load.h"
+#include "bplus_csv.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 20000 // Records of the largest load
+#define CSV_SORTED 3000     // Ascending rows of the CSV load
+#define CSV_UNSORTED 1000   // Descending rows after them
+#define FILE_NAME "test_bulk_load.db"
+#define CSV_NAME "test_bulk_load.csv"
+
+/**
+ * Bulk loads keys 3i + 1 for i < n into a new file and checks the tree, the
+ * fill of its leaves, a few inserts and deletes after the load, and a reopen.
+ */
+static void check_load(const TableSchema *schema, const int n, const int filter_bits)
+{
+  remove(FILE_NAME);
+  bplus_create_file(schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    CHECK(0, "cannot open %s", FILE_NAME);
+    return;
+  }
+  if (filter_bits > 0) {
+    bplus_filter_enable(file_desc, info, filter_bits);
+  }
+
+  // ===== Load =====
+  BPlusBulkLoader *loader = bplus_bulk_load_create(file_desc, info);
+  CHECK(loader != NULL, "n %d: loader not created", n);
+  if (loader == NULL) {
+    bplus_close_file(file_desc, info);
+    return;
+  }
+  Record record;
+  for (int i = 0; i < n; i++) {
+    employee_record(schema, &record, 3 * i + 1, (unsigned long long)i);
+    CHECK(bplus_bulk_load_add(loader, &record) == 0, "n %d: add of key %d", n, 3 * i + 1);
+    // a key that is not above the last one is refused
+    CHECK(bplus_bulk_load_add(loader, &record) == 1, "n %d: repeated key %d added", n, 3 * i + 1);
+  }
+  CHECK(bplus_bulk_load_finish(loader) == n, "n %d: finish", n);
+
+  TreeShape shape;
+  CHECK(tree_check(file_desc, info, &shape) == 0, "n %d: tree invariants", n);
+  CHECK(shape.records == n, "n %d: %ld records", n, shape.records);
+  // every leaf but the last two is full
+  const int capacity = info->leaf_capacity;
+  const int expected = n == 0 ? 0 : (n + capacity - 1) / capacity;
+  CHECK(shape.leaves == expected, "n %d: %d leaves, expected %d", n, shape.leaves, expected);
+  CHECK(shape.free_blocks == 0, "n %d: %d unused blocks", n, shape.free_blocks);
+
+  int missing = 0;
+  for (int i = 0; i < n; i++) {
+    Record *found;
+    if (bplus_record_find(file_desc, info, 3 * i + 1, &found) != 0 || found->values[0].int_value != 3 * i + 1) {
+      missing++;
+    }
+    free(found);
+  }
+  CHECK(missing == 0, "n %d: %d loaded keys not found", n, missing);
+  printf("n %5d  filter %2d  depth %d  leaves %4d  index %3d  leaf fill %.2f\n", n, filter_bits, info->depth,
+         shape.leaves, shape.index_nodes, shape.leaf_fill);
+
+  // ===== Changes after the load =====
+  for (int i = 0; i < n; i += 5) {
+    employee_record(schema, &record, 3 * i + 2, 0);
+    CHECK(bplus_record_insert(file_desc, info, &record) > 0, "n %d: insert of key %d", n, 3 * i + 2);
+  }
+  for (int i = 0; i < n; i += 2) {
+    CHECK(bplus_record_delete(file_desc, info, 3 * i + 1) == 0, "n %d: delete of key %d", n, 3 * i + 1);
+  }
+  const long changed = (n + 4) / 5 + n / 2;
+  CHECK(tree_check(file_desc, info, &shape) == 0, "n %d: tree invariants after changes", n);
+  CHECK(shape.records == changed, "n %d: %ld records after changes, expected %ld", n, shape.records, changed);
+
+  // ===== Reopen =====
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  BF_Init(LRU);
+  bplus_open_file(FILE_NAME, &file_desc, &info);
+  CHECK(tree_check(file_desc, info, &shape) == 0, "n %d: tree invariants after reopen", n);
+  CHECK(shape.records == changed, "n %d: %ld records after reopen", n, shape.records);
+
+  // a file that is not empty is refused
+  if (changed > 0) {
+    loader = bplus_bulk_load_create(file_desc, info);
+    CHECK(loader == NULL, "n %d: loader created on a file that is not empty", n);
+  }
+  bplus_close_file(file_desc, info);
+  remove(FILE_NAME);
+}
+
+/**
+ * Loads a CSV file that starts in key order, with a repeated key, and goes
+ * on out of order with keys that are already in the file.
+ */
+static void check_csv(const TableSchema *schema)
+{
+  FILE *csv = fopen(CSV_NAME, "w");
+  if (csv == NULL) {
+    CHECK(0, "cannot create %s", CSV_NAME);
+    return;
+  }
+  fprintf(csv, "id,name,surname,city\n");
+  long rows = 0;
+  for (int key = 1; key <= CSV_SORTED; key++, rows++) {
+    fprintf(csv, "%d,name%d,surname,city\n", key, key);
+    if (key == CSV_SORTED / 2) {
+      fprintf(csv, "%d,again,surname,city\n", key);
+      rows++;
+    }
+  }
+  for (int key = 2 * CSV_SORTED + CSV_UNSORTED; key >= 2 * CSV_SORTED; key--, rows++) {
+    fprintf(csv, "%d,name%d,surname,city\n", key, key);
+  }
+  fprintf(csv, "1,again,surname,city\n");
+  rows++;
+  fclose(csv);
+
+  remove(FILE_NAME);
+  bplus_create_file(schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    CHECK(0, "cannot open %s", FILE_NAME);
+    return;
+  }
+  BPlusCsvOptions options;
+  bplus_csv_options_default(&options);
+  options.header = 1;
+  const long loaded = bplus_csv_load(CSV_NAME, file_desc, info, &options);
+  CHECK(loaded == rows, "csv: %ld rows read, expected %ld", loaded, rows);
+
+  TreeShape shape;
+  const long records = CSV_SORTED + CSV_UNSORTED + 1;
+  CHECK(tree_check(file_desc, info, &shape) == 0, "csv: tree invariants");
+  CHECK(shape.records == records, "csv: %ld records, expected %ld", shape.records, records);
+  // the first row of a repeated key is kept
+  Record *found = NULL;
+  CHECK(bplus_record_find(file_desc, info, CSV_SORTED / 2, &found) == 0 &&
+        strcmp(found->values[1].string_value, "again") != 0, "csv: repeated key replaced");
+  free(found);
+  found = NULL;
+  CHECK(bplus_record_find(file_desc, info, 1, &found) == 0 && strcmp(found->values[1].string_value, "again") != 0,
+        "csv: loaded key replaced");
+  free(found);
+  printf("csv      records %5ld  depth %d  leaves %4d  index %3d  leaf fill %.2f\n", shape.records, info->depth,
+         shape.leaves, shape.index_nodes, shape.leaf_fill);
+
+  bplus_close_file(file_desc, info);
+  remove(FILE_NAME);
+  remove(CSV_NAME);
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  const int sizes[] = {0, 1, 3, 7, 8, 10, 49, 50, 57, 1000, RECORDS_NUM};
+
+  BF_Init(LRU);
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    check_load(&schema, sizes[i], 0);
+  }
+  check_load(&schema, RECORDS_NUM, 10);
+  check_csv(&schema);
+  BF_Close();
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 20000 // Records inserted, deleted in part and inserted again
+#define DELETE_NUM 14000  // Records deleted in the second phase
+#define FILE_NAME "test_churn.db"
+
+/**
+ * Checks the tree and prints its shape after a phase.
+ */
+static void check_phase(const char *phase, int file_desc, BPlusMeta *info, long records, TreeShape *shape)
+{
+  CHECK(tree_check(file_desc, info, shape) == 0, "%s: tree invariants", phase);
+  CHECK(shape->records == records, "%s: %ld records, expected %ld", phase, shape->records, records);
+  printf("%-8s records %6ld  depth %d  leaves %5d  index %4d  free %5d  blocks %5d  leaf fill %.2f\n", phase,
+         shape->records, info->depth, shape->leaves, shape->index_nodes, shape->free_blocks, shape->blocks,
+         shape->leaf_fill);
+}
+
+/**
+ * Checks that exactly the keys marked present can be found.
+ */
+static void check_keys(const char *phase, int file_desc, BPlusMeta *info, const int *keys, const char *present)
+{
+  int wrong = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    Record *record;
+    const int found = bplus_record_find(file_desc, info, keys[i], &record) == 0;
+    if (found != present[i]) {
+      wrong++;
+    }
+    free(record);
+  }
+  CHECK(wrong == 0, "%s: %d keys found when deleted or missing when inserted", phase, wrong);
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  int keys[RECORDS_NUM];
+  char present[RECORDS_NUM];
+  TreeShape shape;
+
+  // Distinct keys in random order
+  srand(42);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    keys[i] = 3 * i + 1;
+  }
+  for (int i = RECORDS_NUM - 1; i > 0; i--) {
+    const int j = rand() % (i + 1);
+    const int key = keys[i];
+    keys[i] = keys[j];
+    keys[j] = key;
+  }
+
+  BF_Init(LRU);
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    return 1;
+  }
+
+  // ===== Insert =====
+  Record record;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    employee_record(&schema, &record, keys[i], (unsigned long long)rand());
+    CHECK(bplus_record_insert(file_desc, info, &record) > 0, "insert of key %d", keys[i]);
+    present[i] = 1;
+  }
+  check_phase("insert", file_desc, info, RECORDS_NUM, &shape);
+  check_keys("insert", file_desc, info, keys, present);
+  const int inserted_depth = info->depth;
+
+  // ===== Delete random keys =====
+  for (int i = 0; i < DELETE_NUM; i++) {
+    int victim;
+    do {
+      victim = rand() % RECORDS_NUM;
+    } while (!present[victim]);
+    CHECK(bplus_record_delete(file_desc, info, keys[victim]) == 0, "delete of key %d", keys[victim]);
+    present[victim] = 0;
+  }
+  CHECK(bplus_record_delete(file_desc, info, 0) == -1, "delete of a missing key succeeded");
+  check_phase("delete", file_desc, info, RECORDS_NUM - DELETE_NUM, &shape);
+  check_keys("delete", file_desc, info, keys, present);
+  CHECK(info->depth <= inserted_depth, "depth grew from %d to %d on deletes", inserted_depth, info->depth);
+  CHECK(shape.free_blocks > 0, "merges freed no blocks");
+  const int deleted_blocks = shape.blocks;
+  const int deleted_free = shape.free_blocks;
+
+  // ===== Reinsert =====
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    if (!present[i]) {
+      employee_record(&schema, &record, keys[i], (unsigned long long)rand());
+      CHECK(bplus_record_insert(file_desc, info, &record) > 0, "reinsert of key %d", keys[i]);
+      present[i] = 1;
+    }
+  }
+  check_phase("reinsert", file_desc, info, RECORDS_NUM, &shape);
+  check_keys("reinsert", file_desc, info, keys, present);
+  // The freed blocks are taken before the file grows
+  CHECK(shape.blocks == deleted_blocks || shape.free_blocks == 0,
+        "file grew by %d blocks with %d of %d freed blocks still unused", shape.blocks - deleted_blocks,
+        shape.free_blocks, deleted_free);
+  CHECK(shape.free_blocks < deleted_free, "reinserts reused no freed block");
+
+  // ===== Reopen =====
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  BF_Init(LRU);
+  bplus_open_file(FILE_NAME, &file_desc, &info);
+  check_phase("reopen", file_desc, info, RECORDS_NUM, &shape);
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  remove(FILE_NAME);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
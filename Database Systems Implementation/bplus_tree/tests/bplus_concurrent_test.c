@@ -0,0 +1,132 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_concurrent.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define THREADS 8             // Threads inserting at the same time
+#define RECORDS_PER_THREAD 5000
+#define RECORDS_NUM (THREADS * RECORDS_PER_THREAD)
+#define FILE_NAME "test_concurrent.db"
+
+typedef struct {
+  BPlusSharedTree *tree;
+  const int *keys;  // RECORDS_PER_THREAD keys of this thread only
+  int errors;       // calls that returned something unexpected
+} Worker;
+
+/**
+ * Inserts the thread's keys, reads each one back right away and checks
+ * that a second insert of an earlier key is refused as a duplicate.
+ */
+static void *worker_run(void *argument)
+{
+  Worker *worker = argument;
+  const TableSchema schema = employee_get_schema();
+  Record record, found;
+
+  for (int i = 0; i < RECORDS_PER_THREAD; i++) {
+    employee_record(&schema, &record, worker->keys[i], (unsigned long long)worker->keys[i] * 2654435761u);
+    if (bplus_shared_insert(worker->tree, &record) <= 0) {
+      worker->errors++;
+    }
+    if (bplus_shared_find(worker->tree, worker->keys[i], &found) != 0 ||
+        record_get_key(&schema, &found) != worker->keys[i]) {
+      worker->errors++;
+    }
+    if (i % 16 == 0 && bplus_shared_insert(worker->tree, &record) != -1) {
+      worker->errors++;
+    }
+  }
+  return NULL;
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  static int keys[RECORDS_NUM];
+
+  // Thread t gets the keys equal to t modulo THREADS, in random order
+  srand(42);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    keys[i] = i;
+  }
+  for (int i = RECORDS_NUM - 1; i > 0; i--) {
+    const int j = rand() % (i + 1);
+    const int key = keys[i];
+    keys[i] = keys[j];
+    keys[j] = key;
+  }
+  static int thread_keys[THREADS][RECORDS_PER_THREAD];
+  int filled[THREADS] = {0};
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    const int t = keys[i] % THREADS;
+    thread_keys[t][filled[t]++] = keys[i];
+  }
+
+  BF_Init(LRU);
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    return 1;
+  }
+
+  // ===== 8 threads insert and find =====
+  BPlusSharedTree *tree = bplus_shared_open(file_desc, info);
+  CHECK(tree != NULL, "bplus_shared_open");
+  if (tree == NULL) {
+    return 1;
+  }
+  pthread_t threads[THREADS];
+  Worker workers[THREADS];
+  for (int t = 0; t < THREADS; t++) {
+    workers[t] = (Worker){tree, thread_keys[t], 0};
+    pthread_create(&threads[t], NULL, worker_run, &workers[t]);
+  }
+  for (int t = 0; t < THREADS; t++) {
+    pthread_join(threads[t], NULL);
+    CHECK(workers[t].errors == 0, "thread %d: %d failed inserts or finds", t, workers[t].errors);
+  }
+
+  // every key is visible to the shared handle, and nothing else is
+  Record found;
+  int missing = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    missing += bplus_shared_find(tree, i, &found) != 0;
+  }
+  CHECK(missing == 0, "%d keys lost", missing);
+  CHECK(bplus_shared_find(tree, RECORDS_NUM, &found) == -1, "found a key never inserted");
+  printf("threads %d  records %d  restarts %ld\n", THREADS, RECORDS_NUM, bplus_shared_restarts(tree));
+  bplus_shared_close(tree);
+
+  // ===== Single threaded view, before and after reopening =====
+  for (int pass = 0; pass < 2; pass++) {
+    TreeShape shape;
+    CHECK(tree_check(file_desc, info, &shape) == 0, "tree invariants (pass %d)", pass);
+    CHECK(shape.records == RECORDS_NUM, "%ld records, expected %d (pass %d)", shape.records, RECORDS_NUM, pass);
+    missing = 0;
+    for (int i = 0; i < RECORDS_NUM; i++) {
+      Record *record;
+      missing += bplus_record_find(file_desc, info, i, &record) != 0;
+      free(record);
+    }
+    CHECK(missing == 0, "%d keys lost (pass %d)", missing, pass);
+
+    bplus_close_file(file_desc, info);
+    BF_Close();
+    BF_Init(LRU);
+    bplus_open_file(FILE_NAME, &file_desc, &info);
+  }
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  remove(FILE_NAME);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
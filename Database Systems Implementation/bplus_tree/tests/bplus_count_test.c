@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_concurrent.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 20000  // Records inserted first
+#define DELETE_NUM 8000    // Of them deleted next
+#define SHARED_NUM 3000    // Records inserted through a bplus_shared_* handle
+#define KEY_RANGE 100000   // Keys are drawn from [0, KEY_RANGE)
+#define QUERIES 2000       // Random count_range queries per phase
+#define FILE_NAME "test_count.db"
+
+/**
+ * Position of the first key >= key in the sorted keys.
+ */
+static long lower_bound(const int *keys, long n, int key)
+{
+  long low = 0, high = n;
+  while (low < high) {
+    const long middle = (low + high) / 2;
+    if (keys[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/**
+ * Checks bplus_count_range and bplus_select_kth against the keys read
+ * along the leaf chain.
+ */
+static void check_phase(const char *phase, int file_desc, BPlusMeta *info)
+{
+  const TableSchema *schema = &info->table_schema;
+  long n;
+  Record *records = tree_leaf_records(file_desc, info, &n);
+  int *keys = malloc((n + 1) * sizeof(int));
+  for (long i = 0; i < n; i++) {
+    keys[i] = record_get_key(schema, &records[i]);
+  }
+  free(records);
+
+  // count_range: random ranges, single keys, empty and reversed ranges
+  int wrong = 0;
+  for (int q = 0; q < QUERIES; q++) {
+    int lo = rand() % (KEY_RANGE + 100) - 50;
+    int hi = q % 4 == 0 ? lo : lo + rand() % (q % 2 == 0 ? 50 : KEY_RANGE);
+    if (q % 10 == 0) {
+      const int swap = lo;
+      lo = hi + 1;
+      hi = swap;
+    }
+    const long expected = lo > hi ? 0 : lower_bound(keys, n, hi + 1) - lower_bound(keys, n, lo);
+    if (bplus_count_range(file_desc, info, lo, hi) != expected) {
+      wrong++;
+    }
+  }
+  CHECK(wrong == 0, "%s: %d of %d count_range results differ from a leaf scan", phase, wrong, QUERIES);
+  CHECK(bplus_count_range(file_desc, info, 0, KEY_RANGE) == n, "%s: count of the whole key range", phase);
+
+  // select_kth: every rank, and the ranks just outside
+  wrong = 0;
+  Record record;
+  for (long k = 1; k <= n; k++) {
+    if (bplus_select_kth(file_desc, info, (int)k, &record) != 0 || record_get_key(schema, &record) != keys[k - 1]) {
+      wrong++;
+    }
+  }
+  CHECK(wrong == 0, "%s: %d of %ld select_kth results differ from a leaf scan", phase, wrong, n);
+  CHECK(bplus_select_kth(file_desc, info, 0, &record) == -1, "%s: select_kth(0) succeeded", phase);
+  CHECK(bplus_select_kth(file_desc, info, (int)n + 1, &record) == -1, "%s: select_kth(n + 1) succeeded", phase);
+
+  // after the queries the subtree counts are exact again
+  CHECK(!info->counts_stale, "%s: counts still stale", phase);
+  CHECK(tree_check(file_desc, info, NULL) == 0, "%s: tree invariants", phase);
+  printf("%-7s %6ld records checked\n", phase, n);
+  free(keys);
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  static char present[KEY_RANGE];
+  Record record;
+
+  BF_Init(LRU);
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    return 1;
+  }
+  srand(42);
+
+  // ===== After inserts =====
+  for (int inserted = 0; inserted < RECORDS_NUM;) {
+    const int key = rand() % KEY_RANGE;
+    if (!present[key]) {
+      employee_record(&schema, &record, key, (unsigned long long)rand());
+      CHECK(bplus_record_insert(file_desc, info, &record) > 0, "insert of key %d", key);
+      present[key] = 1;
+      inserted++;
+    }
+  }
+  check_phase("insert", file_desc, info);
+
+  // ===== After deletes =====
+  for (int deleted = 0; deleted < DELETE_NUM;) {
+    const int key = rand() % KEY_RANGE;
+    if (present[key]) {
+      CHECK(bplus_record_delete(file_desc, info, key) == 0, "delete of key %d", key);
+      present[key] = 0;
+      deleted++;
+    }
+  }
+  check_phase("delete", file_desc, info);
+
+  // ===== After a shared session, whose writers leave the counts stale =====
+  BPlusSharedTree *tree = bplus_shared_open(file_desc, info);
+  for (int inserted = 0; tree != NULL && inserted < SHARED_NUM;) {
+    const int key = rand() % KEY_RANGE;
+    if (!present[key]) {
+      employee_record(&schema, &record, key, (unsigned long long)rand());
+      CHECK(bplus_shared_insert(tree, &record) > 0, "shared insert of key %d", key);
+      present[key] = 1;
+      inserted++;
+    }
+  }
+  bplus_shared_close(tree);
+  CHECK(info->counts_stale, "a shared session left the counts valid");
+  check_phase("shared", file_desc, info);
+
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  remove(FILE_NAME);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
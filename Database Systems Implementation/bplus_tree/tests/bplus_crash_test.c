@@ -0,0 +1,182 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bf.h"
+#include "bplus_block.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 60000  // Committed inserts; the log passes WAL_CHECKPOINT_BYTES on the way
+#define UNCOMMITTED_NUM 10 // Inserts and deletes of the operation that never commits
+#define SYNC_EVERY 1000    // Inserts between the progress reports of the killed child
+#define KILL_AFTER 20      // Progress reports before the child is killed
+#define FILE_NAME "test_crash.db"
+
+static int keys[RECORDS_NUM];
+
+/**
+ * Creates the file, opens it and inserts keys[0..count) one operation each.
+ */
+static int insert_keys(int count, int report_fd, BPlusMeta **info)
+{
+  const TableSchema schema = employee_get_schema();
+  BF_Init(LRU);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  if (bplus_open_file(FILE_NAME, &file_desc, info) == -1) {
+    _exit(2);
+  }
+
+  Record record;
+  for (int i = 0; i < count; i++) {
+    employee_record(&schema, &record, keys[i], (unsigned long long)keys[i] * 2654435761u);
+    if (bplus_record_insert(file_desc, *info, &record) == -1) {
+      _exit(3);
+    }
+    // Everything up to a report is durable when the parent reads it
+    if (report_fd != -1 && (i + 1) % SYNC_EVERY == 0) {
+      bplus_sync(file_desc);
+      const int done = i + 1;
+      if (write(report_fd, &done, sizeof(done)) != sizeof(done)) {
+        _exit(4);
+      }
+    }
+  }
+  return file_desc;
+}
+
+/**
+ * Child that commits every insert, then crashes in the middle of one
+ * operation that inserts and deletes keys and has its pages written back.
+ */
+static void crash_in_operation(void)
+{
+  BPlusMeta *info;
+  const int file_desc = insert_keys(RECORDS_NUM, -1, &info);
+  bplus_sync(file_desc);
+
+  const TableSchema schema = employee_get_schema();
+  Record record;
+  bplus_begin_op(file_desc);
+  for (int i = 0; i < UNCOMMITTED_NUM; i++) {
+    employee_record(&schema, &record, 2 * i, 0);
+    bplus_record_insert(file_desc, info, &record);
+    bplus_record_delete(file_desc, info, keys[i]);
+  }
+  // Reading the whole tree evicts the changed pages, which BF writes to the file
+  for (int i = 0; i < RECORDS_NUM; i += 7) {
+    Record *found;
+    bplus_record_find(file_desc, info, keys[i], &found);
+    free(found);
+  }
+  _exit(0);
+}
+
+/**
+ * Opens the crashed file and checks that it holds exactly keys[0..expected).
+ * With expected < 0 it may hold any prefix of keys of at least -expected keys.
+ */
+static void check_recovered(const char *scenario, int expected)
+{
+  BF_Init(LRU);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    CHECK(0, "%s: recovery failed", scenario);
+    BF_Close();
+    return;
+  }
+
+  TreeShape shape;
+  CHECK(tree_check(file_desc, info, &shape) == 0, "%s: tree invariants", scenario);
+  const long present = shape.records;
+  if (expected >= 0) {
+    CHECK(present == expected, "%s: %ld records, expected %d", scenario, present, expected);
+  } else {
+    CHECK(present >= -expected, "%s: %ld records, at least %d were durable", scenario, present, -expected);
+  }
+
+  // the records are a prefix of the insertion order: no insert is half applied
+  int wrong = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    Record *found;
+    if ((bplus_record_find(file_desc, info, keys[i], &found) == 0) != (i < present)) {
+      wrong++;
+    }
+    free(found);
+  }
+  for (int i = 0; i < UNCOMMITTED_NUM; i++) {
+    Record *found;
+    if (bplus_record_find(file_desc, info, 2 * i, &found) == 0) {
+      wrong++;
+    }
+    free(found);
+  }
+  CHECK(wrong == 0, "%s: %d keys present that were not committed or missing that were", scenario, wrong);
+  printf("%-10s recovered %ld records, depth %d, leaf fill %.2f\n", scenario, present, info->depth,
+         shape.leaf_fill);
+
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  CHECK(access(FILE_NAME ".wal", F_OK) == -1, "%s: log left after a clean close", scenario);
+}
+
+int main() {
+  // Distinct odd keys in random order, so the uncommitted even keys are new
+  srand(42);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    keys[i] = 2 * i + 1;
+  }
+  for (int i = RECORDS_NUM - 1; i > 0; i--) {
+    const int j = rand() % (i + 1);
+    const int key = keys[i];
+    keys[i] = keys[j];
+    keys[j] = key;
+  }
+
+  // ===== _exit in the middle of an operation =====
+  remove(FILE_NAME);
+  remove(FILE_NAME ".wal");
+  pid_t child = fork();
+  if (child == 0) {
+    crash_in_operation();
+  }
+  int status;
+  waitpid(child, &status, 0);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0, "child failed before the crash");
+  CHECK(access(FILE_NAME ".wal", F_OK) == 0, "no log after the crash");
+  check_recovered("_exit", RECORDS_NUM);
+
+  // ===== SIGKILL during inserts =====
+  remove(FILE_NAME);
+  remove(FILE_NAME ".wal");
+  int reports[2];
+  if (pipe(reports) == -1) {
+    return 1;
+  }
+  child = fork();
+  if (child == 0) {
+    close(reports[0]);
+    BPlusMeta *info;
+    insert_keys(RECORDS_NUM, reports[1], &info);
+    pause();
+    _exit(0);
+  }
+  close(reports[1]);
+  int durable = 0;
+  for (int i = 0; i < KILL_AFTER && read(reports[0], &durable, sizeof(durable)) == sizeof(durable); i++) {
+  }
+  kill(child, SIGKILL);
+  waitpid(child, &status, 0);
+  close(reports[0]);
+  CHECK(durable == KILL_AFTER * SYNC_EVERY, "child reported %d durable inserts", durable);
+  check_recovered("SIGKILL", -durable);
+
+  remove(FILE_NAME);
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
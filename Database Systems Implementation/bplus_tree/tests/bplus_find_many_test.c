@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define TREE_NUM 30000   // Even keys [0, 2 * TREE_NUM) go to the tree
+#define BUFFERED_NUM 600 // Odd keys left in the insert buffer
+#define PROBES_NUM 6000  // Keys of one find_many call
+#define NAMES_NUM 12000  // Rows of the table with the composite key
+#define FILE_NAME "test_find_many.db"
+#define NAMES_FILE_NAME "test_find_many_names.db"
+
+/**
+ * What a find of key must return: bits[key] made its record, 0 if absent.
+ */
+static unsigned long long bits[2 * TREE_NUM];
+
+static int same_records(const TableSchema *schema, const Record *a, const Record *b)
+{
+  char x[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  char y[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  record_serialize(schema, a, x);
+  record_serialize(schema, b, y);
+  return memcmp(x, y, schema->record_size) == 0;
+}
+
+/**
+ * Runs one find_many over the keys (or key_records, if not NULL) and checks
+ * every result and flag against a single find of the same key.
+ */
+static void check_probes(const char *phase, int file_desc, const BPlusMeta *info, const int *keys,
+                         const Record *key_records, int n)
+{
+  const TableSchema *schema = &info->table_schema;
+  Record *out = malloc((size_t)n * sizeof(Record));
+  int *found = malloc((size_t)n * sizeof(int));
+  const int count = key_records != NULL ? bplus_record_find_many_by_key(file_desc, info, key_records, n, out, found)
+                                        : bplus_record_find_many(file_desc, info, keys, n, out, found);
+
+  int expected = 0;
+  int wrong = 0;
+  for (int i = 0; i < n; i++) {
+    Record *record = NULL;
+    const int hit = key_records != NULL ? bplus_record_find_by_key(file_desc, info, &key_records[i], &record) == 0
+                                        : bplus_record_find(file_desc, info, keys[i], &record) == 0;
+    expected += hit;
+    wrong += found[i] != hit || (hit && !same_records(schema, &out[i], record));
+    free(record);
+  }
+  CHECK(count == expected, "%s: find_many found %d keys, single finds %d", phase, count, expected);
+  CHECK(wrong == 0, "%s: %d of %d keys differ from a single find", phase, wrong, n);
+  printf("%-16s probes %5d  found %5d\n", phase, n, count);
+  free(found);
+  free(out);
+}
+
+static int compare_ints(const void *a, const void *b)
+{
+  const int x = *(const int *)a;
+  const int y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Checks the single finds of the INT keys against the model, so that the two
+ * ways cannot agree on a wrong answer.
+ */
+static void check_model(const char *phase, int file_desc, const BPlusMeta *info, const int *keys, int n)
+{
+  const TableSchema *schema = &info->table_schema;
+  int wrong = 0;
+  for (int i = 0; i < n; i++) {
+    const int key = keys[i];
+    const unsigned long long b = key >= 0 && key < 2 * TREE_NUM ? bits[key] : 0;
+    Record *record = NULL;
+    const int hit = bplus_record_find(file_desc, info, key, &record) == 0;
+    if (hit && b != 0) {
+      Record model;
+      employee_record(schema, &model, key, b);
+      wrong += !same_records(schema, &model, record);
+    } else {
+      wrong += hit != (b != 0);
+    }
+    free(record);
+  }
+  CHECK(wrong == 0, "%s: %d single finds differ from the model", phase, wrong);
+}
+
+/**
+ * Probes in random order: keys of the tree, buffered keys, odd keys that were
+ * never inserted, keys out of range and repeats of earlier probes.
+ */
+static void make_probes(int *keys, int n)
+{
+  for (int i = 0; i < n; i++) {
+    switch (rand() % 6) {
+      case 0:
+      case 1:
+        keys[i] = 2 * (rand() % TREE_NUM);
+        break;
+      case 2:
+        keys[i] = 2 * (rand() % TREE_NUM) + 1;
+        break;
+      case 3:
+        keys[i] = rand() % 2 ? -1 - rand() % 100 : 2 * TREE_NUM + rand() % 100;
+        break;
+      default:
+        keys[i] = i > 0 ? keys[rand() % i] : 0;
+        break;
+    }
+  }
+}
+
+static void check_int_keys(void)
+{
+  const TableSchema schema = employee_get_schema();
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    exit(1);
+  }
+
+  // the even keys in random order
+  int *order = malloc(TREE_NUM * sizeof(int));
+  for (int i = 0; i < TREE_NUM; i++) {
+    order[i] = 2 * i;
+  }
+  for (int i = TREE_NUM - 1; i > 0; i--) {
+    const int j = rand() % (i + 1);
+    const int key = order[i];
+    order[i] = order[j];
+    order[j] = key;
+  }
+  Record record;
+  int failed = 0;
+  for (int i = 0; i < TREE_NUM; i++) {
+    bits[order[i]] = (unsigned long long)rand() << 1 | 1;
+    employee_record(&schema, &record, order[i], bits[order[i]]);
+    failed += bplus_record_insert(file_desc, info, &record) == -1;
+  }
+  free(order);
+  CHECK(failed == 0, "%d inserts failed", failed);
+  CHECK(info->depth >= 3, "tree of %d levels", info->depth);
+
+  int *keys = malloc(PROBES_NUM * sizeof(int));
+  make_probes(keys, PROBES_NUM);
+  check_probes("tree", file_desc, info, keys, NULL, PROBES_NUM);
+  check_model("tree", file_desc, info, keys, PROBES_NUM);
+
+  // odd keys stay in the buffer, and so do new records for distinct keys of
+  // the tree, which are dropped as duplicates: the tree record stays
+  CHECK(bplus_insert_buffer_enable(file_desc, info, 4 * BUFFERED_NUM) == 0, "enabling the insert buffer");
+  failed = 0;
+  for (int i = 0; i < BUFFERED_NUM; i++) {
+    const int key = 2 * (rand() % TREE_NUM) + 1;
+    if (bits[key] == 0) {
+      bits[key] = (unsigned long long)rand() << 1 | 1;
+      employee_record(&schema, &record, key, bits[key]);
+      failed += bplus_record_insert(file_desc, info, &record) == -1;
+    }
+    employee_record(&schema, &record, 4 * i, 2);
+    failed += bplus_record_insert(file_desc, info, &record) == -1;
+  }
+  CHECK(failed == 0, "%d buffered inserts failed", failed);
+
+  // half the odd probes are buffered keys
+  make_probes(keys, PROBES_NUM);
+  for (int i = 0; i < PROBES_NUM; i++) {
+    if (keys[i] % 2 != 0 && keys[i] > 0 && keys[i] < 2 * TREE_NUM && rand() % 2) {
+      int key = 2 * (rand() % TREE_NUM) + 1;
+      while (bits[key] == 0) {
+        key = (key + 2) % (2 * TREE_NUM);
+      }
+      keys[i] = key;
+    }
+  }
+  check_probes("buffered", file_desc, info, keys, NULL, PROBES_NUM);
+  check_model("buffered", file_desc, info, keys, PROBES_NUM);
+
+  CHECK(bplus_insert_buffer_flush(file_desc) >= 0, "flushing the insert buffer");
+  check_probes("flushed", file_desc, info, keys, NULL, PROBES_NUM);
+  check_model("flushed", file_desc, info, keys, PROBES_NUM);
+
+  CHECK(bplus_filter_enable(file_desc, info, 10) == 0, "enabling the filter");
+  check_probes("filtered", file_desc, info, keys, NULL, PROBES_NUM);
+
+  // sorted, one key, none
+  qsort(keys, PROBES_NUM, sizeof(int), compare_ints);
+  check_probes("sorted", file_desc, info, keys, NULL, PROBES_NUM);
+  check_probes("one key", file_desc, info, keys + PROBES_NUM / 2, NULL, 1);
+  check_probes("no keys", file_desc, info, keys, NULL, 0);
+
+  free(keys);
+  bplus_close_file(file_desc, info);
+  remove(FILE_NAME);
+}
+
+/**
+ * A table keyed by (surname, name), for bplus_record_find_many_by_key.
+ */
+static TableSchema names_schema(void)
+{
+  const AttributeSchema attributes[] = {
+    {"id", TYPE_INT, 0},
+    {"name", TYPE_CHAR, 10},
+    {"surname", TYPE_CHAR, 14},
+  };
+  TableSchema schema;
+  schema_init(&schema, attributes, 3, "surname,name");
+  return schema;
+}
+
+// row r is ("surname<r / 4>", "name<r % 4>"); only rows with r % 3 != 0 are inserted
+static void names_row(const TableSchema *schema, Record *record, int row)
+{
+  char name[10];
+  char surname[14];
+  snprintf(name, sizeof(name), "name%d", row % 4);
+  snprintf(surname, sizeof(surname), "surname%05d", row / 4);
+  record_create(schema, record, row, name, surname);
+}
+
+static void check_composite_keys(void)
+{
+  const TableSchema schema = names_schema();
+  remove(NAMES_FILE_NAME);
+  bplus_create_file(&schema, NAMES_FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(NAMES_FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", NAMES_FILE_NAME);
+    exit(1);
+  }
+
+  Record record;
+  int failed = 0;
+  for (int i = 0; i < NAMES_NUM; i++) {
+    const int row = (int)((long)i * 7919 % NAMES_NUM);
+    if (row % 3 != 0) {
+      names_row(&schema, &record, row);
+      failed += bplus_record_insert(file_desc, info, &record) == -1;
+    }
+  }
+  CHECK(failed == 0, "names: %d inserts failed", failed);
+  CHECK(info->depth >= 3, "names: tree of %d levels", info->depth);
+
+  // the last rows stay in the buffer
+  CHECK(bplus_insert_buffer_enable(file_desc, info, NAMES_NUM) == 0, "names: enabling the insert buffer");
+  for (int row = NAMES_NUM; row < NAMES_NUM + 200; row++) {
+    names_row(&schema, &record, row);
+    failed += bplus_record_insert(file_desc, info, &record) == -1;
+  }
+  CHECK(failed == 0, "names: %d buffered inserts failed", failed);
+
+  // present, missing, buffered and beyond every row, with repeats
+  Record *key_records = malloc(PROBES_NUM * sizeof(Record));
+  for (int i = 0; i < PROBES_NUM; i++) {
+    if (i > 0 && rand() % 5 == 0) {
+      key_records[i] = key_records[rand() % i];
+    } else {
+      names_row(&schema, &key_records[i], rand() % (NAMES_NUM + 400));
+    }
+  }
+  check_probes("names buffered", file_desc, info, NULL, key_records, PROBES_NUM);
+  CHECK(bplus_insert_buffer_flush(file_desc) >= 0, "names: flushing the insert buffer");
+  check_probes("names flushed", file_desc, info, NULL, key_records, PROBES_NUM);
+
+  free(key_records);
+  bplus_close_file(file_desc, info);
+  remove(NAMES_FILE_NAME);
+}
+
+int main() {
+  srand(35);
+  BF_Init(LRU);
+  check_int_keys();
+  check_composite_keys();
+  BF_Close();
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
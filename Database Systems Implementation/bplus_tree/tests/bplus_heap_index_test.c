@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bf.h"
+#include "bplus_exec.h"
+#include "bplus_file_funcs.h"
+#include "bplus_heap.h"
+#include "bplus_index_build.h"
+#include "bplus_secondary.h"
+#include "heap_writer.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 20000 // Records of the heap file
+#define HEAP_NAME "test_heap.db"
+#define CITY_INDEX "test_heap_city.db"
+#define ID_INDEX "test_heap_id.db"
+#define BAD_HEAP "test_heap_bad.db"
+
+/**
+ * The records of heap_writer.c, packed as in the heap Record.
+ */
+static TableSchema heap_schema(void)
+{
+  const AttributeSchema attributes[] = {
+    {"id", TYPE_INT, 0},
+    {"name", TYPE_CHAR, 15},
+    {"surname", TYPE_CHAR, 20},
+    {"city", TYPE_CHAR, 20},
+  };
+  TableSchema schema;
+  schema_init(&schema, attributes, 4, "id");
+  return schema;
+}
+
+/**
+ * Copies the record at a location (block * records_per_block + slot) of the heap file.
+ */
+static int heap_record(int heap_desc, const BPlusHeapHeader *header, int location, char *packed)
+{
+  const int block_id = location / header->records_per_block;
+  const int slot = location % header->records_per_block;
+  BF_Block *block;
+  BF_Block_Init(&block);
+  if (block_id < 1 || block_id > header->last_data_block || BF_GetBlock(heap_desc, block_id, block) != BF_OK) {
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+  const char *data = BF_Block_GetData(block);
+  const int found = slot < *(const int *)data;
+  memcpy(packed, data + sizeof(int) + (size_t)slot * heap_record_stride(), heap_record_stride());
+  BF_UnpinBlock(block);
+  BF_Block_Destroy(&block);
+  return found ? 0 : -1;
+}
+
+/**
+ * Checks that the header and exec_heap_scan see every record in insert order.
+ */
+static void check_scan(int heap_desc, const TableSchema *schema, BPlusHeapHeader *header)
+{
+  CHECK(bplus_heap_header(heap_desc, header) == 0, "header of %s", HEAP_NAME);
+  const int records_per_block = (BF_BLOCK_SIZE - (int)sizeof(int)) / heap_record_stride();
+  const int blocks = (RECORDS_NUM + records_per_block - 1) / records_per_block;
+  CHECK(header->total_records == RECORDS_NUM, "header: %d records", header->total_records);
+  CHECK(header->records_per_block == records_per_block, "header: %d records per block, expected %d",
+        header->records_per_block, records_per_block);
+  CHECK(header->last_data_block == blocks, "header: last data block %d, expected %d", header->last_data_block,
+        blocks);
+
+  ExecOperator *scan = exec_heap_scan(heap_desc, schema, heap_record_stride());
+  CHECK(scan != NULL, "exec_heap_scan");
+  if (scan == NULL) {
+    return;
+  }
+  ExecBatch *batch;
+  int rows;
+  int next = 0;
+  int wrong = 0;
+  while ((rows = exec_next(scan, &batch)) > 0) {
+    const int *ids = (const int *)batch->columns[0];
+    for (int r = 0; r < batch->count; r++) {
+      wrong += ids[r] != next++;
+    }
+  }
+  CHECK(rows == 0, "exec_heap_scan failed");
+  CHECK(next == RECORDS_NUM, "exec_heap_scan: %d records", next);
+  CHECK(wrong == 0, "exec_heap_scan: %d records out of order", wrong);
+  exec_close(scan);
+}
+
+/**
+ * Builds an index on the city and checks that the locations of every city
+ * are exactly the records of that city.
+ */
+static void check_city_index(int heap_desc, const TableSchema *schema, const BPlusHeapHeader *header)
+{
+  const long indexed = bplus_build_index(heap_desc, schema, heap_record_stride(), "city", CITY_INDEX, NULL);
+  CHECK(indexed == RECORDS_NUM, "city index: %ld records indexed", indexed);
+  int file_desc;
+  BPlusMeta *info;
+  if (indexed == -1 || bplus_open_file(CITY_INDEX, &file_desc, &info) == -1) {
+    CHECK(0, "cannot open %s", CITY_INDEX);
+    return;
+  }
+
+  const int city = schema_attribute_index(schema, "city");
+  char *packed = malloc(heap_record_stride());
+  long total = 0;
+  for (int c = 0; c < HEAP_WRITER_CITIES; c++) {
+    FieldValue value;
+    memset(&value, 0, sizeof(value));
+    snprintf(value.string_value, sizeof(value.string_value), "city%d", c);
+    int *locations;
+    const int n = bplus_secondary_find(file_desc, info, &value, &locations);
+    const int expected = RECORDS_NUM / HEAP_WRITER_CITIES + (c < RECORDS_NUM % HEAP_WRITER_CITIES);
+    CHECK(n == expected, "%s: %d locations, expected %d", value.string_value, n, expected);
+    int wrong = 0;
+    for (int i = 0; i < n; i++) {
+      if (heap_record(heap_desc, header, locations[i], packed) == -1 ||
+          strncmp(record_field(schema, packed, city), value.string_value, 20) != 0 ||
+          record_field_int(schema, packed, 0) % HEAP_WRITER_CITIES != c) {
+        wrong++;
+      }
+    }
+    CHECK(wrong == 0, "%s: %d locations of other records", value.string_value, wrong);
+    total += n > 0 ? n : 0;
+    free(locations);
+  }
+  CHECK(total == RECORDS_NUM, "city index: %ld locations", total);
+  free(packed);
+  bplus_close_file(file_desc, info);
+}
+
+/**
+ * Builds an index on the id and checks the location of every record.
+ */
+static void check_id_index(int heap_desc, const TableSchema *schema, const BPlusHeapHeader *header)
+{
+  const long indexed = bplus_build_index(heap_desc, schema, heap_record_stride(), "id", ID_INDEX, NULL);
+  CHECK(indexed == RECORDS_NUM, "id index: %ld records indexed", indexed);
+  int file_desc;
+  BPlusMeta *info;
+  if (indexed == -1 || bplus_open_file(ID_INDEX, &file_desc, &info) == -1) {
+    CHECK(0, "cannot open %s", ID_INDEX);
+    return;
+  }
+
+  char *packed = malloc(heap_record_stride());
+  int wrong = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    FieldValue value;
+    value.int_value = i;
+    int *locations;
+    const int n = bplus_secondary_find(file_desc, info, &value, &locations);
+    if (n != 1 || heap_record(heap_desc, header, locations[0], packed) == -1 ||
+        record_field_int(schema, packed, 0) != i) {
+      wrong++;
+    }
+    free(locations);
+  }
+  CHECK(wrong == 0, "id index: %d ids without their one location", wrong);
+  free(packed);
+  bplus_close_file(file_desc, info);
+}
+
+/**
+ * A build that fails after creating the index removes it; one into an existing file leaves that file alone.
+ */
+static void check_failures_cleanup(int heap_desc, const TableSchema *schema)
+{
+  int bad_desc;
+  BF_Block *block;
+  BF_Block_Init(&block);
+  if (BF_CreateFile(BAD_HEAP) == BF_OK && BF_OpenFile(BAD_HEAP, &bad_desc) == BF_OK &&
+      BF_AllocateBlock(bad_desc, block) == BF_OK) {
+    memset(BF_Block_GetData(block), 0, BF_BLOCK_SIZE);
+    BF_Block_SetDirty(block);
+    BF_UnpinBlock(block);
+    remove(ID_INDEX);
+    CHECK(bplus_build_index(bad_desc, schema, heap_record_stride(), "id", ID_INDEX, NULL) == -1,
+          "index of a file that is not a heap file");
+    CHECK(access(ID_INDEX, F_OK) != 0, "failed build left %s behind", ID_INDEX);
+    CHECK(access(ID_INDEX ".wal", F_OK) != 0, "failed build left %s.wal behind", ID_INDEX);
+    BF_CloseFile(bad_desc);
+  } else {
+    CHECK(0, "cannot create %s", BAD_HEAP);
+  }
+  BF_Block_Destroy(&block);
+  remove(BAD_HEAP);
+
+  CHECK(bplus_build_index(heap_desc, schema, heap_record_stride(), "city", CITY_INDEX, NULL) == -1,
+        "index into an existing file");
+  CHECK(access(CITY_INDEX, F_OK) == 0, "build removed the existing %s", CITY_INDEX);
+}
+
+int main() {
+  const TableSchema schema = heap_schema();
+  CHECK(schema.record_size <= heap_record_stride(), "schema of %d bytes for a heap record of %d",
+        schema.record_size, heap_record_stride());
+
+  BF_Init(LRU);
+  remove(HEAP_NAME);
+  remove(CITY_INDEX);
+  remove(ID_INDEX);
+  if (heap_write_records(HEAP_NAME, RECORDS_NUM) == -1) {
+    fprintf(stderr, "cannot write %s\n", HEAP_NAME);
+    return 1;
+  }
+  int heap_desc;
+  if (BF_OpenFile(HEAP_NAME, &heap_desc) != BF_OK) {
+    fprintf(stderr, "cannot open %s\n", HEAP_NAME);
+    return 1;
+  }
+
+  BPlusHeapHeader header;
+  check_scan(heap_desc, &schema, &header);
+  check_city_index(heap_desc, &schema, &header);
+  check_id_index(heap_desc, &schema, &header);
+  check_failures_cleanup(heap_desc, &schema);
+  printf("heap     records %5d  blocks %4d  records per block %d\n", header.total_records, header.last_data_block,
+         header.records_per_block);
+
+  BF_CloseFile(heap_desc);
+  BF_Close();
+  remove(HEAP_NAME);
+  remove(CITY_INDEX);
+  remove(ID_INDEX);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
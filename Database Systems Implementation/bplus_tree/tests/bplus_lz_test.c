@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "bplus_lz.h"
+#include "tree_check.h"
+
+#define LARGE_SIZE 200000   // Bytes of the large inputs, past the 64 KiB offset limit
+#define SMALL_SIZES 300     // Every input size below this is round-tripped
+#define CORRUPTIONS 3000    // Corrupted copies of a valid stream
+#define GARBAGE 3000        // Random byte strings given to the decoder
+
+/**
+ * A buffer of size bytes between two PROT_NONE pages, starting right after
+ * the first one (at_end 0) or ending right before the second (at_end 1), so
+ * any access outside it faults.
+ */
+static char *guard_alloc(size_t size, int at_end)
+{
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t pages = (size + page - 1) / page;
+  char *base = mmap(NULL, (pages + 2) * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    perror("mmap");
+    exit(1);
+  }
+  mprotect(base, page, PROT_NONE);
+  mprotect(base + (pages + 1) * page, page, PROT_NONE);
+  return at_end ? base + (pages + 1) * page - size : base + page;
+}
+
+static void guard_free(char *buffer, size_t size, int at_end)
+{
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t pages = (size + page - 1) / page;
+  munmap(at_end ? buffer + size - (pages + 1) * page : buffer - page, (pages + 2) * page);
+}
+
+/**
+ * Decompresses with the input and the output each against a guard page, on
+ * both sides in turn. Returns the result of the decoder, or -2 if the two
+ * placements disagree; out (if not NULL) receives the bytes.
+ */
+static int decompress_guarded(const char *in, int n, int capacity, char *out)
+{
+  int results[2];
+  for (int at_end = 0; at_end < 2; at_end++) {
+    char *input = guard_alloc(n, at_end);
+    char *output = guard_alloc(capacity, at_end);
+    memcpy(input, in, n);
+    results[at_end] = bplus_lz_decompress(input, n, output, capacity);
+    if (out != NULL && at_end == 1 && results[at_end] > 0) {
+      memcpy(out, output, results[at_end]);
+    }
+    guard_free(output, capacity, at_end);
+    guard_free(input, n, at_end);
+  }
+  return results[0] == results[1] ? results[0] : -2;
+}
+
+/**
+ * Compresses into a buffer that ends at a guard page.
+ */
+static int compress_guarded(const char *in, int n, int capacity, char *out)
+{
+  char *input = guard_alloc(n, 1);
+  char *output = guard_alloc(capacity, 1);
+  memcpy(input, in, n);
+  const int result = bplus_lz_compress(input, n, output, capacity);
+  if (result > 0) {
+    memcpy(out, output, result);
+  }
+  guard_free(output, capacity, 1);
+  guard_free(input, n, 1);
+  return result;
+}
+
+/**
+ * Compresses and decompresses one input, and checks the sizes, the bytes and
+ * that a buffer one byte too small is refused both ways. Returns the compressed size.
+ */
+static int round_trip(const char *name, const char *in, int n)
+{
+  char *packed = malloc(BPLUS_LZ_BOUND(n));
+  char *unpacked = malloc(n + 1);
+  const int size = compress_guarded(in, n, BPLUS_LZ_BOUND(n), packed);
+  CHECK(size > 0 && size <= BPLUS_LZ_BOUND(n), "%s (%d bytes): compressed to %d, bound %d", name, n, size,
+        BPLUS_LZ_BOUND(n));
+  if (size > 0) {
+    const int back = decompress_guarded(packed, size, n, unpacked);
+    CHECK(back == n, "%s (%d bytes): decompressed to %d", name, n, back);
+    CHECK(back != n || memcmp(in, unpacked, n) == 0, "%s (%d bytes): bytes differ", name, n);
+    if (n > 0) {
+      CHECK(decompress_guarded(packed, size, n - 1, NULL) == -1, "%s (%d bytes): output one byte short accepted",
+            name, n);
+    }
+    CHECK(compress_guarded(in, n, size - 1, packed) == -1, "%s (%d bytes): compressed into %d bytes", name, n,
+          size - 1);
+  }
+  free(unpacked);
+  free(packed);
+  return size;
+}
+
+static void fill_random(char *data, int n, int alphabet)
+{
+  for (int i = 0; i < n; i++) {
+    data[i] = (char)(alphabet == 256 ? rand() : 'a' + rand() % alphabet);
+  }
+}
+
+static void check_round_trips(void)
+{
+  char *data = malloc(LARGE_SIZE);
+
+  fill_random(data, LARGE_SIZE, 256);
+  const int random_size = round_trip("random", data, LARGE_SIZE);
+  CHECK(random_size >= LARGE_SIZE, "random: %d bytes compressed to %d", LARGE_SIZE, random_size);
+  round_trip("random page", data, 4096);
+
+  memset(data, 0, LARGE_SIZE);
+  const int zero_size = round_trip("zeros", data, LARGE_SIZE);
+  CHECK(zero_size < LARGE_SIZE / 200, "zeros: %d bytes compressed to %d", LARGE_SIZE, zero_size);
+  round_trip("zero page", data, 4096);
+
+  fill_random(data, LARGE_SIZE, 4);
+  round_trip("four letters", data, LARGE_SIZE);
+
+  // a random block repeated further back than an offset can reach, and then near enough
+  fill_random(data, 70000, 256);
+  memcpy(data + 70000, data, 70000);
+  memmove(data + 140000, data + 100000, LARGE_SIZE - 140000);
+  round_trip("repeated block", data, LARGE_SIZE);
+
+  // records: a fixed layout with a counter and a few changing letters
+  for (int i = 0; i + 64 <= LARGE_SIZE; i += 64) {
+    memset(data + i, 0, 64);
+    memcpy(data + i, &i, sizeof(i));
+    snprintf(data + i + 4, 60, "name%c surname%c city%d", 'A' + rand() % 26, 'A' + rand() % 26, rand() % 10);
+  }
+  round_trip("records", data, LARGE_SIZE - LARGE_SIZE % 64);
+
+  // every small size, so both ends of the last literals and match limits are met
+  for (int n = 0; n < SMALL_SIZES; n++) {
+    fill_random(data, n, 256);
+    round_trip("small random", data, n);
+    fill_random(data, n, 2);
+    round_trip("small two letters", data, n);
+    memset(data, 0, n);
+    round_trip("small zeros", data, n);
+  }
+  free(data);
+}
+
+/**
+ * Hand-made streams that are malformed in one way each.
+ */
+static void check_malformed(void)
+{
+  static const struct {
+    const char *name;
+    int n;
+    int capacity;
+    unsigned char bytes[12];
+  } cases[] = {
+    {"offset past the output", 5, 64, {0x10, 'a', 0x02, 0x00, 0x00}},
+    {"offset 0", 4, 64, {0x10, 'a', 0x00, 0x00}},
+    {"match before any literal", 3, 64, {0x00, 0x01, 0x00}},
+    {"literal length past the input", 3, 64, {0x50, 'a', 'b'}},
+    {"literal length continuation missing", 2, 64, {0xF0, 0xFF}},
+    {"literal length past the output", 6, 4, {0x50, 'a', 'b', 'c', 'd', 'e'}},
+    {"long literal length past the input", 3, 64, {0xF0, 0xFF, 0x00}},
+    {"offset byte missing", 3, 64, {0x14, 'a', 0x01}},
+    {"offset missing", 2, 64, {0x14, 'a'}},
+    {"match length continuation missing", 4, 64, {0x1F, 'a', 0x01, 0x00}},
+    {"match length past the output", 4, 8, {0x1E, 'a', 0x01, 0x00}},
+    {"long match length past the output", 7, 300, {0x1F, 'a', 0x01, 0x00, 0xFF, 0xFF, 0x10}},
+  };
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const int result = decompress_guarded((const char *)cases[c].bytes, cases[c].n, cases[c].capacity, NULL);
+    CHECK(result == -1, "%s: returned %d", cases[c].name, result);
+  }
+  CHECK(decompress_guarded("", 0, 64, NULL) == -1, "empty stream accepted");
+}
+
+/**
+ * Marks in ends the positions of a valid stream right after the literals of
+ * a sequence with match nibble 0, where a cut leaves a valid stream.
+ */
+static void literal_ends(const unsigned char *in, int n, char *ends)
+{
+  memset(ends, 0, n + 1);
+  int pos = 0;
+  while (pos < n) {
+    const int token = in[pos++];
+    int literals = token >> 4;
+    if (literals == 15) {
+      while (in[pos] == 255) {
+        literals += in[pos++];
+      }
+      literals += in[pos++];
+    }
+    pos += literals;
+    ends[pos] = (token & 15) == 0;
+    pos += 2;
+    if ((token & 15) == 15) {
+      while (in[pos++] == 255) {
+      }
+    }
+  }
+}
+
+/**
+ * Truncated streams are refused where the format allows. For corrupted and
+ * random streams any result is allowed but a read or write outside the
+ * buffers (which faults) or a size above the capacity.
+ */
+static void check_damaged(void)
+{
+  char *data = malloc(8192);
+  char *packed = malloc(BPLUS_LZ_BOUND(8192));
+  char *damaged = malloc(BPLUS_LZ_BOUND(8192));
+  char *unpacked = malloc(8192);
+  fill_random(data, 8192, 3);
+  const int size = bplus_lz_compress(data, 8192, packed, BPLUS_LZ_BOUND(8192));
+  CHECK(size > 0, "compressing the stream to damage");
+
+  // a cut stream is refused, unless it stops right after the literals of a
+  // sequence whose match has the minimum length (match nibble 0): that is a
+  // valid shorter stream, which only its size gives away
+  char *ends = malloc(size + 1);
+  literal_ends((const unsigned char *)packed, size, ends);
+  int wrong = 0;
+  for (int n = 0; n < size; n++) {
+    const int result = decompress_guarded(packed, n, 8192, unpacked);
+    if (result != -1 && (!ends[n] || result >= 8192 || memcmp(unpacked, data, result) != 0)) {
+      wrong++;
+    }
+  }
+  CHECK(wrong == 0, "%d of %d cut streams accepted", wrong, size);
+  free(ends);
+
+  wrong = 0;
+  for (int i = 0; i < CORRUPTIONS; i++) {
+    memcpy(damaged, packed, size);
+    for (int flips = 1 + rand() % 4; flips > 0; flips--) {
+      damaged[rand() % size] ^= (char)(1 + rand() % 255);
+    }
+    const int result = decompress_guarded(damaged, size, 8192, NULL);
+    wrong += result < -1 || result > 8192;
+  }
+  CHECK(wrong == 0, "%d corrupted streams returned a bad size", wrong);
+
+  wrong = 0;
+  for (int i = 0; i < GARBAGE; i++) {
+    const int n = rand() % 256;
+    const int capacity = rand() % 1024;
+    fill_random(damaged, n, 256);
+    const int result = decompress_guarded(damaged, n, capacity, NULL);
+    wrong += result < -1 || result > capacity;
+  }
+  CHECK(wrong == 0, "%d random streams returned a bad size", wrong);
+
+  free(unpacked);
+  free(damaged);
+  free(packed);
+  free(data);
+}
+
+int main() {
+  srand(7);
+  check_round_trips();
+  check_malformed();
+  check_damaged();
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "bplus_memtree.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 5000    // Records in the file before it is loaded
+#define CHANGES_NUM 20000   // Random changes made in memory
+#define KEY_RANGE 20000     // Keys are drawn from [0, KEY_RANGE)
+#define RECORD_BYTES 64     // record_size of the employee schema
+#define FILE_NAME "test_memtree.db"
+
+static char present[KEY_RANGE];
+static char model[KEY_RANGE][RECORD_BYTES];  // packed record expected for each present key
+
+/**
+ * Checks that a record equals the one the model holds for its key.
+ */
+static int matches_model(const TableSchema *schema, const Record *record)
+{
+  char packed[RECORD_BYTES];
+  record_serialize(schema, record, packed);
+  const int key = record_get_key(schema, record);
+  return key >= 0 && key < KEY_RANGE && present[key] && memcmp(packed, model[key], schema->record_size) == 0;
+}
+
+/**
+ * Checks every key of the model against the in-memory tree.
+ */
+static void check_memtree(const char *phase, const BPlusMemTree *tree, long expected)
+{
+  int wrong = 0;
+  Record record;
+  for (int key = 0; key < KEY_RANGE; key++) {
+    const int found = bplus_memtree_find(tree, key, &record) == 0;
+    if (found != present[key] || (found && !matches_model(&tree->schema, &record))) {
+      wrong++;
+    }
+  }
+  CHECK(wrong == 0, "%s: %d keys of the memtree differ from the model", phase, wrong);
+  CHECK(tree->record_count == expected, "%s: %ld records, expected %ld", phase, tree->record_count, expected);
+}
+
+/**
+ * Reopens the file and checks that its leaves hold exactly the model.
+ */
+static void check_file(const char *phase, long expected)
+{
+  BF_Init(LRU);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    CHECK(0, "%s: cannot reopen %s", phase, FILE_NAME);
+    BF_Close();
+    return;
+  }
+
+  TreeShape shape;
+  CHECK(tree_check(file_desc, info, &shape) == 0, "%s: tree invariants", phase);
+  long n;
+  Record *records = tree_leaf_records(file_desc, info, &n);
+  int wrong = 0;
+  for (long i = 0; i < n; i++) {
+    wrong += !matches_model(&info->table_schema, &records[i]);
+  }
+  free(records);
+  CHECK(n == expected, "%s: %ld records in the file, expected %ld", phase, n, expected);
+  CHECK(wrong == 0, "%s: %d records of the file differ from the model", phase, wrong);
+  printf("%-11s %5ld records  depth %d  leaves %4d  leaf fill %.2f\n", phase, n, info->depth, shape.leaves,
+         shape.leaf_fill);
+
+  bplus_close_file(file_desc, info);
+  BF_Close();
+}
+
+/**
+ * Loads the file, makes CHANGES_NUM random inserts and deletes in memory
+ * (re-inserting deleted keys with new contents among them), then
+ * checkpoints and closes. Returns the number of records.
+ */
+static long change_in_memory(const char *phase, long count, int checkpoint_every)
+{
+  const TableSchema schema = employee_get_schema();
+  BF_Init(LRU);
+  int file_desc;
+  BPlusMeta *info;
+  bplus_open_file(FILE_NAME, &file_desc, &info);
+  BPlusMemTree *tree = bplus_memtree_load(file_desc, info, checkpoint_every);
+  CHECK(tree != NULL, "%s: load", phase);
+  if (tree == NULL) {
+    bplus_close_file(file_desc, info);
+    BF_Close();
+    return count;
+  }
+  check_memtree(phase, tree, count);
+
+  Record record;
+  int last_deleted = -1;
+  for (int i = 0; i < CHANGES_NUM; i++) {
+    // every fourth change puts back the key deleted last, with new contents
+    const int key = i % 4 == 0 && last_deleted != -1 ? last_deleted : rand() % KEY_RANGE;
+    if (present[key]) {
+      employee_record(&schema, &record, key, 0);
+      CHECK(bplus_memtree_insert(tree, &record) == -1, "%s: duplicate insert of key %d accepted", phase, key);
+      CHECK(bplus_memtree_delete(tree, key) == 0, "%s: delete of key %d", phase, key);
+      present[key] = 0;
+      last_deleted = key;
+      count--;
+    } else {
+      employee_record(&schema, &record, key, (unsigned long long)rand() << 16 | (unsigned long long)rand());
+      CHECK(bplus_memtree_insert(tree, &record) == 0, "%s: insert of key %d", phase, key);
+      record_serialize(&schema, &record, model[key]);
+      present[key] = 1;
+      if (key == last_deleted) {
+        last_deleted = -1;
+      }
+      count++;
+    }
+  }
+  CHECK(bplus_memtree_delete(tree, KEY_RANGE) == -1, "%s: delete of a missing key succeeded", phase);
+  check_memtree(phase, tree, count);
+
+  CHECK(bplus_memtree_checkpoint(tree) >= 0, "%s: checkpoint", phase);
+  CHECK(bplus_memtree_checkpoint(tree) == 0, "%s: second checkpoint found changes", phase);
+  CHECK(bplus_memtree_close(tree) == 0, "%s: close", phase);
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  return count;
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  srand(42);
+
+  // ===== The file to load =====
+  BF_Init(LRU);
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    return 1;
+  }
+  Record record;
+  long count = 0;
+  while (count < RECORDS_NUM) {
+    const int key = rand() % KEY_RANGE;
+    if (!present[key]) {
+      employee_record(&schema, &record, key, (unsigned long long)rand());
+      bplus_record_insert(file_desc, info, &record);
+      record_serialize(&schema, &record, model[key]);
+      present[key] = 1;
+      count++;
+    }
+  }
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  check_file("created", count);
+
+  // ===== Explicit checkpoint only, then automatic ones every 100 changes =====
+  count = change_in_memory("explicit", count, 0);
+  check_file("explicit", count);
+  count = change_in_memory("automatic", count, 100);
+  check_file("automatic", count);
+
+  remove(FILE_NAME);
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "bplus_page_pool.h"
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define KEY_RANGE 60000   // Keys are drawn from [0, KEY_RANGE)
+#define RECORDS_NUM 40000 // Records inserted before the churn
+#define CHURN_OPS 40000   // Mixed operations, with a resize every RESIZE_EVERY
+#define RESIZE_EVERY 8000
+#define SCAN_RANGE 400    // Keys covered by a range scan
+#define FILE_NAME "test_pool.db"
+
+/**
+ * Pool sizes in extents, one per stretch of RESIZE_EVERY operations: the tree
+ * needs about four extents, so one extent keeps the clock evicting.
+ */
+static const int pool_extents[] = {1, 4, 0, 2, 1};
+
+/**
+ * The records the file must hold: bits[key] made the record of key, 0 if absent.
+ */
+static unsigned long long bits[KEY_RANGE];
+
+static unsigned long long next_bits(void)
+{
+  return ((unsigned long long)rand() << 31 | (unsigned long long)rand()) | 1;
+}
+
+static int same_record(const TableSchema *schema, const Record *record, int key)
+{
+  Record expected;
+  char a[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  char b[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  employee_record(schema, &expected, key, bits[key]);
+  record_serialize(schema, &expected, a);
+  record_serialize(schema, record, b);
+  return memcmp(a, b, schema->record_size) == 0;
+}
+
+typedef struct {
+  const TableSchema *schema;
+  int next;   // smallest key the scan may still return
+  int wrong;
+} ScanCheck;
+
+// every present key from next on must come, in order and with its record
+static int check_scanned(const Record *record, void *ctx)
+{
+  ScanCheck *scan = ctx;
+  const int key = record_get_key(scan->schema, record);
+  while (scan->next < key) {
+    scan->wrong += bits[scan->next++] != 0;
+  }
+  scan->wrong += key != scan->next || bits[key] == 0 || !same_record(scan->schema, record, key);
+  scan->next = key + 1;
+  return 0;
+}
+
+static int check_lookup(int file_desc, const BPlusMeta *info, int key)
+{
+  Record *record = NULL;
+  const int found = bplus_record_find(file_desc, info, key, &record) == 0;
+  const int right = found == (bits[key] != 0) && (!found || same_record(&info->table_schema, record, key));
+  free(record);
+  return right;
+}
+
+static int check_scan(int file_desc, const BPlusMeta *info, int lo, int hi)
+{
+  ScanCheck scan = {&info->table_schema, lo, 0};
+  const int visited = bplus_range_scan(file_desc, info, lo, hi, check_scanned, &scan);
+  while (scan.next <= hi) {
+    scan.wrong += bits[scan.next++] != 0;
+  }
+  return visited >= 0 && scan.wrong == 0;
+}
+
+static void resize(int extents, const char *phase)
+{
+  CHECK(bplus_pool_resize((size_t)extents * BPLUS_POOL_EXTENT) == 0, "%s: resize to %d extents", phase, extents);
+  BPlusPoolStats stats;
+  bplus_pool_stats(&stats);
+  CHECK(stats.frames == extents * (BPLUS_POOL_EXTENT / BF_BLOCK_SIZE), "%s: %d frames for %d extents", phase,
+        stats.frames, extents);
+}
+
+/**
+ * Checks every cached page against the block BF holds, and the records of the
+ * leaf chain (read through BF alone) against the model.
+ */
+static void check_pages(const char *phase, int file_desc, const BPlusMeta *info)
+{
+  int blocks = 0;
+  BF_GetBlockCounter(file_desc, &blocks);
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int cached = 0;
+  int differ = 0;
+  for (int b = 1; b < blocks; b++) {
+    BPlusPoolStats before, after;
+    bplus_pool_stats(&before);
+    const char *copy = page_pool_read(file_desc, b);
+    bplus_pool_stats(&after);
+    if (copy == NULL || after.hits == before.hits || BF_GetBlock(file_desc, b, block) != BF_OK) {
+      continue;
+    }
+    cached++;
+    differ += memcmp(copy, BF_Block_GetData(block), BF_BLOCK_SIZE) != 0;
+    BF_UnpinBlock(block);
+  }
+  BF_Block_Destroy(&block);
+  CHECK(differ == 0, "%s: %d of %d cached pages differ from BF", phase, differ, cached);
+
+  long count;
+  Record *records = tree_leaf_records(file_desc, info, &count);
+  long expected = 0;
+  int wrong = 0;
+  for (int key = 0; key < KEY_RANGE; key++) {
+    if (bits[key] != 0) {
+      wrong += expected >= count || record_get_key(&info->table_schema, &records[expected]) != key ||
+               !same_record(&info->table_schema, &records[expected], key);
+      expected++;
+    }
+  }
+  free(records);
+  CHECK(count == expected && wrong == 0, "%s: leaf chain has %ld records, %d wrong, expected %ld", phase, count,
+        wrong, expected);
+  CHECK(tree_check(file_desc, info, NULL) == 0, "%s: tree invariants", phase);
+  printf("%-7s blocks %5d  cached pages checked %5d\n", phase, blocks, cached);
+}
+
+int main() {
+  const TableSchema schema = employee_get_schema();
+  srand(49);
+  BF_Init(LRU);
+  if (bplus_pool_init(BPLUS_POOL_EXTENT) == -1) {
+    fprintf(stderr, "cannot map the page pool\n");
+    return 1;
+  }
+  remove(FILE_NAME);
+  bplus_create_file(&schema, FILE_NAME);
+  int file_desc;
+  BPlusMeta *info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1) {
+    fprintf(stderr, "cannot open %s\n", FILE_NAME);
+    return 1;
+  }
+
+  // ===== Insert, with lookups that fill the pool as the tree grows =====
+  Record record;
+  int wrong = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    const int key = rand() % KEY_RANGE;
+    const unsigned long long b = next_bits();
+    employee_record(&schema, &record, key, b);
+    const int inserted = bplus_record_insert(file_desc, info, &record) != -1;
+    wrong += inserted == (bits[key] != 0);
+    if (inserted) {
+      bits[key] = b;
+    }
+    wrong += !check_lookup(file_desc, info, rand() % KEY_RANGE);
+  }
+  CHECK(wrong == 0, "insert: %d inserts or lookups wrong", wrong);
+  check_pages("insert", file_desc, info);
+
+  // ===== Churn: inserts, updates, deletes, lookups and scans, resizing the pool on the way =====
+  wrong = 0;
+  for (int op = 0; op < CHURN_OPS; op++) {
+    if (op % RESIZE_EVERY == 0) {
+      char phase[32];
+      snprintf(phase, sizeof(phase), "op %d", op);
+      resize(pool_extents[op / RESIZE_EVERY], phase);
+    }
+    const int key = rand() % KEY_RANGE;
+    switch (rand() % 5) {
+      case 0:
+        if (bits[key] == 0) {
+          bits[key] = next_bits();
+          employee_record(&schema, &record, key, bits[key]);
+          wrong += bplus_record_insert(file_desc, info, &record) == -1;
+        } else {
+          wrong += bplus_record_delete(file_desc, info, key) != 0;
+          bits[key] = 0;
+        }
+        break;
+      case 1:
+        if (bits[key] != 0) {
+          bits[key] = next_bits();
+          employee_record(&schema, &record, key, bits[key]);
+          wrong += bplus_record_update(file_desc, info, &record) == -1;
+        }
+        break;
+      case 2:
+        wrong += !check_scan(file_desc, info, key, key + SCAN_RANGE < KEY_RANGE ? key + SCAN_RANGE : KEY_RANGE - 1);
+        break;
+      default:
+        wrong += !check_lookup(file_desc, info, key);
+        break;
+    }
+  }
+  CHECK(wrong == 0, "churn: %d operations wrong", wrong);
+  check_pages("churn", file_desc, info);
+
+  BPlusPoolStats stats;
+  bplus_pool_stats(&stats);
+  CHECK(stats.hits > 0 && stats.misses > stats.frames, "pool: %ld hits, %ld misses for %d frames", stats.hits,
+        stats.misses, stats.frames);
+
+  // ===== Reopen: the copies of a closed file are dropped =====
+  bplus_close_file(file_desc, info);
+  CHECK(bplus_open_file(FILE_NAME, &file_desc, &info) == 0, "reopen");
+  wrong = 0;
+  for (int key = 0; key < KEY_RANGE; key += 7) {
+    wrong += !check_lookup(file_desc, info, key);
+  }
+  CHECK(wrong == 0, "reopen: %d lookups wrong", wrong);
+  check_pages("reopen", file_desc, info);
+
+  bplus_close_file(file_desc, info);
+  bplus_pool_close();
+  BF_Close();
+  remove(FILE_NAME);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
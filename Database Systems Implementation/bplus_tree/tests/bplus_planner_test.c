@@ -0,0 +1,226 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bplus_file_funcs.h"
+#include "bplus_planner.h"
+#include "bplus_secondary.h"
+#include "bplus_stats.h"
+#include "tree_check.h"
+
+#define RECORDS_NUM 20000 // Rows of the table, ids [0, RECORDS_NUM)
+#define DEPTS 100         // Rare departments 1..DEPTS; every other row is in department 0
+#define RARE_DEPT 37
+#define FILE_NAME "test_planner.db"
+#define INDEX_NAME "test_planner_dept.db"
+
+/**
+ * Nine rows in ten are in department 0, the rest are spread evenly over 1..DEPTS.
+ */
+static int dept_of(int id)
+{
+  return id % 10 != 0 ? 0 : 1 + (id / 10) % DEPTS;
+}
+
+static TableSchema planner_schema(void)
+{
+  const AttributeSchema attributes[] = {
+    {"id", TYPE_INT, 0},
+    {"dept", TYPE_INT, 0},
+    {"name", TYPE_CHAR, 15},
+  };
+  TableSchema schema;
+  schema_init(&schema, attributes, 3, "id");
+  return schema;
+}
+
+typedef struct {
+  int *ids;
+  int count;
+} RowSet;
+
+static int collect(const Record *record, void *ctx)
+{
+  RowSet *rows = ctx;
+  if (rows->count < RECORDS_NUM) {
+    rows->ids[rows->count] = record->values[0].int_value;
+  }
+  rows->count++;
+  return 0;
+}
+
+static int compare_ints(const void *a, const void *b)
+{
+  const int x = *(const int *)a;
+  const int y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+static int holds(ExecCompare compare, int value, int constant)
+{
+  switch (compare) {
+    case EXEC_EQ: return value == constant;
+    case EXEC_LT: return value < constant;
+    default: return value >= constant;
+  }
+}
+
+/**
+ * Runs one plan and checks that it returns exactly the rows of the predicate.
+ */
+static void check_rows(const BPlusAccessPaths *paths, const BPlusPredicate *predicate, BPlusPlanKind kind,
+                       int secondary, const char *name)
+{
+  static const char *paths_names[] = {"full scan", "index scan", "bitmap scan"};
+  BPlusPlan plan;
+  memset(&plan, 0, sizeof(plan));
+  plan.kind = kind;
+  plan.secondary = secondary;
+
+  RowSet rows = {malloc(RECORDS_NUM * sizeof(int)), 0};
+  const int visited = bplus_plan_execute(paths, predicate, &plan, collect, &rows);
+  CHECK(visited == rows.count, "%s, %s: returned %d, visited %d rows", name, paths_names[kind], visited, rows.count);
+  qsort(rows.ids, rows.count < RECORDS_NUM ? rows.count : RECORDS_NUM, sizeof(int), compare_ints);
+
+  int expected = 0;
+  int wrong = 0;
+  for (int id = 0; id < RECORDS_NUM; id++) {
+    const int value = predicate->column == 0 ? id : dept_of(id);
+    if (holds(predicate->compare, value, predicate->value.int_value)) {
+      wrong += expected >= rows.count || rows.ids[expected] != id;
+      expected++;
+    }
+  }
+  CHECK(rows.count == expected, "%s, %s: %d rows, expected %d", name, paths_names[kind], rows.count, expected);
+  CHECK(wrong == 0, "%s, %s: %d rows differ", name, paths_names[kind], wrong);
+  free(rows.ids);
+}
+
+/**
+ * Every access path that applies to the predicate returns the same rows as a full scan.
+ */
+static void check_paths(const BPlusAccessPaths *paths, int column, ExecCompare compare, int value, const char *name)
+{
+  BPlusPredicate predicate;
+  memset(&predicate, 0, sizeof(predicate));
+  predicate.column = column;
+  predicate.compare = compare;
+  predicate.value.int_value = value;
+
+  check_rows(paths, &predicate, BPLUS_PLAN_FULL_SCAN, -1, name);
+  if (column == 0) {
+    check_rows(paths, &predicate, BPLUS_PLAN_INDEX_SCAN, -1, name);
+  } else if (compare == EXEC_EQ) {
+    check_rows(paths, &predicate, BPLUS_PLAN_INDEX_SCAN, 0, name);
+    check_rows(paths, &predicate, BPLUS_PLAN_BITMAP_SCAN, 0, name);
+  }
+
+  // the plan of bplus_plan itself returns the same rows
+  BPlusPlan plan;
+  CHECK(bplus_plan(paths, &predicate, &plan) == 0, "%s: bplus_plan failed", name);
+  check_rows(paths, &predicate, plan.kind, plan.secondary, name);
+}
+
+/**
+ * Plans for a rare and a common value of the skewed column, and for ranges.
+ */
+static void check_choices(const BPlusAccessPaths *paths)
+{
+  BPlusPredicate predicate;
+  memset(&predicate, 0, sizeof(predicate));
+  BPlusPlan plan;
+
+  predicate.column = 1;
+  predicate.compare = EXEC_EQ;
+  predicate.value.int_value = RARE_DEPT;
+  CHECK(bplus_plan(paths, &predicate, &plan) == 0, "rare dept: bplus_plan failed");
+  CHECK(plan.kind == BPLUS_PLAN_INDEX_SCAN || plan.kind == BPLUS_PLAN_BITMAP_SCAN, "rare dept: plan %d", plan.kind);
+  CHECK(plan.secondary == 0, "rare dept: secondary %d", plan.secondary);
+  CHECK(plan.estimated_rows < RECORDS_NUM / 100, "rare dept: %.0f rows estimated", plan.estimated_rows);
+  bplus_plan_print(&plan);
+
+  predicate.value.int_value = 0;
+  CHECK(bplus_plan(paths, &predicate, &plan) == 0, "common dept: bplus_plan failed");
+  CHECK(plan.kind == BPLUS_PLAN_FULL_SCAN, "common dept: plan %d", plan.kind);
+  CHECK(plan.estimated_rows > RECORDS_NUM / 2, "common dept: %.0f rows estimated", plan.estimated_rows);
+  CHECK(plan.index_cost > plan.cost && plan.bitmap_cost > plan.cost, "common dept: index %.1f bitmap %.1f full %.1f",
+        plan.index_cost, plan.bitmap_cost, plan.cost);
+  bplus_plan_print(&plan);
+
+  // the secondary index only answers EQ
+  predicate.compare = EXEC_GE;
+  predicate.value.int_value = DEPTS;
+  CHECK(bplus_plan(paths, &predicate, &plan) == 0, "dept range: bplus_plan failed");
+  CHECK(plan.kind == BPLUS_PLAN_FULL_SCAN && plan.index_cost < 0 && plan.bitmap_cost < 0,
+        "dept range: plan %d, index %.1f, bitmap %.1f", plan.kind, plan.index_cost, plan.bitmap_cost);
+
+  predicate.column = 0;
+  predicate.compare = EXEC_LT;
+  predicate.value.int_value = 100;
+  CHECK(bplus_plan(paths, &predicate, &plan) == 0, "short id range: bplus_plan failed");
+  CHECK(plan.kind == BPLUS_PLAN_INDEX_SCAN && plan.secondary == -1, "short id range: plan %d, secondary %d",
+        plan.kind, plan.secondary);
+
+  predicate.column = 3;
+  CHECK(bplus_plan(paths, &predicate, &plan) == -1, "column out of range planned");
+}
+
+int main() {
+  const TableSchema schema = planner_schema();
+  BF_Init(LRU);
+  remove(FILE_NAME);
+  remove(INDEX_NAME);
+  if (bplus_create_file(&schema, FILE_NAME) == -1 || bplus_secondary_create(&schema, "dept", INDEX_NAME) == -1) {
+    fprintf(stderr, "cannot create %s and %s\n", FILE_NAME, INDEX_NAME);
+    return 1;
+  }
+  int file_desc, index_desc;
+  BPlusMeta *info, *index_info;
+  if (bplus_open_file(FILE_NAME, &file_desc, &info) == -1 ||
+      bplus_open_file(INDEX_NAME, &index_desc, &index_info) == -1) {
+    fprintf(stderr, "cannot open %s and %s\n", FILE_NAME, INDEX_NAME);
+    return 1;
+  }
+
+  // ids in a scattered order, so the leaves are split as by random inserts
+  int failed = 0;
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    const int id = (int)((long)i * 7919 % RECORDS_NUM);
+    Record record;
+    record_create(&schema, &record, id, dept_of(id), "row");
+    failed += bplus_record_insert(file_desc, info, &record) == -1 ||
+              bplus_secondary_insert(index_desc, index_info, &record.values[1], id) == -1;
+  }
+  CHECK(failed == 0, "%d inserts failed", failed);
+
+  BPlusTableStats stats;
+  CHECK(bplus_analyze(file_desc, info, &stats) == 0, "bplus_analyze failed");
+  CHECK(stats.row_count == RECORDS_NUM, "analyze: %ld rows", stats.row_count);
+  CHECK(stats.columns[0].distinct_count == RECORDS_NUM, "analyze: %ld distinct ids", stats.columns[0].distinct_count);
+  CHECK(stats.columns[1].distinct_count == DEPTS + 1, "analyze: %ld distinct depts", stats.columns[1].distinct_count);
+
+  const BPlusSecondaryPath secondary = {index_desc, index_info};
+  const BPlusAccessPaths paths = {file_desc, info, &stats, &secondary, 1};
+  check_choices(&paths);
+
+  check_paths(&paths, 1, EXEC_EQ, RARE_DEPT, "dept = rare");
+  check_paths(&paths, 1, EXEC_EQ, 0, "dept = common");
+  check_paths(&paths, 1, EXEC_EQ, DEPTS + 1, "dept = absent");
+  check_paths(&paths, 1, EXEC_LT, 5, "dept < 5");
+  check_paths(&paths, 1, EXEC_GE, DEPTS / 2, "dept >= half");
+  check_paths(&paths, 0, EXEC_EQ, 1234, "id = 1234");
+  check_paths(&paths, 0, EXEC_LT, 100, "id < 100");
+  check_paths(&paths, 0, EXEC_LT, INT_MIN, "id < INT_MIN");
+  check_paths(&paths, 0, EXEC_GE, RECORDS_NUM - 50, "id >= last 50");
+  check_paths(&paths, 0, EXEC_GE, 0, "id >= 0");
+
+  bplus_close_file(index_desc, index_info);
+  bplus_close_file(file_desc, info);
+  BF_Close();
+  remove(FILE_NAME);
+  remove(INDEX_NAME);
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
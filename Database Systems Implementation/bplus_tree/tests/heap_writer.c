@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <string.h>
+#include "bf.h"
+#include "hp_file_funcs.h"
+#include "hp_file_structs.h"
+#include "record.h"
+#include "heap_writer.h"
+
+int heap_write_records(const char *file_name, int count)
+{
+  if (!HeapFile_Create(file_name)) {
+    return -1;
+  }
+  int file_desc;
+  HeapFileHeader *header;
+  if (!HeapFile_Open(file_name, &file_desc, &header)) {
+    return -1;
+  }
+
+  int result = 0;
+  for (int i = 0; i < count && result == 0; i++) {
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.id = i;
+    snprintf(record.name, sizeof(record.name), "name%d", i % 13);
+    snprintf(record.surname, sizeof(record.surname), "surname%d", i % 17);
+    snprintf(record.city, sizeof(record.city), "city%d", i % HEAP_WRITER_CITIES);
+    if (!HeapFile_InsertRecord(file_desc, header, record)) {
+      result = -1;
+    }
+  }
+  if (!HeapFile_Close(file_desc, header)) {
+    result = -1;
+  }
+  return result;
+}
+
+int heap_record_stride(void)
+{
+  return (int)sizeof(Record);
+}
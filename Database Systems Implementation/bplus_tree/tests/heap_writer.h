@@ -0,0 +1,31 @@
+#ifndef HEAP_WRITER_H
+#define HEAP_WRITER_H
+
+/**
+ * Heap files for the tests
+ *
+ * Writes heap files with the code of the heap file project (../Heapfolder),
+ * so the tests read the layout that project really writes. heap_writer.c is
+ * compiled with the headers of that project, whose Record is not the one of
+ * record.h, so nothing here uses either Record.
+ *
+ * Record i of a file has id i, name "name<i % 13>", surname
+ * "surname<i % 17>" and city "city<i % HEAP_WRITER_CITIES>".
+ */
+
+#define HEAP_WRITER_CITIES 7
+
+/**
+ * @brief Creates a heap file and inserts records 0..count-1 one at a time with HeapFile_InsertRecord.
+ * @param file_name Name of the heap file, which must not exist yet.
+ * @param count Number of records.
+ * @return 0 on success, -1 on failure.
+ */
+int heap_write_records(const char *file_name, int count);
+
+/**
+ * @brief Bytes from one record of a data block to the next (sizeof the heap Record).
+ */
+int heap_record_stride(void);
+
+#endif
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "record_generator.h"
+#include "tree_check.h"
+
+#define OUTPUT_SIZE 256 // Bytes of captured output per print
+
+/**
+ * Runs a printer with stdout sent to a temporary file and returns what it wrote.
+ */
+static void capture(RecordPrinter print, const TableSchema *schema, const Record *record, char *out)
+{
+  fflush(stdout);
+  FILE *file = tmpfile();
+  const int saved = dup(fileno(stdout));
+  dup2(fileno(file), fileno(stdout));
+  print(schema, record);
+  fflush(stdout);
+  dup2(saved, fileno(stdout));
+  close(saved);
+  rewind(file);
+  const size_t n = fread(out, 1, OUTPUT_SIZE - 1, file);
+  out[n] = '\0';
+  fclose(file);
+}
+
+/**
+ * Checks that the compiled layout of a schema is picked, and that it writes,
+ * reads and prints a record like record.h does, with a text field that
+ * fills its attribute and so has no NUL.
+ */
+static void check_layout(const char *name, const TableSchema *schema, const Record *record)
+{
+  CHECK(record_serializer(schema) != record_serialize, "%s: compiled serializer not picked", name);
+  CHECK(record_deserializer(schema) != record_deserialize, "%s: compiled deserializer not picked", name);
+  CHECK(record_printer(schema) != record_print, "%s: compiled printer not picked", name);
+
+  // the same bytes, zero padding of the shorter text fields included
+  char packed[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  char compiled_packed[MAX_ATTRIBUTES * MAX_STRING_LENGTH];
+  memset(packed, 0x5a, sizeof(packed));
+  memset(compiled_packed, 0xa5, sizeof(compiled_packed));
+  record_serialize(schema, record, packed);
+  record_serializer(schema)(schema, record, compiled_packed);
+  CHECK(memcmp(packed, compiled_packed, schema->record_size) == 0, "%s: serialized differently", name);
+  Record generic;
+  Record compiled;
+  memset(&generic, 0x5a, sizeof(generic));
+  memset(&compiled, 0x5a, sizeof(compiled));
+  record_deserialize(schema, packed, &generic);
+  record_deserializer(schema)(schema, packed, &compiled);
+  for (int i = 0; i < schema->count; i++) {
+    const int same = schema->attributes[i].type == TYPE_CHAR
+                       ? strncmp(generic.values[i].string_value, compiled.values[i].string_value,
+                                 MAX_STRING_LENGTH) == 0
+                       : generic.values[i].int_value == compiled.values[i].int_value;
+    CHECK(same, "%s: field %s deserialized differently", name, schema->attributes[i].name);
+  }
+
+  char expected[OUTPUT_SIZE];
+  char output[OUTPUT_SIZE];
+  capture(record_print, schema, &generic, expected);
+  capture(record_printer(schema), schema, &compiled, output);
+  CHECK(strcmp(expected, output) == 0, "%s: printed \"%s\", expected \"%s\"", name, output, expected);
+  CHECK(strstr(output, "ABCDEFGHIJKLMNOPQRST,") != NULL, "%s: full text field printed as \"%s\"", name, output);
+}
+
+int main() {
+  const TableSchema employee = employee_get_schema();
+  const TableSchema student = student_get_schema();
+  Record record;
+
+  employee_make(&record, 42, "ABCDEFGHIJKLMNOPQRST", "Nikolaou", "Patra");
+  check_layout("employee", &employee, &record);
+  student_make(&record, 7, "ABCDEFGHIJKLMNOPQRST", "Georgiou", "EKPA", "MATH");
+  check_layout("student", &student, &record);
+
+  // a schema with no compiled layout keeps the functions of record.h
+  const AttributeSchema attributes[] = {{"id", TYPE_INT, 0}, {"name", TYPE_CHAR, 15}};
+  TableSchema other;
+  schema_init(&other, attributes, 2, "id");
+  CHECK(record_serializer(&other) == record_serialize, "other schema: compiled serializer picked");
+  CHECK(record_deserializer(&other) == record_deserialize, "other schema: compiled deserializer picked");
+  CHECK(record_printer(&other) == record_print, "other schema: compiled printer picked");
+
+  printf("%s\n", check_failures == 0 ? "PASS" : "FAIL");
+  return check_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+// Έλεγχος των αναλλοίωτων ενός B+ δέντρου για τα tests: βάθος, γέμισμα κόμβων,
+// σειρά κλειδιών στους κόμβους και στη λίστα φύλλων, πλήθη υποδέντρων και
+// λίστα ελεύθερων blocks.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "bplus_datanode.h"
+#include "bplus_index_node.h"
+#include "bplus_key.h"
+#include "tree_check.h"
+
+int check_failures = 0;
+
+typedef struct {
+  int file_desc;
+  const BPlusMeta *metadata;
+  TreeShape *shape;
+  int *leaf_order;   // τα φυλλα με τη σειρα που τα βρισκει η καταβαση
+  int leaf_allocated;
+  int errors;
+} Walk;
+
+static void violation(Walk *walk, const char *what, const int block_id)
+{
+  if (walk->errors++ < 10) {
+    fprintf(stderr, "tree_check: %s (block %d)\n", what, block_id);
+  }
+}
+
+static int read_block(const int file_desc, const int block_id, char *copy)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  const int ok = BF_GetBlock(file_desc, block_id, block) == BF_OK;
+  if (ok) {
+    memcpy(copy, BF_Block_GetData(block), BF_BLOCK_SIZE);
+    BF_UnpinBlock(block);
+  }
+  BF_Block_Destroy(&block);
+  return ok ? 0 : -1;
+}
+
+// Ελεγχει το υποδεντρο του block_id με κλειδια στο [low, high) (NULL χωρις οριο)
+// και επιστρεφει ποσες εγγραφες εχει
+static long walk_node(Walk *walk, const int block_id, const int level, const unsigned char *low,
+                      const unsigned char *high)
+{
+  const BPlusMeta *metadata = walk->metadata;
+  const TableSchema *schema = &metadata->table_schema;
+  const int key_size = schema->key_size;
+  const int root = level == 0;
+  char data[BF_BLOCK_SIZE];
+  unsigned char key[BPLUS_MAX_KEY_SIZE], previous[BPLUS_MAX_KEY_SIZE];
+
+  if (read_block(walk->file_desc, block_id, data) == -1) {
+    violation(walk, "unreadable block", block_id);
+    return 0;
+  }
+
+  if (level == metadata->depth - 1) {
+    const BPlusDataNode *leaf = (const BPlusDataNode *)data;
+    const int capacity = metadata->leaf_capacity;
+    if (leaf->is_leaf != 1) {
+      violation(walk, "leaf level block is not a leaf", block_id);
+      return 0;
+    }
+    if (leaf->key_count > capacity || leaf->key_count < (root ? 1 : capacity / 2)) {
+      violation(walk, "leaf under or over full", block_id);
+    }
+    for (int i = 0; i < leaf->key_count; i++) {
+      datanode_key(data, schema, capacity, i, key);
+      if ((i > 0 && memcmp(previous, key, key_size) >= 0) || (low != NULL && memcmp(key, low, key_size) < 0) ||
+          (high != NULL && memcmp(key, high, key_size) >= 0)) {
+        violation(walk, "leaf key out of order or outside its separators", block_id);
+      }
+      memcpy(previous, key, key_size);
+    }
+    if (walk->shape->leaves == walk->leaf_allocated) {
+      walk->leaf_allocated = walk->leaf_allocated == 0 ? 64 : 2 * walk->leaf_allocated;
+      walk->leaf_order = realloc(walk->leaf_order, walk->leaf_allocated * sizeof(int));
+    }
+    walk->leaf_order[walk->shape->leaves++] = block_id;
+    return leaf->key_count;
+  }
+
+  const BPlusIndexNode *node = (const BPlusIndexNode *)data;
+  const int capacity = metadata->index_capacity;
+  if (node->is_leaf != 0) {
+    violation(walk, "index level block is not an index node", block_id);
+    return 0;
+  }
+  if (node->key_count > capacity || node->key_count < (root ? 1 : capacity / 2)) {
+    violation(walk, "index node under or over full", block_id);
+  }
+  walk->shape->index_nodes++;
+
+  // τα παιδια και τα πληθη αντιγραφονται: η αναδρομη ξαναχρησιμοποιει τη στοιβα
+  const int children = node->key_count + 1;
+  int *child_ids = malloc(children * sizeof(int));
+  int *counts = malloc(children * sizeof(int));
+  unsigned char *separators = malloc((size_t)(node->key_count + 1) * key_size);
+  memcpy(child_ids, indexnode_children(data, capacity), children * sizeof(int));
+  memcpy(counts, indexnode_counts(data, capacity), children * sizeof(int));
+  for (int i = 0; i < node->key_count; i++) {
+    indexnode_key(data, capacity, key_size, i, separators + (size_t)i * key_size);
+    if ((i > 0 && memcmp(separators + (size_t)(i - 1) * key_size, separators + (size_t)i * key_size, key_size) >= 0) ||
+        (low != NULL && memcmp(separators + (size_t)i * key_size, low, key_size) < 0) ||
+        (high != NULL && memcmp(separators + (size_t)i * key_size, high, key_size) >= 0)) {
+      violation(walk, "separator out of order or outside its parent's range", block_id);
+    }
+  }
+
+  long total = 0;
+  for (int i = 0; i < children; i++) {
+    const unsigned char *child_low = i == 0 ? low : separators + (size_t)(i - 1) * key_size;
+    const unsigned char *child_high = i == children - 1 ? high : separators + (size_t)i * key_size;
+    const long records = walk_node(walk, child_ids[i], level + 1, child_low, child_high);
+    if (!metadata->counts_stale && records != counts[i]) {
+      violation(walk, "subtree count does not match its records", block_id);
+    }
+    total += records;
+  }
+  free(child_ids);
+  free(counts);
+  free(separators);
+  return total;
+}
+
+int tree_check(const int file_desc, const BPlusMeta *metadata, TreeShape *shape)
+{
+  TreeShape local;
+  Walk walk = {file_desc, metadata, shape != NULL ? shape : &local, NULL, 0, 0};
+  memset(walk.shape, 0, sizeof(TreeShape));
+  char data[BF_BLOCK_SIZE];
+
+  if (metadata->root_block_num == -1) {
+    if (metadata->depth != 0 || metadata->data_block_count != 0 || metadata->index_block_count != 0) {
+      violation(&walk, "empty tree with nodes in its metadata", -1);
+    }
+  } else {
+    walk.shape->records = walk_node(&walk, metadata->root_block_num, 0, NULL, NULL);
+
+    // η λιστα των φυλλων περναει απο τα ιδια φυλλα με την ιδια σειρα
+    int block_id = walk.leaf_order[0];
+    for (int i = 0; i < walk.shape->leaves; i++) {
+      if (block_id != walk.leaf_order[i]) {
+        violation(&walk, "leaf chain does not follow key order", block_id);
+        break;
+      }
+      if (read_block(file_desc, block_id, data) == -1) {
+        break;
+      }
+      block_id = ((const BPlusDataNode *)data)->next_block;
+    }
+    if (block_id != -1 && walk.errors == 0) {
+      violation(&walk, "leaf chain goes past the last leaf", block_id);
+    }
+  }
+  if (walk.shape->leaves != metadata->data_block_count || walk.shape->index_nodes != metadata->index_block_count) {
+    violation(&walk, "node counters of the metadata do not match the tree", metadata->root_block_num);
+  }
+  if (walk.shape->leaves > 0) {
+    walk.shape->leaf_fill = (double)walk.shape->records / ((double)walk.shape->leaves * metadata->leaf_capacity);
+  }
+
+  // λιστα ελευθερων: μονο ελευθερα blocks, χωρις κυκλους
+  BF_GetBlockCounter(file_desc, &walk.shape->blocks);
+  for (int block_id = metadata->free_block_head; block_id != -1;) {
+    if (walk.shape->free_blocks > walk.shape->blocks || read_block(file_desc, block_id, data) == -1 ||
+        ((const BPlusFreeBlock *)data)->is_leaf != BPLUS_FREE_BLOCK) {
+      violation(&walk, "free list holds a block in use or loops", block_id);
+      break;
+    }
+    walk.shape->free_blocks++;
+    block_id = ((const BPlusFreeBlock *)data)->next_free;
+  }
+  if (1 + walk.shape->leaves + walk.shape->index_nodes + walk.shape->free_blocks != walk.shape->blocks) {
+    violation(&walk, "blocks are neither in the tree nor on the free list", -1);
+  }
+
+  free(walk.leaf_order);
+  return walk.errors == 0 ? 0 : -1;
+}
+
+Record *tree_leaf_records(const int file_desc, const BPlusMeta *metadata, long *count)
+{
+  const TableSchema *schema = &metadata->table_schema;
+  char data[BF_BLOCK_SIZE];
+  Record *records = NULL;
+  long allocated = 0;
+  *count = 0;
+
+  // το αριστεροτερο φυλλο
+  int block_id = metadata->root_block_num;
+  for (int level = 0; block_id != -1 && level < metadata->depth - 1; level++) {
+    if (read_block(file_desc, block_id, data) == -1) {
+      return NULL;
+    }
+    block_id = indexnode_children(data, metadata->index_capacity)[0];
+  }
+
+  while (block_id != -1) {
+    if (read_block(file_desc, block_id, data) == -1) {
+      free(records);
+      *count = 0;
+      return NULL;
+    }
+    const BPlusDataNode *leaf = (const BPlusDataNode *)data;
+    if (*count + leaf->key_count > allocated) {
+      allocated = 2 * (*count + leaf->key_count);
+      records = realloc(records, allocated * sizeof(Record));
+    }
+    for (int i = 0; i < leaf->key_count; i++) {
+      record_deserialize(schema, datanode_record(data, schema, metadata->leaf_capacity, i), &records[(*count)++]);
+    }
+    block_id = leaf->next_block;
+  }
+  return records;
+}
@@ -0,0 +1,70 @@
+#ifndef BP_TREE_CHECK_H
+#define BP_TREE_CHECK_H
+
+#include "bplus_file_structs.h"
+
+/**
+ * Test support
+ *
+ * Every tests/..._test.c is a program that returns 0 when all its checks
+ * pass (make test builds and runs them in turn). tree_check walks a B+ tree
+ * file through BF and checks the invariants every operation must keep.
+ */
+
+/**
+ * @brief Shape of a checked tree.
+ */
+typedef struct {
+    long records;      /**< Records in the leaves */
+    int leaves;        /**< Leaves reached from the root */
+    int index_nodes;   /**< Index nodes reached from the root */
+    int free_blocks;   /**< Blocks on the free list */
+    int blocks;        /**< Blocks of the file, block 0 included */
+    double leaf_fill;  /**< Mean records per leaf over the leaf capacity */
+} TreeShape;
+
+/**
+ * @brief Checks the invariants of a primary B+ tree file.
+ *
+ * All leaves are at depth metadata->depth and every node but the root is at
+ * least half full. Keys are strictly ascending inside each node and along the
+ * leaf chain, and lie between the separators above them. The subtree counts
+ * match the records (unless metadata->counts_stale). The node counters of the
+ * metadata match the nodes found, the free list holds only free blocks, and
+ * every block of the file is block 0, a node or on the free list.
+ * Violations are printed to stderr.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the open file.
+ * @param shape Receives the shape of the tree (may be NULL).
+ * @return 0 if every invariant holds, -1 otherwise.
+ */
+int tree_check(int file_desc, const BPlusMeta *metadata, TreeShape *shape);
+
+/**
+ * @brief Reads the records of a B+ tree file in leaf chain order.
+ *
+ * Goes down the leftmost path and follows next_block, without any of the
+ * search or scan functions under test.
+ * @param file_desc File descriptor of the B+ tree file.
+ * @param metadata Metadata of the open file.
+ * @param count Receives the number of records.
+ * @return malloc'd array of the records (NULL for an empty tree or on failure).
+ */
+Record *tree_leaf_records(int file_desc, const BPlusMeta *metadata, long *count);
+
+/**
+ * @brief Prints a failed check and counts it.
+ */
+#define CHECK(condition, ...)                                           \
+    do {                                                                \
+        if (!(condition)) {                                             \
+            fprintf(stderr, "%s:%d: check failed: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                               \
+            fprintf(stderr, "\n");                                      \
+            check_failures++;                                           \
+        }                                                               \
+    } while (0)
+
+extern int check_failures;
+
+#endif
@@ -0,0 +1,289 @@
+// Υποστήριξη για τα benchmarks: μέτρηση σελίδων I/O με ένα σκιώδες LRU buffer
+// pool πάνω από τις κλήσεις του BF, χρονομέτρηση και γραμμές CSV.
+
+#include "bench.h"
+#include "bf.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BLOCK_TABLE_SIZE 4096 // ποιο block κραταει καθε BF_Block*, direct mapped
+
+typedef struct {
+  int file_desc;
+  int block_num;
+  int dirty;
+  int prev;       // προς το πιο προσφατο
+  int next;       // προς το λιγοτερο προσφατο, ή επομενο ελευθερο
+  int hash_next;  // επομενο στην ιδια αλυσιδα
+} Frame;
+
+typedef struct {
+  const BF_Block *block;
+  int file_desc;
+  int block_num;
+} BlockOwner;
+
+static Frame *frames;
+static int frame_count;
+static int *buckets;
+static int bucket_mask;
+static int most_recent = -1;
+static int least_recent = -1;
+static int free_frames = -1;
+static BenchIO counters;
+static BlockOwner owners[BLOCK_TABLE_SIZE];
+
+BF_ErrorCode __real_BF_GetBlock(int file_desc, int block_num, BF_Block *block);
+BF_ErrorCode __real_BF_AllocateBlock(int file_desc, BF_Block *block);
+void __real_BF_Block_SetDirty(BF_Block *block);
+BF_ErrorCode __real_BF_CloseFile(int file_desc);
+
+int bench_io_init(const int frame_total)
+{
+  int bucket_total = 1;
+  while (bucket_total < 2 * frame_total) {
+    bucket_total *= 2;
+  }
+  frames = malloc(frame_total * sizeof(Frame));
+  buckets = malloc(bucket_total * sizeof(int));
+  if (frames == NULL || buckets == NULL) {
+    free(frames);
+    free(buckets);
+    return -1;
+  }
+
+  frame_count = frame_total;
+  bucket_mask = bucket_total - 1;
+  for (int i = 0; i < bucket_total; i++) {
+    buckets[i] = -1;
+  }
+  for (int i = 0; i < frame_total; i++) {
+    frames[i].next = i + 1 < frame_total ? i + 1 : -1;
+  }
+  free_frames = 0;
+  return 0;
+}
+
+static int bucket_of(const int file_desc, const int block_num)
+{
+  return (int)(((uint32_t)block_num * 2654435761u) ^ (uint32_t)file_desc * 40503u) & bucket_mask;
+}
+
+static int lookup(const int file_desc, const int block_num)
+{
+  int f = buckets[bucket_of(file_desc, block_num)];
+  while (f != -1 && (frames[f].file_desc != file_desc || frames[f].block_num != block_num)) {
+    f = frames[f].hash_next;
+  }
+  return f;
+}
+
+static void unlink_lru(const int f)
+{
+  if (frames[f].prev != -1) {
+    frames[frames[f].prev].next = frames[f].next;
+  } else {
+    most_recent = frames[f].next;
+  }
+  if (frames[f].next != -1) {
+    frames[frames[f].next].prev = frames[f].prev;
+  } else {
+    least_recent = frames[f].prev;
+  }
+}
+
+static void push_front(const int f)
+{
+  frames[f].prev = -1;
+  frames[f].next = most_recent;
+  if (most_recent != -1) {
+    frames[most_recent].prev = f;
+  }
+  most_recent = f;
+  if (least_recent == -1) {
+    least_recent = f;
+  }
+}
+
+// βγαζει το frame απο το pool, γραφοντας το αν ειναι dirty
+static void drop(const int f)
+{
+  int *link = &buckets[bucket_of(frames[f].file_desc, frames[f].block_num)];
+  while (*link != f) {
+    link = &frames[*link].hash_next;
+  }
+  *link = frames[f].hash_next;
+  unlink_lru(f);
+  counters.writes += frames[f].dirty;
+}
+
+// Μια αιτηση για block: hit, ή miss που παιρνει ελευθερο frame ή διωχνει το LRU
+static void access_block(const int file_desc, const int block_num, const int allocated)
+{
+  if (frames == NULL) {
+    return;
+  }
+
+  int f = lookup(file_desc, block_num);
+  if (f != -1) {
+    counters.hits++;
+    unlink_lru(f);
+    push_front(f);
+    frames[f].dirty |= allocated;
+    return;
+  }
+
+  if (allocated) {
+    counters.allocations++;
+  } else {
+    counters.misses++;
+  }
+  if (free_frames != -1) {
+    f = free_frames;
+    free_frames = frames[f].next;
+  } else {
+    f = least_recent;
+    drop(f);
+  }
+
+  const int bucket = bucket_of(file_desc, block_num);
+  frames[f].file_desc = file_desc;
+  frames[f].block_num = block_num;
+  frames[f].dirty = allocated;
+  frames[f].hash_next = buckets[bucket];
+  buckets[bucket] = f;
+  push_front(f);
+}
+
+static BlockOwner *owner_of(const BF_Block *block)
+{
+  return &owners[((uintptr_t)block >> 4) % BLOCK_TABLE_SIZE];
+}
+
+BF_ErrorCode __wrap_BF_GetBlock(const int file_desc, const int block_num, BF_Block *block)
+{
+  const BF_ErrorCode code = __real_BF_GetBlock(file_desc, block_num, block);
+  if (code == BF_OK) {
+    access_block(file_desc, block_num, 0);
+    *owner_of(block) = (BlockOwner){block, file_desc, block_num};
+  }
+  return code;
+}
+
+BF_ErrorCode __wrap_BF_AllocateBlock(const int file_desc, BF_Block *block)
+{
+  const BF_ErrorCode code = __real_BF_AllocateBlock(file_desc, block);
+  int blocks;
+  if (code == BF_OK && BF_GetBlockCounter(file_desc, &blocks) == BF_OK) {
+    access_block(file_desc, blocks - 1, 1);
+    *owner_of(block) = (BlockOwner){block, file_desc, blocks - 1};
+  }
+  return code;
+}
+
+void __wrap_BF_Block_SetDirty(BF_Block *block)
+{
+  __real_BF_Block_SetDirty(block);
+  const BlockOwner *owner = owner_of(block);
+  if (frames != NULL && owner->block == block) {
+    const int f = lookup(owner->file_desc, owner->block_num);
+    if (f != -1) {
+      frames[f].dirty = 1;
+    }
+  }
+}
+
+BF_ErrorCode __wrap_BF_CloseFile(const int file_desc)
+{
+  // οσα frames του αρχειου μενουν γραφονται στο κλεισιμο
+  for (int f = 0; frames != NULL && f < frame_count; f++) {
+    if (lookup(file_desc, frames[f].block_num) == f && frames[f].file_desc == file_desc) {
+      drop(f);
+      frames[f].next = free_frames;
+      free_frames = f;
+    }
+  }
+  return __real_BF_CloseFile(file_desc);
+}
+
+BenchIO bench_io(void)
+{
+  return counters;
+}
+
+double bench_now(void)
+{
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+void bench_print_header(void)
+{
+  printf("benchmark,distribution,records,ops,seconds,ops_per_sec,p50_us,p90_us,p99_us,p999_us,"
+         "hits_per_op,misses_per_op,allocations_per_op,writes_per_op\n");
+  fflush(stdout);
+}
+
+int bench_begin(BenchRun *run, const char *name, const long expected_ops)
+{
+  run->name = name;
+  run->ops = 0;
+  run->expected_ops = expected_ops > 0 ? expected_ops : 1;
+  run->sample_stride = (run->expected_ops + BENCH_MAX_SAMPLES - 1) / BENCH_MAX_SAMPLES;
+  run->sample_count = 0;
+  run->samples = malloc((run->expected_ops / run->sample_stride + 1) * sizeof(double));
+  run->io_start = counters;
+  run->started = bench_now();
+  return run->samples == NULL ? -1 : 0;
+}
+
+void bench_record(BenchRun *run, const double op_start)
+{
+  if (run->ops % run->sample_stride == 0 && run->sample_count <= run->expected_ops / run->sample_stride) {
+    run->samples[run->sample_count++] = bench_now() - op_start;
+  }
+  run->ops++;
+}
+
+void bench_record_batch(BenchRun *run, const double batch_start, const long count)
+{
+  if (count > 0 && run->sample_count <= run->expected_ops / run->sample_stride) {
+    run->samples[run->sample_count++] = (bench_now() - batch_start) / count;
+  }
+  run->ops += count;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+  const double x = *(const double *)a;
+  const double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double percentile(const BenchRun *run, const double fraction)
+{
+  if (run->sample_count == 0) {
+    return 0;
+  }
+  const long i = (long)(fraction * (run->sample_count - 1) + 0.5);
+  return run->samples[i] / 1000.0;
+}
+
+void bench_end(BenchRun *run, const char *distribution, const long records)
+{
+  const double seconds = (bench_now() - run->started) / 1e9;
+  const double ops = run->ops > 0 ? (double)run->ops : 1;
+  qsort(run->samples, run->sample_count, sizeof(double), compare_doubles);
+
+  printf("%s,%s,%ld,%ld,%.3f,%.0f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", run->name, distribution, records,
+         run->ops, seconds, run->ops / seconds, percentile(run, 0.5), percentile(run, 0.9), percentile(run, 0.99),
+         percentile(run, 0.999), (counters.hits - run->io_start.hits) / ops,
+         (counters.misses - run->io_start.misses) / ops, (counters.allocations - run->io_start.allocations) / ops,
+         (counters.writes - run->io_start.writes) / ops);
+  fflush(stdout);
+  free(run->samples);
+  run->samples = NULL;
+}
@@ -0,0 +1,104 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * Benchmark support
+ *
+ * Page I/O accounting: the benchmark binaries are linked with
+ * -Wl,--wrap for BF_GetBlock, BF_AllocateBlock, BF_Block_SetDirty and
+ * BF_CloseFile, and every call is replayed against a shadow LRU buffer pool
+ * of a chosen number of frames. libbf keeps its own pool of BF_BUFFER_SIZE
+ * frames and exposes no counters, so hits, misses and writes are those of
+ * the shadow pool: a miss is a block read, a write is a dirty frame that is
+ * evicted or dropped when its file closes. Allocations are counted apart.
+ *
+ * Latency: bench_record times every operation; at most BENCH_MAX_SAMPLES
+ * evenly spaced operations are kept for the percentiles.
+ *
+ * Each finished run prints one CSV line (see bench_print_header).
+ * Nothing here is thread safe.
+ */
+
+#define BENCH_MAX_SAMPLES 1000000
+
+/**
+ * @brief Page I/O counters of the shadow buffer pool.
+ */
+typedef struct {
+    long hits;         /**< Block requests found in the pool */
+    long misses;       /**< Block requests that had to read the block */
+    long allocations;  /**< New blocks */
+    long writes;       /**< Dirty frames written back */
+} BenchIO;
+
+/**
+ * @brief One measured benchmark.
+ */
+typedef struct {
+    const char *name;    /**< Benchmark name, first CSV column */
+    long ops;            /**< Operations recorded so far */
+    long expected_ops;   /**< Operations the run was started for */
+    double started;      /**< bench_now() at bench_begin */
+    double *samples;     /**< Sampled latencies in ns */
+    long sample_count;   /**< Samples kept */
+    long sample_stride;  /**< Every how many operations a sample is kept */
+    BenchIO io_start;    /**< Counters at bench_begin */
+} BenchRun;
+
+/**
+ * @brief Sets up the shadow buffer pool. Call before the first BF call.
+ * @param frames Frames of the simulated pool.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int bench_io_init(int frames);
+
+/**
+ * @brief Returns the page I/O counters so far.
+ */
+BenchIO bench_io(void);
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+double bench_now(void);
+
+/**
+ * @brief Prints the CSV header line.
+ */
+void bench_print_header(void);
+
+/**
+ * @brief Starts a run.
+ * @param run Run to start.
+ * @param name Benchmark name.
+ * @param expected_ops Operations the run will record (for the sampling stride).
+ * @return 0 on success, -1 on allocation failure.
+ */
+int bench_begin(BenchRun *run, const char *name, long expected_ops);
+
+/**
+ * @brief Records one operation that started at op_start (a bench_now() value).
+ * @param run Run of the operation.
+ * @param op_start Start time of the operation.
+ */
+void bench_record(BenchRun *run, double op_start);
+
+/**
+ * @brief Records count operations timed together, for operations too short to time one by one.
+ *
+ * Keeps one sample, the mean latency of the batch.
+ * @param run Run of the operations.
+ * @param batch_start Start time of the batch.
+ * @param count Operations in the batch.
+ */
+void bench_record_batch(BenchRun *run, double batch_start, long count);
+
+/**
+ * @brief Ends a run and prints its CSV line.
+ * @param run Run to end.
+ * @param distribution Key distribution, for the CSV line.
+ * @param records Records in the file, for the CSV line.
+ */
+void bench_end(BenchRun *run, const char *distribution, long records);
+
+#endif
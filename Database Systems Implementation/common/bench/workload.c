@@ -0,0 +1,220 @@
+// Γεννήτρια συνθετικών φορτίων: δείκτες εγγραφών από uniform, zipfian, hotspot,
+// sequential και latest κατανομές και μίξη πράξεων, με δική της γεννήτρια
+// τυχαίων αριθμών ώστε κάθε νήμα να έχει το δικό του Workload.
+
+#include "workload.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *distribution_names[] = {"uniform", "zipfian", "hotspot", "sequential", "latest"};
+
+static uint64_t rotl(const uint64_t x, const int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+// splitmix64, μονο για να απλωσει το seed στα 256 bits της κατάστασης
+static uint64_t splitmix(uint64_t *x)
+{
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t workload_random(Workload *workload)
+{
+  uint64_t *s = workload->state;
+  const uint64_t result = rotl(s[1] * 5, 7) * 9;
+  const uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+  return result;
+}
+
+// πολλαπλασιασμος αντι για modulo (Lemire), χωρις διαιρεση
+long workload_uniform(Workload *workload, const long bound)
+{
+  return (long)(((unsigned __int128)workload_random(workload) * (uint64_t)bound) >> 64);
+}
+
+static double next_double(Workload *workload)
+{
+  return (workload_random(workload) >> 11) * 0x1.0p-53;
+}
+
+// sum 1/i^theta για i = 1..n: ακριβως ως WORKLOAD_ZETA_EXACT, μετα Euler-Maclaurin
+static double zeta(const long n, const double theta)
+{
+  const long exact = n < WORKLOAD_ZETA_EXACT ? n : WORKLOAD_ZETA_EXACT;
+  double sum = 0;
+  for (long i = 1; i <= exact; i++) {
+    sum += pow((double)i, -theta);
+  }
+  if (n > exact) {
+    const double m = (double)exact;
+    const double end = (double)n;
+    sum += (pow(end, 1 - theta) - pow(m, 1 - theta)) / (1 - theta) + (pow(end, -theta) - pow(m, -theta)) / 2;
+  }
+  return sum;
+}
+
+// οι σταθερες του zipfian για n στοιχεια· με λιγα νεα στοιχεια προστιθενται μονο οι νεοι οροι
+static void prepare_zipf(Workload *workload, const long n)
+{
+  if (workload->zeta_items == n) {
+    return;
+  }
+  const double theta = workload->config.zipf_theta;
+  if (workload->zeta_items > 0 && n > workload->zeta_items && n - workload->zeta_items <= 64) {
+    for (long i = workload->zeta_items + 1; i <= n; i++) {
+      workload->zeta += pow((double)i, -theta);
+    }
+  } else {
+    workload->zeta = zeta(n, theta);
+  }
+  workload->zeta_items = n;
+  workload->eta = (1 - pow(2.0 / n, 1 - theta)) / (1 - workload->zeta2 / workload->zeta);
+}
+
+static long zipf_rank(Workload *workload, const long n)
+{
+  prepare_zipf(workload, n);
+  const double u = next_double(workload);
+  const double uz = u * workload->zeta;
+  if (uz < 1.0) {
+    return 0;
+  }
+  if (uz < 1.0 + workload->half_pow_theta) {
+    return n > 1 ? 1 : 0;
+  }
+  const long rank = (long)(n * pow(workload->eta * u - workload->eta + 1, workload->alpha));
+  return rank < n ? rank : n - 1;
+}
+
+void workload_config_default(WorkloadConfig *config)
+{
+  config->distribution = WORKLOAD_UNIFORM;
+  config->zipf_theta = WORKLOAD_ZIPF_THETA;
+  config->hot_keys = WORKLOAD_HOT_KEYS;
+  config->hot_ops = WORKLOAD_HOT_OPS;
+  config->read_percent = 100;
+  config->insert_percent = 0;
+  config->scramble = 1;
+}
+
+int workload_parse_distribution(const char *name, WorkloadDistribution *distribution)
+{
+  for (int i = 0; i < (int)(sizeof(distribution_names) / sizeof(distribution_names[0])); i++) {
+    if (strcmp(name, distribution_names[i]) == 0) {
+      *distribution = (WorkloadDistribution)i;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+const char *workload_distribution_name(const WorkloadDistribution distribution)
+{
+  return distribution_names[distribution];
+}
+
+int workload_parse_mix(const char *mix, WorkloadConfig *config)
+{
+  int read, insert, scan;
+  if (sscanf(mix, "%d/%d/%d", &read, &insert, &scan) != 3 || read < 0 || insert < 0 || scan < 0 ||
+      read + insert + scan != 100) {
+    return -1;
+  }
+  config->read_percent = read;
+  config->insert_percent = insert;
+  return 0;
+}
+
+void workload_init(Workload *workload, const WorkloadConfig *config, const long records, const uint64_t seed,
+                   const int thread, const int threads)
+{
+  memset(workload, 0, sizeof(*workload));
+  workload->config = *config;
+  workload->initial_records = records;
+  workload->records = records;
+  workload->thread = thread;
+  workload->threads = threads > 0 ? threads : 1;
+  workload->sequential_next = thread;
+
+  // καθε νημα ξεκινα απο διαφορετικο σημειο της ακολουθιας του splitmix
+  uint64_t x = seed ^ (0xd1b54a32d192ed03ULL * (uint64_t)(thread + 1));
+  for (int i = 0; i < 4; i++) {
+    workload->state[i] = splitmix(&x);
+  }
+
+  const double theta = config->zipf_theta;
+  workload->alpha = 1 / (1 - theta);
+  workload->zeta2 = zeta(2, theta);
+  workload->half_pow_theta = pow(0.5, theta);
+}
+
+long workload_next_index(Workload *workload)
+{
+  const long n = workload->records;
+  if (n <= 0) {
+    return -1;
+  }
+
+  switch (workload->config.distribution) {
+    case WORKLOAD_ZIPFIAN:
+      return zipf_rank(workload, n);
+    case WORKLOAD_LATEST:
+      return n - 1 - zipf_rank(workload, n);
+    case WORKLOAD_HOTSPOT: {
+      long hot = (long)(n * workload->config.hot_keys);
+      hot = hot < 1 ? 1 : hot;
+      if (hot >= n || next_double(workload) < workload->config.hot_ops) {
+        return workload_uniform(workload, hot);
+      }
+      return hot + workload_uniform(workload, n - hot);
+    }
+    case WORKLOAD_SEQUENTIAL: {
+      if (workload->sequential_next >= n) {
+        workload->sequential_next %= n;
+      }
+      const long index = workload->sequential_next;
+      workload->sequential_next += workload->threads;
+      return index;
+    }
+    default:
+      return workload_uniform(workload, n);
+  }
+}
+
+long workload_insert_index(Workload *workload)
+{
+  const long index = workload->initial_records + workload->thread + workload->inserted++ * workload->threads;
+  if (index >= workload->records) {
+    workload->records = index + 1;
+  }
+  return index;
+}
+
+int workload_key(const Workload *workload, const long index)
+{
+  // ο πολλαπλασιασμος με περιττο αριθμο mod 2^31 ειναι μεταθεση: διαφορετικα, σκορπια κλειδια
+  return workload->config.scramble ? (int)(((uint32_t)index * 2654435761u) & 0x7fffffff) : (int)index;
+}
+
+WorkloadOp workload_next_op(Workload *workload)
+{
+  const long draw = workload_uniform(workload, 100);
+  if (draw < workload->config.read_percent) {
+    return WORKLOAD_READ;
+  }
+  if (draw < workload->config.read_percent + workload->config.insert_percent) {
+    return WORKLOAD_INSERT;
+  }
+  return WORKLOAD_SCAN;
+}
@@ -0,0 +1,141 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+
+/**
+ * Synthetic workloads
+ *
+ * A Workload generates the key indexes, keys and operation mix of a
+ * benchmark. It carries its own xoshiro256** generator, so each thread uses
+ * its own Workload and nothing is shared. Records are numbered by index:
+ * indexes [0, records) exist, inserts create new ones (thread t of T takes
+ * indexes records + t, records + t + T, ...), and workload_key maps an index
+ * to its key, either unchanged or scattered over [0, 2^31) by a permutation.
+ *
+ * Distributions of the indexes that reads and scans ask for:
+ *   uniform     every existing record equally likely
+ *   zipfian     rank r with probability ~ 1 / (r + 1)^theta (YCSB method);
+ *               index 0 is the hottest
+ *   hotspot     hot_ops of the operations go to the first hot_keys of the records
+ *   sequential  0, 1, 2, ... wrapping around
+ *   latest      zipfian over recency: the newest record is the hottest
+ */
+
+#define WORKLOAD_ZIPF_THETA 0.99     /* Default zipfian skew */
+#define WORKLOAD_HOT_KEYS 0.2        /* Default hotspot: fraction of the records that are hot */
+#define WORKLOAD_HOT_OPS 0.8         /* Default hotspot: fraction of the operations on them */
+#define WORKLOAD_ZETA_EXACT 1000000  /* Zeta terms summed exactly; the rest are approximated */
+
+typedef enum {
+    WORKLOAD_UNIFORM,
+    WORKLOAD_ZIPFIAN,
+    WORKLOAD_HOTSPOT,
+    WORKLOAD_SEQUENTIAL,
+    WORKLOAD_LATEST
+} WorkloadDistribution;
+
+typedef enum {
+    WORKLOAD_READ,
+    WORKLOAD_INSERT,
+    WORKLOAD_SCAN
+} WorkloadOp;
+
+typedef struct {
+    WorkloadDistribution distribution;  /**< Distribution of reads and scans */
+    double zipf_theta;                  /**< Skew of zipfian and latest, in (0, 1) */
+    double hot_keys;                    /**< Hotspot: fraction of the records that are hot */
+    double hot_ops;                     /**< Hotspot: fraction of the operations on them */
+    int read_percent;                   /**< Share of reads in workload_next_op */
+    int insert_percent;                 /**< Share of inserts; scans get the rest of 100 */
+    int scramble;                       /**< Scatter keys over [0, 2^31) instead of key = index */
+} WorkloadConfig;
+
+typedef struct {
+    WorkloadConfig config;   /**< Configuration */
+    uint64_t state[4];       /**< xoshiro256** state */
+    long initial_records;    /**< Records that existed at workload_init */
+    long records;            /**< Indexes [0, records) are visible to this workload */
+    long inserted;           /**< Inserts made by this workload */
+    int thread;              /**< Index of the thread using this workload */
+    int threads;             /**< Threads sharing the index space */
+    long sequential_next;    /**< Next index of the sequential distribution */
+    long zeta_items;         /**< Items the zipfian constants were computed for */
+    double zeta;             /**< zeta(zeta_items, theta) */
+    double zeta2;            /**< zeta(2, theta) */
+    double alpha;            /**< 1 / (1 - theta) */
+    double eta;              /**< YCSB eta for zeta_items */
+    double half_pow_theta;   /**< 0.5^theta */
+} Workload;
+
+/**
+ * @brief Fills a configuration with the defaults: uniform, only reads, scattered keys.
+ * @param config Configuration to fill.
+ */
+void workload_config_default(WorkloadConfig *config);
+
+/**
+ * @brief Parses a distribution name (uniform, zipfian, hotspot, sequential, latest).
+ * @param name Name to parse.
+ * @param distribution Receives the distribution.
+ * @return 0 on success, -1 for an unknown name.
+ */
+int workload_parse_distribution(const char *name, WorkloadDistribution *distribution);
+
+/**
+ * @brief Returns the name of a distribution.
+ */
+const char *workload_distribution_name(WorkloadDistribution distribution);
+
+/**
+ * @brief Parses an operation mix "read/insert/scan" in percent, e.g. "90/5/5".
+ * @param mix Text to parse.
+ * @param config Receives read_percent and insert_percent.
+ * @return 0 on success, -1 if the shares are malformed or do not add up to 100.
+ */
+int workload_parse_mix(const char *mix, WorkloadConfig *config);
+
+/**
+ * @brief Starts a workload.
+ * @param workload Workload to start.
+ * @param config Configuration (copied).
+ * @param records Records that already exist (indexes [0, records)).
+ * @param seed Seed; the same seed and thread give the same stream.
+ * @param thread Index of the calling thread, from 0.
+ * @param threads Threads that insert into the same index space.
+ */
+void workload_init(Workload *workload, const WorkloadConfig *config, long records, uint64_t seed, int thread,
+                   int threads);
+
+/**
+ * @brief Returns 64 random bits.
+ */
+uint64_t workload_random(Workload *workload);
+
+/**
+ * @brief Returns a random value in [0, bound).
+ */
+long workload_uniform(Workload *workload, long bound);
+
+/**
+ * @brief Returns the index of an existing record, drawn from the distribution.
+ * @return Index, or -1 if no record exists yet.
+ */
+long workload_next_index(Workload *workload);
+
+/**
+ * @brief Returns the index of a new record and makes it visible to later reads.
+ */
+long workload_insert_index(Workload *workload);
+
+/**
+ * @brief Returns the key of a record index.
+ */
+int workload_key(const Workload *workload, long index);
+
+/**
+ * @brief Draws the next operation from the read/insert/scan mix.
+ */
+WorkloadOp workload_next_op(Workload *workload);
+
+#endif
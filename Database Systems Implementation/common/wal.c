@@ -0,0 +1,763 @@
+// Write-ahead log: εγγραφες αλλαγων σελιδας με παλια και νεα bytes (undo + redo),
+// group commit με ενα thread που κανει fsync, checkpoints οσο το αρχειο ειναι
+// ανοιχτο, και recovery στο ανοιγμα του αρχειου.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wal.h"
+
+#define WAL_PAGE 1      // αλλαγη σελιδας, αναιρειται αν η πραξη δεν εφτασε στο commit
+#define WAL_REDO_ONLY 2 // αλλαγη σελιδας που δεν αναιρειται ποτε
+#define WAL_COMMIT 3
+
+// δυο αλλαγμενα κομματια μιας σελιδας με μικροτερο κενο γραφονται ως μια εγγραφη.
+// Στα metadata δεν ενωνουμε: τα κοινα πεδια αλλαζουν απο πολλα threads και
+// το undo μιας πραξης δεν πρεπει να πειραξει bytes που δεν αλλαξε η ιδια.
+#define WAL_MERGE_GAP 16
+#define WAL_METADATA_GAP 1
+#define WAL_BUFFER_SIZE (64 * 1024)
+#define WAL_MAX_RECORD (sizeof(WalRecord) + 2 * BF_BLOCK_SIZE)
+
+// Επικεφαλιδα εγγραφης. Ακολουθουν length παλια bytes και length νεα bytes.
+typedef struct {
+  uint32_t size;     // ολη η εγγραφη σε bytes
+  uint32_t checksum; // crc32 ολης της εγγραφης με checksum = 0
+  uint64_t op_id;
+  int32_t type;
+  int32_t block_id;
+  int32_t offset;
+  int32_t length;
+} WalRecord;
+
+struct Wal {
+  char *file_name;
+  int file_desc;
+  int log_fd;
+  const char *metadata;
+  int metadata_size;
+  char metadata_image[BF_BLOCK_SIZE]; // τα metadata οπως γραφτηκαν τελευταια στο log
+  pthread_mutex_t mutex;
+  pthread_cond_t flush_cond;          // ξυπναει τον flusher
+  pthread_cond_t synced_cond;         // ξυπναει οσους περιμενουν fsync
+  pthread_t flusher;
+  int stopping;
+  int synchronous;
+  int failed;
+  uint64_t next_op_id;
+  uint64_t written;                   // bytes που δοθηκαν στον kernel
+  uint64_t synced;                    // bytes που εχουν γινει fsync
+  uint64_t log_start;                 // το written του τελευταιου checkpoint, εκει αρχιζει το log
+  int buffered;
+  char buffer[WAL_BUFFER_SIZE];
+  WalOp op;                           // η πραξη των single threaded κλησεων
+};
+
+// τα BF file descriptors ειναι μικροι αριθμοι, οποτε αρκει ενας πινακας
+static Wal *registry[BF_MAX_OPEN_FILES];
+
+// crc32 με slicing-by-8: οκτω πινακες, ενα lookup ανα byte αλλα 8 bytes ανα βημα
+static uint32_t crc_table[8][256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void)
+{
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    crc_table[0][i] = c;
+  }
+  for (int t = 1; t < 8; t++) {
+    for (int i = 0; i < 256; i++) {
+      const uint32_t c = crc_table[t - 1][i];
+      crc_table[t][i] = crc_table[0][c & 0xff] ^ (c >> 8);
+    }
+  }
+}
+
+static uint32_t crc32(const unsigned char *bytes, size_t length)
+{
+  pthread_once(&crc_once, crc_init);
+  uint32_t c = 0xFFFFFFFFu;
+  while (length >= 8) {
+    uint32_t lo, hi;
+    memcpy(&lo, bytes, 4);
+    memcpy(&hi, bytes + 4, 4);
+    lo ^= c;
+    c = crc_table[7][lo & 0xff] ^ crc_table[6][(lo >> 8) & 0xff] ^ crc_table[5][(lo >> 16) & 0xff] ^
+        crc_table[4][lo >> 24] ^ crc_table[3][hi & 0xff] ^ crc_table[2][(hi >> 8) & 0xff] ^
+        crc_table[1][(hi >> 16) & 0xff] ^ crc_table[0][hi >> 24];
+    bytes += 8;
+    length -= 8;
+  }
+  while (length-- > 0) {
+    c = crc_table[0][(c ^ *bytes++) & 0xff] ^ (c >> 8);
+  }
+  return c ^ 0xFFFFFFFFu;
+}
+
+static char *log_path(const char *file_name)
+{
+  char *path = malloc(strlen(file_name) + 5);
+  if (path != NULL) {
+    sprintf(path, "%s.wal", file_name);
+  }
+  return path;
+}
+
+// fsync του αρχειου δεδομενων, αφου το BF εχει γραψει τις σελιδες του
+static int sync_file(const char *file_name)
+{
+  const int fd = open(file_name, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  const int result = fsync(fd);
+  close(fd);
+  return result;
+}
+
+// Δινει στον kernel οτι εχει μαζευτει στο buffer (με κλειδωμενο mutex)
+static int write_out(Wal *wal)
+{
+  int done = 0;
+  while (done < wal->buffered) {
+    const ssize_t n = write(wal->log_fd, wal->buffer + done, wal->buffered - done);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("wal write");
+      wal->failed = 1;
+      return -1;
+    }
+    done += n;
+  }
+  wal->written += wal->buffered;
+  wal->buffered = 0;
+  return 0;
+}
+
+// Προσθετει μια εγγραφη στο buffer (με κλειδωμενο mutex)
+static int append(Wal *wal, WalOp *op, const int type, const int block_id, const int offset, const int length,
+                  const char *before, const char *after)
+{
+  const uint32_t size = sizeof(WalRecord) + 2 * length;
+  if (wal->buffered + size > WAL_BUFFER_SIZE && write_out(wal) == -1) {
+    return -1;
+  }
+  if (op->id == 0) {
+    op->id = ++wal->next_op_id;
+  }
+
+  char *out = wal->buffer + wal->buffered;
+  WalRecord record = {size, 0, op->id, type, block_id, offset, length};
+  memcpy(out, &record, sizeof(record));
+  memcpy(out + sizeof(record), before, length);
+  memcpy(out + sizeof(record) + length, after, length);
+  record.checksum = crc32((const unsigned char *)out, size);
+  memcpy(out + offsetof(WalRecord, checksum), &record.checksum, sizeof(record.checksum));
+
+  wal->buffered += size;
+  return 0;
+}
+
+// Γραφει τα κομματια που διαφερουν αναμεσα στο image και στο data, και
+// ενημερωνει το image ωστε η επομενη κληση να γραψει μονο τις νεες αλλαγες
+static int log_diff(Wal *wal, WalOp *op, const int type, const int block_id, char *image, const char *data,
+                    const int size, const int merge_gap)
+{
+  int pos = 0;
+  while (pos < size) {
+    // τα ιδια κομματια τα προσπερναμε 8 bytes τη φορα
+    if (pos + 8 <= size && memcmp(image + pos, data + pos, 8) == 0) {
+      pos += 8;
+      continue;
+    }
+    if (image[pos] == data[pos]) {
+      pos++;
+      continue;
+    }
+
+    const int start = pos;
+    int end = pos + 1;
+    for (pos = end; pos < size && pos - end < merge_gap; pos++) {
+      if (image[pos] != data[pos]) {
+        end = pos + 1;
+      }
+    }
+
+    if (append(wal, op, type, block_id, start, end - start, image + start, data + start) == -1) {
+      return -1;
+    }
+    pos = end;
+  }
+
+  memcpy(image, data, size);
+  return 0;
+}
+
+static void *flusher_main(void *arg)
+{
+  Wal *wal = arg;
+  pthread_mutex_lock(&wal->mutex);
+
+  while (!wal->stopping) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += WAL_GROUP_COMMIT_USEC * 1000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&wal->flush_cond, &wal->mutex, &deadline);
+
+    if (wal->written == wal->synced) {
+      continue;
+    }
+
+    // ενα fsync καλυπτει ολα τα commits που εχουν γραφτει ως τωρα
+    const uint64_t target = wal->written;
+    pthread_mutex_unlock(&wal->mutex);
+    const int result = fdatasync(wal->log_fd);
+    pthread_mutex_lock(&wal->mutex);
+
+    if (result != 0) {
+      perror("wal fsync");
+      wal->failed = 1;
+    } else if (target > wal->synced) {
+      wal->synced = target;
+    }
+    pthread_cond_broadcast(&wal->synced_cond);
+  }
+
+  pthread_mutex_unlock(&wal->mutex);
+  return NULL;
+}
+
+// περιμενει ως οτου γινει fsync μεχρι και το byte target (με κλειδωμενο mutex)
+static int wait_synced(Wal *wal, const uint64_t target)
+{
+  while (wal->synced < target && !wal->failed) {
+    pthread_cond_signal(&wal->flush_cond);
+    pthread_cond_wait(&wal->synced_cond, &wal->mutex);
+  }
+  return wal->failed ? -1 : 0;
+}
+
+Wal *wal_open(const char *file_name, const int file_desc, const void *metadata, const int metadata_size)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES || metadata_size > BF_BLOCK_SIZE) {
+    return NULL;
+  }
+
+  Wal *wal = calloc(1, sizeof(Wal));
+  char *path = log_path(file_name);
+  if (wal == NULL || path == NULL) {
+    free(wal);
+    free(path);
+    return NULL;
+  }
+
+  wal->log_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  free(path);
+  if (wal->log_fd < 0) {
+    perror("wal open");
+    free(wal);
+    return NULL;
+  }
+
+  wal->file_name = strdup(file_name);
+  wal->file_desc = file_desc;
+  wal->metadata = metadata;
+  wal->metadata_size = metadata_size;
+  memcpy(wal->metadata_image, metadata, metadata_size);
+  pthread_mutex_init(&wal->mutex, NULL);
+  pthread_cond_init(&wal->flush_cond, NULL);
+  pthread_cond_init(&wal->synced_cond, NULL);
+
+  if (pthread_create(&wal->flusher, NULL, flusher_main, wal) != 0) {
+    close(wal->log_fd);
+    free(wal->file_name);
+    free(wal);
+    return NULL;
+  }
+
+  registry[file_desc] = wal;
+  return wal;
+}
+
+Wal *wal_of(const int file_desc)
+{
+  if (file_desc < 0 || file_desc >= BF_MAX_OPEN_FILES) {
+    return NULL;
+  }
+  return registry[file_desc];
+}
+
+int wal_close(Wal *wal)
+{
+  pthread_mutex_lock(&wal->mutex);
+  write_out(wal);
+  wal->stopping = 1;
+  pthread_cond_signal(&wal->flush_cond);
+  pthread_mutex_unlock(&wal->mutex);
+  pthread_join(wal->flusher, NULL);
+
+  // το log πεταγεται μονο αφου οι σελιδες του αρχειου ειναι σιγουρα στον δισκο
+  int result = sync_file(wal->file_name);
+  close(wal->log_fd);
+  if (result == 0) {
+    char *path = log_path(wal->file_name);
+    if (path != NULL) {
+      unlink(path);
+      free(path);
+    }
+  } else {
+    perror("wal checkpoint");
+  }
+
+  if (registry[wal->file_desc] == wal) {
+    registry[wal->file_desc] = NULL;
+  }
+  pthread_mutex_destroy(&wal->mutex);
+  pthread_cond_destroy(&wal->flush_cond);
+  pthread_cond_destroy(&wal->synced_cond);
+  free(wal->file_name);
+  free(wal);
+  return result == 0 ? 0 : -1;
+}
+
+// Ξανανοιγει το αρχειο στη θεση file_desc του BF, ωστε οι καλουντες να κρατουν το ιδιο
+// file_desc. Το BF δινει την πρωτη ελευθερη θεση, οποτε οσες ελευθερες ειναι πριν απο
+// αυτη πιανονται προσωρινα με αλλα ανοιγματα του ιδιου αρχειου
+static int reopen_at(const char *file_name, const int file_desc)
+{
+  int extra[BF_MAX_OPEN_FILES];
+  int extra_count = 0;
+  int desc = -1;
+  while (extra_count < BF_MAX_OPEN_FILES && BF_OpenFile(file_name, &desc) == BF_OK && desc < file_desc) {
+    extra[extra_count++] = desc;
+  }
+  for (int i = 0; i < extra_count; i++) {
+    BF_CloseFile(extra[i]);
+  }
+  if (desc != file_desc) {
+    if (desc > file_desc) {
+      BF_CloseFile(desc);
+    }
+    return -1;
+  }
+  return 0;
+}
+
+int wal_checkpoint(Wal *wal)
+{
+  if (wal->op.nesting > 0) {
+    return 0;
+  }
+
+  // τα metadata της μνημης πανε στο block 0, οπως στο κλεισιμο του αρχειου
+  BF_Block *block;
+  BF_Block_Init(&block);
+  BF_ErrorCode code = BF_GetBlock(wal->file_desc, 0, block);
+  if (code == BF_OK) {
+    memcpy(BF_Block_GetData(block), wal->metadata, wal->metadata_size);
+    BF_Block_SetDirty(block);
+    code = BF_UnpinBlock(block);
+  }
+  BF_Block_Destroy(&block);
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    return -1;
+  }
+
+  // το κλεισιμο γραφει ολες τις σελιδες του αρχειου. Αν καποια ειναι pinned το BF
+  // δεν το κλεινει, και το checkpoint ξαναδοκιμαζεται σε επομενο commit
+  if (BF_CloseFile(wal->file_desc) != BF_OK) {
+    return 0;
+  }
+  if (reopen_at(wal->file_name, wal->file_desc) == -1) {
+    fprintf(stderr, "Error: cannot reopen %s in the same BF slot after a checkpoint\n", wal->file_name);
+    wal->failed = 1;
+    return -1;
+  }
+  if (sync_file(wal->file_name) != 0) {
+    perror("wal checkpoint");
+    return -1;
+  }
+
+  // οι σελιδες ειναι στον δισκο, οτι εχει γραφτει στο log ως τωρα δεν χρειαζεται
+  pthread_mutex_lock(&wal->mutex);
+  int result = write_out(wal);
+  if (result == 0 && ftruncate(wal->log_fd, 0) != 0) {
+    perror("wal checkpoint");
+    result = -1;
+  }
+  if (result == 0) {
+    wal->log_start = wal->written;
+  }
+  pthread_mutex_unlock(&wal->mutex);
+  return result;
+}
+
+WalOp *wal_begin(Wal *wal, WalOp *op)
+{
+  if (op == NULL) {
+    op = &wal->op;
+  }
+  if (op->nesting++ == 0) {
+    op->id = 0;
+    op->page_count = 0;
+  }
+  return op;
+}
+
+WalOp *wal_current(Wal *wal)
+{
+  return wal != NULL && wal->op.nesting > 0 ? &wal->op : NULL;
+}
+
+int wal_track(WalOp *op, const int block_id, const char *data)
+{
+  for (int i = 0; i < op->page_count; i++) {
+    if (op->block_ids[i] == block_id) {
+      return 0;
+    }
+  }
+  if (op->page_count == WAL_OP_MAX_PAGES) {
+    fprintf(stderr, "Error: operation changes more than %d pages\n", WAL_OP_MAX_PAGES);
+    return -1;
+  }
+
+  op->block_ids[op->page_count] = block_id;
+  memcpy(op->images[op->page_count], data, BF_BLOCK_SIZE);
+  op->page_count++;
+  return 0;
+}
+
+int wal_log_page(Wal *wal, WalOp *op, const int block_id, const char *data)
+{
+  int i = 0;
+  while (i < op->page_count && op->block_ids[i] != block_id) {
+    i++;
+  }
+  if (i == op->page_count) {
+    fprintf(stderr, "Error: block %d changed without being tracked\n", block_id);
+    return -1;
+  }
+  if (memcmp(op->images[i], data, BF_BLOCK_SIZE) == 0) {
+    return 0;
+  }
+
+  // οι εγγραφες πρεπει να φτασουν στον kernel πριν το BF μπορει να γραψει τη σελιδα
+  pthread_mutex_lock(&wal->mutex);
+  int result = log_diff(wal, op, WAL_PAGE, block_id, op->images[i], data, BF_BLOCK_SIZE, WAL_MERGE_GAP);
+  if (result == 0) {
+    result = write_out(wal);
+  }
+  pthread_mutex_unlock(&wal->mutex);
+  return result;
+}
+
+int wal_log_metadata(Wal *wal, WalOp *op, const int redo_only)
+{
+  pthread_mutex_lock(&wal->mutex);
+  int result = 0;
+  if (memcmp(wal->metadata_image, wal->metadata, wal->metadata_size) != 0) {
+    result = log_diff(wal, op, redo_only ? WAL_REDO_ONLY : WAL_PAGE, 0, wal->metadata_image, wal->metadata,
+                      wal->metadata_size, WAL_METADATA_GAP);
+    if (result == 0) {
+      result = write_out(wal);
+    }
+  }
+  pthread_mutex_unlock(&wal->mutex);
+  return result;
+}
+
+int wal_commit(Wal *wal, WalOp *op)
+{
+  const int own = op == NULL || op == &wal->op;
+  if (op == NULL) {
+    op = &wal->op;
+  }
+  if (--op->nesting > 0) {
+    return 0;
+  }
+
+  // τα metadata της single threaded πραξης γραφονται μαζι με το commit της
+  if (own && wal_log_metadata(wal, op, 0) == -1) {
+    return -1;
+  }
+  if (op->id == 0) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&wal->mutex);
+  int result = wal->failed ? -1 : append(wal, op, WAL_COMMIT, -1, 0, 0, NULL, NULL);
+  if (result == 0) {
+    result = write_out(wal);
+  }
+  if (result == 0 && wal->synchronous) {
+    result = wait_synced(wal, wal->written);
+  }
+  const int full = wal->written - wal->log_start >= WAL_CHECKPOINT_BYTES;
+  pthread_mutex_unlock(&wal->mutex);
+
+  op->id = 0;
+  op->page_count = 0;
+
+  // η πραξη του ιδιου του handle μολις τελειωσε, οποτε καμια δεν ειναι στη μεση
+  if (result == 0 && own && full) {
+    result = wal_checkpoint(wal);
+  }
+  return result;
+}
+
+int wal_sync(Wal *wal)
+{
+  pthread_mutex_lock(&wal->mutex);
+  int result = write_out(wal);
+  if (result == 0) {
+    result = wait_synced(wal, wal->written);
+  }
+  pthread_mutex_unlock(&wal->mutex);
+  return result;
+}
+
+void wal_set_synchronous(Wal *wal, const int synchronous)
+{
+  pthread_mutex_lock(&wal->mutex);
+  wal->synchronous = synchronous;
+  pthread_mutex_unlock(&wal->mutex);
+}
+
+// Γραφει bytes σε σελιδα του αρχειου, φτιαχνοντας οσα blocks λειπουν απο το τελος
+static int apply(const int file_desc, const int block_id, const int offset, const int length, const char *bytes)
+{
+  BF_Block *block;
+  BF_Block_Init(&block);
+  int block_count;
+  BF_ErrorCode code = BF_GetBlockCounter(file_desc, &block_count);
+
+  while (code == BF_OK && block_count <= block_id) {
+    code = BF_AllocateBlock(file_desc, block);
+    if (code == BF_OK) {
+      code = BF_UnpinBlock(block);
+      block_count++;
+    }
+  }
+  if (code == BF_OK) {
+    code = BF_GetBlock(file_desc, block_id, block);
+  }
+  if (code != BF_OK) {
+    BF_PrintError(code);
+    BF_Block_Destroy(&block);
+    return -1;
+  }
+
+  memcpy(BF_Block_GetData(block) + offset, bytes, length);
+  BF_Block_SetDirty(block);
+  code = BF_UnpinBlock(block);
+  BF_Block_Destroy(&block);
+  return code == BF_OK ? 0 : -1;
+}
+
+// Διαβαζει το log εγγραφη-εγγραφη μεσα απο ενα buffer, χωρις να το φερνει ολο στη μνημη
+typedef struct {
+  int fd;
+  int start;      // η επομενη εγγραφη στο buffer
+  int end;        // bytes του buffer που διαβαστηκαν
+  size_t offset;  // θεση της επομενης εγγραφης στο αρχειο
+  char buffer[WAL_BUFFER_SIZE];
+} LogReader;
+
+static void reader_rewind(LogReader *reader)
+{
+  reader->start = 0;
+  reader->end = 0;
+  reader->offset = 0;
+  lseek(reader->fd, 0, SEEK_SET);
+}
+
+// φερνει στο buffer τουλαχιστον need bytes απο την επομενη εγγραφη, αν υπαρχουν
+static int reader_fill(LogReader *reader, const int need)
+{
+  if (reader->end - reader->start >= need) {
+    return 1;
+  }
+  memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+  reader->end -= reader->start;
+  reader->start = 0;
+  while (reader->end < need) {
+    const ssize_t n = read(reader->fd, reader->buffer + reader->end, WAL_BUFFER_SIZE - reader->end);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    reader->end += n;
+  }
+  return 1;
+}
+
+// ελεγχει μια εγγραφη του buffer, 1 αν ειναι ακεραια
+static int valid_record(char *bytes, const WalRecord *record)
+{
+  if (record->size < sizeof(WalRecord) || record->size > WAL_MAX_RECORD || record->length < 0 ||
+      record->size != sizeof(WalRecord) + 2 * (uint32_t)record->length || record->offset < 0 ||
+      record->offset + record->length > BF_BLOCK_SIZE) {
+    return 0;
+  }
+  memset(bytes + offsetof(WalRecord, checksum), 0, sizeof(uint32_t));
+  const uint32_t actual = crc32((const unsigned char *)bytes, record->size);
+  memcpy(bytes + offsetof(WalRecord, checksum), &record->checksum, sizeof(uint32_t));
+  return actual == record->checksum;
+}
+
+// Η επομενη ακεραια εγγραφη: η επικεφαλιδα στο *record, η θεση της στο *offset, και
+// επιστρεφει τα παλια bytes (ακολουθουν τα νεα). NULL στο τελος ή σε κομμενη εγγραφη
+static const char *reader_next(LogReader *reader, WalRecord *record, size_t *offset)
+{
+  if (!reader_fill(reader, sizeof(WalRecord))) {
+    return NULL;
+  }
+  memcpy(record, reader->buffer + reader->start, sizeof(WalRecord));
+  if (record->size < sizeof(WalRecord) || record->size > WAL_MAX_RECORD ||
+      !reader_fill(reader, (int)record->size)) {
+    return NULL;
+  }
+  char *bytes = reader->buffer + reader->start;
+  if (!valid_record(bytes, record)) {
+    return NULL;
+  }
+  *offset = reader->offset;
+  reader->start += record->size;
+  reader->offset += record->size;
+  return bytes + sizeof(WalRecord);
+}
+
+int wal_recover(const char *file_name, int *file_desc)
+{
+  char *path = log_path(file_name);
+  if (path == NULL) {
+    return -1;
+  }
+  const int log_fd = open(path, O_RDONLY);
+  if (log_fd < 0) {
+    free(path);
+    return errno == ENOENT ? 0 : -1;
+  }
+  LogReader *reader = malloc(sizeof(LogReader));
+  if (reader == NULL) {
+    close(log_fd);
+    free(path);
+    return -1;
+  }
+  reader->fd = log_fd;
+
+  // analysis: ποσες εγγραφες ειναι ακεραιες και ποιο ευρος εχουν τα ids των πραξεων.
+  // Μετα απο ενα checkpoint τα ids δεν ξεκινουν απο το 1
+  WalRecord record;
+  size_t offset;
+  const char *before;
+  int count = 0;
+  uint64_t min_op = UINT64_MAX;
+  uint64_t max_op = 0;
+  reader_rewind(reader);
+  while (reader_next(reader, &record, &offset) != NULL) {
+    min_op = record.op_id < min_op ? record.op_id : min_op;
+    max_op = record.op_id > max_op ? record.op_id : max_op;
+    count++;
+  }
+
+  const size_t ops = count > 0 ? max_op - min_op + 1 : 1;
+  unsigned char *committed = calloc(ops, 1);
+  unsigned char *seen = calloc(ops, 1);
+  int result = committed != NULL && seen != NULL ? 0 : -1;
+
+  reader_rewind(reader);
+  for (int i = 0; result == 0 && i < count && reader_next(reader, &record, &offset) != NULL; i++) {
+    seen[record.op_id - min_op] = 1;
+    if (record.type == WAL_COMMIT) {
+      committed[record.op_id - min_op] = 1;
+    }
+  }
+
+  // redo: επαναλαμβανουμε ολη την ιστορια, και των πραξεων που θα αναιρεθουν. Κραταμε
+  // μονο τις θεσεις των εγγραφων τους, που ειναι λιγες: οσες πραξεις ηταν στη μεση
+  size_t *undo = NULL;
+  int undo_count = 0;
+  int undo_allocated = 0;
+  reader_rewind(reader);
+  for (int i = 0; result == 0 && i < count && (before = reader_next(reader, &record, &offset)) != NULL; i++) {
+    if (record.type == WAL_COMMIT) {
+      continue;
+    }
+    result = apply(*file_desc, record.block_id, record.offset, record.length, before + record.length);
+    if (result == 0 && record.type == WAL_PAGE && !committed[record.op_id - min_op]) {
+      if (undo_count == undo_allocated) {
+        undo_allocated = undo_allocated == 0 ? 64 : 2 * undo_allocated;
+        size_t *grown = realloc(undo, undo_allocated * sizeof(size_t));
+        if (grown == NULL) {
+          result = -1;
+          break;
+        }
+        undo = grown;
+      }
+      undo[undo_count++] = offset;
+    }
+  }
+
+  // undo: οι πραξεις χωρις commit γυριζουν πισω, απο την πιο προσφατη αλλαγη
+  char bytes[WAL_MAX_RECORD];
+  for (int i = undo_count - 1; result == 0 && i >= 0; i--) {
+    if (pread(log_fd, bytes, WAL_MAX_RECORD, undo[i]) < (ssize_t)sizeof(WalRecord)) {
+      result = -1;
+      break;
+    }
+    memcpy(&record, bytes, sizeof(record));
+    result = apply(*file_desc, record.block_id, record.offset, record.length, bytes + sizeof(WalRecord));
+  }
+  int losers = 0;
+  for (size_t op = 0; op < ops && result == 0; op++) {
+    losers += seen[op] && !committed[op];
+  }
+
+  free(undo);
+  free(committed);
+  free(seen);
+  free(reader);
+  close(log_fd);
+
+  // checkpoint: οι σελιδες γραφονται και γινονται fsync, μετα το log δεν χρειαζεται
+  if (result == 0) {
+    BF_ErrorCode code = BF_CloseFile(*file_desc);
+    if (code == BF_OK && sync_file(file_name) == 0) {
+      code = BF_OpenFile(file_name, file_desc);
+      if (code == BF_OK) {
+        unlink(path);
+        fprintf(stderr, "Recovery of %s: replayed %d log records, rolled back %d operations\n", file_name, count,
+                losers);
+      }
+    }
+    if (code != BF_OK) {
+      BF_PrintError(code);
+      result = -1;
+    }
+  }
+
+  free(path);
+  return result;
+}
@@ -0,0 +1,197 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdint.h>
+
+#include "bf.h"
+
+/**
+ * Write-ahead log
+ *
+ * Every change to a page of a BF file is appended to "<file>.wal" as one or
+ * more page records holding the changed byte range of the page with both
+ * its old (undo) and new (redo) contents. The records of one operation
+ * (an insert, a delete, ...) belong to one mini-transaction that ends with
+ * a commit record. Operations that are not committed when a crash happens
+ * are rolled back by recovery.
+ *
+ * The BF layer writes dirty pages back whenever it evicts them and offers no
+ * hook to delay that, so the log records of a page are handed to the kernel
+ * (write) before the page is unpinned. Commits are made durable in groups
+ * by a background thread that calls fsync at most every
+ * WAL_GROUP_COMMIT_USEC, instead of one fsync per operation. With
+ * synchronous commits (wal_set_synchronous), wal_commit waits for the
+ * fsync that covers it, and all commits waiting together share it.
+ *
+ * Recovery is therefore guaranteed against crashes of the process, not
+ * against power loss or a crash of the operating system. The records of a
+ * page reach the kernel before the page does, but nothing syncs them
+ * before BF writes the page. The kernel may put an evicted page on disk
+ * before the log records that undo it. After a power loss, an operation
+ * that was in progress can then be left half applied. A synchronous
+ * commit only makes sure that the operations committed before it are
+ * redone.
+ *
+ * Checkpoints keep the log short while the file is open. When the log has
+ * grown past WAL_CHECKPOINT_BYTES, the commit of the handle's own operation
+ * that crossed it writes the registered metadata to block 0 and closes the
+ * BF file, which writes every page back. It then reopens the file in the
+ * same BF slot, so file descriptors stay valid, fsyncs it and truncates the
+ * log. If a page of the file is still pinned, BF refuses to close it and the
+ * checkpoint waits for a later commit. Operations of other threads
+ * (wal_begin with their own WalOp) never checkpoint, so the log of a
+ * bplus_shared_* session is checkpointed by the first single threaded
+ * commit after it.
+ *
+ * Recovery (wal_recover, on open) streams the log three times through a
+ * buffer of WAL_BUFFER_SIZE bytes, so it needs little memory whatever the
+ * size of the log. Analysis finds the committed operations, redo replays
+ * every page record in log order, and undo restores the old contents of
+ * the operations that never committed, newest first; only the positions of
+ * their records are kept in memory. Then the file is checkpointed and the
+ * log is discarded. The log is also discarded on a clean close. Blocks that
+ * a rolled back operation appended stay in the file, zeroed as BF handed
+ * them out; the B+ tree puts them on its free list when it is opened and the
+ * heap file fills them before it allocates new ones.
+ *
+ * File metadata that lives in memory while the file is open (BPlusMeta,
+ * HeapFileHeader) is registered with wal_open and logged as a change to the
+ * start of block 0, where the close function writes it.
+ */
+
+#define WAL_GROUP_COMMIT_USEC 2000     /* Most time a commit waits before its fsync */
+#define WAL_OP_MAX_PAGES 64            /* Most pages one operation may change */
+#define WAL_CHECKPOINT_BYTES (8 << 20) /* Log size after which a commit checkpoints */
+
+typedef struct Wal Wal;
+
+/**
+ * @brief Pages changed by one operation, with the last logged image of each.
+ */
+typedef struct {
+    uint64_t id;                                 /**< Operation id, 0 until the first record */
+    int nesting;                                 /**< Open wal_begin calls */
+    int page_count;                              /**< Pages tracked so far */
+    int block_ids[WAL_OP_MAX_PAGES];             /**< Tracked block numbers */
+    char images[WAL_OP_MAX_PAGES][BF_BLOCK_SIZE];/**< Page contents as last logged */
+} WalOp;
+
+/**
+ * @brief Replays "<file_name>.wal" into a file that was not closed cleanly.
+ *
+ * Does nothing if there is no log. Otherwise the recovered file is written
+ * back and reopened, so *file_desc may change.
+ * @param file_name Name of the data file.
+ * @param file_desc File descriptor of the open data file (updated).
+ * @return 0 on success, -1 on failure.
+ */
+int wal_recover(const char *file_name, int *file_desc);
+
+/**
+ * @brief Starts logging changes of an open file.
+ * @param file_name Name of the data file (the log is "<file_name>.wal").
+ * @param file_desc File descriptor of the open data file.
+ * @param metadata In-memory metadata that is written to the start of block 0 on close.
+ * @param metadata_size Size of the metadata in bytes.
+ * @return New log handle, or NULL on failure.
+ */
+Wal *wal_open(const char *file_name, int file_desc, const void *metadata, int metadata_size);
+
+/**
+ * @brief Returns the log of an open file, or NULL if it has none.
+ * @param file_desc File descriptor of the data file.
+ */
+Wal *wal_of(int file_desc);
+
+/**
+ * @brief Makes the data file durable and discards the log. Call after BF_CloseFile.
+ * @param wal Log handle (freed).
+ * @return 0 on success, -1 on failure.
+ */
+int wal_close(Wal *wal);
+
+/**
+ * @brief Starts (or nests into) an operation.
+ * @param wal Log handle.
+ * @param op Operation state, or NULL for the handle's own operation
+ *        (single threaded callers).
+ * @return The operation that was started.
+ */
+WalOp *wal_begin(Wal *wal, WalOp *op);
+
+/**
+ * @brief Returns the handle's own operation if one is in progress, else NULL.
+ * @param wal Log handle (may be NULL).
+ */
+WalOp *wal_current(Wal *wal);
+
+/**
+ * @brief Remembers the contents of a page before the operation changes it.
+ * @param op Operation state.
+ * @param block_id Block number of the page.
+ * @param data Current page contents.
+ * @return 0 on success, -1 if the operation already tracks WAL_OP_MAX_PAGES pages.
+ */
+int wal_track(WalOp *op, int block_id, const char *data);
+
+/**
+ * @brief Logs the changes of a tracked page since it was last logged.
+ *
+ * Must be called while the page is still pinned.
+ * @param wal Log handle.
+ * @param op Operation state.
+ * @param block_id Block number of the page.
+ * @param data Current page contents.
+ * @return 0 on success, -1 on failure or if the page was not tracked.
+ */
+int wal_log_page(Wal *wal, WalOp *op, int block_id, const char *data);
+
+/**
+ * @brief Logs the changes of the registered metadata since it was last logged.
+ * @param wal Log handle.
+ * @param op Operation state.
+ * @param redo_only 1 for changes that recovery must never roll back
+ *        (block allocation counters), 0 for ordinary changes.
+ * @return 0 on success, -1 on failure.
+ */
+int wal_log_metadata(Wal *wal, WalOp *op, int redo_only);
+
+/**
+ * @brief Ends an operation; the outermost call appends its commit record.
+ *
+ * For the handle's own operation the changes of the registered metadata
+ * are logged first. Operations of other threads log them explicitly with
+ * wal_log_metadata.
+ * @param wal Log handle.
+ * @param op Operation state (NULL for the handle's own operation).
+ * @return 0 on success, -1 on failure.
+ */
+int wal_commit(Wal *wal, WalOp *op);
+
+/**
+ * @brief Writes every page of the file back, makes it durable and empties the log.
+ *
+ * Called by wal_commit once the log passes WAL_CHECKPOINT_BYTES. Does
+ * nothing while the handle's own operation is in progress, or if BF cannot
+ * close the file because some of its pages are pinned. The file keeps its
+ * file descriptor. Must not run while other threads use the file.
+ * @param wal Log handle.
+ * @return 0 on success or if skipped, -1 on failure.
+ */
+int wal_checkpoint(Wal *wal);
+
+/**
+ * @brief Waits until everything logged so far is on stable storage.
+ * @param wal Log handle.
+ * @return 0 on success, -1 on failure.
+ */
+int wal_sync(Wal *wal);
+
+/**
+ * @brief Chooses whether wal_commit waits for its group fsync.
+ * @param wal Log handle.
+ * @param synchronous 1 to wait, 0 to return once the commit is handed to the kernel.
+ */
+void wal_set_synchronous(Wal *wal, int synchronous);
+
+#endif